@@ -202,6 +202,28 @@ SOURCES += \
     src/TemplateManager.cpp \
     src/FieldExtractor.cpp \
     src/KZipUtils.cpp \
+    src/DocxPartCache.cpp \
+    src/DocxConversionManifest.cpp \
+    src/DocxStyleResolver.cpp \
+    src/PdfDocumentPool.cpp \
+    src/PdfTextEngine.cpp \
+    src/PdfCoreDocument.cpp \
+    src/PdfTableDetector.cpp \
+    src/PdfRegionDetector.cpp \
+    src/PdfRegionRenderer.cpp \
+    src/PdfAnalysisRaster.cpp \
+    src/PdfTextLayoutCache.cpp \
+    src/PdfStructureExtractor.cpp \
+    src/PdfFormReader.cpp \
+    src/PdfProbe.cpp \
+    src/PdfObjectScanner.cpp \
+    src/PdfSignatureValidator.cpp \
+    src/PdfFontTable.cpp \
+    src/ProcessingDeadline.cpp \
+    src/ConversionWorker.cpp \
+    src/ConversionWorkerPool.cpp \
+    src/BatchConverter.cpp \
+    src/DocumentPipeline.cpp \
     src/PopplerCompat.cpp \
     libs/poppler-qt6/poppler-document.cc \
     libs/poppler-qt6/poppler-page.cc \
@@ -257,6 +279,7 @@ SOURCES += \
     libs/splash/SplashFontEngine.cc \
     libs/splash/SplashFontFile.cc \
     libs/splash/SplashFontFileID.cc \
+    libs/splash/SplashGlyphCache.cc \
     libs/splash/SplashScreen.cc \
     libs/splash/SplashPattern.cc \
     libs/splash/SplashSolidColor.cc \
@@ -324,6 +347,10 @@ SOURCES += \
     libs/poppler-core/MarkedContentOutputDev.cc \
     libs/poppler-core/PreScanOutputDev.cc \
     libs/poppler-core/BBoxOutputDev.cc \
+    libs/poppler-core/ImageCollectorOutputDev.cc \
+    libs/poppler-core/RulingOutputDev.cc \
+    libs/poppler-core/DrawingRegionOutputDev.cc \
+    libs/poppler-core/MarkedContentCollectorOutputDev.cc \
     libs/poppler-core/PSOutputDev.cc \
     libs/poppler-core/PSTokenizer.cc \
     libs/poppler-core/ProfileData.cc \
@@ -409,6 +436,29 @@ HEADERS += \
     src/TemplateManager.h \
     src/KZipConfig.h \
     src/KZipUtils.h \
+    src/DocxPartCache.h \
+    src/DocxConversionManifest.h \
+    src/DocxStyleResolver.h \
+    src/OoxmlTags.h \
+    src/PdfDocumentPool.h \
+    src/PdfTextEngine.h \
+    src/PdfCoreDocument.h \
+    src/PdfTableDetector.h \
+    src/PdfRegionDetector.h \
+    src/PdfRegionRenderer.h \
+    src/PdfAnalysisRaster.h \
+    src/PdfTextLayoutCache.h \
+    src/PdfStructureExtractor.h \
+    src/PdfFormReader.h \
+    src/PdfProbe.h \
+    src/PdfObjectScanner.h \
+    src/PdfSignatureValidator.h \
+    src/PdfFontTable.h \
+    src/ProcessingDeadline.h \
+    src/ConversionWorker.h \
+    src/ConversionWorkerPool.h \
+    src/BatchConverter.h \
+    src/DocumentPipeline.h \
     src/FieldExtractor.h \
     src/QtCompat.h\
     libs/karchive/src/karchive.h \
@@ -458,6 +508,7 @@ HEADERS += \
     libs/splash/SplashMath.h \
     libs/splash/SplashState.h \
     libs/splash/SplashGlyphBitmap.h \
+    libs/splash/SplashGlyphCache.h \
     libs/splash/SplashPattern.h \
     libs/splash/SplashPath.h \
     libs/splash/SplashScreen.h \
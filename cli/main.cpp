@@ -0,0 +1,327 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-19 00:50:00
+ * @LastEditTime: 2026-10-19 00:50:00
+ * @LastEditors: seelights
+ * @Description: reportmason-cli 无界面批量转换入口
+ * @FilePath: \ReportMason\cli\main.cpp
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+/*
+ * 用法：
+ *   reportmason-cli [选项] <文件或目录>...
+ *
+ * 示例：
+ *   reportmason-cli --jobs 8 --converter lossless --output-dir out reports/
+ *   reportmason-cli -c pdf -o out --file-list files.txt
+ *   reportmason-cli --pipeline --stage-workers read=2,parse=6,serialize=2 -o out reports/
+ *
+ * 退出码：0 全部成功；1 部分文件失败；2 参数错误或无法启动转换
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QGuiApplication>
+#include <QTextStream>
+#include <cstring>
+#include <memory>
+
+#include "src/BatchConverter.h"
+#include "src/ConversionWorker.h"
+#include "src/QtCompat.h"
+
+namespace {
+
+/**
+ * @brief 命令行中的转换器名称
+ */
+bool parseConverter(const QString& name, ConversionWorker::Converter& converter)
+{
+    const QString key = name.toLower();
+    if (key == QS("lossless") || key == QS("losslessdocumentconverter")) {
+        converter = ConversionWorker::Converter::LOSSLESS_XML;
+    } else if (key == QS("docx") || key == QS("doctoxmlconverter")) {
+        converter = ConversionWorker::Converter::DOCX_FIELD_XML;
+    } else if (key == QS("pdf") || key == QS("pdftoxmlconverter")) {
+        converter = ConversionWorker::Converter::PDF_FIELD_XML;
+    } else if (key == QS("fields")) {
+        converter = ConversionWorker::Converter::FIELD_XML;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+QString statusLabel(ConversionWorkerPool::JobStatus status)
+{
+    switch (status) {
+    case ConversionWorkerPool::JobStatus::SUCCESS:
+        return QS("成功");
+    case ConversionWorkerPool::JobStatus::FAILED:
+        return QS("失败");
+    case ConversionWorkerPool::JobStatus::CRASHED:
+        return QS("崩溃");
+    case ConversionWorkerPool::JobStatus::TIMED_OUT:
+        return QS("超时");
+    case ConversionWorkerPool::JobStatus::CANCELLED:
+        return QS("取消");
+    }
+    return QS("未知");
+}
+
+QString formatBytes(qint64 bytes)
+{
+    if (bytes >= 1024 * 1024) {
+        return QS("%1 MB").arg(bytes / (1024.0 * 1024.0), 0, 'f', 2);
+    }
+    return QS("%1 KB").arg(bytes / 1024.0, 0, 'f', 1);
+}
+
+/**
+ * @brief 读取文件列表，每行一个路径，忽略空行和#开头的注释
+ */
+bool readFileList(const QString& listPath, QStringList& paths)
+{
+    QFile file(listPath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return false;
+    }
+    QTextStream stream(&file);
+    while (!stream.atEnd()) {
+        const QString line = stream.readLine().trimmed();
+        if (!line.isEmpty() && !line.startsWith(QLatin1Char('#'))) {
+            paths.append(line);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 解析--stage-workers的值，形如"read=2,parse=6"
+ */
+bool parseStageWorkers(const QString& value, BatchConverter& batch)
+{
+    for (const QString& entry : value.split(QLatin1Char(','), Qt::SkipEmptyParts)) {
+        const QStringList pair = entry.split(QLatin1Char('='));
+        if (pair.size() != 2) {
+            return false;
+        }
+        bool ok = false;
+        const int workers = pair.at(1).trimmed().toInt(&ok);
+        if (!ok || workers <= 0) {
+            return false;
+        }
+
+        bool matched = false;
+        for (int stage = 0; stage < DocumentPipeline::STAGE_COUNT; ++stage) {
+            const auto pipelineStage = static_cast<DocumentPipeline::Stage>(stage);
+            if (DocumentPipeline::stageName(pipelineStage) == pair.at(0).trimmed().toLower()) {
+                batch.setStageWorkers(pipelineStage, workers);
+                matched = true;
+            }
+        }
+        if (!matched) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool hasArgument(int argc, char* argv[], const char* argument)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], argument) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    // 工作进程池以本程序自身启动工作进程
+    if (ConversionWorker::isWorkerInvocation(argc, argv)) {
+        return ConversionWorker::run(argc, argv);
+    }
+
+    // 工作进程方式下主进程只负责调度和写出结果，不需要GUI应用对象；
+    // 流水线方式在本进程中转换，转换器用到QFont和QImage，需要不创建窗口的GUI应用对象
+    std::unique_ptr<QCoreApplication> application;
+    if (hasArgument(argc, argv, "--pipeline")) {
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+        application = std::make_unique<QGuiApplication>(argc, argv);
+    } else {
+        application = std::make_unique<QCoreApplication>(argc, argv);
+    }
+    QCoreApplication& app = *application;
+    app.setApplicationName(QS("reportmason-cli"));
+    app.setApplicationVersion(QS("1.0.0"));
+    app.setOrganizationName(QS("ReportMason"));
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QS("ReportMason 无界面批量文档转换"));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument(QS("inputs"), QS("要转换的文件或目录"), QS("<文件或目录>..."));
+
+    const QCommandLineOption jobsOption({QS("j"), QS("jobs")}, QS("并行的工作进程数（流水线方式下为parse阶段线程数），默认使用CPU核数"),
+                                        QS("N"), QS("0"));
+    const QCommandLineOption converterOption(
+        {QS("c"), QS("converter")},
+        QS("转换器：lossless（LosslessDocumentConverter）、docx（DocToXmlConverter）、"
+           "pdf（PdfToXmlConverter）或fields（按扩展名选择docx/pdf），默认lossless"),
+        QS("name"), QS("lossless"));
+    const QCommandLineOption outputOption({QS("o"), QS("output-dir")}, QS("输出目录，默认当前目录"),
+                                          QS("dir"), QS("."));
+    const QCommandLineOption recursiveOption({QS("r"), QS("recursive")}, QS("递归处理目录中的子目录"));
+    const QCommandLineOption fileListOption(QS("file-list"), QS("从文件读取输入路径，每行一个"), QS("file"));
+    const QCommandLineOption timeoutOption(QS("timeout"), QS("单个文件的硬时限（秒），0表示不限时"),
+                                           QS("seconds"),
+                                           QString::number(ConversionWorkerPool::DEFAULT_JOB_TIMEOUT_MS / 1000));
+    const QCommandLineOption pipelineOption(
+        QS("pipeline"), QS("在本进程中分阶段转换（read/unpack/parse/extract/serialize），仅支持lossless，不隔离崩溃"));
+    const QCommandLineOption stageWorkersOption(
+        QS("stage-workers"), QS("流水线各阶段的线程数，如read=2,parse=6,serialize=2；parse默认取--jobs"),
+        QS("list"));
+    const QCommandLineOption queueCapacityOption(QS("queue-capacity"), QS("流水线阶段之间的队列容量"),
+                                                 QS("N"), QS("0"));
+    parser.addOption(jobsOption);
+    parser.addOption(converterOption);
+    parser.addOption(outputOption);
+    parser.addOption(recursiveOption);
+    parser.addOption(fileListOption);
+    parser.addOption(timeoutOption);
+    parser.addOption(pipelineOption);
+    parser.addOption(stageWorkersOption);
+    parser.addOption(queueCapacityOption);
+    parser.process(app);
+
+    ConversionWorker::Converter converter;
+    if (!parseConverter(parser.value(converterOption), converter)) {
+        err << QS("未知的转换器: %1").arg(parser.value(converterOption)) << Qt::endl;
+        return 2;
+    }
+
+    bool ok = false;
+    const int jobs = parser.value(jobsOption).toInt(&ok);
+    if (!ok || jobs < 0) {
+        err << QS("无效的并行数: %1").arg(parser.value(jobsOption)) << Qt::endl;
+        return 2;
+    }
+    const int timeoutSeconds = parser.value(timeoutOption).toInt(&ok);
+    if (!ok || timeoutSeconds < 0) {
+        err << QS("无效的时限: %1").arg(parser.value(timeoutOption)) << Qt::endl;
+        return 2;
+    }
+
+    const int queueCapacity = parser.value(queueCapacityOption).toInt(&ok);
+    if (!ok || queueCapacity < 0) {
+        err << QS("无效的队列容量: %1").arg(parser.value(queueCapacityOption)) << Qt::endl;
+        return 2;
+    }
+    const bool pipeline = parser.isSet(pipelineOption);
+    if (pipeline && converter != ConversionWorker::Converter::LOSSLESS_XML) {
+        err << QS("--pipeline只支持lossless转换器") << Qt::endl;
+        return 2;
+    }
+
+    QStringList paths = parser.positionalArguments();
+    if (parser.isSet(fileListOption) && !readFileList(parser.value(fileListOption), paths)) {
+        err << QS("无法读取文件列表: %1").arg(parser.value(fileListOption)) << Qt::endl;
+        return 2;
+    }
+    if (paths.isEmpty()) {
+        parser.showHelp(2);
+    }
+
+    QStringList rejected;
+    const QList<BatchConverter::Input> inputs =
+        BatchConverter::collectInputs(paths, converter, parser.isSet(recursiveOption), rejected);
+    for (const QString& path : rejected) {
+        err << QS("跳过不存在或不支持的输入: %1").arg(path) << Qt::endl;
+    }
+    if (inputs.isEmpty()) {
+        err << QS("没有可转换的文件") << Qt::endl;
+        return 2;
+    }
+
+    BatchConverter batch;
+    batch.setConverter(converter);
+    batch.setJobs(jobs);
+    batch.setOutputDirectory(parser.value(outputOption));
+    batch.setJobTimeout(timeoutSeconds * 1000);
+    if (pipeline) {
+        batch.setMode(BatchConverter::Mode::PIPELINE);
+        batch.setStageWorkers(DocumentPipeline::Stage::PARSE, jobs);
+        batch.setQueueCapacity(queueCapacity);
+        if (!parseStageWorkers(parser.value(stageWorkersOption), batch)) {
+            err << QS("无效的阶段线程数: %1").arg(parser.value(stageWorkersOption)) << Qt::endl;
+            return 2;
+        }
+    }
+
+    int finished = 0;
+    const int total = inputs.size();
+    QObject::connect(&batch, &BatchConverter::fileFinished, [&](const BatchConverter::FileReport& report) {
+        ++finished;
+        out << QS("[%1/%2] %3 %4 %5 ms %6")
+                   .arg(finished)
+                   .arg(total)
+                   .arg(statusLabel(report.status))
+                   .arg(report.inputPath)
+                   .arg(report.elapsedMs)
+                   .arg(formatBytes(report.inputBytes));
+        if (report.status == ConversionWorkerPool::JobStatus::SUCCESS) {
+            out << QS(" -> %1").arg(report.outputPath);
+        } else {
+            out << QS(": %1").arg(report.error);
+        }
+        out << Qt::endl;
+    });
+
+    BatchConverter::Summary summary;
+    if (!batch.run(inputs, summary)) {
+        err << QS("无法启动转换: %1").arg(batch.lastError()) << Qt::endl;
+        return 2;
+    }
+
+    out << QS("共 %1 个文件，成功 %2，失败 %3，工作进程重启 %4 次")
+               .arg(summary.total)
+               .arg(summary.succeeded)
+               .arg(summary.failed)
+               .arg(summary.workerRestarts)
+        << Qt::endl;
+    out << QS("总耗时 %1 s，输入 %2，输出 %3，吞吐量 %4 文件/s，%5 MB/s")
+               .arg(summary.wallMs / 1000.0, 0, 'f', 2)
+               .arg(formatBytes(summary.inputBytes))
+               .arg(formatBytes(summary.outputBytes))
+               .arg(summary.filesPerSecond(), 0, 'f', 2)
+               .arg(summary.megabytesPerSecond(), 0, 'f', 2)
+        << Qt::endl;
+
+    if (!summary.stageMetrics.isEmpty()) {
+        out << QS("阶段        线程  文档  利用率   处理(ms)  等待输入(ms)  背压(ms)  最大队列") << Qt::endl;
+        for (const DocumentPipeline::StageMetrics& metrics : summary.stageMetrics) {
+            out << QS("%1 %2 %3 %4% %5 %6 %7 %8")
+                       .arg(DocumentPipeline::stageName(metrics.stage), -10)
+                       .arg(metrics.workers, 5)
+                       .arg(metrics.processed, 5)
+                       .arg(metrics.utilization * 100.0, 7, 'f', 1)
+                       .arg(metrics.busyMs, 9)
+                       .arg(metrics.starvedMs, 13)
+                       .arg(metrics.blockedMs, 9)
+                       .arg(metrics.maxQueueDepth, 9)
+                << Qt::endl;
+        }
+    }
+
+    return summary.failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,360 @@
+//========================================================================
+//
+// DrawingRegionOutputDev.cc
+//
+// This file is licensed under the GPLv2 or later
+//
+//========================================================================
+
+#include <config.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "DrawingRegionOutputDev.h"
+#include "GfxFont.h"
+#include "GfxState.h"
+
+DrawingRegionOutputDev::DrawingRegionOutputDev()
+{
+    collectText = true;
+    axisTolerance = 1;
+}
+
+DrawingRegionOutputDev::~DrawingRegionOutputDev() = default;
+
+void DrawingRegionOutputDev::startPage(int /*pageNum*/, GfxState * /*state*/, XRef * /*xref*/)
+{
+    primitives.clear();
+}
+
+std::vector<DrawingPrimitive> DrawingRegionOutputDev::takePrimitives()
+{
+    std::vector<DrawingPrimitive> result;
+    result.swap(primitives);
+    return result;
+}
+
+void DrawingRegionOutputDev::stroke(GfxState *state)
+{
+    addPath(state->getPath(), state, false);
+}
+
+void DrawingRegionOutputDev::fill(GfxState *state)
+{
+    addPath(state->getPath(), state, true);
+}
+
+void DrawingRegionOutputDev::eoFill(GfxState *state)
+{
+    addPath(state->getPath(), state, true);
+}
+
+bool DrawingRegionOutputDev::functionShadedFill(GfxState *state, GfxFunctionShading * /*shading*/)
+{
+    addClipBox(state);
+    return true;
+}
+
+bool DrawingRegionOutputDev::axialShadedFill(GfxState *state, GfxAxialShading * /*shading*/, double /*tMin*/, double /*tMax*/)
+{
+    addClipBox(state);
+    return true;
+}
+
+bool DrawingRegionOutputDev::radialShadedFill(GfxState *state, GfxRadialShading * /*shading*/, double /*sMin*/, double /*sMax*/)
+{
+    addClipBox(state);
+    return true;
+}
+
+bool DrawingRegionOutputDev::gouraudTriangleShadedFill(GfxState *state, GfxGouraudTriangleShading * /*shading*/)
+{
+    addClipBox(state);
+    return true;
+}
+
+bool DrawingRegionOutputDev::patchMeshShadedFill(GfxState *state, GfxPatchMeshShading * /*shading*/)
+{
+    addClipBox(state);
+    return true;
+}
+
+void DrawingRegionOutputDev::drawChar(GfxState *state, double x, double y, double dx, double dy, double /*originX*/, double /*originY*/, CharCode code, int /*nBytes*/, const Unicode * /*u*/, int /*uLen*/)
+{
+    if (!collectText || code == (CharCode)0x20) {
+        return;
+    }
+    // invisible text (e.g. an OCR layer over a scan) and clip-only text
+    if ((state->getRender() & 3) == 3) {
+        return;
+    }
+
+    const GfxFont *const font = state->getFont().get();
+    if (!font) {
+        return;
+    }
+
+    // glyph box from the font metrics, as in BBoxOutputDev::drawChar()
+    double leftent, rightent, ascent, descent;
+    const double *fb = font->getFontBBox();
+    if (font->getWMode() == 0) { // horizontal
+        leftent = 0;
+        rightent = 0;
+        ascent = font->getAscent();
+        descent = font->getDescent();
+    } else {
+        if (fb[0] == 0 && fb[1] == 0 && fb[2] == 0 && fb[3] == 0) {
+            leftent = -0.5;
+            rightent = 0.5;
+        } else {
+            leftent = fb[1];
+            rightent = fb[3];
+        }
+        ascent = 0;
+        descent = 0;
+    }
+
+    double adjust = 1;
+    if (font->getType() == fontType3) {
+        adjust = ((const Gfx8BitFont *)font)->getWidth(code) / 0.5;
+        const double *fm = font->getFontMatrix();
+        if (fm[0] != 0) {
+            adjust *= std::fabs(fm[3] / fm[0]);
+        }
+    }
+
+    const double fontSize = state->getFontSize();
+    ascent *= adjust * fontSize;
+    descent *= adjust * fontSize;
+    leftent *= adjust * fontSize;
+    rightent *= adjust * fontSize;
+
+    double xMin = 0, yMin = 0, xMax = 0, yMax = 0;
+    bool first = true;
+    const double corners[4][2] = { { leftent, descent }, { rightent, ascent }, { leftent, descent }, { rightent, ascent } };
+    for (int i = 0; i < 4; ++i) {
+        double fx, fy, tx, ty;
+        state->textTransformDelta(corners[i][0], corners[i][1], &fx, &fy);
+        if (i < 2) {
+            state->transform(x + fx, y + fy, &tx, &ty);
+        } else {
+            state->transform(x + dx + fx, y + dy + fy, &tx, &ty);
+        }
+        if (first) {
+            xMin = xMax = tx;
+            yMin = yMax = ty;
+            first = false;
+        } else {
+            xMin = std::min(xMin, tx);
+            xMax = std::max(xMax, tx);
+            yMin = std::min(yMin, ty);
+            yMax = std::max(yMax, ty);
+        }
+    }
+    if (!clipBox(state, &xMin, &yMin, &xMax, &yMax)) {
+        return;
+    }
+
+    // extend the previous run when the glyph continues the same line
+    if (!primitives.empty()) {
+        DrawingPrimitive &last = primitives.back();
+        if (last.kind == DrawingPrimitive::kindText) {
+            const double height = std::max(yMax - yMin, last.y2 - last.y1);
+            const double overlap = std::min(yMax, last.y2) - std::max(yMin, last.y1);
+            const double gap = std::max(xMin - last.x2, last.x1 - xMax);
+            if (overlap > 0.5 * height && gap < height) {
+                last.x1 = std::min(last.x1, xMin);
+                last.y1 = std::min(last.y1, yMin);
+                last.x2 = std::max(last.x2, xMax);
+                last.y2 = std::max(last.y2, yMax);
+                return;
+            }
+        }
+    }
+
+    DrawingPrimitive primitive;
+    primitive.kind = DrawingPrimitive::kindText;
+    primitive.x1 = xMin;
+    primitive.y1 = yMin;
+    primitive.x2 = xMax;
+    primitive.y2 = yMax;
+    primitive.filled = true;
+    primitive.rectilinear = false;
+    primitive.colored = false;
+    primitives.push_back(primitive);
+}
+
+void DrawingRegionOutputDev::drawImageMask(GfxState *state, Object *ref, Stream *str, int width, int height, bool invert, bool interpolate, bool inlineImg)
+{
+    addImage(state);
+    // the base class skips over inline image data
+    OutputDev::drawImageMask(state, ref, str, width, height, invert, interpolate, inlineImg);
+}
+
+void DrawingRegionOutputDev::drawImage(GfxState *state, Object *ref, Stream *str, int width, int height, GfxImageColorMap *colorMap, bool interpolate, const int *maskColors, bool inlineImg)
+{
+    addImage(state);
+    OutputDev::drawImage(state, ref, str, width, height, colorMap, interpolate, maskColors, inlineImg);
+}
+
+void DrawingRegionOutputDev::drawMaskedImage(GfxState *state, Object * /*ref*/, Stream * /*str*/, int /*width*/, int /*height*/, GfxImageColorMap * /*colorMap*/, bool /*interpolate*/, Stream * /*maskStr*/, int /*maskWidth*/, int /*maskHeight*/,
+                                             bool /*maskInvert*/, bool /*maskInterpolate*/)
+{
+    addImage(state);
+}
+
+void DrawingRegionOutputDev::drawSoftMaskedImage(GfxState *state, Object * /*ref*/, Stream * /*str*/, int /*width*/, int /*height*/, GfxImageColorMap * /*colorMap*/, bool /*interpolate*/, Stream * /*maskStr*/, int /*maskWidth*/,
+                                                 int /*maskHeight*/, GfxImageColorMap * /*maskColorMap*/, bool /*maskInterpolate*/)
+{
+    addImage(state);
+}
+
+bool DrawingRegionOutputDev::clipBox(const GfxState *state, double *x1, double *y1, double *x2, double *y2) const
+{
+    double xMin, yMin, xMax, yMax;
+    state->getClipBBox(&xMin, &yMin, &xMax, &yMax);
+
+    *x1 = std::max(*x1, xMin);
+    *y1 = std::max(*y1, yMin);
+    *x2 = std::min(*x2, xMax);
+    *y2 = std::min(*y2, yMax);
+    return *x1 <= *x2 && *y1 <= *y2;
+}
+
+bool DrawingRegionOutputDev::isColored(const GfxState *state, bool filled)
+{
+    GfxRGB rgb;
+    if (filled) {
+        state->getFillRGB(&rgb);
+    } else {
+        state->getStrokeRGB(&rgb);
+    }
+    const GfxColorComp lo = std::min({ rgb.r, rgb.g, rgb.b });
+    const GfxColorComp hi = std::max({ rgb.r, rgb.g, rgb.b });
+    return colToDbl(hi - lo) > 0.1;
+}
+
+void DrawingRegionOutputDev::addPath(const GfxPath *path, GfxState *state, bool filled)
+{
+    double xMin = 0, yMin = 0, xMax = 0, yMax = 0;
+    bool first = true;
+    bool rectilinear = true;
+
+    for (int i = 0; i < path->getNumSubpaths(); ++i) {
+        const GfxSubpath *subpath = path->getSubpath(i);
+        const int n = subpath->getNumPoints();
+        double firstX = 0, firstY = 0, prevX = 0, prevY = 0;
+        for (int j = 0; j < n; ++j) {
+            double tx, ty;
+            state->transform(subpath->getX(j), subpath->getY(j), &tx, &ty);
+            if (first) {
+                xMin = xMax = tx;
+                yMin = yMax = ty;
+                first = false;
+            } else {
+                xMin = std::min(xMin, tx);
+                xMax = std::max(xMax, tx);
+                yMin = std::min(yMin, ty);
+                yMax = std::max(yMax, ty);
+            }
+
+            if (j == 0) {
+                firstX = tx;
+                firstY = ty;
+            } else if (rectilinear) {
+                if (subpath->getCurve(j)) {
+                    rectilinear = false;
+                } else if (std::fabs(tx - prevX) > axisTolerance && std::fabs(ty - prevY) > axisTolerance) {
+                    rectilinear = false;
+                }
+            }
+            prevX = tx;
+            prevY = ty;
+        }
+        // fills close open subpaths implicitly
+        if (filled && rectilinear && n > 1 && std::fabs(firstX - prevX) > axisTolerance && std::fabs(firstY - prevY) > axisTolerance) {
+            rectilinear = false;
+        }
+    }
+    if (first) {
+        return;
+    }
+
+    if (!filled) {
+        const double halfWidth = state->getTransformedLineWidth() / 2;
+        xMin -= halfWidth;
+        yMin -= halfWidth;
+        xMax += halfWidth;
+        yMax += halfWidth;
+    }
+    if (!clipBox(state, &xMin, &yMin, &xMax, &yMax)) {
+        return;
+    }
+
+    DrawingPrimitive primitive;
+    primitive.kind = DrawingPrimitive::kindPath;
+    primitive.x1 = xMin;
+    primitive.y1 = yMin;
+    primitive.x2 = xMax;
+    primitive.y2 = yMax;
+    primitive.filled = filled;
+    primitive.rectilinear = rectilinear;
+    primitive.colored = isColored(state, filled);
+    primitives.push_back(primitive);
+}
+
+void DrawingRegionOutputDev::addImage(GfxState *state)
+{
+    // images fill the unit square of the current transformation
+    double xMin = 0, yMin = 0, xMax = 0, yMax = 0;
+    const double corners[4][2] = { { 0, 0 }, { 1, 0 }, { 0, 1 }, { 1, 1 } };
+    for (int i = 0; i < 4; ++i) {
+        double tx, ty;
+        state->transform(corners[i][0], corners[i][1], &tx, &ty);
+        if (i == 0) {
+            xMin = xMax = tx;
+            yMin = yMax = ty;
+        } else {
+            xMin = std::min(xMin, tx);
+            xMax = std::max(xMax, tx);
+            yMin = std::min(yMin, ty);
+            yMax = std::max(yMax, ty);
+        }
+    }
+    if (!clipBox(state, &xMin, &yMin, &xMax, &yMax)) {
+        return;
+    }
+
+    DrawingPrimitive primitive;
+    primitive.kind = DrawingPrimitive::kindImage;
+    primitive.x1 = xMin;
+    primitive.y1 = yMin;
+    primitive.x2 = xMax;
+    primitive.y2 = yMax;
+    primitive.filled = true;
+    primitive.rectilinear = true;
+    primitive.colored = true;
+    primitives.push_back(primitive);
+}
+
+void DrawingRegionOutputDev::addClipBox(GfxState *state)
+{
+    // shadings paint the whole clip region
+    double xMin, yMin, xMax, yMax;
+    state->getClipBBox(&xMin, &yMin, &xMax, &yMax);
+    if (xMin > xMax || yMin > yMax) {
+        return;
+    }
+
+    DrawingPrimitive primitive;
+    primitive.kind = DrawingPrimitive::kindPath;
+    primitive.x1 = xMin;
+    primitive.y1 = yMin;
+    primitive.x2 = xMax;
+    primitive.y2 = yMax;
+    primitive.filled = true;
+    primitive.rectilinear = false;
+    primitive.colored = true;
+    primitives.push_back(primitive);
+}
@@ -0,0 +1,101 @@
+//========================================================================
+//
+// DrawingRegionOutputDev.h
+//
+// Records the device-space bounding box of every drawing operation on a
+// page, kept apart by kind (images, vector paths, text runs), so that
+// callers can cluster them into figure regions without rasterizing.
+//
+// This file is licensed under the GPLv2 or later
+//
+//========================================================================
+
+#ifndef DRAWINGREGIONOUTPUTDEV_H
+#define DRAWINGREGIONOUTPUTDEV_H
+
+#include <vector>
+
+#include "poppler_private_export.h"
+#include "OutputDev.h"
+
+class GfxState;
+class GfxPath;
+
+struct DrawingPrimitive
+{
+    enum Kind
+    {
+        kindImage,
+        kindPath,
+        kindText
+    };
+
+    Kind kind;
+    // Device coordinates in points with an upper-left origin, clipped
+    // to the current clip region.  x1 <= x2 and y1 <= y2.
+    double x1, y1, x2, y2;
+    // Paths only: painted by a fill or shading rather than a stroke.
+    bool filled;
+    // Paths only: every segment is straight and axis-aligned.
+    bool rectilinear;
+    // Paths only: the paint color is not a shade of gray.
+    bool colored;
+};
+
+class POPPLER_PRIVATE_EXPORT DrawingRegionOutputDev : public OutputDev
+{
+public:
+    DrawingRegionOutputDev();
+    ~DrawingRegionOutputDev() override;
+
+    bool upsideDown() override { return true; }
+    bool useDrawChar() override { return true; }
+    bool interpretType3Chars() override { return false; }
+    bool needNonText() override { return true; }
+    // Shadings are recorded as one box instead of being decomposed into
+    // many small fills.
+    bool useShadedFills(int type) override { return type >= 1 && type <= 7; }
+
+    void startPage(int pageNum, GfxState *state, XRef *xref) override;
+
+    void stroke(GfxState *state) override;
+    void fill(GfxState *state) override;
+    void eoFill(GfxState *state) override;
+
+    bool functionShadedFill(GfxState *state, GfxFunctionShading *shading) override;
+    bool axialShadedFill(GfxState *state, GfxAxialShading *shading, double tMin, double tMax) override;
+    bool radialShadedFill(GfxState *state, GfxRadialShading *shading, double sMin, double sMax) override;
+    bool gouraudTriangleShadedFill(GfxState *state, GfxGouraudTriangleShading *shading) override;
+    bool patchMeshShadedFill(GfxState *state, GfxPatchMeshShading *shading) override;
+
+    void drawChar(GfxState *state, double x, double y, double dx, double dy, double originX, double originY, CharCode code, int nBytes, const Unicode *u, int uLen) override;
+
+    void drawImageMask(GfxState *state, Object *ref, Stream *str, int width, int height, bool invert, bool interpolate, bool inlineImg) override;
+    void drawImage(GfxState *state, Object *ref, Stream *str, int width, int height, GfxImageColorMap *colorMap, bool interpolate, const int *maskColors, bool inlineImg) override;
+    void drawMaskedImage(GfxState *state, Object *ref, Stream *str, int width, int height, GfxImageColorMap *colorMap, bool interpolate, Stream *maskStr, int maskWidth, int maskHeight, bool maskInvert, bool maskInterpolate) override;
+    void drawSoftMaskedImage(GfxState *state, Object *ref, Stream *str, int width, int height, GfxImageColorMap *colorMap, bool interpolate, Stream *maskStr, int maskWidth, int maskHeight, GfxImageColorMap *maskColorMap,
+                             bool maskInterpolate) override;
+
+    // Record glyph boxes (merged into runs along a line).  Defaults to
+    // true.
+    void setCollectText(bool collectTextA) { collectText = collectTextA; }
+    // Segments within this many points of an axis count as axis-aligned.
+    // Defaults to 1.
+    void setAxisTolerance(double toleranceA) { axisTolerance = toleranceA; }
+
+    const std::vector<DrawingPrimitive> &getPrimitives() const { return primitives; }
+    std::vector<DrawingPrimitive> takePrimitives();
+
+private:
+    void addPath(const GfxPath *path, GfxState *state, bool filled);
+    void addImage(GfxState *state);
+    void addClipBox(GfxState *state);
+    bool clipBox(const GfxState *state, double *x1, double *y1, double *x2, double *y2) const;
+    static bool isColored(const GfxState *state, bool filled);
+
+    bool collectText;
+    double axisTolerance;
+    std::vector<DrawingPrimitive> primitives;
+};
+
+#endif
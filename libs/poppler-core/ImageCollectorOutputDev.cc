@@ -0,0 +1,175 @@
+//========================================================================
+//
+// ImageCollectorOutputDev.cc
+//
+// This file is licensed under the GPLv2 or later
+//
+//========================================================================
+
+#include <config.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "ImageCollectorOutputDev.h"
+#include "Error.h"
+#include "GfxState.h"
+#include "Stream.h"
+
+ImageCollectorOutputDev::ImageCollectorOutputDev(bool decodeRasterA)
+{
+    decodeRaster = decodeRasterA;
+    minSize = 1;
+    currentPage = 0;
+}
+
+ImageCollectorOutputDev::~ImageCollectorOutputDev() = default;
+
+void ImageCollectorOutputDev::startPage(int pageNum, GfxState * /*state*/, XRef * /*xref*/)
+{
+    currentPage = pageNum;
+}
+
+std::vector<CollectedImage> ImageCollectorOutputDev::takeImages()
+{
+    std::vector<CollectedImage> result;
+    result.swap(images);
+    return result;
+}
+
+void ImageCollectorOutputDev::drawImage(GfxState *state, Object *ref, Stream *str, int width, int height, GfxImageColorMap *colorMap, bool /*interpolate*/, const int *maskColors, bool inlineImg)
+{
+    collect(state, ref, str, width, height, colorMap, inlineImg, maskColors != nullptr);
+}
+
+void ImageCollectorOutputDev::drawMaskedImage(GfxState *state, Object *ref, Stream *str, int width, int height, GfxImageColorMap *colorMap, bool /*interpolate*/, Stream * /*maskStr*/, int /*maskWidth*/, int /*maskHeight*/,
+                                              bool /*maskInvert*/, bool /*maskInterpolate*/)
+{
+    collect(state, ref, str, width, height, colorMap, false, true);
+}
+
+void ImageCollectorOutputDev::drawSoftMaskedImage(GfxState *state, Object *ref, Stream *str, int width, int height, GfxImageColorMap *colorMap, bool /*interpolate*/, Stream * /*maskStr*/, int /*maskWidth*/,
+                                                  int /*maskHeight*/, GfxImageColorMap * /*maskColorMap*/, bool /*maskInterpolate*/)
+{
+    collect(state, ref, str, width, height, colorMap, false, true);
+}
+
+void ImageCollectorOutputDev::collect(GfxState *state, Object *ref, Stream *str, int width, int height, GfxImageColorMap *colorMap, bool inlineImg, bool masked)
+{
+    if (width < minSize || height < minSize || !colorMap || !colorMap->isOk()) {
+        return;
+    }
+
+    CollectedImage image;
+    image.page = currentPage;
+    image.ref = (ref && ref->isRef()) ? ref->getRef() : Ref::INVALID();
+    image.width = width;
+    image.height = height;
+    image.bitsPerComponent = colorMap->getBits();
+    image.components = colorMap->getNumPixelComps();
+    image.inlineImage = inlineImg;
+    image.masked = masked;
+
+    // The image occupies the unit square in image space.
+    const double *ctm = state->getCTM();
+    std::copy(ctm, ctm + 6, image.ctm);
+    double xs[4], ys[4];
+    state->transform(0, 0, &xs[0], &ys[0]);
+    state->transform(1, 0, &xs[1], &ys[1]);
+    state->transform(0, 1, &xs[2], &ys[2]);
+    state->transform(1, 1, &xs[3], &ys[3]);
+    image.x1 = *std::min_element(xs, xs + 4);
+    image.x2 = *std::max_element(xs, xs + 4);
+    image.y1 = *std::min_element(ys, ys + 4);
+    image.y2 = *std::max_element(ys, ys + 4);
+
+    switch (str->getKind()) {
+    case strDCT:
+        image.encoding = CollectedImage::encodingJPEG;
+        break;
+    case strJPX:
+        image.encoding = CollectedImage::encodingJPX;
+        break;
+    default:
+        image.encoding = CollectedImage::encodingRGB;
+        break;
+    }
+
+    // An XObject placed several times is copied or decoded only once; later
+    // placements carry no data and the caller reuses what it kept from the first.
+    image.repeated = image.ref != Ref::INVALID() && !seenRefs.insert(image.ref).second;
+    if (image.repeated) {
+        images.push_back(std::move(image));
+        return;
+    }
+
+    switch (image.encoding) {
+    case CollectedImage::encodingJPEG:
+    case CollectedImage::encodingJPX:
+        image.data = copyRaw(str->getNextStream());
+        break;
+    case CollectedImage::encodingRGB:
+        if (decodeRaster) {
+            image.data = decodeRGB(str, width, height, colorMap);
+        }
+        break;
+    }
+
+    images.push_back(std::move(image));
+}
+
+std::shared_ptr<const std::string> ImageCollectorOutputDev::copyRaw(Stream *str)
+{
+    if (!str) {
+        return nullptr;
+    }
+
+    auto data = std::make_shared<std::string>();
+    unsigned char buf[16384];
+    str->reset();
+    int n;
+    while ((n = str->doGetChars(sizeof(buf), buf)) > 0) {
+        data->append(reinterpret_cast<const char *>(buf), n);
+    }
+    str->close();
+    return data;
+}
+
+std::shared_ptr<const std::string> ImageCollectorOutputDev::decodeRGB(Stream *str, int width, int height, GfxImageColorMap *colorMap)
+{
+    // /Width and /Height come straight from the file
+    if (width <= 0 || height <= 0 || static_cast<long long>(width) * height > maxRasterPixels) {
+        error(errSyntaxWarning, -1, "Image of {0:d}x{1:d} samples is too large to decode", width, height);
+        return nullptr;
+    }
+
+    auto data = std::make_shared<std::string>();
+    data->resize(static_cast<size_t>(width) * height * 3);
+
+    ImageStream imgStr(str, width, colorMap->getNumPixelComps(), colorMap->getBits());
+    imgStr.reset();
+
+    unsigned char *out = reinterpret_cast<unsigned char *>(data->data());
+    const bool useLine = colorMap->useRGBLine();
+    for (int y = 0; y < height; ++y) {
+        unsigned char *line = imgStr.getLine();
+        if (!line) {
+            break;
+        }
+        unsigned char *row = out + static_cast<size_t>(y) * width * 3;
+        if (useLine) {
+            colorMap->getRGBLine(line, row, width);
+        } else {
+            const int nComps = colorMap->getNumPixelComps();
+            for (int x = 0; x < width; ++x) {
+                GfxRGB rgb;
+                colorMap->getRGB(line + x * nComps, &rgb);
+                row[x * 3] = colToByte(rgb.r);
+                row[x * 3 + 1] = colToByte(rgb.g);
+                row[x * 3 + 2] = colToByte(rgb.b);
+            }
+        }
+    }
+    imgStr.close();
+    return data;
+}
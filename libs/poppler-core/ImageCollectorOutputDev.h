@@ -0,0 +1,101 @@
+//========================================================================
+//
+// ImageCollectorOutputDev.h
+//
+// Collects the image XObjects and inline images drawn on a page together
+// with their placement, without rasterizing anything.  DCT (JPEG) and JPX
+// (JPEG 2000) payloads are copied verbatim from the file; other images
+// are decoded into packed 8-bit RGB.  An XObject placed several times is
+// copied or decoded only at its first placement.
+//
+// This file is licensed under the GPLv2 or later
+//
+//========================================================================
+
+#ifndef IMAGECOLLECTOROUTPUTDEV_H
+#define IMAGECOLLECTOROUTPUTDEV_H
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "poppler_private_export.h"
+#include "Object.h"
+#include "OutputDev.h"
+
+class GfxState;
+class GfxImageColorMap;
+class Stream;
+
+struct CollectedImage
+{
+    enum Encoding
+    {
+        encodingJPEG, // data holds the original DCTDecode payload
+        encodingJPX, // data holds the original JPXDecode payload
+        encodingRGB // data holds width * height * 3 bytes of decoded RGB
+    };
+
+    int page; // 1-based page number
+    Ref ref; // object reference, Ref::INVALID() for inline images
+    int width; // image width in samples
+    int height; // image height in samples
+    int bitsPerComponent;
+    int components; // number of color components of the image color space
+    bool inlineImage;
+    bool masked; // drawn with an explicit or soft mask
+    double x1, y1, x2, y2; // placement bounding box in points, upper-left origin
+    double ctm[6]; // image space to device space matrix at draw time
+    Encoding encoding;
+    bool repeated; // XObject already collected at an earlier placement; data is null
+    std::shared_ptr<const std::string> data;
+};
+
+class POPPLER_PRIVATE_EXPORT ImageCollectorOutputDev : public OutputDev
+{
+public:
+    // If <decodeRasterA> is false, non-JPEG images are recorded without data.
+    explicit ImageCollectorOutputDev(bool decodeRasterA = true);
+    ~ImageCollectorOutputDev() override;
+
+    bool upsideDown() override { return true; }
+    bool useDrawChar() override { return true; }
+    bool interpretType3Chars() override { return false; }
+    bool needNonText() override { return true; }
+
+    void startPage(int pageNum, GfxState *state, XRef *xref) override;
+
+    void drawImage(GfxState *state, Object *ref, Stream *str, int width, int height, GfxImageColorMap *colorMap, bool interpolate, const int *maskColors, bool inlineImg) override;
+    void drawMaskedImage(GfxState *state, Object *ref, Stream *str, int width, int height, GfxImageColorMap *colorMap, bool interpolate, Stream *maskStr, int maskWidth, int maskHeight, bool maskInvert, bool maskInterpolate) override;
+    void drawSoftMaskedImage(GfxState *state, Object *ref, Stream *str, int width, int height, GfxImageColorMap *colorMap, bool interpolate, Stream *maskStr, int maskWidth, int maskHeight, GfxImageColorMap *maskColorMap,
+                             bool maskInterpolate) override;
+
+    // Images smaller than this in either dimension (in samples) are ignored.
+    void setMinSize(int minSizeA) { minSize = minSizeA; }
+
+    // Images collected since construction or the last takeImages().
+    const std::vector<CollectedImage> &getImages() const { return images; }
+    std::vector<CollectedImage> takeImages();
+
+    // Forget the XObjects seen so far; call when switching documents.
+    void resetSeenRefs() { seenRefs.clear(); }
+
+    // Rasters with more samples than this are recorded without data.
+    static constexpr long long maxRasterPixels = 32LL * 1024 * 1024;
+
+private:
+    void collect(GfxState *state, Object *ref, Stream *str, int width, int height, GfxImageColorMap *colorMap, bool inlineImg, bool masked);
+    static std::shared_ptr<const std::string> copyRaw(Stream *str);
+    static std::shared_ptr<const std::string> decodeRGB(Stream *str, int width, int height, GfxImageColorMap *colorMap);
+
+    bool decodeRaster;
+    int minSize;
+    int currentPage;
+    std::vector<CollectedImage> images;
+    // Only the references are kept: holding the payloads here would keep every
+    // image of the document alive until the collector is destroyed.
+    std::set<Ref> seenRefs;
+};
+
+#endif
@@ -0,0 +1,248 @@
+//========================================================================
+//
+// MarkedContentCollectorOutputDev.cc
+//
+// This file is licensed under the GPLv2 or later
+//
+//========================================================================
+
+#include <config.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "MarkedContentCollectorOutputDev.h"
+#include "Dict.h"
+#include "GfxFont.h"
+#include "GfxState.h"
+
+MarkedContentItem::MarkedContentItem()
+{
+    x1 = y1 = x2 = y2 = 0;
+    hasBox = false;
+    lastX = lastY = lastSize = 0;
+    hasLast = false;
+}
+
+MarkedContentCollectorOutputDev::MarkedContentCollectorOutputDev()
+{
+    pageWidth = 0;
+    pageHeight = 0;
+}
+
+MarkedContentCollectorOutputDev::~MarkedContentCollectorOutputDev() = default;
+
+void MarkedContentCollectorOutputDev::startPage(int /*pageNum*/, GfxState *state, XRef * /*xref*/)
+{
+    items.clear();
+    mcStack.clear();
+    formStack.clear();
+    if (state) {
+        pageWidth = state->getPageWidth();
+        pageHeight = state->getPageHeight();
+    } else {
+        pageWidth = pageHeight = 0;
+    }
+}
+
+void MarkedContentCollectorOutputDev::beginForm(Object * /*obj*/, Ref id)
+{
+    formStack.push_back(id);
+}
+
+void MarkedContentCollectorOutputDev::endForm(Object * /*obj*/, Ref /*id*/)
+{
+    if (!formStack.empty()) {
+        formStack.pop_back();
+    }
+}
+
+void MarkedContentCollectorOutputDev::beginMarkedContent(const char * /*name*/, Dict *properties)
+{
+    // every sequence is pushed so that EMC operators stay balanced
+    StackEntry entry;
+    entry.stmRef = formStack.empty() ? Ref::INVALID() : formStack.back();
+    entry.mcid = -1;
+    if (properties) {
+        properties->lookupInt("MCID", nullptr, &entry.mcid);
+    }
+    mcStack.push_back(entry);
+}
+
+void MarkedContentCollectorOutputDev::endMarkedContent(GfxState * /*state*/)
+{
+    if (!mcStack.empty()) {
+        mcStack.pop_back();
+    }
+}
+
+const MarkedContentItem *MarkedContentCollectorOutputDev::find(Ref stmRef, int mcid) const
+{
+    const auto it = items.find(Key(stmRef, mcid));
+    return it == items.end() ? nullptr : &it->second;
+}
+
+MarkedContentItem *MarkedContentCollectorOutputDev::currentItem()
+{
+    // the innermost sequence with an MCID owns the content
+    for (auto it = mcStack.rbegin(); it != mcStack.rend(); ++it) {
+        if (it->mcid >= 0) {
+            return &items[Key(it->stmRef, it->mcid)];
+        }
+    }
+    return nullptr;
+}
+
+void MarkedContentCollectorOutputDev::addPoint(MarkedContentItem *item, double x, double y)
+{
+    if (std::isnan(x) || std::isnan(y)) {
+        return;
+    }
+    if (!item->hasBox) {
+        item->x1 = item->x2 = x;
+        item->y1 = item->y2 = y;
+        item->hasBox = true;
+    } else {
+        item->x1 = std::min(item->x1, x);
+        item->y1 = std::min(item->y1, y);
+        item->x2 = std::max(item->x2, x);
+        item->y2 = std::max(item->y2, y);
+    }
+}
+
+void MarkedContentCollectorOutputDev::drawChar(GfxState *state, double x, double y, double dx, double dy, double /*originX*/, double /*originY*/, CharCode code, int /*nBytes*/, const Unicode *u, int uLen)
+{
+    MarkedContentItem *item = currentItem();
+    if (!item || !uLen) {
+        return;
+    }
+
+    // character advance without char/word spacing, as in MarkedContentOutputDev
+    double sp = state->getCharSpace();
+    if (code == (CharCode)0x20) {
+        sp += state->getWordSpace();
+    }
+    double dx2, dy2;
+    state->textTransformDelta(sp * state->getHorizScaling(), 0, &dx2, &dy2);
+    dx -= dx2;
+    dy -= dy2;
+
+    double x1, y1, x2, y2;
+    state->transform(x, y, &x1, &y1);
+    state->transform(x + dx, y + dy, &x2, &y2);
+    if (std::isnan(x1) || std::isnan(y1) || std::isnan(x2) || std::isnan(y2)) {
+        return;
+    }
+    // characters outside the page are not visible
+    if (std::max(x1, x2) < 0 || std::min(x1, x2) > pageWidth || std::max(y1, y2) < 0 || std::min(y1, y2) > pageHeight) {
+        return;
+    }
+
+    const double size = std::max(state->getTransformedFontSize(), 1.0);
+    double ascent = 0.95;
+    double descent = -0.35;
+    const GfxFont *font = state->getFont().get();
+    if (font && font->getWMode() == 0) {
+        ascent = font->getAscent();
+        descent = font->getDescent();
+    }
+
+    // separate words that are visibly apart but have no space in the stream
+    const bool isSpace = uLen == 1 && (u[0] == 0x20 || u[0] == 0xA0);
+    if (item->hasLast && !isSpace && !item->text.empty() && item->text.back() != 0x20) {
+        const double gap = std::fabs(x1 - item->lastX) + std::fabs(y1 - item->lastY);
+        if (gap > 0.2 * std::max(size, item->lastSize)) {
+            item->text.push_back(0x20);
+        }
+    }
+
+    for (int i = 0; i < uLen; ++i) {
+        // soft hyphens are invisible
+        if (u[i] != 0x00AD) {
+            item->text.push_back(u[i]);
+        }
+    }
+    item->lastX = x2;
+    item->lastY = y2;
+    item->lastSize = size;
+    item->hasLast = true;
+
+    if (isSpace) {
+        return;
+    }
+    // upright text: the glyph box spans from descent to ascent
+    addPoint(item, std::min(x1, x2), std::min(y1, y2) - ascent * size);
+    addPoint(item, std::max(x1, x2), std::max(y1, y2) - descent * size);
+}
+
+void MarkedContentCollectorOutputDev::stroke(GfxState *state)
+{
+    addPath(state->getPath(), state);
+}
+
+void MarkedContentCollectorOutputDev::fill(GfxState *state)
+{
+    addPath(state->getPath(), state);
+}
+
+void MarkedContentCollectorOutputDev::eoFill(GfxState *state)
+{
+    addPath(state->getPath(), state);
+}
+
+void MarkedContentCollectorOutputDev::addPath(const GfxPath *path, GfxState *state)
+{
+    MarkedContentItem *item = currentItem();
+    if (!item) {
+        return;
+    }
+
+    for (int i = 0; i < path->getNumSubpaths(); ++i) {
+        const GfxSubpath *subpath = path->getSubpath(i);
+        for (int j = 0; j < subpath->getNumPoints(); ++j) {
+            double tx, ty;
+            state->transform(subpath->getX(j), subpath->getY(j), &tx, &ty);
+            addPoint(item, tx, ty);
+        }
+    }
+}
+
+void MarkedContentCollectorOutputDev::addImage(GfxState *state)
+{
+    MarkedContentItem *item = currentItem();
+    if (!item) {
+        return;
+    }
+
+    const double corners[4][2] = { { 0, 0 }, { 1, 0 }, { 0, 1 }, { 1, 1 } };
+    for (int i = 0; i < 4; ++i) {
+        double tx, ty;
+        state->transform(corners[i][0], corners[i][1], &tx, &ty);
+        addPoint(item, tx, ty);
+    }
+}
+
+void MarkedContentCollectorOutputDev::drawImageMask(GfxState *state, Object *ref, Stream *str, int width, int height, bool invert, bool interpolate, bool inlineImg)
+{
+    addImage(state);
+    // the base class skips over inline image data
+    OutputDev::drawImageMask(state, ref, str, width, height, invert, interpolate, inlineImg);
+}
+
+void MarkedContentCollectorOutputDev::drawImage(GfxState *state, Object *ref, Stream *str, int width, int height, GfxImageColorMap *colorMap, bool interpolate, const int *maskColors, bool inlineImg)
+{
+    addImage(state);
+    OutputDev::drawImage(state, ref, str, width, height, colorMap, interpolate, maskColors, inlineImg);
+}
+
+void MarkedContentCollectorOutputDev::drawMaskedImage(GfxState *state, Object * /*ref*/, Stream * /*str*/, int /*width*/, int /*height*/, GfxImageColorMap * /*colorMap*/, bool /*interpolate*/, Stream * /*maskStr*/, int /*maskWidth*/,
+                                                      int /*maskHeight*/, bool /*maskInvert*/, bool /*maskInterpolate*/)
+{
+    addImage(state);
+}
+
+void MarkedContentCollectorOutputDev::drawSoftMaskedImage(GfxState *state, Object * /*ref*/, Stream * /*str*/, int /*width*/, int /*height*/, GfxImageColorMap * /*colorMap*/, bool /*interpolate*/, Stream * /*maskStr*/,
+                                                          int /*maskWidth*/, int /*maskHeight*/, GfxImageColorMap * /*maskColorMap*/, bool /*maskInterpolate*/)
+{
+    addImage(state);
+}
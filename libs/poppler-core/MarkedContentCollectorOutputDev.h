@@ -0,0 +1,106 @@
+//========================================================================
+//
+// MarkedContentCollectorOutputDev.h
+//
+// Collects the text and bounding box of every marked-content sequence
+// with an MCID on a page in a single pass, so that a structure tree can
+// be resolved without one page pass per MCID (as MarkedContentOutputDev
+// needs).
+//
+// This file is licensed under the GPLv2 or later
+//
+//========================================================================
+
+#ifndef MARKEDCONTENTCOLLECTOROUTPUTDEV_H
+#define MARKEDCONTENTCOLLECTOROUTPUTDEV_H
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "poppler_private_export.h"
+#include "OutputDev.h"
+#include "Object.h"
+
+class GfxState;
+class GfxPath;
+
+struct MarkedContentItem
+{
+    // Visible text in content order.  A space is inserted where glyphs
+    // are visibly apart and the content stream has no space character.
+    std::vector<Unicode> text;
+    // Device coordinates in points with an upper-left origin, covering
+    // glyphs, paths and images drawn inside the sequence.
+    double x1, y1, x2, y2;
+    bool hasBox;
+
+    // state for space insertion
+    double lastX, lastY, lastSize;
+    bool hasLast;
+
+    MarkedContentItem();
+};
+
+class POPPLER_PRIVATE_EXPORT MarkedContentCollectorOutputDev : public OutputDev
+{
+public:
+    // Sequences are keyed by the content stream they appear in (the
+    // form XObject reference, or Ref::INVALID() for the page contents)
+    // and their MCID.
+    typedef std::pair<Ref, int> Key;
+
+    MarkedContentCollectorOutputDev();
+    ~MarkedContentCollectorOutputDev() override;
+
+    bool upsideDown() override { return true; }
+    bool useDrawChar() override { return true; }
+    bool interpretType3Chars() override { return false; }
+    bool needNonText() override { return true; }
+    bool needCharCount() override { return false; }
+
+    void startPage(int pageNum, GfxState *state, XRef *xref) override;
+
+    void beginForm(Object *obj, Ref id) override;
+    void endForm(Object *obj, Ref id) override;
+
+    void beginMarkedContent(const char *name, Dict *properties) override;
+    void endMarkedContent(GfxState *state) override;
+
+    void drawChar(GfxState *state, double x, double y, double dx, double dy, double originX, double originY, CharCode code, int nBytes, const Unicode *u, int uLen) override;
+
+    void stroke(GfxState *state) override;
+    void fill(GfxState *state) override;
+    void eoFill(GfxState *state) override;
+
+    void drawImageMask(GfxState *state, Object *ref, Stream *str, int width, int height, bool invert, bool interpolate, bool inlineImg) override;
+    void drawImage(GfxState *state, Object *ref, Stream *str, int width, int height, GfxImageColorMap *colorMap, bool interpolate, const int *maskColors, bool inlineImg) override;
+    void drawMaskedImage(GfxState *state, Object *ref, Stream *str, int width, int height, GfxImageColorMap *colorMap, bool interpolate, Stream *maskStr, int maskWidth, int maskHeight, bool maskInvert, bool maskInterpolate) override;
+    void drawSoftMaskedImage(GfxState *state, Object *ref, Stream *str, int width, int height, GfxImageColorMap *colorMap, bool interpolate, Stream *maskStr, int maskWidth, int maskHeight, GfxImageColorMap *maskColorMap,
+                             bool maskInterpolate) override;
+
+    // Returns nullptr if the page has no sequence with this MCID in the
+    // given content stream.
+    const MarkedContentItem *find(Ref stmRef, int mcid) const;
+    const std::map<Key, MarkedContentItem> &getItems() const { return items; }
+
+private:
+    struct StackEntry
+    {
+        Ref stmRef;
+        int mcid; // -1 for sequences without an MCID
+    };
+
+    MarkedContentItem *currentItem();
+    void addPoint(MarkedContentItem *item, double x, double y);
+    void addImage(GfxState *state);
+    void addPath(const GfxPath *path, GfxState *state);
+
+    std::map<Key, MarkedContentItem> items;
+    std::vector<StackEntry> mcStack;
+    std::vector<Ref> formStack;
+    double pageWidth;
+    double pageHeight;
+};
+
+#endif
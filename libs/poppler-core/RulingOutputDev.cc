@@ -0,0 +1,146 @@
+//========================================================================
+//
+// RulingOutputDev.cc
+//
+// This file is licensed under the GPLv2 or later
+//
+//========================================================================
+
+#include <config.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "RulingOutputDev.h"
+#include "GfxState.h"
+
+RulingOutputDev::RulingOutputDev()
+{
+    axisTolerance = 1;
+    maxRuleThickness = 3;
+    minLength = 4;
+}
+
+RulingOutputDev::~RulingOutputDev() = default;
+
+void RulingOutputDev::startPage(int /*pageNum*/, GfxState * /*state*/, XRef * /*xref*/)
+{
+    segments.clear();
+}
+
+std::vector<RulingSegment> RulingOutputDev::takeSegments()
+{
+    std::vector<RulingSegment> result;
+    result.swap(segments);
+    return result;
+}
+
+void RulingOutputDev::stroke(GfxState *state)
+{
+    addStrokedPath(state->getPath(), state);
+}
+
+void RulingOutputDev::fill(GfxState *state)
+{
+    addFilledPath(state->getPath(), state);
+}
+
+void RulingOutputDev::eoFill(GfxState *state)
+{
+    addFilledPath(state->getPath(), state);
+}
+
+void RulingOutputDev::addSegment(double x1, double y1, double x2, double y2)
+{
+    const double dx = std::fabs(x2 - x1);
+    const double dy = std::fabs(y2 - y1);
+
+    RulingSegment segment;
+    if (dy <= axisTolerance && dx >= minLength) {
+        const double y = (y1 + y2) / 2;
+        segment.x1 = std::min(x1, x2);
+        segment.x2 = std::max(x1, x2);
+        segment.y1 = segment.y2 = y;
+        segment.horizontal = true;
+    } else if (dx <= axisTolerance && dy >= minLength) {
+        const double x = (x1 + x2) / 2;
+        segment.y1 = std::min(y1, y2);
+        segment.y2 = std::max(y1, y2);
+        segment.x1 = segment.x2 = x;
+        segment.horizontal = false;
+    } else {
+        return;
+    }
+    segments.push_back(segment);
+}
+
+void RulingOutputDev::addStrokedPath(const GfxPath *path, const GfxState *state)
+{
+    for (int i = 0; i < path->getNumSubpaths(); ++i) {
+        const GfxSubpath *subpath = path->getSubpath(i);
+        const int n = subpath->getNumPoints();
+        double px, py;
+        state->transform(subpath->getX(0), subpath->getY(0), &px, &py);
+        for (int j = 1; j < n; ++j) {
+            double x, y;
+            state->transform(subpath->getX(j), subpath->getY(j), &x, &y);
+            // Curves cannot be rulings; skip anything touching a control point.
+            if (!subpath->getCurve(j) && !subpath->getCurve(j - 1)) {
+                addSegment(px, py, x, y);
+            }
+            px = x;
+            py = y;
+        }
+    }
+}
+
+void RulingOutputDev::addFilledPath(const GfxPath *path, const GfxState *state)
+{
+    for (int i = 0; i < path->getNumSubpaths(); ++i) {
+        const GfxSubpath *subpath = path->getSubpath(i);
+        const int n = subpath->getNumPoints();
+        // Only axis-aligned rectangles (4 corners, optionally closed).
+        if (n < 4 || n > 5) {
+            continue;
+        }
+
+        double xMin = 0, yMin = 0, xMax = 0, yMax = 0;
+        bool rectilinear = true;
+        double px = 0, py = 0;
+        for (int j = 0; j < n && rectilinear; ++j) {
+            if (subpath->getCurve(j)) {
+                rectilinear = false;
+                break;
+            }
+            double x, y;
+            state->transform(subpath->getX(j), subpath->getY(j), &x, &y);
+            if (j == 0) {
+                xMin = xMax = x;
+                yMin = yMax = y;
+            } else {
+                if (std::fabs(x - px) > axisTolerance && std::fabs(y - py) > axisTolerance) {
+                    rectilinear = false;
+                }
+                xMin = std::min(xMin, x);
+                xMax = std::max(xMax, x);
+                yMin = std::min(yMin, y);
+                yMax = std::max(yMax, y);
+            }
+            px = x;
+            py = y;
+        }
+        if (!rectilinear) {
+            continue;
+        }
+
+        const double width = xMax - xMin;
+        const double height = yMax - yMin;
+        if (height <= maxRuleThickness && width >= minLength) {
+            const double y = (yMin + yMax) / 2;
+            addSegment(xMin, y, xMax, y);
+        } else if (width <= maxRuleThickness && height >= minLength) {
+            const double x = (xMin + xMax) / 2;
+            addSegment(x, yMin, x, yMax);
+        }
+    }
+}
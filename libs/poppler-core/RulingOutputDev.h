@@ -0,0 +1,73 @@
+//========================================================================
+//
+// RulingOutputDev.h
+//
+// Records the horizontal and vertical line segments drawn on a page
+// (stroked lines and rectangles, thin filled rectangles) for table
+// detection.  Nothing is rasterized and images are skipped.
+//
+// This file is licensed under the GPLv2 or later
+//
+//========================================================================
+
+#ifndef RULINGOUTPUTDEV_H
+#define RULINGOUTPUTDEV_H
+
+#include <vector>
+
+#include "poppler_private_export.h"
+#include "OutputDev.h"
+
+class GfxState;
+class GfxPath;
+
+struct RulingSegment
+{
+    // Device coordinates in points with an upper-left origin.  For
+    // horizontal segments y1 == y2 and x1 <= x2, for vertical segments
+    // x1 == x2 and y1 <= y2.
+    double x1, y1, x2, y2;
+    bool horizontal;
+};
+
+class POPPLER_PRIVATE_EXPORT RulingOutputDev : public OutputDev
+{
+public:
+    RulingOutputDev();
+    ~RulingOutputDev() override;
+
+    bool upsideDown() override { return true; }
+    bool useDrawChar() override { return true; }
+    bool interpretType3Chars() override { return false; }
+    bool needNonText() override { return true; }
+
+    void startPage(int pageNum, GfxState *state, XRef *xref) override;
+
+    void stroke(GfxState *state) override;
+    void fill(GfxState *state) override;
+    void eoFill(GfxState *state) override;
+
+    // Segments whose direction deviates from the axis by more than this
+    // (in points) are ignored.  Defaults to 1.
+    void setAxisTolerance(double toleranceA) { axisTolerance = toleranceA; }
+    // Filled rectangles thinner than this (in points) count as rulings.
+    // Defaults to 3.
+    void setMaxRuleThickness(double thicknessA) { maxRuleThickness = thicknessA; }
+    // Segments shorter than this (in points) are ignored.  Defaults to 4.
+    void setMinLength(double lengthA) { minLength = lengthA; }
+
+    const std::vector<RulingSegment> &getSegments() const { return segments; }
+    std::vector<RulingSegment> takeSegments();
+
+private:
+    void addSegment(double x1, double y1, double x2, double y2);
+    void addStrokedPath(const GfxPath *path, const GfxState *state);
+    void addFilledPath(const GfxPath *path, const GfxState *state);
+
+    double axisTolerance;
+    double maxRuleThickness;
+    double minLength;
+    std::vector<RulingSegment> segments;
+};
+
+#endif
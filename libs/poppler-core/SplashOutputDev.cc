@@ -76,6 +76,7 @@
 #include "splash/SplashFont.h"
 #include "splash/SplashFontFile.h"
 #include "splash/SplashFontFileID.h"
+#include "splash/SplashGlyphCache.h"
 #include "splash/SplashMath.h"
 #include "splash/Splash.h"
 #include "SplashOutputDev.h"
@@ -1819,6 +1820,40 @@ void SplashOutputDev::updateFont(GfxState * /*state*/)
     needFontUpdate = true;
 }
 
+// Compute the key under which glyphs of <gfxFont> are stored in the
+// shared glyph cache.  SplashOutFontFileID only identifies a font within
+// one document, so the key is built from what determines the rasterized
+// glyphs: the font program (its bytes, or the path of an external font)
+// and the mapping from character codes to glyphs.
+static unsigned long long computeSharedFontKey(GfxFont *gfxFont, const SplashFontSrc *fontsrc, GfxFontType fontType, int faceIndex)
+{
+    unsigned long long key;
+    if (fontsrc->isFile()) {
+        key = SplashGlyphCache::hashBytes(fontsrc->fileName.data(), fontsrc->fileName.size());
+    } else {
+        key = SplashGlyphCache::hashBytes(fontsrc->getBuf(), fontsrc->getBufLen());
+    }
+    const int params[] = { (int)fontType, faceIndex, gfxFont->getFlags() };
+    key = SplashGlyphCache::hashBytes(params, sizeof(params), key);
+
+    if (gfxFont->isCIDFont()) {
+        const GfxCIDFont *cidFont = static_cast<const GfxCIDFont *>(gfxFont);
+        if (cidFont->getCIDToGID()) {
+            key = SplashGlyphCache::hashBytes(cidFont->getCIDToGID(), cidFont->getCIDToGIDLen() * sizeof(int), key);
+        }
+    } else {
+        char **enc = static_cast<Gfx8BitFont *>(gfxFont)->getEncoding();
+        for (int code = 0; code < 256; ++code) {
+            // the terminating NUL separates the names; missing names hash as a single NUL
+            const char *name = enc[code] ? enc[code] : "";
+            key = SplashGlyphCache::hashBytes(name, strlen(name) + 1, key);
+        }
+    }
+
+    // zero is reserved for "not shared"
+    return key ? key : 1;
+}
+
 void SplashOutputDev::doUpdateFont(GfxState *state)
 {
     GfxFontType fontType;
@@ -2026,6 +2061,9 @@ reload:
             goto err2;
         }
         fontFile->doAdjustMatrix = doAdjustFontMatrix;
+        fontFile->sharedCacheKey = computeSharedFontKey(gfxFont, fontsrc, fontType, faceIndex);
+        fontFile->enableFreeTypeHinting = fontEngine->getFreeTypeHinting();
+        fontFile->enableSlightHinting = fontEngine->getSlightHinting();
     }
 
     // get the font matrix
@@ -26,6 +26,7 @@
 #include "goo/gmem.h"
 #include "SplashMath.h"
 #include "SplashGlyphBitmap.h"
+#include "SplashGlyphCache.h"
 #include "SplashFontFile.h"
 #include "SplashFont.h"
 
@@ -155,9 +156,23 @@ bool SplashFont::getGlyph(int c, int xFrac, int yFrac, SplashGlyphBitmap *bitmap
         }
     }
 
-    // generate the glyph bitmap
-    if (!makeGlyph(c, xFrac, yFrac, &bitmap2, x0, y0, clip, clipRes)) {
-        return false;
+    // check the cache shared with the other rendering threads, and
+    // generate the glyph bitmap if it isn't there either
+    SplashGlyphCache *sharedCache = fontFile->sharedCacheKey ? SplashGlyphCache::getShared() : nullptr;
+    SplashGlyphCacheKey sharedKey;
+    if (sharedCache) {
+        sharedKey = SplashGlyphCache::makeKey(fontFile->sharedCacheKey, c, xFrac, yFrac, mat, aa, fontFile->enableFreeTypeHinting, fontFile->enableSlightHinting);
+    }
+    if (sharedCache && sharedCache->lookup(sharedKey, &bitmap2)) {
+        *clipRes = clip->testRect(x0 - bitmap2.x, y0 - bitmap2.y, x0 - bitmap2.x + bitmap2.w - 1, y0 - bitmap2.y + bitmap2.h - 1);
+    } else {
+        if (!makeGlyph(c, xFrac, yFrac, &bitmap2, x0, y0, clip, clipRes)) {
+            return false;
+        }
+        // glyphs that are entirely clipped out are not rasterized
+        if (sharedCache && *clipRes != splashClipAllOutside) {
+            sharedCache->insert(sharedKey, bitmap2);
+        }
     }
 
     if (*clipRes == splashClipAllOutside) {
@@ -13,7 +13,7 @@
 #include "SplashFontFileID.h"
 #include "SplashFont.h"
 
-SplashFontEngine::SplashFontEngine(bool enableFreeType, bool enableFreeTypeHinting, bool enableSlightHinting, bool aa)
+SplashFontEngine::SplashFontEngine(bool enableFreeType, bool enableFreeTypeHintingA, bool enableSlightHintingA, bool aa) : enableFreeTypeHinting(enableFreeTypeHintingA), enableSlightHinting(enableSlightHintingA)
 {
     // Initialize font cache
     for (int i = 0; i < 16; i++) {
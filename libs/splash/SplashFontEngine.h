@@ -80,8 +80,14 @@ public:
     bool getAA();
     void setAA(bool aa);
 
+    // Hinting settings the engine was created with.
+    bool getFreeTypeHinting() const { return enableFreeTypeHinting; }
+    bool getSlightHinting() const { return enableSlightHinting; }
+
 private:
     std::array<SplashFont *, 16> fontCache;
+    bool enableFreeTypeHinting;
+    bool enableSlightHinting;
 
     SplashFTFontEngine *ftEngine;
 };
@@ -44,6 +44,9 @@ SplashFontFile::SplashFontFile(std::unique_ptr<SplashFontFileID> idA, SplashFont
     src->ref();
     refCnt = 0;
     doAdjustMatrix = false;
+    sharedCacheKey = 0;
+    enableFreeTypeHinting = false;
+    enableSlightHinting = false;
 }
 
 SplashFontFile::~SplashFontFile()
@@ -94,6 +94,18 @@ public:
 
     bool doAdjustMatrix;
 
+    // Key identifying the font program and its code-to-glyph mapping
+    // across documents and font engines, used for the shared glyph cache
+    // (see SplashGlyphCache).  Zero means glyphs of this font are not
+    // shared.
+    unsigned long long sharedCacheKey;
+
+    // Hinting settings of the engine that loaded this font.  Hinting
+    // changes the rasterized glyphs, so they are part of the shared glyph
+    // cache key as well.
+    bool enableFreeTypeHinting;
+    bool enableSlightHinting;
+
 protected:
     SplashFontFile(std::unique_ptr<SplashFontFileID> idA, SplashFontSrc *srcA);
 
@@ -0,0 +1,174 @@
+//========================================================================
+//
+// SplashGlyphCache.cc
+//
+// This file is licensed under the GPLv2 or later
+//
+//========================================================================
+
+#include <config.h>
+
+#include <cmath>
+#include <cstring>
+
+#include "goo/gmem.h"
+#include "SplashGlyphBitmap.h"
+#include "SplashGlyphCache.h"
+
+// Default memory cap for the shared cache.
+static const size_t defaultMaxBytes = 64 * 1024 * 1024;
+
+static size_t glyphDataSize(int w, int h, bool aa)
+{
+    if (w <= 0 || h <= 0) {
+        return 0;
+    }
+    return aa ? (size_t)w * h : (size_t)((w + 7) >> 3) * h;
+}
+
+//------------------------------------------------------------------------
+// SplashGlyphCacheKey
+//------------------------------------------------------------------------
+
+bool SplashGlyphCacheKey::operator==(const SplashGlyphCacheKey &other) const
+{
+    return fontKey == other.fontKey && c == other.c && xFrac == other.xFrac && yFrac == other.yFrac && mat[0] == other.mat[0] && mat[1] == other.mat[1] && mat[2] == other.mat[2] && mat[3] == other.mat[3] && aa == other.aa && hinting == other.hinting && slightHinting == other.slightHinting;
+}
+
+size_t SplashGlyphCacheKeyHash::operator()(const SplashGlyphCacheKey &key) const
+{
+    unsigned long long h = key.fontKey;
+    const long long fields[] = { key.c, key.xFrac, key.yFrac, key.mat[0], key.mat[1], key.mat[2], key.mat[3], (key.aa ? 1 : 0) | (key.hinting ? 2 : 0) | (key.slightHinting ? 4 : 0) };
+    for (long long field : fields) {
+        h ^= (unsigned long long)field + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    }
+    return (size_t)h;
+}
+
+//------------------------------------------------------------------------
+// SplashGlyphCache
+//------------------------------------------------------------------------
+
+SplashGlyphCache *SplashGlyphCache::getShared()
+{
+    static SplashGlyphCache cache;
+    return &cache;
+}
+
+SplashGlyphCache::SplashGlyphCache() : maxBytes(defaultMaxBytes), hits(0), misses(0) { }
+
+SplashGlyphCacheKey SplashGlyphCache::makeKey(unsigned long long fontKey, int c, int xFrac, int yFrac, const SplashCoord *mat, bool aa, bool hinting, bool slightHinting)
+{
+    SplashGlyphCacheKey key;
+    key.fontKey = fontKey;
+    key.c = c;
+    key.xFrac = xFrac;
+    key.yFrac = yFrac;
+    for (int i = 0; i < 4; ++i) {
+        key.mat[i] = std::llround(mat[i] * 64);
+    }
+    key.aa = aa;
+    key.hinting = hinting;
+    key.slightHinting = slightHinting;
+    return key;
+}
+
+unsigned long long SplashGlyphCache::hashBytes(const void *data, size_t len, unsigned long long seed)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    unsigned long long h = seed;
+    for (size_t i = 0; i < len; ++i) {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+SplashGlyphCache::Stripe &SplashGlyphCache::stripeFor(const SplashGlyphCacheKey &key)
+{
+    // use the high bits: the low bits also select the bucket inside the
+    // stripe's hash table
+    return stripes[(SplashGlyphCacheKeyHash()(key) >> 28) % numStripes];
+}
+
+bool SplashGlyphCache::lookup(const SplashGlyphCacheKey &key, SplashGlyphBitmap *bitmap)
+{
+    Stripe &stripe = stripeFor(key);
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+
+    auto it = stripe.index.find(key);
+    if (it == stripe.index.end()) {
+        ++misses;
+        return false;
+    }
+    stripe.lru.splice(stripe.lru.begin(), stripe.lru, it->second);
+
+    const Entry &entry = *it->second;
+    bitmap->x = entry.x;
+    bitmap->y = entry.y;
+    bitmap->w = entry.w;
+    bitmap->h = entry.h;
+    bitmap->aa = key.aa;
+    bitmap->data = (unsigned char *)gmalloc(entry.data.empty() ? 1 : entry.data.size());
+    if (!entry.data.empty()) {
+        memcpy(bitmap->data, entry.data.data(), entry.data.size());
+    }
+    bitmap->freeData = true;
+    ++hits;
+    return true;
+}
+
+void SplashGlyphCache::insert(const SplashGlyphCacheKey &key, const SplashGlyphBitmap &bitmap)
+{
+    const size_t size = glyphDataSize(bitmap.w, bitmap.h, key.aa);
+    const size_t stripeMax = maxBytes / numStripes;
+    if (!bitmap.data || size > stripeMax) {
+        return;
+    }
+
+    Stripe &stripe = stripeFor(key);
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+
+    // another thread may have rasterized the same glyph concurrently
+    if (stripe.index.find(key) != stripe.index.end()) {
+        return;
+    }
+
+    while (!stripe.lru.empty() && stripe.bytes + size > stripeMax) {
+        const Entry &victim = stripe.lru.back();
+        stripe.bytes -= victim.data.size();
+        stripe.index.erase(victim.key);
+        stripe.lru.pop_back();
+    }
+
+    stripe.lru.push_front(Entry { key, bitmap.x, bitmap.y, bitmap.w, bitmap.h, std::vector<unsigned char>(bitmap.data, bitmap.data + size) });
+    stripe.index.emplace(key, stripe.lru.begin());
+    stripe.bytes += size;
+}
+
+void SplashGlyphCache::setMaxBytes(size_t maxBytesA)
+{
+    maxBytes = maxBytesA;
+}
+
+size_t SplashGlyphCache::getBytes() const
+{
+    size_t bytes = 0;
+    for (const Stripe &stripe : stripes) {
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        bytes += stripe.bytes;
+    }
+    return bytes;
+}
+
+void SplashGlyphCache::clear()
+{
+    for (Stripe &stripe : stripes) {
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        stripe.index.clear();
+        stripe.lru.clear();
+        stripe.bytes = 0;
+    }
+    hits = 0;
+    misses = 0;
+}
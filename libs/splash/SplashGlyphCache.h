@@ -0,0 +1,128 @@
+//========================================================================
+//
+// SplashGlyphCache.h
+//
+// Process-wide glyph bitmap cache shared by all SplashFont instances.
+// Every SplashOutputDev owns its own SplashFontEngine, so when pages are
+// rendered on several threads the per-font caches in SplashFont do not
+// see each other and the same glyphs (typically CJK) are rasterized once
+// per thread.  This cache sits behind the per-font cache and is keyed by
+// font content rather than by SplashFontFileID, which is only unique
+// within a single document.
+//
+// The cache is split into independently locked stripes so that render
+// threads rarely contend, and the total size of the stored bitmaps is
+// capped; each stripe evicts its least recently used glyphs.
+//
+// This file is licensed under the GPLv2 or later
+//
+//========================================================================
+
+#ifndef SPLASHGLYPHCACHE_H
+#define SPLASHGLYPHCACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "SplashTypes.h"
+#include "poppler_private_export.h"
+
+struct SplashGlyphBitmap;
+
+//------------------------------------------------------------------------
+// SplashGlyphCacheKey
+//------------------------------------------------------------------------
+
+struct SplashGlyphCacheKey
+{
+    unsigned long long fontKey; // SplashFontFile::sharedCacheKey
+    int c; // glyph code
+    int xFrac, yFrac; // sub-pixel position
+    long long mat[4]; // font matrix, quantized to 1/64 pixel
+    bool aa; // anti-aliasing
+    bool hinting; // FreeType hinting enabled
+    bool slightHinting; // slight (vertical only) hinting
+
+    bool operator==(const SplashGlyphCacheKey &other) const;
+};
+
+struct SplashGlyphCacheKeyHash
+{
+    size_t operator()(const SplashGlyphCacheKey &key) const;
+};
+
+//------------------------------------------------------------------------
+// SplashGlyphCache
+//------------------------------------------------------------------------
+
+class POPPLER_PRIVATE_EXPORT SplashGlyphCache
+{
+public:
+    // The cache shared by all rendering threads.
+    static SplashGlyphCache *getShared();
+
+    SplashGlyphCache(const SplashGlyphCache &) = delete;
+    SplashGlyphCache &operator=(const SplashGlyphCache &) = delete;
+
+    // Build a lookup key for glyph <c> of a font with the given shared
+    // key, transform matrix and rasterization settings.
+    static SplashGlyphCacheKey makeKey(unsigned long long fontKey, int c, int xFrac, int yFrac, const SplashCoord *mat, bool aa, bool hinting, bool slightHinting);
+
+    // FNV-1a hash used to build font content keys; pass the previous
+    // result as <seed> to chain several buffers.
+    static unsigned long long hashBytes(const void *data, size_t len, unsigned long long seed = 0xcbf29ce484222325ULL);
+
+    // Look up a glyph.  On a hit, <bitmap> receives a private copy of the
+    // glyph (gmalloc'ed, freeData set) and true is returned.
+    bool lookup(const SplashGlyphCacheKey &key, SplashGlyphBitmap *bitmap);
+
+    // Store a copy of <bitmap>.  Glyphs larger than a stripe's share of
+    // the memory cap are not stored.
+    void insert(const SplashGlyphCacheKey &key, const SplashGlyphBitmap &bitmap);
+
+    // Memory cap for the stored bitmap data, in bytes.  Lowering the cap
+    // evicts glyphs on the next insertion into each stripe.
+    void setMaxBytes(size_t maxBytesA);
+    size_t getMaxBytes() const { return maxBytes; }
+
+    // Current size of the stored bitmap data, in bytes.
+    size_t getBytes() const;
+
+    void clear();
+
+    unsigned long long getHits() const { return hits; }
+    unsigned long long getMisses() const { return misses; }
+
+private:
+    SplashGlyphCache();
+
+    struct Entry
+    {
+        SplashGlyphCacheKey key;
+        int x, y, w, h;
+        std::vector<unsigned char> data;
+    };
+
+    struct Stripe
+    {
+        mutable std::mutex mutex;
+        std::list<Entry> lru; // most recently used first
+        std::unordered_map<SplashGlyphCacheKey, std::list<Entry>::iterator, SplashGlyphCacheKeyHash> index;
+        size_t bytes = 0;
+    };
+
+    static const int numStripes = 16;
+
+    Stripe &stripeFor(const SplashGlyphCacheKey &key);
+
+    Stripe stripes[numStripes];
+    std::atomic<size_t> maxBytes;
+    std::atomic<unsigned long long> hits;
+    std::atomic<unsigned long long> misses;
+};
+
+#endif
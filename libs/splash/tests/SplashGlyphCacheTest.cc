@@ -0,0 +1,278 @@
+//========================================================================
+//
+// SplashGlyphCacheTest.cc
+//
+// Unit test for the shared glyph cache: lookup and insertion, the key
+// fields that must keep glyphs apart, LRU eviction under the default
+// 64 MiB cap, and concurrent access through the locked stripes.
+//
+// Build and run with qmake (make check), or from the repository root:
+//   g++ -std=c++17 -pthread -Ilibs -Ilibs/goo -Ilibs/splash
+//       libs/splash/tests/SplashGlyphCacheTest.cc libs/splash/SplashGlyphCache.cc
+//       -o SplashGlyphCacheTest && ./SplashGlyphCacheTest
+//
+// This file is licensed under the GPLv2 or later
+//
+//========================================================================
+
+#include <config.h>
+
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "goo/gmem.h"
+#include "SplashGlyphBitmap.h"
+#include "SplashGlyphCache.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                  \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++failures;                                                              \
+        }                                                                            \
+    } while (0)
+
+static const SplashCoord identity[4] = { 12, 0, 0, 12 };
+
+static SplashGlyphCacheKey glyphKey(int c, unsigned long long fontKey = 0x1234)
+{
+    return SplashGlyphCache::makeKey(fontKey, c, 0, 0, identity, true, false, false);
+}
+
+// Anti-aliased w x h glyph whose pixels are all <fill>.
+struct TestGlyph
+{
+    std::vector<unsigned char> pixels;
+    SplashGlyphBitmap bitmap;
+
+    TestGlyph(int w, int h, unsigned char fill) : pixels((size_t)w * h, fill)
+    {
+        bitmap.x = 1;
+        bitmap.y = 2;
+        bitmap.w = w;
+        bitmap.h = h;
+        bitmap.aa = true;
+        bitmap.data = pixels.data();
+        bitmap.freeData = false;
+    }
+};
+
+// Look up <key> and check that the returned glyph is w x h and filled
+// with <fill>.  Returns false on a miss.
+static bool lookupGlyph(SplashGlyphCache *cache, const SplashGlyphCacheKey &key, int w, int h, unsigned char fill)
+{
+    SplashGlyphBitmap bitmap;
+    if (!cache->lookup(key, &bitmap)) {
+        return false;
+    }
+    CHECK(bitmap.freeData);
+    CHECK(bitmap.w == w && bitmap.h == h);
+    bool same = true;
+    for (int i = 0; i < w * h; ++i) {
+        same = same && bitmap.data[i] == fill;
+    }
+    CHECK(same);
+    gfree(bitmap.data);
+    return true;
+}
+
+// Stripe selection as done by SplashGlyphCache::stripeFor.
+static int stripeOf(const SplashGlyphCacheKey &key)
+{
+    return (int)((SplashGlyphCacheKeyHash()(key) >> 28) % 16);
+}
+
+static void testInsertLookup(SplashGlyphCache *cache)
+{
+    cache->clear();
+
+    const SplashGlyphCacheKey key = glyphKey('A');
+    CHECK(!lookupGlyph(cache, key, 8, 10, 0x5a));
+    CHECK(cache->getMisses() == 1);
+
+    TestGlyph glyph(8, 10, 0x5a);
+    cache->insert(key, glyph.bitmap);
+    CHECK(cache->getBytes() == 80);
+
+    SplashGlyphBitmap bitmap;
+    CHECK(cache->lookup(key, &bitmap));
+    CHECK(bitmap.x == 1 && bitmap.y == 2 && bitmap.aa);
+    // the cache hands out a private copy
+    CHECK(bitmap.data != glyph.pixels.data());
+    gfree(bitmap.data);
+    CHECK(lookupGlyph(cache, key, 8, 10, 0x5a));
+    CHECK(cache->getHits() == 2);
+
+    // a second insertion of the same glyph is ignored
+    TestGlyph other(8, 10, 0x11);
+    cache->insert(key, other.bitmap);
+    CHECK(cache->getBytes() == 80);
+    CHECK(lookupGlyph(cache, key, 8, 10, 0x5a));
+}
+
+static void testKeyFields(SplashGlyphCache *cache)
+{
+    cache->clear();
+
+    const SplashGlyphCacheKey base = glyphKey('B');
+    TestGlyph glyph(4, 4, 0x77);
+    cache->insert(base, glyph.bitmap);
+
+    const SplashCoord scaled[4] = { 13, 0, 0, 13 };
+    const SplashGlyphCacheKey variants[] = {
+        glyphKey('B', 0x4321),
+        glyphKey('C'),
+        SplashGlyphCache::makeKey(0x1234, 'B', 1, 0, identity, true, false, false),
+        SplashGlyphCache::makeKey(0x1234, 'B', 0, 0, scaled, true, false, false),
+        SplashGlyphCache::makeKey(0x1234, 'B', 0, 0, identity, false, false, false),
+        SplashGlyphCache::makeKey(0x1234, 'B', 0, 0, identity, true, true, false),
+        SplashGlyphCache::makeKey(0x1234, 'B', 0, 0, identity, true, true, true),
+    };
+    for (const SplashGlyphCacheKey &variant : variants) {
+        CHECK(!(variant == base));
+        CHECK(!lookupGlyph(cache, variant, 4, 4, 0x77));
+    }
+
+    // matrices that quantize to the same 1/64 pixel share glyphs
+    const SplashCoord nearby[4] = { 12.001, 0, 0, 12.001 };
+    CHECK(lookupGlyph(cache, SplashGlyphCache::makeKey(0x1234, 'B', 0, 0, nearby, true, false, false), 4, 4, 0x77));
+}
+
+static void testLruEviction(SplashGlyphCache *cache)
+{
+    cache->clear();
+    CHECK(cache->getMaxBytes() == 64 * 1024 * 1024);
+
+    // 64 KiB glyphs: the cap holds about a thousand of them
+    const int size = 256;
+    const int count = 1536;
+    std::vector<SplashGlyphCacheKey> keys;
+    for (int c = 0; c < count; ++c) {
+        keys.push_back(glyphKey(c));
+    }
+
+    // keep touching the first glyph of one stripe so that it stays the
+    // most recently used one there
+    const SplashGlyphCacheKey kept = keys[0];
+    TestGlyph keptGlyph(size, size, 1);
+    cache->insert(kept, keptGlyph.bitmap);
+
+    int evictedInKeptStripe = 0;
+    for (int c = 1; c < count; ++c) {
+        TestGlyph glyph(size, size, (unsigned char)(c & 0xff));
+        cache->insert(keys[c], glyph.bitmap);
+        CHECK(cache->getBytes() <= cache->getMaxBytes());
+        if (stripeOf(keys[c]) == stripeOf(kept)) {
+            CHECK(lookupGlyph(cache, kept, size, size, 1));
+        }
+    }
+
+    // the oldest untouched glyphs of the kept glyph's stripe are gone,
+    // the newest glyph is still there
+    for (int c = 1; c < count; ++c) {
+        if (stripeOf(keys[c]) == stripeOf(kept)) {
+            if (!lookupGlyph(cache, keys[c], size, size, (unsigned char)(c & 0xff))) {
+                ++evictedInKeptStripe;
+            }
+        }
+    }
+    CHECK(evictedInKeptStripe > 0);
+    CHECK(lookupGlyph(cache, kept, size, size, 1));
+    CHECK(lookupGlyph(cache, keys[count - 1], size, size, (unsigned char)((count - 1) & 0xff)));
+    CHECK(cache->getBytes() > cache->getMaxBytes() / 2);
+
+    // glyphs larger than a stripe's share of the cap are never stored
+    cache->clear();
+    cache->setMaxBytes(16 * 1024);
+    TestGlyph huge(64, 64, 9);
+    cache->insert(glyphKey('H'), huge.bitmap);
+    CHECK(cache->getBytes() == 0);
+
+    // lowering the cap evicts on the next insertion into a stripe
+    cache->setMaxBytes(64 * 1024 * 1024);
+    for (int c = 0; c < 64; ++c) {
+        TestGlyph glyph(32, 32, 3);
+        cache->insert(keys[c], glyph.bitmap);
+    }
+    CHECK(cache->getBytes() == 64 * 1024);
+    cache->setMaxBytes(16 * 1024);
+    for (int c = 64; c < 128; ++c) {
+        TestGlyph glyph(16, 16, 4);
+        cache->insert(keys[c], glyph.bitmap);
+    }
+    CHECK(cache->getBytes() <= 16 * 1024);
+
+    cache->setMaxBytes(64 * 1024 * 1024);
+}
+
+static void testConcurrentAccess(SplashGlyphCache *cache)
+{
+    cache->clear();
+    cache->setMaxBytes(256 * 1024);
+
+    // every thread rasterizes the same glyph set in a different order;
+    // whatever a lookup returns must be the complete glyph for its key
+    const int threadCount = 8;
+    const int glyphCount = 512;
+    std::vector<std::thread> threads;
+    std::vector<int> corrupted(threadCount, 0);
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([cache, t, &corrupted]() {
+            for (int round = 0; round < 4; ++round) {
+                for (int i = 0; i < glyphCount; ++i) {
+                    const int c = (i * 7 + t * 61) % glyphCount;
+                    const SplashGlyphCacheKey key = glyphKey(c);
+                    const unsigned char fill = (unsigned char)(c * 13);
+                    SplashGlyphBitmap bitmap;
+                    if (cache->lookup(key, &bitmap)) {
+                        for (int p = 0; p < 24 * 24; ++p) {
+                            if (bitmap.w != 24 || bitmap.h != 24 || bitmap.data[p] != fill) {
+                                ++corrupted[t];
+                                break;
+                            }
+                        }
+                        gfree(bitmap.data);
+                    } else {
+                        TestGlyph glyph(24, 24, fill);
+                        cache->insert(key, glyph.bitmap);
+                    }
+                }
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    for (int count : corrupted) {
+        CHECK(count == 0);
+    }
+    CHECK(cache->getBytes() <= cache->getMaxBytes());
+    CHECK(cache->getHits() + cache->getMisses() == (unsigned long long)threadCount * 4 * glyphCount);
+    CHECK(cache->getHits() > 0);
+
+    cache->clear();
+    CHECK(cache->getBytes() == 0);
+    cache->setMaxBytes(64 * 1024 * 1024);
+}
+
+int main()
+{
+    SplashGlyphCache *cache = SplashGlyphCache::getShared();
+
+    testInsertLookup(cache);
+    testKeyFields(cache);
+    testLruEviction(cache);
+    testConcurrentAccess(cache);
+
+    if (failures) {
+        fprintf(stderr, "SplashGlyphCacheTest: %d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("SplashGlyphCacheTest: all checks passed\n");
+    return 0;
+}
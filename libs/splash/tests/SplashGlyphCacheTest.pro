@@ -0,0 +1,11 @@
+# Unit test for the shared Splash glyph cache; "make check" runs it.
+TEMPLATE = app
+TARGET = SplashGlyphCacheTest
+CONFIG += console c++17 thread testcase
+CONFIG -= qt app_bundle
+
+INCLUDEPATH += $$PWD/../.. $$PWD/../../goo $$PWD/..
+
+SOURCES += \
+    SplashGlyphCacheTest.cc \
+    ../SplashGlyphCache.cc
@@ -26,6 +26,8 @@
 #include <QProcessEnvironment>
 
 #include "src/QtCompat.h"
+#include "src/PopplerCompat.h"
+#include "src/ConversionWorker.h"
 #include "src/widgetTest/XmlTestWidget.h"
 #include "src/widgetTest/TestWidget.h"
 #include "src/widgetTest/DocxContentTestWidget.h"
@@ -37,6 +39,11 @@
 
 int main(int argc, char* argv[])
 {
+    // 以转换工作进程方式启动时不创建界面，见ConversionWorkerPool
+    if (ConversionWorker::isWorkerInvocation(argc, argv)) {
+        return ConversionWorker::run(argc, argv);
+    }
+
     // 设置Qt插件路径环境变量
     QString appDir = QDir::currentPath();
     QString pluginPath = appDir + QS("/platforms");
@@ -68,6 +75,9 @@ int main(int argc, char* argv[])
     qDebug() << "版本:" << app.applicationVersion();
     qDebug() << "Qt版本:" << QT_VERSION_STR;
 
+    // 在后台完成Poppler的一次性初始化（globalParams、字体映射、CMap），界面创建不必等待
+    PopplerCompat::warmUp(true);
+
     // 创建主窗口
     QWidget mainWindow;
     mainWindow.setWindowTitle(QS("ReportMason - 文档处理工具"));
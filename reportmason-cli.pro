@@ -0,0 +1,30 @@
+# reportmason-cli：无界面批量转换程序
+# 复用ReportMason.pro的编译选项、库和转换相关源文件，去掉界面入口、测试界面和AI模块
+include(ReportMason.pro)
+
+TARGET = reportmason-cli
+
+# 转换器用到QFont、QTextDocument和QImage，仍需要gui模块，但不依赖widgets
+QT -= widgets
+CONFIG += console
+CONFIG -= app_bundle
+
+INCLUDEPATH -= src/widgetTest
+
+SOURCES -= \
+    main.cpp \
+    src/LogSystem.cpp \
+    $$files(src/widgetTest/*.cpp) \
+    $$files(tools/ai/*.cpp)
+
+HEADERS -= \
+    src/LogSystem.h \
+    $$files(src/widgetTest/*.h) \
+    $$files(tools/ai/*.h)
+
+SOURCES += \
+    cli/main.cpp
+
+# 默认规则（ReportMason.pro中按原TARGET设置过，这里重新计算）
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
@@ -0,0 +1,19 @@
+# reportmason-tests：转换核心的单元测试，"make check"运行
+# 复用reportmason-cli.pro的源文件和库，以测试入口替换命令行入口
+include(reportmason-cli.pro)
+
+TARGET = reportmason-tests
+
+QT += testlib
+CONFIG += testcase
+
+INCLUDEPATH += src
+
+SOURCES -= \
+    cli/main.cpp
+
+SOURCES += \
+    tests/DocumentPipelineTest.cpp
+
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
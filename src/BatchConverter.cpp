@@ -0,0 +1,378 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-19 00:50:00
+ * @LastEditTime: 2026-10-19 00:50:00
+ * @LastEditors: seelights
+ * @Description: 无界面的批量文档转换实现
+ * @FilePath: \ReportMason\src\BatchConverter.cpp
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#include "BatchConverter.h"
+#include "QtCompat.h"
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <algorithm>
+
+double BatchConverter::Summary::filesPerSecond() const
+{
+    return wallMs > 0 ? total * 1000.0 / wallMs : 0.0;
+}
+
+double BatchConverter::Summary::megabytesPerSecond() const
+{
+    return wallMs > 0 ? (inputBytes / (1024.0 * 1024.0)) * 1000.0 / wallMs : 0.0;
+}
+
+BatchConverter::BatchConverter(QObject* parent)
+    : QObject(parent),
+      m_mode(Mode::WORKER_POOL),
+      m_converter(ConversionWorker::Converter::LOSSLESS_XML),
+      m_jobs(0),
+      m_jobTimeout(ConversionWorkerPool::DEFAULT_JOB_TIMEOUT_MS),
+      m_stageWorkers(DocumentPipeline::STAGE_COUNT, 0),
+      m_queueCapacity(0),
+      m_outputDirectory(QS("."))
+{
+}
+
+BatchConverter::~BatchConverter() = default;
+
+void BatchConverter::setMode(Mode mode)
+{
+    m_mode = mode;
+}
+
+BatchConverter::Mode BatchConverter::mode() const
+{
+    return m_mode;
+}
+
+void BatchConverter::setConverter(ConversionWorker::Converter converter)
+{
+    m_converter = converter;
+}
+
+ConversionWorker::Converter BatchConverter::converter() const
+{
+    return m_converter;
+}
+
+void BatchConverter::setJobs(int jobs)
+{
+    m_jobs = jobs;
+}
+
+int BatchConverter::jobs() const
+{
+    return m_jobs;
+}
+
+void BatchConverter::setOutputDirectory(const QString& directory)
+{
+    m_outputDirectory = directory;
+}
+
+QString BatchConverter::outputDirectory() const
+{
+    return m_outputDirectory;
+}
+
+void BatchConverter::setJobTimeout(int milliseconds)
+{
+    m_jobTimeout = milliseconds;
+}
+
+int BatchConverter::jobTimeout() const
+{
+    return m_jobTimeout;
+}
+
+void BatchConverter::setStageWorkers(DocumentPipeline::Stage stage, int workers)
+{
+    m_stageWorkers[static_cast<int>(stage)] = workers;
+}
+
+int BatchConverter::stageWorkers(DocumentPipeline::Stage stage) const
+{
+    return m_stageWorkers.at(static_cast<int>(stage));
+}
+
+void BatchConverter::setQueueCapacity(int capacity)
+{
+    m_queueCapacity = capacity;
+}
+
+int BatchConverter::queueCapacity() const
+{
+    return m_queueCapacity;
+}
+
+QList<BatchConverter::Input> BatchConverter::collectInputs(const QStringList& paths,
+                                                           ConversionWorker::Converter converter,
+                                                           bool recursive, QStringList& rejected)
+{
+    const QStringList extensions = ConversionWorker::supportedExtensions(converter);
+    QStringList nameFilters;
+    for (const QString& extension : extensions) {
+        nameFilters.append(QS("*.") + extension);
+    }
+
+    QList<Input> inputs;
+    QSet<QString> seen;
+    // 同一个文件只转换一次；按规范路径判断，经符号链接重复给出的文件也只保留一份
+    const auto append = [&inputs, &seen](const QString& filePath, const QString& relativePath) {
+        const QString canonicalPath = QFileInfo(filePath).canonicalFilePath();
+        if (!seen.contains(canonicalPath)) {
+            seen.insert(canonicalPath);
+            inputs.append({filePath, relativePath});
+        }
+    };
+    for (const QString& path : paths) {
+        const QFileInfo info(path);
+        if (!info.exists()) {
+            rejected.append(path);
+            continue;
+        }
+
+        if (info.isFile()) {
+            if (extensions.contains(info.suffix().toLower())) {
+                append(info.absoluteFilePath(), info.fileName());
+            } else {
+                rejected.append(path);
+            }
+            continue;
+        }
+
+        const QDir directory(info.absoluteFilePath());
+        QStringList files;
+        QDirIterator it(directory.absolutePath(), nameFilters, QDir::Files | QDir::Readable,
+                        recursive ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags);
+        while (it.hasNext()) {
+            const QString filePath = it.next();
+            // 跳过Office打开文档时留下的锁文件
+            if (!QFileInfo(filePath).fileName().startsWith(QS("~$"))) {
+                files.append(filePath);
+            }
+        }
+        std::sort(files.begin(), files.end());
+        for (const QString& filePath : files) {
+            append(filePath, directory.relativeFilePath(filePath));
+        }
+    }
+    return inputs;
+}
+
+bool BatchConverter::run(const QList<Input>& inputs, Summary& summary)
+{
+    summary = Summary();
+    summary.total = inputs.size();
+    if (inputs.isEmpty()) {
+        return true;
+    }
+
+    if (m_mode == Mode::PIPELINE && m_converter != ConversionWorker::Converter::LOSSLESS_XML) {
+        setLastError(QS("流水线方式只支持无损转换"));
+        return false;
+    }
+    if (!QDir().mkpath(m_outputDirectory)) {
+        setLastError(QS("无法创建输出目录: %1").arg(m_outputDirectory));
+        return false;
+    }
+
+    const bool started = m_mode == Mode::PIPELINE ? runPipeline(inputs, summary) : runWorkerPool(inputs, summary);
+    if (started) {
+        qDebug() << "BatchConverter: 完成" << summary.total << "个文件，成功" << summary.succeeded << "，失败"
+                 << summary.failed << "，耗时" << summary.wallMs << "ms";
+    }
+    return started;
+}
+
+bool BatchConverter::runWorkerPool(const QList<Input>& inputs, Summary& summary)
+{
+    QElapsedTimer wallClock;
+    wallClock.start();
+
+    ConversionWorkerPool pool(m_jobs);
+    pool.setJobTimeout(m_jobTimeout);
+    if (!pool.start()) {
+        setLastError(pool.lastError());
+        return false;
+    }
+
+    struct PendingFile {
+        QString inputPath;
+        QString outputPath;
+        qint64 inputBytes = 0;
+    };
+    QHash<quint64, PendingFile> pending;
+    QEventLoop loop;
+
+    connect(&pool, &ConversionWorkerPool::jobFinished, &loop,
+            [this, &pending, &summary, &loop](const ConversionWorkerPool::Result& result) {
+                const auto it = pending.find(result.jobId);
+                if (it == pending.end()) {
+                    return;
+                }
+
+                FileReport report;
+                report.inputPath = it->inputPath;
+                report.inputBytes = it->inputBytes;
+                report.status = result.status;
+                report.error = result.error;
+                report.elapsedMs = result.elapsedMs;
+                report.workerIndex = result.workerIndex;
+                if (result.status == ConversionWorkerPool::JobStatus::SUCCESS) {
+                    if (writeOutput(it->outputPath, result.output, report.error)) {
+                        report.outputPath = it->outputPath;
+                        report.outputBytes = result.output.size();
+                    } else {
+                        report.status = ConversionWorkerPool::JobStatus::FAILED;
+                    }
+                }
+
+                if (report.status == ConversionWorkerPool::JobStatus::SUCCESS) {
+                    ++summary.succeeded;
+                    summary.outputBytes += report.outputBytes;
+                } else {
+                    ++summary.failed;
+                }
+                pending.erase(it);
+
+                emit fileFinished(report);
+                if (pending.isEmpty()) {
+                    loop.quit();
+                }
+            });
+
+    QSet<QString> usedPaths;
+    for (const Input& input : inputs) {
+        PendingFile file;
+        file.inputPath = input.filePath;
+        file.outputPath = outputPathFor(input, usedPaths);
+        file.inputBytes = QFileInfo(input.filePath).size();
+        summary.inputBytes += file.inputBytes;
+
+        // 池已启动，submit总是返回有效的任务编号；结果最早在事件循环中才会到达
+        pending.insert(pool.submit(input.filePath, m_converter), file);
+    }
+
+    loop.exec();
+
+    summary.workerRestarts = pool.restartCount();
+    pool.stop();
+    summary.wallMs = wallClock.elapsed();
+    return true;
+}
+
+bool BatchConverter::runPipeline(const QList<Input>& inputs, Summary& summary)
+{
+    DocumentPipeline pipeline;
+    for (int stage = 0; stage < DocumentPipeline::STAGE_COUNT; ++stage) {
+        if (m_stageWorkers.at(stage) > 0) {
+            pipeline.setStageWorkers(static_cast<DocumentPipeline::Stage>(stage), m_stageWorkers.at(stage));
+        }
+    }
+    if (m_queueCapacity > 0) {
+        pipeline.setQueueCapacity(m_queueCapacity);
+    }
+
+    QList<DocumentPipeline::Job> jobs;
+    QList<qint64> inputBytes;
+    QSet<QString> usedPaths;
+    for (const Input& input : inputs) {
+        jobs.append({input.filePath, outputPathFor(input, usedPaths)});
+        inputBytes.append(QFileInfo(input.filePath).size());
+        summary.inputBytes += inputBytes.last();
+    }
+
+    // 信号在流水线线程中发出，以事件循环为上下文对象，槽函数在当前线程中排队执行
+    QEventLoop loop;
+    connect(&pipeline, &DocumentPipeline::documentFinished, &loop,
+            [this, &inputBytes, &summary](const DocumentPipeline::Result& result) {
+                FileReport report;
+                report.inputPath = result.filePath;
+                report.inputBytes = inputBytes.value(result.index);
+                report.elapsedMs = result.latencyMs;
+                if (result.status == LosslessDocumentConverter::ConvertStatus::SUCCESS) {
+                    report.status = ConversionWorkerPool::JobStatus::SUCCESS;
+                    report.outputPath = result.outputPath;
+                    report.outputBytes = result.outputBytes;
+                    ++summary.succeeded;
+                    summary.outputBytes += report.outputBytes;
+                } else {
+                    report.status = ConversionWorkerPool::JobStatus::FAILED;
+                    report.error = QS("%1: %2").arg(DocumentPipeline::stageName(result.failedStage), result.error);
+                    ++summary.failed;
+                }
+                emit fileFinished(report);
+            });
+    // finished在全部documentFinished之后发出，排队执行时顺序不变
+    connect(&pipeline, &DocumentPipeline::finished, &loop, &QEventLoop::quit);
+
+    if (!pipeline.start(jobs)) {
+        setLastError(QS("无法启动转换流水线"));
+        return false;
+    }
+    loop.exec();
+    pipeline.waitForFinished();
+
+    summary.wallMs = pipeline.elapsedMs();
+    summary.stageMetrics = pipeline.metrics();
+    return true;
+}
+
+QString BatchConverter::lastError() const
+{
+    return m_lastError;
+}
+
+QString BatchConverter::outputPathFor(const Input& input, QSet<QString>& usedPaths) const
+{
+    const QFileInfo relative(input.relativePath);
+    QString base = relative.completeBaseName();
+    if (relative.path() != QS(".")) {
+        base = relative.path() + QS("/") + base;
+    }
+
+    const QDir directory(m_outputDirectory);
+    QString outputPath = QDir::cleanPath(directory.absoluteFilePath(base + QS(".xml")));
+    // 不同目录中的同名文件以文件列表形式传入时会映射到同一个输出文件
+    for (int sequence = 2; usedPaths.contains(outputPath); ++sequence) {
+        outputPath = QDir::cleanPath(directory.absoluteFilePath(QS("%1_%2.xml").arg(base).arg(sequence)));
+    }
+    usedPaths.insert(outputPath);
+    return outputPath;
+}
+
+bool BatchConverter::writeOutput(const QString& outputPath, const QByteArray& data, QString& error) const
+{
+    if (!QDir().mkpath(QFileInfo(outputPath).absolutePath())) {
+        error = QS("无法创建输出目录: %1").arg(QFileInfo(outputPath).absolutePath());
+        return false;
+    }
+
+    // 先写临时文件再替换，中断时不会留下截断的结果
+    QSaveFile file(outputPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        error = QS("无法写入输出文件: %1").arg(file.errorString());
+        return false;
+    }
+    if (file.write(data) != data.size() || !file.commit()) {
+        error = QS("写入输出文件失败: %1").arg(file.errorString());
+        return false;
+    }
+    return true;
+}
+
+void BatchConverter::setLastError(const QString& error)
+{
+    m_lastError = error;
+    qDebug() << "BatchConverter错误:" << error;
+}
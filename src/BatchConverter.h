@@ -0,0 +1,187 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-19 00:50:00
+ * @LastEditTime: 2026-10-19 00:50:00
+ * @LastEditors: seelights
+ * @Description: 无界面的批量文档转换
+ * @FilePath: \ReportMason\src\BatchConverter.h
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#pragma once
+
+#include "ConversionWorker.h"
+#include "ConversionWorkerPool.h"
+#include "DocumentPipeline.h"
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief 无界面的批量文档转换
+ *
+ * 把一组输入文件交给ConversionWorkerPool并行转换，或在当前进程中经DocumentPipeline分阶段转换，
+ * 结果写入输出目录，同时统计每个文件的耗时和整批的吞吐量。只依赖事件循环，不创建任何窗口，
+ * 供reportmason-cli等无界面入口使用。
+ */
+class BatchConverter : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 执行方式
+     */
+    enum class Mode {
+        WORKER_POOL, ///< 每个文件在独立的工作进程中完整转换，崩溃隔离
+        PIPELINE     ///< 在当前进程中分阶段转换，阶段之间重叠执行，仅支持无损转换
+    };
+
+    /**
+     * @brief 输入文件
+     */
+    struct Input {
+        QString filePath;     ///< 输入文件路径
+        QString relativePath; ///< 相对于输入目录的路径，决定输出文件在输出目录中的位置
+    };
+
+    /**
+     * @brief 单个文件的转换报告
+     */
+    struct FileReport {
+        QString inputPath;
+        QString outputPath;                ///< 失败时为空
+        ConversionWorkerPool::JobStatus status = ConversionWorkerPool::JobStatus::FAILED;
+        QString error;
+        qint64 inputBytes = 0;
+        qint64 outputBytes = 0;
+        qint64 elapsedMs = 0;              ///< 转换耗时：工作进程方式从派发起算，流水线方式从进入read阶段起算
+        int workerIndex = -1;
+    };
+
+    /**
+     * @brief 整批的汇总统计
+     */
+    struct Summary {
+        int total = 0;
+        int succeeded = 0;
+        int failed = 0;
+        qint64 inputBytes = 0;  ///< 全部输入文件的字节数
+        qint64 outputBytes = 0; ///< 成功写出的结果字节数
+        qint64 wallMs = 0;      ///< 整批的墙钟耗时，含工作进程启动
+        int workerRestarts = 0; ///< 工作进程崩溃或超时后被重启的次数
+        QList<DocumentPipeline::StageMetrics> stageMetrics; ///< 流水线方式下各阶段的统计
+
+        /**
+         * @brief 每秒处理的文件数
+         */
+        double filesPerSecond() const;
+
+        /**
+         * @brief 每秒处理的输入数据量（MB）
+         */
+        double megabytesPerSecond() const;
+    };
+
+    explicit BatchConverter(QObject* parent = nullptr);
+    ~BatchConverter() override;
+
+    void setMode(Mode mode);
+    Mode mode() const;
+
+    void setConverter(ConversionWorker::Converter converter);
+    ConversionWorker::Converter converter() const;
+
+    /**
+     * @brief 设置并行的工作进程数
+     * @param jobs 工作进程数，小于等于0时使用CPU核数
+     */
+    void setJobs(int jobs);
+    int jobs() const;
+
+    void setOutputDirectory(const QString& directory);
+    QString outputDirectory() const;
+
+    /**
+     * @brief 设置单个文件的硬时限，见ConversionWorkerPool::setJobTimeout
+     */
+    void setJobTimeout(int milliseconds);
+    int jobTimeout() const;
+
+    /**
+     * @brief 设置流水线方式下阶段的工作线程数
+     * @param stage 阶段
+     * @param workers 线程数，小于等于0时使用DocumentPipeline的默认值
+     */
+    void setStageWorkers(DocumentPipeline::Stage stage, int workers);
+    int stageWorkers(DocumentPipeline::Stage stage) const;
+
+    /**
+     * @brief 设置流水线方式下阶段之间的队列容量
+     * @param capacity 容量，小于等于0时使用DocumentPipeline的默认值
+     */
+    void setQueueCapacity(int capacity);
+    int queueCapacity() const;
+
+    /**
+     * @brief 展开输入路径
+     *
+     * 文件直接加入；目录中转换器支持的文件按名称排序后加入。
+     * @param paths 文件或目录路径
+     * @param converter 转换器类型，决定接受的扩展名
+     * @param recursive 是否递归子目录
+     * @param rejected 不存在或格式不受支持的路径
+     * @return 输入文件列表
+     */
+    static QList<Input> collectInputs(const QStringList& paths, ConversionWorker::Converter converter,
+                                      bool recursive, QStringList& rejected);
+
+    /**
+     * @brief 转换全部输入文件，阻塞直到整批结束
+     *
+     * 运行期间在当前线程中执行局部事件循环，每个文件结束时在当前线程中发出fileFinished。
+     * @param inputs 输入文件
+     * @param summary 汇总统计
+     * @return 是否成功启动批处理；个别文件失败不影响返回值，见summary.failed
+     */
+    bool run(const QList<Input>& inputs, Summary& summary);
+
+    /**
+     * @brief 返回最近一次错误信息
+     */
+    QString lastError() const;
+
+signals:
+    /**
+     * @brief 单个文件转换结束（无论成功与否）
+     */
+    void fileFinished(const BatchConverter::FileReport& report);
+
+private:
+    bool runWorkerPool(const QList<Input>& inputs, Summary& summary);
+    bool runPipeline(const QList<Input>& inputs, Summary& summary);
+
+    /**
+     * @brief 计算输出文件路径，重名时追加序号
+     */
+    QString outputPathFor(const Input& input, QSet<QString>& usedPaths) const;
+
+    /**
+     * @brief 写出转换结果
+     */
+    bool writeOutput(const QString& outputPath, const QByteArray& data, QString& error) const;
+
+    void setLastError(const QString& error);
+
+    Mode m_mode;
+    ConversionWorker::Converter m_converter;
+    int m_jobs;
+    int m_jobTimeout;
+    QVector<int> m_stageWorkers; ///< 0表示使用默认值
+    int m_queueCapacity;
+    QString m_outputDirectory;
+    QString m_lastError;
+};
@@ -0,0 +1,276 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-19 00:10:00
+ * @LastEditTime: 2026-10-19 00:10:00
+ * @LastEditors: seelights
+ * @Description: 转换工作进程及其与主进程之间的通信协议实现
+ * @FilePath: \ReportMason\src\ConversionWorker.cpp
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#include "ConversionWorker.h"
+#include "DocToXmlConverter.h"
+#include "LosslessDocumentConverter.h"
+#include "PdfToXmlConverter.h"
+#include "PopplerCompat.h"
+#include "QtCompat.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QLocalSocket>
+#include <QSharedMemory>
+#include <cstring>
+
+bool ConversionWorker::isWorkerInvocation(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], WORKER_ARGUMENT) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int ConversionWorker::run(int argc, char* argv[])
+{
+    // 转换器用到QFont、QTextDocument和QImage，需要GUI应用对象，但不创建任何窗口
+    QGuiApplication app(argc, argv);
+
+    const QStringList arguments = QCoreApplication::arguments();
+    const int position = arguments.indexOf(QString::fromLatin1(WORKER_ARGUMENT));
+    if (position < 0 || position + 2 >= arguments.size()) {
+        qDebug() << "ConversionWorker: 缺少服务名或工作进程编号";
+        return 2;
+    }
+    const QString serverName = arguments.at(position + 1);
+    const int workerIndex = arguments.at(position + 2).toInt();
+
+    // 常驻进程只初始化一次Poppler全局状态
+    PopplerCompat::warmUp();
+
+    QLocalSocket socket;
+    socket.connectToServer(serverName);
+    if (!socket.waitForConnected(CONNECT_TIMEOUT_MS)) {
+        qDebug() << "ConversionWorker: 无法连接主进程" << serverName << socket.errorString();
+        return 3;
+    }
+
+    QByteArray hello;
+    QDataStream helloStream(&hello, QIODevice::WriteOnly);
+    helloStream << qint32(workerIndex) << QCoreApplication::applicationPid();
+    writeMessage(socket, MessageType::HELLO, hello);
+
+    ConversionWorker worker(serverName, workerIndex);
+    while (socket.state() == QLocalSocket::ConnectedState) {
+        // 缓冲区中没有完整的帧时（包括只收到半帧）等待更多数据，而不是反复解析同一段数据。
+        // 主进程退出或断开连接时waitForReadyRead返回false，工作进程随之退出
+        const QList<QByteArray> messages = readMessages(socket);
+        if (messages.isEmpty()) {
+            if (!socket.waitForReadyRead(-1)) {
+                break;
+            }
+            continue;
+        }
+
+        for (const QByteArray& message : messages) {
+            QDataStream stream(message);
+            const MessageType type = takeMessageType(stream);
+            if (type == MessageType::QUIT) {
+                return 0;
+            }
+            if (type != MessageType::JOB) {
+                continue;
+            }
+
+            Job job;
+            stream >> job;
+            const JobResult result = worker.execute(job);
+
+            QByteArray body;
+            QDataStream bodyStream(&body, QIODevice::WriteOnly);
+            bodyStream << result;
+            writeMessage(socket, MessageType::RESULT, body);
+            // 没有事件循环，结果必须在等待下一个任务之前写完
+            while (socket.bytesToWrite() > 0 && socket.waitForBytesWritten(-1)) {
+            }
+        }
+    }
+    return 0;
+}
+
+bool ConversionWorker::convert(const Job& job, QByteArray& output, QString& error)
+{
+    output.clear();
+    if (!QFileInfo::exists(job.filePath)) {
+        error = QS("文件不存在: %1").arg(job.filePath);
+        return false;
+    }
+
+    try {
+        if (job.converter == Converter::LOSSLESS_XML) {
+            LosslessDocumentConverter converter;
+            if (!converter.isSupported(job.filePath)) {
+                error = QS("不支持的文件格式");
+                return false;
+            }
+            output = converter.convertToLosslessXmlByteArray(job.filePath);
+            if (output.isEmpty()) {
+                error = QS("文档解析失败");
+                return false;
+            }
+            return true;
+        }
+
+        std::unique_ptr<FileConverter> converter;
+        const QString extension = QFileInfo(job.filePath).suffix().toLower();
+        if (job.converter == Converter::PDF_FIELD_XML
+            || (job.converter == Converter::FIELD_XML && extension == QS("pdf"))) {
+            converter = std::make_unique<PdfToXmlConverter>();
+        } else {
+            converter = std::make_unique<DocToXmlConverter>();
+        }
+        if (!converter->isSupported(job.filePath)) {
+            error = QS("不支持的文件格式");
+            return false;
+        }
+
+        QMap<QString, FileConverter::FieldInfo> fields;
+        if (converter->extractFields(job.filePath, fields) != FileConverter::ConvertStatus::SUCCESS
+            || converter->convertToXml(fields, output) != FileConverter::ConvertStatus::SUCCESS) {
+            error = converter->getLastError();
+            return false;
+        }
+        return true;
+    } catch (const std::exception& e) {
+        error = QS("转换时发生异常: %1").arg(QString::fromUtf8(e.what()));
+        return false;
+    }
+}
+
+QStringList ConversionWorker::supportedExtensions(Converter converter)
+{
+    switch (converter) {
+    case Converter::DOCX_FIELD_XML:
+        return {QS("docx")};
+    case Converter::PDF_FIELD_XML:
+        return {QS("pdf")};
+    case Converter::LOSSLESS_XML:
+    case Converter::FIELD_XML:
+        break;
+    }
+    return {QS("docx"), QS("pdf")};
+}
+
+void ConversionWorker::writeMessage(QLocalSocket& socket, MessageType type, const QByteArray& body)
+{
+    QByteArray frame;
+    frame.reserve(body.size() + 1);
+    frame.append(static_cast<char>(type));
+    frame.append(body);
+
+    QDataStream stream(&socket);
+    stream << frame;
+    socket.flush();
+}
+
+QList<QByteArray> ConversionWorker::readMessages(QLocalSocket& socket)
+{
+    QList<QByteArray> messages;
+    QDataStream stream(&socket);
+    while (socket.bytesAvailable() > 0) {
+        stream.startTransaction();
+        QByteArray frame;
+        stream >> frame;
+        if (!stream.commitTransaction()) {
+            break; // 帧不完整，等待后续数据
+        }
+        if (!frame.isEmpty()) {
+            messages.append(frame);
+        }
+    }
+    return messages;
+}
+
+ConversionWorker::MessageType ConversionWorker::takeMessageType(QDataStream& stream)
+{
+    quint8 type = 0;
+    stream >> type;
+    return static_cast<MessageType>(type);
+}
+
+ConversionWorker::ConversionWorker(const QString& serverName, int workerIndex)
+    : m_serverName(serverName), m_workerIndex(workerIndex), m_segmentGeneration(0)
+{
+}
+
+ConversionWorker::~ConversionWorker() = default;
+
+ConversionWorker::JobResult ConversionWorker::execute(const Job& job)
+{
+    JobResult result;
+    result.jobId = job.jobId;
+
+    QByteArray output;
+    result.success = convert(job, output, result.error);
+    if (result.success && !publish(output, result)) {
+        result.inlineData = output;
+        result.size = output.size();
+    }
+    return result;
+}
+
+bool ConversionWorker::publish(const QByteArray& output, JobResult& result)
+{
+    // 段只在放不下结果时替换；主进程读取完上一个结果之后才会派发下一个任务，
+    // 因此覆盖旧结果是安全的
+    if (!m_segment || m_segment->size() < output.size()) {
+        m_segment.reset();
+        qint64 size = MIN_SEGMENT_SIZE;
+        while (size < output.size()) {
+            size *= 2;
+        }
+        const QString key = QS("%1-w%2-%3").arg(m_serverName).arg(m_workerIndex).arg(++m_segmentGeneration);
+        auto segment = std::make_unique<QSharedMemory>(key);
+        if (!segment->create(size)) {
+            qDebug() << "ConversionWorker: 无法创建共享内存" << key << segment->errorString();
+            return false;
+        }
+        m_segment = std::move(segment);
+    }
+
+    if (!m_segment->lock()) {
+        return false;
+    }
+    std::memcpy(m_segment->data(), output.constData(), static_cast<size_t>(output.size()));
+    m_segment->unlock();
+
+    result.sharedMemoryKey = m_segment->key();
+    result.size = output.size();
+    return true;
+}
+
+QDataStream& operator<<(QDataStream& stream, const ConversionWorker::Job& job)
+{
+    return stream << job.jobId << job.filePath << static_cast<quint8>(job.converter);
+}
+
+QDataStream& operator>>(QDataStream& stream, ConversionWorker::Job& job)
+{
+    quint8 converter = 0;
+    stream >> job.jobId >> job.filePath >> converter;
+    job.converter = static_cast<ConversionWorker::Converter>(converter);
+    return stream;
+}
+
+QDataStream& operator<<(QDataStream& stream, const ConversionWorker::JobResult& result)
+{
+    return stream << result.jobId << result.success << result.error << result.sharedMemoryKey << result.size
+                  << result.inlineData;
+}
+
+QDataStream& operator>>(QDataStream& stream, ConversionWorker::JobResult& result)
+{
+    return stream >> result.jobId >> result.success >> result.error >> result.sharedMemoryKey >> result.size
+           >> result.inlineData;
+}
@@ -0,0 +1,142 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-19 00:10:00
+ * @LastEditTime: 2026-10-19 00:10:00
+ * @LastEditors: seelights
+ * @Description: 转换工作进程及其与主进程之间的通信协议
+ * @FilePath: \ReportMason\src\ConversionWorker.h
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <memory>
+
+class QLocalSocket;
+class QSharedMemory;
+
+/**
+ * @brief 转换工作进程
+ *
+ * 工作进程由ConversionWorkerPool以"<程序> --conversion-worker <服务名> <编号>"启动，
+ * 连接主进程的本地套接字后循环接收任务。转换结果写入工作进程持有的共享内存段，
+ * 套接字上只回传段名和长度；共享内存不可用时结果直接随消息回传。
+ * 工作进程常驻，Poppler全局状态、文档池和各类缓存在任务之间保持有效。
+ * 主进程断开连接时工作进程自行退出。
+ *
+ * 消息格式：QDataStream写出的QByteArray帧，帧内第一个字段为MessageType。
+ */
+class ConversionWorker
+{
+public:
+    /**
+     * @brief 转换器类型
+     */
+    enum class Converter : quint8 {
+        LOSSLESS_XML,   ///< LosslessDocumentConverter，输出无损XML
+        FIELD_XML,      ///< 按扩展名选择DocToXmlConverter或PdfToXmlConverter，输出字段XML
+        DOCX_FIELD_XML, ///< DocToXmlConverter，输出字段XML
+        PDF_FIELD_XML   ///< PdfToXmlConverter，输出字段XML
+    };
+
+    /**
+     * @brief 消息类型
+     */
+    enum class MessageType : quint8 {
+        HELLO,  ///< 工作进程 -> 主进程：连接后报告编号
+        JOB,    ///< 主进程 -> 工作进程：转换任务
+        RESULT, ///< 工作进程 -> 主进程：任务结果
+        QUIT    ///< 主进程 -> 工作进程：退出
+    };
+
+    /**
+     * @brief 转换任务
+     */
+    struct Job {
+        quint64 jobId = 0;
+        QString filePath;
+        Converter converter = Converter::LOSSLESS_XML;
+    };
+
+    /**
+     * @brief 任务结果
+     */
+    struct JobResult {
+        quint64 jobId = 0;
+        bool success = false;
+        QString error;
+        QString sharedMemoryKey; ///< 结果所在的共享内存段，为空时结果在inlineData中
+        qint64 size = 0;         ///< 结果字节数
+        QByteArray inlineData;   ///< 共享内存不可用时随消息回传的结果
+    };
+
+    /**
+     * @brief 命令行参数是否要求以工作进程方式运行
+     */
+    static bool isWorkerInvocation(int argc, char* argv[]);
+
+    /**
+     * @brief 工作进程入口，在main中创建QApplication之前调用
+     * @return 进程退出码
+     */
+    static int run(int argc, char* argv[]);
+
+    /**
+     * @brief 在当前进程中执行一个转换任务
+     * @param job 任务
+     * @param output 转换结果
+     * @param error 失败时的错误信息
+     * @return 是否成功
+     */
+    static bool convert(const Job& job, QByteArray& output, QString& error);
+
+    /**
+     * @brief 转换器支持的输入扩展名（小写，不含点）
+     *
+     * 与各转换器的isSupported保持一致，供主进程在不构造转换器的情况下筛选输入文件。
+     */
+    static QStringList supportedExtensions(Converter converter);
+
+    /**
+     * @brief 向套接字写出一条消息
+     */
+    static void writeMessage(QLocalSocket& socket, MessageType type, const QByteArray& body = QByteArray());
+
+    /**
+     * @brief 读出套接字中所有完整的消息，不完整的帧留在套接字中等待后续数据
+     * @return 消息帧，用takeMessageType取出类型
+     */
+    static QList<QByteArray> readMessages(QLocalSocket& socket);
+
+    /**
+     * @brief 从消息帧中取出类型，stream随后可读出消息体
+     */
+    static MessageType takeMessageType(QDataStream& stream);
+
+    static constexpr const char* WORKER_ARGUMENT = "--conversion-worker";
+
+private:
+    ConversionWorker(const QString& serverName, int workerIndex);
+    ~ConversionWorker();
+
+    JobResult execute(const Job& job);
+    bool publish(const QByteArray& output, JobResult& result);
+
+    QString m_serverName;
+    int m_workerIndex;
+    int m_segmentGeneration;
+    std::unique_ptr<QSharedMemory> m_segment; ///< 当前结果段，下一次任务才会覆盖或替换
+
+    static constexpr int CONNECT_TIMEOUT_MS = 10 * 1000;
+    static constexpr qint64 MIN_SEGMENT_SIZE = 1024 * 1024;
+};
+
+QDataStream& operator<<(QDataStream& stream, const ConversionWorker::Job& job);
+QDataStream& operator>>(QDataStream& stream, ConversionWorker::Job& job);
+QDataStream& operator<<(QDataStream& stream, const ConversionWorker::JobResult& result);
+QDataStream& operator>>(QDataStream& stream, ConversionWorker::JobResult& result);
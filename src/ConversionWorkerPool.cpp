@@ -0,0 +1,464 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-19 00:10:00
+ * @LastEditTime: 2026-10-19 00:10:00
+ * @LastEditors: seelights
+ * @Description: 崩溃隔离的转换工作进程池实现
+ * @FilePath: \ReportMason\src\ConversionWorkerPool.cpp
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#include "ConversionWorkerPool.h"
+#include "QtCompat.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QProcessEnvironment>
+#include <QSharedMemory>
+#include <QThread>
+#include <QTimer>
+#include <algorithm>
+
+ConversionWorkerPool::ConversionWorkerPool(int workerCount, QObject* parent)
+    : QObject(parent),
+      m_workerCount(workerCount > 0 ? workerCount : qMax(1, QThread::idealThreadCount())),
+      m_jobTimeout(DEFAULT_JOB_TIMEOUT_MS),
+      m_restartCount(0),
+      m_nextJobId(1),
+      m_running(false),
+      m_server(nullptr)
+{
+}
+
+ConversionWorkerPool::~ConversionWorkerPool()
+{
+    stop();
+}
+
+bool ConversionWorkerPool::start()
+{
+    if (m_running) {
+        return true;
+    }
+
+    // 服务名包含进程号和池地址，同一台机器上的多个实例互不干扰
+    m_serverName = QS("ReportMason-workers-%1-%2")
+                       .arg(QCoreApplication::applicationPid())
+                       .arg(reinterpret_cast<quintptr>(this), 0, 16);
+    m_server = new QLocalServer(this);
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    QLocalServer::removeServer(m_serverName);
+    if (!m_server->listen(m_serverName)) {
+        setLastError(QS("无法启动本地服务: %1").arg(m_server->errorString()));
+        delete m_server;
+        m_server = nullptr;
+        return false;
+    }
+    connect(m_server, &QLocalServer::newConnection, this, &ConversionWorkerPool::onNewConnection);
+
+    m_running = true;
+    m_workers.clear();
+    m_workers.resize(m_workerCount);
+    for (int index = 0; index < m_workerCount; ++index) {
+        Worker& worker = m_workers[index];
+        worker.index = index;
+        worker.jobTimer = new QTimer(this);
+        worker.jobTimer->setSingleShot(true);
+        connect(worker.jobTimer, &QTimer::timeout, this, [this, index]() { onJobTimeout(index); });
+        spawnWorker(index);
+    }
+
+    qDebug() << "ConversionWorkerPool: 已启动" << m_workerCount << "个工作进程，服务名" << m_serverName;
+    return true;
+}
+
+void ConversionWorkerPool::stop()
+{
+    if (!m_running) {
+        return;
+    }
+    m_running = false;
+
+    for (Worker& worker : m_workers) {
+        worker.jobTimer->stop();
+        if (worker.socket && worker.socket->state() == QLocalSocket::ConnectedState) {
+            ConversionWorker::writeMessage(*worker.socket, ConversionWorker::MessageType::QUIT);
+        }
+    }
+
+    // 正在转换的工作进程要等当前任务结束才会读到QUIT，等待超时后直接终止
+    for (Worker& worker : m_workers) {
+        if (worker.process) {
+            worker.process->disconnect(this);
+            if (!worker.process->waitForFinished(QUIT_TIMEOUT_MS)) {
+                worker.process->kill();
+                worker.process->waitForFinished(QUIT_TIMEOUT_MS);
+            }
+        }
+        if (worker.busy) {
+            Result result;
+            result.status = JobStatus::CANCELLED;
+            result.error = QS("工作进程池已停止");
+            finishJob(worker, result);
+        }
+    }
+    failQueuedJobs(JobStatus::CANCELLED, QS("工作进程池已停止"));
+
+    for (Worker& worker : m_workers) {
+        if (worker.socket) {
+            worker.socket->disconnect(this);
+            worker.socket->deleteLater();
+        }
+        if (worker.process) {
+            worker.process->deleteLater();
+        }
+        worker.jobTimer->deleteLater();
+    }
+    m_workers.clear();
+
+    m_server->close();
+    m_server->deleteLater();
+    m_server = nullptr;
+}
+
+bool ConversionWorkerPool::isRunning() const
+{
+    return m_running;
+}
+
+quint64 ConversionWorkerPool::submit(const QString& filePath, ConversionWorker::Converter converter)
+{
+    if (!m_running) {
+        setLastError(QS("工作进程池未启动"));
+        return 0;
+    }
+
+    ConversionWorker::Job job;
+    job.jobId = m_nextJobId++;
+    job.filePath = filePath;
+    job.converter = converter;
+    m_queue.enqueue(job);
+
+    const bool allDisabled = std::all_of(m_workers.cbegin(), m_workers.cend(),
+                                         [](const Worker& worker) { return worker.disabled; });
+    if (allDisabled) {
+        // 没有可用的工作进程，在返回任务编号之后再报告失败
+        QMetaObject::invokeMethod(this, [this]() {
+            failQueuedJobs(JobStatus::FAILED, m_lastError);
+            checkIdle();
+        }, Qt::QueuedConnection);
+    } else {
+        dispatch();
+    }
+    return job.jobId;
+}
+
+int ConversionWorkerPool::pendingCount() const
+{
+    int busy = 0;
+    for (const Worker& worker : m_workers) {
+        if (worker.busy) {
+            ++busy;
+        }
+    }
+    return m_queue.size() + busy;
+}
+
+int ConversionWorkerPool::workerCount() const
+{
+    return m_workerCount;
+}
+
+int ConversionWorkerPool::restartCount() const
+{
+    return m_restartCount;
+}
+
+void ConversionWorkerPool::setJobTimeout(int milliseconds)
+{
+    m_jobTimeout = milliseconds;
+}
+
+int ConversionWorkerPool::jobTimeout() const
+{
+    return m_jobTimeout;
+}
+
+QString ConversionWorkerPool::lastError() const
+{
+    return m_lastError;
+}
+
+void ConversionWorkerPool::onNewConnection()
+{
+    while (QLocalSocket* socket = m_server->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() { onSocketReadyRead(socket); });
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+            if (Worker* worker = findWorker(socket)) {
+                worker->socket = nullptr;
+            }
+            socket->deleteLater();
+        });
+    }
+}
+
+void ConversionWorkerPool::spawnWorker(int index)
+{
+    Worker& worker = m_workers[index];
+    if (worker.socket) {
+        worker.socket->disconnect(this);
+        worker.socket->deleteLater();
+        worker.socket = nullptr;
+    }
+    if (worker.process) {
+        worker.process->disconnect(this);
+        worker.process->deleteLater();
+    }
+    worker.connected = false;
+    worker.busy = false;
+    worker.timedOut = false;
+
+    auto* process = new QProcess(this);
+    // 工作进程的调试输出直接转发，不在主进程中缓存
+    process->setProcessChannelMode(QProcess::ForwardedChannels);
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    if (!environment.contains(QS("QT_QPA_PLATFORM"))) {
+        environment.insert(QS("QT_QPA_PLATFORM"), QS("offscreen"));
+    }
+    process->setProcessEnvironment(environment);
+
+    connect(process, &QProcess::finished, this, [this, index, process](int exitCode, QProcess::ExitStatus exitStatus) {
+        onWorkerFinished(index, process, exitCode, exitStatus);
+    });
+    connect(process, &QProcess::errorOccurred, this, [this, index, process](QProcess::ProcessError error) {
+        // 启动失败时不会发出finished
+        if (error == QProcess::FailedToStart) {
+            onWorkerFinished(index, process, -1, QProcess::CrashExit);
+        }
+    });
+
+    worker.process = process;
+    process->start(QCoreApplication::applicationFilePath(),
+                   {QString::fromLatin1(ConversionWorker::WORKER_ARGUMENT), m_serverName, QString::number(index)});
+}
+
+ConversionWorkerPool::Worker* ConversionWorkerPool::findWorker(QLocalSocket* socket)
+{
+    for (Worker& worker : m_workers) {
+        if (worker.socket == socket) {
+            return &worker;
+        }
+    }
+    return nullptr;
+}
+
+void ConversionWorkerPool::onSocketReadyRead(QLocalSocket* socket)
+{
+    for (const QByteArray& message : ConversionWorker::readMessages(*socket)) {
+        QDataStream stream(message);
+        switch (ConversionWorker::takeMessageType(stream)) {
+        case ConversionWorker::MessageType::HELLO:
+            onHello(socket, stream);
+            break;
+        case ConversionWorker::MessageType::RESULT:
+            if (Worker* worker = findWorker(socket)) {
+                onResult(*worker, stream);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void ConversionWorkerPool::onHello(QLocalSocket* socket, QDataStream& stream)
+{
+    qint32 index = -1;
+    qint64 pid = 0;
+    stream >> index >> pid;
+
+    // 只接受由本池启动的进程，其他连接直接断开
+    if (index < 0 || index >= m_workers.size() || !m_workers.at(index).process
+        || m_workers.at(index).process->processId() != pid) {
+        qDebug() << "ConversionWorkerPool: 拒绝未知的连接" << index << pid;
+        socket->disconnectFromServer();
+        return;
+    }
+
+    Worker& worker = m_workers[index];
+    worker.socket = socket;
+    worker.connected = true;
+    worker.startupFailures = 0;
+    dispatch();
+}
+
+void ConversionWorkerPool::onResult(Worker& worker, QDataStream& stream)
+{
+    ConversionWorker::JobResult jobResult;
+    stream >> jobResult;
+    if (!worker.busy || jobResult.jobId != worker.job.jobId) {
+        return;
+    }
+    worker.jobTimer->stop();
+
+    Result result;
+    result.status = JobStatus::FAILED;
+    result.error = jobResult.error;
+    if (jobResult.success) {
+        if (jobResult.sharedMemoryKey.isEmpty()) {
+            result.output = jobResult.inlineData;
+            result.status = JobStatus::SUCCESS;
+        } else if (readSharedMemory(jobResult.sharedMemoryKey, jobResult.size, result.output, result.error)) {
+            result.status = JobStatus::SUCCESS;
+        }
+    }
+
+    finishJob(worker, result);
+    dispatch();
+    checkIdle();
+}
+
+void ConversionWorkerPool::onWorkerFinished(int index, QProcess* process, int exitCode, QProcess::ExitStatus exitStatus)
+{
+    if (index >= m_workers.size() || m_workers.at(index).process != process) {
+        return;
+    }
+    Worker& worker = m_workers[index];
+    worker.jobTimer->stop();
+
+    const bool hadJob = worker.busy;
+    if (hadJob) {
+        Result result;
+        if (worker.timedOut) {
+            result.status = JobStatus::TIMED_OUT;
+            result.error = QS("任务超过%1毫秒未完成，工作进程已终止").arg(m_jobTimeout);
+        } else {
+            result.status = JobStatus::CRASHED;
+            result.error = exitStatus == QProcess::CrashExit ? QS("工作进程崩溃")
+                                                             : QS("工作进程意外退出，退出码%1").arg(exitCode);
+        }
+        qDebug() << "ConversionWorkerPool:" << worker.job.filePath << result.error;
+        finishJob(worker, result);
+    }
+
+    if (!m_running) {
+        return;
+    }
+
+    // 未完成握手就退出说明工作进程无法启动，连续失败后不再重启，避免反复拉起
+    if (!worker.connected && ++worker.startupFailures >= MAX_STARTUP_FAILURES) {
+        worker.disabled = true;
+        setLastError(QS("工作进程%1连续%2次启动失败").arg(index).arg(worker.startupFailures));
+        qDebug() << "ConversionWorkerPool:" << m_lastError;
+
+        const bool allDisabled = std::all_of(m_workers.cbegin(), m_workers.cend(),
+                                             [](const Worker& item) { return item.disabled; });
+        if (allDisabled) {
+            failQueuedJobs(JobStatus::FAILED, m_lastError);
+        }
+        if (hadJob || allDisabled) {
+            checkIdle();
+        }
+        return;
+    }
+
+    ++m_restartCount;
+    spawnWorker(index);
+    emit workerRestarted(index, exitCode);
+    if (hadJob) {
+        checkIdle();
+    }
+}
+
+void ConversionWorkerPool::onJobTimeout(int index)
+{
+    Worker& worker = m_workers[index];
+    if (!worker.busy || !worker.process) {
+        return;
+    }
+    qDebug() << "ConversionWorkerPool: 任务超时，终止工作进程" << index << worker.job.filePath;
+    worker.timedOut = true;
+    worker.process->kill();
+}
+
+void ConversionWorkerPool::dispatch()
+{
+    for (Worker& worker : m_workers) {
+        if (m_queue.isEmpty()) {
+            return;
+        }
+        if (worker.busy || !worker.socket) {
+            continue;
+        }
+
+        worker.job = m_queue.dequeue();
+        worker.busy = true;
+        worker.timedOut = false;
+        worker.elapsed.start();
+
+        QByteArray body;
+        QDataStream stream(&body, QIODevice::WriteOnly);
+        stream << worker.job;
+        ConversionWorker::writeMessage(*worker.socket, ConversionWorker::MessageType::JOB, body);
+        if (m_jobTimeout > 0) {
+            worker.jobTimer->start(m_jobTimeout);
+        }
+    }
+}
+
+void ConversionWorkerPool::finishJob(Worker& worker, Result& result)
+{
+    result.jobId = worker.job.jobId;
+    result.filePath = worker.job.filePath;
+    result.converter = worker.job.converter;
+    result.workerIndex = worker.index;
+    result.elapsedMs = worker.elapsed.isValid() ? worker.elapsed.elapsed() : 0;
+    worker.busy = false;
+    emit jobFinished(result);
+}
+
+void ConversionWorkerPool::failQueuedJobs(JobStatus status, const QString& error)
+{
+    while (!m_queue.isEmpty()) {
+        const ConversionWorker::Job job = m_queue.dequeue();
+        Result result;
+        result.jobId = job.jobId;
+        result.filePath = job.filePath;
+        result.converter = job.converter;
+        result.status = status;
+        result.error = error;
+        emit jobFinished(result);
+    }
+}
+
+void ConversionWorkerPool::checkIdle()
+{
+    if (m_queue.isEmpty() && pendingCount() == 0) {
+        emit idle();
+    }
+}
+
+bool ConversionWorkerPool::readSharedMemory(const QString& key, qint64 size, QByteArray& output, QString& error)
+{
+    QSharedMemory segment(key);
+    if (!segment.attach(QSharedMemory::ReadOnly)) {
+        error = QS("无法读取共享内存: %1").arg(segment.errorString());
+        return false;
+    }
+    if (size < 0 || segment.size() < size) {
+        error = QS("共享内存中的结果不完整");
+        return false;
+    }
+
+    segment.lock();
+    output = QByteArray(static_cast<const char*>(segment.constData()), size);
+    segment.unlock();
+    segment.detach();
+    return true;
+}
+
+void ConversionWorkerPool::setLastError(const QString& error)
+{
+    m_lastError = error;
+}
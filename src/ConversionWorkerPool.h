@@ -0,0 +1,190 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-19 00:10:00
+ * @LastEditTime: 2026-10-19 00:10:00
+ * @LastEditors: seelights
+ * @Description: 崩溃隔离的转换工作进程池
+ * @FilePath: \ReportMason\src\ConversionWorkerPool.h
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#pragma once
+
+#include "ConversionWorker.h"
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QProcess>
+#include <QQueue>
+#include <QString>
+
+class QLocalServer;
+class QLocalSocket;
+class QTimer;
+
+/**
+ * @brief 崩溃隔离的转换工作进程池
+ *
+ * Poppler在畸形文档上可能崩溃或陷入死循环，在主进程内转换时一份坏文件会拖垮整个应用或批处理。
+ * 工作进程池预先启动若干常驻的转换工作进程（ConversionWorker），通过本地套接字派发任务，
+ * 结果经共享内存取回。工作进程崩溃或任务超过硬时限被终止时，只有当前任务失败，
+ * 池会自动重启该工作进程并继续处理队列中的其他任务。
+ *
+ * 池依赖事件循环，所有方法须在创建池的线程中调用。
+ */
+class ConversionWorkerPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 任务结束状态
+     */
+    enum class JobStatus {
+        SUCCESS,   ///< 转换成功
+        FAILED,    ///< 转换器报告失败
+        CRASHED,   ///< 工作进程在任务执行期间异常退出
+        TIMED_OUT, ///< 超过硬时限，工作进程被终止
+        CANCELLED  ///< 池停止时任务尚未完成
+    };
+
+    /**
+     * @brief 任务结果
+     */
+    struct Result {
+        quint64 jobId = 0;
+        QString filePath;
+        ConversionWorker::Converter converter = ConversionWorker::Converter::LOSSLESS_XML;
+        JobStatus status = JobStatus::FAILED;
+        QByteArray output;    ///< 转换结果
+        QString error;        ///< 失败原因
+        int workerIndex = -1; ///< 执行任务的工作进程编号
+        qint64 elapsedMs = 0; ///< 从派发到结束的耗时
+    };
+
+    /**
+     * @brief 构造工作进程池
+     * @param workerCount 工作进程数，小于等于0时使用CPU核数
+     * @param parent 父对象
+     */
+    explicit ConversionWorkerPool(int workerCount = 0, QObject* parent = nullptr);
+    ~ConversionWorkerPool() override;
+
+    /**
+     * @brief 启动本地服务并预先启动全部工作进程
+     * @return 是否成功
+     */
+    bool start();
+
+    /**
+     * @brief 停止所有工作进程，未完成的任务以CANCELLED结束
+     */
+    void stop();
+
+    bool isRunning() const;
+
+    /**
+     * @brief 提交转换任务
+     * @param filePath 输入文件路径
+     * @param converter 转换器类型
+     * @return 任务编号，池未启动时为0
+     */
+    quint64 submit(const QString& filePath,
+                   ConversionWorker::Converter converter = ConversionWorker::Converter::LOSSLESS_XML);
+
+    /**
+     * @brief 排队和执行中的任务数
+     */
+    int pendingCount() const;
+
+    int workerCount() const;
+
+    /**
+     * @brief 工作进程被重启的次数
+     */
+    int restartCount() const;
+
+    /**
+     * @brief 设置单个任务的硬时限，超过后终止工作进程
+     *
+     * 应大于转换器自身的文档处理时限，只用于兜底协作式取消无法覆盖的死循环。
+     * @param milliseconds 时限（毫秒），小于等于0表示不限时
+     */
+    void setJobTimeout(int milliseconds);
+    int jobTimeout() const;
+
+    /**
+     * @brief 返回最近一次错误信息
+     */
+    QString lastError() const;
+
+    static constexpr int DEFAULT_JOB_TIMEOUT_MS = 15 * 60 * 1000;
+
+signals:
+    /**
+     * @brief 任务结束（无论成功与否）
+     */
+    void jobFinished(const ConversionWorkerPool::Result& result);
+
+    /**
+     * @brief 队列已清空且没有执行中的任务
+     */
+    void idle();
+
+    /**
+     * @brief 工作进程异常退出并已重新启动
+     * @param workerIndex 工作进程编号
+     * @param exitCode 退出码
+     */
+    void workerRestarted(int workerIndex, int exitCode);
+
+private slots:
+    void onNewConnection();
+
+private:
+    /**
+     * @brief 工作进程槽位
+     */
+    struct Worker {
+        int index = -1;
+        QProcess* process = nullptr;
+        QLocalSocket* socket = nullptr; ///< 收到HELLO后才关联
+        QTimer* jobTimer = nullptr;     ///< 硬时限计时器
+        bool connected = false;         ///< 本次启动已完成握手
+        bool busy = false;
+        bool timedOut = false;
+        ConversionWorker::Job job;      ///< 执行中的任务
+        QElapsedTimer elapsed;
+        int startupFailures = 0;        ///< 连续未能完成握手的启动次数
+        bool disabled = false;          ///< 连续启动失败后不再重启
+    };
+
+    void spawnWorker(int index);
+    Worker* findWorker(QLocalSocket* socket);
+    void onHello(QLocalSocket* socket, QDataStream& stream);
+    void onSocketReadyRead(QLocalSocket* socket);
+    void onResult(Worker& worker, QDataStream& stream);
+    void onWorkerFinished(int index, QProcess* process, int exitCode, QProcess::ExitStatus exitStatus);
+    void onJobTimeout(int index);
+    void dispatch();
+    void finishJob(Worker& worker, Result& result);
+    void failQueuedJobs(JobStatus status, const QString& error);
+    void checkIdle();
+    static bool readSharedMemory(const QString& key, qint64 size, QByteArray& output, QString& error);
+    void setLastError(const QString& error);
+
+    int m_workerCount;
+    int m_jobTimeout;
+    int m_restartCount;
+    quint64 m_nextJobId;
+    bool m_running;
+    QString m_serverName;
+    QLocalServer* m_server;
+    QList<Worker> m_workers;
+    QQueue<ConversionWorker::Job> m_queue;
+    QString m_lastError;
+
+    static constexpr int MAX_STARTUP_FAILURES = 3;
+    static constexpr int QUIT_TIMEOUT_MS = 3000;
+};
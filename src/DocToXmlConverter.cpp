@@ -9,6 +9,7 @@
  */
 #include "QtCompat.h"
 #include "DocToXmlConverter.h"
+#include "OoxmlTags.h"
 #include "kzip.h"
 #include "karchivedirectory.h"
 #include "karchivefile.h"
@@ -273,13 +274,11 @@ FileConverter::ConvertStatus DocToXmlConverter::extractTextContent(const QString
 
             if (token == QXmlStreamReader::StartElement) {
                 elementCount++;
-                QString elementName = reader.name().toString();
-                qDebug() << "DocToXmlConverter: 找到元素:" << elementName;
+                const OoxmlTag tag = OoxmlTags::lookup(reader.name());
 
-                if (elementName == QS("t")) {
+                if (tag == OoxmlTag::T) {
                     wTCount++;
                     QString text = reader.readElementText();
-                    qDebug() << "DocToXmlConverter: t元素内容:" << text;
                     if (!text.isEmpty()) {
                         paragraphs.append(text);
                     }
@@ -358,7 +357,7 @@ bool DocToXmlConverter::parseDocumentXml(const QByteArray& xmlContent,
     while (!reader.atEnd() && !reader.hasError()) {
         QXmlStreamReader::TokenType token = reader.readNext();
 
-        if (token == QXmlStreamReader::StartElement && reader.name() == QS("sdt")) {
+        if (token == QXmlStreamReader::StartElement && OoxmlTags::lookup(reader.name()) == OoxmlTag::Sdt) {
             if (!parseSdtElement(reader, fields)) {
                 return false;
             }
@@ -376,18 +375,20 @@ bool DocToXmlConverter::parseSdtElement(QXmlStreamReader& reader, QMap<QString,
     int depth = 0;
 
     // 解析SDT属性，获取标签名
-    while (reader.readNext() != QXmlStreamReader::EndElement || reader.name() != QS("sdt")) {
-        if (reader.tokenType() == QXmlStreamReader::StartElement) {
-            if (reader.name() == QS("tag")) {
+    QXmlStreamReader::TokenType token;
+    while ((token = reader.readNext()) != QXmlStreamReader::EndElement ||
+           OoxmlTags::lookup(reader.name()) != OoxmlTag::Sdt) {
+        const OoxmlTag tag = OoxmlTags::lookup(reader.name());
+        if (token == QXmlStreamReader::StartElement) {
+            if (tag == OoxmlTag::Tag) {
                 tagName = reader.attributes().value(QS("val")).toString();
-            } else if (reader.name() == QS("sdtContent")) {
+            } else if (tag == OoxmlTag::SdtContent) {
                 inSdtContent = true;
                 depth++; // 手动跟踪深度
-            } else if (inSdtContent && reader.name() == QS("t")) {
+            } else if (inSdtContent && tag == OoxmlTag::T) {
                 content += reader.readElementText();
             }
-        } else if (reader.tokenType() == QXmlStreamReader::EndElement &&
-                   reader.name() == QS("sdtContent")) {
+        } else if (token == QXmlStreamReader::EndElement && tag == OoxmlTag::SdtContent) {
             inSdtContent = false;
             depth--; // 手动跟踪深度
         }
@@ -0,0 +1,417 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-19 01:30:00
+ * @LastEditTime: 2026-10-19 01:30:00
+ * @LastEditors: seelights
+ * @Description: 分阶段文档转换流水线实现
+ * @FilePath: \ReportMason\src\DocumentPipeline.cpp
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#include "DocumentPipeline.h"
+#include "QtCompat.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QThread>
+#include <QWaitCondition>
+#include <deque>
+#include <memory>
+
+namespace {
+
+QString statusMessage(LosslessDocumentConverter::ConvertStatus status)
+{
+    switch (status) {
+    case LosslessDocumentConverter::ConvertStatus::SUCCESS:
+        return QString();
+    case LosslessDocumentConverter::ConvertStatus::FILE_NOT_FOUND:
+        return QS("文件不存在或无法读取");
+    case LosslessDocumentConverter::ConvertStatus::INVALID_FORMAT:
+        return QS("不支持的文件格式");
+    case LosslessDocumentConverter::ConvertStatus::PARSE_ERROR:
+        return QS("文档解析失败");
+    case LosslessDocumentConverter::ConvertStatus::WRITE_ERROR:
+        return QS("写入失败");
+    case LosslessDocumentConverter::ConvertStatus::UNKNOWN_ERROR:
+        break;
+    }
+    return QS("未知错误");
+}
+
+} // namespace
+
+/**
+ * @brief 流水线中传递的文档
+ */
+struct DocumentPipeline::Item {
+    int index = -1;
+    QString outputPath;
+    LosslessDocumentConverter::StagedDocument document;
+    LosslessDocumentConverter::ConvertStatus status = LosslessDocumentConverter::ConvertStatus::SUCCESS;
+    Stage failedStage = Stage::READ;
+    QString error;
+    QElapsedTimer latency;
+};
+
+/**
+ * @brief 阶段之间的有界队列
+ *
+ * 队列满时push阻塞，空时pop阻塞；上游全部线程结束后close，
+ * 下游线程取完剩余文档后pop返回空指针。
+ */
+class DocumentPipeline::Queue
+{
+public:
+    explicit Queue(int capacity) : m_capacity(capacity), m_closed(false), m_maxDepth(0) {}
+
+    /**
+     * @brief 放入文档，队列满时等待
+     * @param blockedMs 累加等待的时间
+     */
+    void push(std::unique_ptr<Item> item, qint64& blockedMs)
+    {
+        QMutexLocker locker(&m_mutex);
+        if (static_cast<int>(m_items.size()) >= m_capacity) {
+            QElapsedTimer waited;
+            waited.start();
+            while (static_cast<int>(m_items.size()) >= m_capacity) {
+                m_notFull.wait(&m_mutex);
+            }
+            blockedMs += waited.elapsed();
+        }
+        m_items.push_back(std::move(item));
+        m_maxDepth = qMax(m_maxDepth, static_cast<int>(m_items.size()));
+        m_notEmpty.wakeOne();
+    }
+
+    /**
+     * @brief 取出文档，队列空时等待
+     * @param starvedMs 累加等待的时间
+     * @return 文档；队列已关闭且为空时返回空指针
+     */
+    std::unique_ptr<Item> pop(qint64& starvedMs)
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_items.empty() && !m_closed) {
+            QElapsedTimer waited;
+            waited.start();
+            while (m_items.empty() && !m_closed) {
+                m_notEmpty.wait(&m_mutex);
+            }
+            starvedMs += waited.elapsed();
+        }
+        if (m_items.empty()) {
+            return nullptr;
+        }
+        std::unique_ptr<Item> item = std::move(m_items.front());
+        m_items.pop_front();
+        m_notFull.wakeOne();
+        return item;
+    }
+
+    /**
+     * @brief 不再有新的文档，唤醒所有等待的下游线程
+     */
+    void close()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_closed = true;
+        m_notEmpty.wakeAll();
+    }
+
+    int maxDepth() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_maxDepth;
+    }
+
+private:
+    mutable QMutex m_mutex;
+    QWaitCondition m_notEmpty;
+    QWaitCondition m_notFull;
+    std::deque<std::unique_ptr<Item>> m_items;
+    int m_capacity;
+    bool m_closed;
+    int m_maxDepth;
+};
+
+DocumentPipeline::DocumentPipeline(QObject* parent)
+    : QObject(parent),
+      m_stageWorkers({1, 1, qMax(1, QThread::idealThreadCount()), 1, 1}),
+      m_queueCapacity(DEFAULT_QUEUE_CAPACITY),
+      m_cancelRequested(false),
+      m_running(false),
+      m_finalElapsedMs(0)
+{
+    for (std::atomic_int& active : m_activeWorkers) {
+        active = 0;
+    }
+}
+
+DocumentPipeline::~DocumentPipeline()
+{
+    cancel();
+    m_pool.waitForDone();
+    qDeleteAll(m_queues);
+}
+
+void DocumentPipeline::setStageWorkers(Stage stage, int workers)
+{
+    m_stageWorkers[static_cast<int>(stage)] = qMax(1, workers);
+}
+
+int DocumentPipeline::stageWorkers(Stage stage) const
+{
+    return m_stageWorkers.at(static_cast<int>(stage));
+}
+
+void DocumentPipeline::setQueueCapacity(int capacity)
+{
+    m_queueCapacity = qMax(1, capacity);
+}
+
+int DocumentPipeline::queueCapacity() const
+{
+    return m_queueCapacity;
+}
+
+bool DocumentPipeline::start(const QList<Job>& jobs)
+{
+    if (m_running) {
+        return false;
+    }
+    // 上一次运行的线程可能还在从finished信号中返回
+    m_pool.waitForDone();
+
+    qDeleteAll(m_queues);
+    m_queues.clear();
+    m_metrics.clear();
+    int totalWorkers = 0;
+    for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+        m_queues.append(new Queue(m_queueCapacity));
+        StageMetrics metrics;
+        metrics.stage = static_cast<Stage>(stage);
+        metrics.workers = m_stageWorkers.at(stage);
+        m_metrics.append(metrics);
+        m_activeWorkers[stage] = m_stageWorkers.at(stage);
+        totalWorkers += m_stageWorkers.at(stage);
+    }
+
+    m_cancelRequested = false;
+    m_running = true;
+    m_finalElapsedMs = 0;
+    m_elapsed.start();
+
+    // 阶段线程在队列上阻塞等待，必须全部同时运行，再加一个线程投放任务
+    m_pool.setMaxThreadCount(totalWorkers + 1);
+    for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+        for (int worker = 0; worker < m_stageWorkers.at(stage); ++worker) {
+            m_pool.start([this, stage]() { runStage(stage); });
+        }
+    }
+    m_pool.start([this, jobs]() { feed(jobs); });
+
+    qDebug() << "DocumentPipeline: 启动" << jobs.size() << "个任务，阶段线程数" << m_stageWorkers
+             << "，队列容量" << m_queueCapacity;
+    return true;
+}
+
+void DocumentPipeline::cancel()
+{
+    m_cancelRequested = true;
+}
+
+bool DocumentPipeline::waitForFinished(int milliseconds)
+{
+    return m_pool.waitForDone(milliseconds);
+}
+
+bool DocumentPipeline::isRunning() const
+{
+    return m_running;
+}
+
+QList<DocumentPipeline::StageMetrics> DocumentPipeline::metrics() const
+{
+    const qint64 wallMs = elapsedMs();
+    QMutexLocker locker(&m_metricsMutex);
+    QList<StageMetrics> result;
+    for (int stage = 0; stage < m_metrics.size(); ++stage) {
+        StageMetrics metrics = m_metrics.at(stage);
+        metrics.maxQueueDepth = m_queues.at(stage)->maxDepth();
+        if (wallMs > 0 && metrics.workers > 0) {
+            metrics.utilization = static_cast<double>(metrics.busyMs) / (static_cast<double>(wallMs) * metrics.workers);
+        }
+        result.append(metrics);
+    }
+    return result;
+}
+
+qint64 DocumentPipeline::elapsedMs() const
+{
+    return m_running ? m_elapsed.elapsed() : m_finalElapsedMs;
+}
+
+QString DocumentPipeline::stageName(Stage stage)
+{
+    switch (stage) {
+    case Stage::READ:
+        return QS("read");
+    case Stage::UNPACK:
+        return QS("unpack");
+    case Stage::PARSE:
+        return QS("parse");
+    case Stage::EXTRACT:
+        return QS("extract");
+    case Stage::SERIALIZE:
+        return QS("serialize");
+    }
+    return QString();
+}
+
+void DocumentPipeline::feed(const QList<Job>& jobs)
+{
+    for (int index = 0; index < jobs.size(); ++index) {
+        auto item = std::make_unique<Item>();
+        item->index = index;
+        item->document.filePath = jobs.at(index).filePath;
+        item->outputPath = jobs.at(index).outputPath;
+        item->latency.start();
+
+        if (m_cancelRequested) {
+            item->status = LosslessDocumentConverter::ConvertStatus::UNKNOWN_ERROR;
+            item->error = QS("已取消");
+            finishItem(*item);
+            continue;
+        }
+
+        // read队列满时在这里等待，背压一直传到任务来源
+        qint64 blockedMs = 0;
+        m_queues.first()->push(std::move(item), blockedMs);
+    }
+    m_queues.first()->close();
+}
+
+void DocumentPipeline::runStage(int stage)
+{
+    // 转换器带有每份文档的解析状态，每个线程各用一个
+    LosslessDocumentConverter converter;
+    Queue* input = m_queues.at(stage);
+    Queue* output = stage + 1 < STAGE_COUNT ? m_queues.at(stage + 1) : nullptr;
+
+    while (true) {
+        qint64 starvedMs = 0;
+        std::unique_ptr<Item> item = input->pop(starvedMs);
+        if (!item) {
+            addMetrics(stage, 0, starvedMs, 0, 0);
+            break;
+        }
+
+        QElapsedTimer busy;
+        busy.start();
+        bool forward = false;
+        if (m_cancelRequested) {
+            item->status = LosslessDocumentConverter::ConvertStatus::UNKNOWN_ERROR;
+            item->failedStage = static_cast<Stage>(stage);
+            item->error = QS("已取消");
+        } else {
+            forward = processItem(stage, converter, *item);
+        }
+        const qint64 busyMs = busy.elapsed();
+
+        qint64 blockedMs = 0;
+        if (forward && output) {
+            output->push(std::move(item), blockedMs);
+        } else {
+            finishItem(*item);
+        }
+        addMetrics(stage, busyMs, starvedMs, blockedMs, 1);
+    }
+
+    // 本阶段最后一个线程退出时关闭下游队列；serialize阶段全部退出意味着整批结束
+    if (--m_activeWorkers[stage] > 0) {
+        return;
+    }
+    if (output) {
+        output->close();
+        return;
+    }
+    m_finalElapsedMs = m_elapsed.elapsed();
+    m_running = false;
+    qDebug() << "DocumentPipeline: 完成，耗时" << m_finalElapsedMs << "ms";
+    emit finished();
+}
+
+bool DocumentPipeline::processItem(int stage, LosslessDocumentConverter& converter, Item& item)
+{
+    using ConvertStatus = LosslessDocumentConverter::ConvertStatus;
+    ConvertStatus status = ConvertStatus::UNKNOWN_ERROR;
+    QString error;
+
+    switch (static_cast<Stage>(stage)) {
+    case Stage::READ:
+        status = converter.readStage(item.document);
+        break;
+    case Stage::UNPACK:
+        status = converter.unpackStage(item.document);
+        break;
+    case Stage::PARSE:
+        status = converter.parseStage(item.document);
+        break;
+    case Stage::EXTRACT:
+        status = converter.extractStage(item.document);
+        break;
+    case Stage::SERIALIZE:
+        status = converter.serializeStage(item.document);
+        if (status == ConvertStatus::SUCCESS && !item.outputPath.isEmpty()) {
+            // 先写临时文件再替换，中断时不会留下截断的结果
+            QDir().mkpath(QFileInfo(item.outputPath).absolutePath());
+            QSaveFile file(item.outputPath);
+            if (!file.open(QIODevice::WriteOnly) || file.write(item.document.xml) != item.document.xml.size()
+                || !file.commit()) {
+                status = ConvertStatus::WRITE_ERROR;
+                error = QS("写入输出文件失败: %1").arg(file.errorString());
+            }
+        }
+        break;
+    }
+
+    if (status == ConvertStatus::SUCCESS) {
+        return true;
+    }
+    item.status = status;
+    item.failedStage = static_cast<Stage>(stage);
+    item.error = error.isEmpty() ? statusMessage(status) : error;
+    return false;
+}
+
+void DocumentPipeline::finishItem(Item& item)
+{
+    Result result;
+    result.index = item.index;
+    result.filePath = item.document.filePath;
+    result.status = item.status;
+    result.failedStage = item.failedStage;
+    result.error = item.error;
+    result.latencyMs = item.latency.isValid() ? item.latency.elapsed() : 0;
+    if (item.status == LosslessDocumentConverter::ConvertStatus::SUCCESS) {
+        result.outputPath = item.outputPath;
+        result.outputBytes = item.document.xml.size();
+        if (item.outputPath.isEmpty()) {
+            result.xml = item.document.xml;
+        }
+    }
+    emit documentFinished(result);
+}
+
+void DocumentPipeline::addMetrics(int stage, qint64 busyMs, qint64 starvedMs, qint64 blockedMs, qint64 processed)
+{
+    QMutexLocker locker(&m_metricsMutex);
+    StageMetrics& metrics = m_metrics[stage];
+    metrics.processed += processed;
+    metrics.busyMs += busyMs;
+    metrics.starvedMs += starvedMs;
+    metrics.blockedMs += blockedMs;
+}
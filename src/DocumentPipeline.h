@@ -0,0 +1,181 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-19 01:30:00
+ * @LastEditTime: 2026-10-19 01:30:00
+ * @LastEditors: seelights
+ * @Description: 分阶段文档转换流水线
+ * @FilePath: \ReportMason\src\DocumentPipeline.h
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#pragma once
+
+#include "LosslessDocumentConverter.h"
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+#include <atomic>
+
+/**
+ * @brief 分阶段文档转换流水线
+ *
+ * 单次无损转换中的读文件、解压、解析、提取和序列化原本在一个线程中依次执行。
+ * 流水线把它们拆成五个阶段，每个阶段有独立的工作线程数，阶段之间用有界队列连接：
+ * 读取第N+1份文档的同时可以提取第N份、序列化第N-1份。
+ * 下游队列满时上游线程阻塞等待（背压），内存中同时存在的文档数不超过各队列容量与线程数之和。
+ *
+ * 每个阶段线程持有自己的LosslessDocumentConverter，同一份文档在阶段之间顺序传递。
+ * unpack阶段加载的PDF文档要交给parse阶段的线程，因此不从PdfDocumentPool借用，而是单独加载。
+ * 与ConversionWorkerPool不同，流水线在当前进程中执行，不隔离崩溃。
+ */
+class DocumentPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 流水线阶段
+     */
+    enum class Stage {
+        READ,     ///< 读入文件
+        UNPACK,   ///< 解压DOCX部件 / 加载PDF文档
+        PARSE,    ///< 解析文档内容
+        EXTRACT,  ///< 建立元素关系
+        SERIALIZE ///< 生成XML并写出
+    };
+    static constexpr int STAGE_COUNT = 5;
+
+    /**
+     * @brief 转换任务
+     */
+    struct Job {
+        QString filePath;
+        QString outputPath; ///< 为空时结果保留在Result::xml中
+    };
+
+    /**
+     * @brief 单个文档的转换结果
+     */
+    struct Result {
+        int index = -1; ///< 任务在start参数中的位置
+        QString filePath;
+        QString outputPath;
+        LosslessDocumentConverter::ConvertStatus status = LosslessDocumentConverter::ConvertStatus::UNKNOWN_ERROR;
+        Stage failedStage = Stage::READ; ///< 失败时所在的阶段
+        QString error;
+        QByteArray xml;                  ///< outputPath为空时的转换结果
+        qint64 outputBytes = 0;
+        qint64 latencyMs = 0;            ///< 从进入read阶段到离开serialize阶段的耗时
+    };
+
+    /**
+     * @brief 阶段统计
+     */
+    struct StageMetrics {
+        Stage stage = Stage::READ;
+        int workers = 0;
+        qint64 processed = 0;  ///< 处理过的文档数
+        qint64 busyMs = 0;     ///< 处理文档的累计耗时
+        qint64 starvedMs = 0;  ///< 等待上游输入的累计耗时
+        qint64 blockedMs = 0;  ///< 下游队列已满时等待的累计耗时（背压）
+        int maxQueueDepth = 0; ///< 输入队列出现过的最大深度
+        double utilization = 0.0; ///< busyMs / (墙钟耗时 × 线程数)
+    };
+
+    explicit DocumentPipeline(QObject* parent = nullptr);
+    ~DocumentPipeline() override;
+
+    /**
+     * @brief 设置阶段的工作线程数
+     * @param stage 阶段
+     * @param workers 线程数，小于1时按1处理
+     */
+    void setStageWorkers(Stage stage, int workers);
+    int stageWorkers(Stage stage) const;
+
+    /**
+     * @brief 设置阶段之间每个队列的容量
+     * @param capacity 容量，小于1时按1处理
+     */
+    void setQueueCapacity(int capacity);
+    int queueCapacity() const;
+
+    /**
+     * @brief 启动流水线，立即返回
+     *
+     * 每个文档结束时（在流水线线程中）发出documentFinished，全部结束后发出finished。
+     * @param jobs 转换任务
+     * @return 是否成功启动；流水线正在运行时返回false
+     */
+    bool start(const QList<Job>& jobs);
+
+    /**
+     * @brief 请求取消，尚未进入流水线的文档以CANCELLED错误结束；可以从任意线程调用
+     */
+    void cancel();
+
+    /**
+     * @brief 等待流水线结束
+     * @param milliseconds 最长等待时间，-1表示一直等待
+     * @return 是否已结束
+     */
+    bool waitForFinished(int milliseconds = -1);
+
+    bool isRunning() const;
+
+    /**
+     * @brief 各阶段统计，运行中调用返回当前快照
+     */
+    QList<StageMetrics> metrics() const;
+
+    /**
+     * @brief 本次运行的墙钟耗时
+     */
+    qint64 elapsedMs() const;
+
+    /**
+     * @brief 阶段名称
+     */
+    static QString stageName(Stage stage);
+
+    static constexpr int DEFAULT_QUEUE_CAPACITY = 4;
+
+signals:
+    /**
+     * @brief 单个文档转换结束（无论成功与否），在流水线线程中发出
+     */
+    void documentFinished(const DocumentPipeline::Result& result);
+
+    /**
+     * @brief 全部文档已结束，在流水线线程中发出
+     */
+    void finished();
+
+private:
+    class Queue;
+    struct Item;
+
+    void feed(const QList<Job>& jobs);
+    void runStage(int stage);
+    bool processItem(int stage, LosslessDocumentConverter& converter, Item& item);
+    void finishItem(Item& item);
+    void addMetrics(int stage, qint64 busyMs, qint64 starvedMs, qint64 blockedMs, qint64 processed);
+
+    QVector<int> m_stageWorkers;
+    int m_queueCapacity;
+    QThreadPool m_pool; ///< 流水线专用线程池，不占用全局线程池
+
+    QList<Queue*> m_queues;              ///< m_queues[i]是第i个阶段的输入队列
+    std::atomic_int m_activeWorkers[STAGE_COUNT]; ///< 各阶段仍在运行的线程数，归零时关闭下游队列
+    std::atomic_bool m_cancelRequested;
+    std::atomic_bool m_running;
+
+    mutable QMutex m_metricsMutex;
+    QVector<StageMetrics> m_metrics;
+    QElapsedTimer m_elapsed;
+    qint64 m_finalElapsedMs;
+};
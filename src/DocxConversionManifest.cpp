@@ -0,0 +1,312 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 11:05:00
+ * @LastEditTime: 2026-10-18 11:05:00
+ * @LastEditors: seelights
+ * @Description: DOCX增量转换清单实现
+ * @FilePath: \ReportMason\src\DocxConversionManifest.cpp
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#include "DocxConversionManifest.h"
+#include "QtCompat.h"
+#include <QByteArrayView>
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QSaveFile>
+
+namespace {
+
+/**
+ * @brief 获取标签的本地名（去掉命名空间前缀）
+ */
+QByteArray tagLocalName(const QByteArray& data, qsizetype nameStart)
+{
+    qsizetype end = nameStart;
+    while (end < data.size()) {
+        const char c = data.at(end);
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '/' || c == '>') {
+            break;
+        }
+        ++end;
+    }
+    QByteArray name = data.mid(nameStart, end - nameStart);
+    const qsizetype colon = name.indexOf(':');
+    return colon >= 0 ? name.mid(colon + 1) : name;
+}
+
+/**
+ * @brief 判断指定位置是否以给定字面量开头（不复制数据）
+ */
+bool startsAt(const QByteArray& data, qsizetype pos, const char* literal)
+{
+    return QByteArrayView(data).sliced(pos).startsWith(QByteArrayView(literal));
+}
+
+} // namespace
+
+bool DocxConversionManifest::load(const QString& manifestPath)
+{
+    clear();
+
+    QFile file(manifestPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+        qDebug() << "增量清单解析失败:" << manifestPath << error.errorString();
+        return false;
+    }
+
+    const QJsonObject root = doc.object();
+    if (root.value(QS("version")).toInt() != MANIFEST_VERSION) {
+        return false;
+    }
+
+    sourcePath = root.value(QS("source")).toString();
+    documentHash = root.value(QS("document")).toString().toLatin1();
+    prologHash = root.value(QS("prolog")).toString().toLatin1();
+    outputSize = static_cast<qint64>(root.value(QS("outputSize")).toDouble(-1));
+    outputModified = static_cast<qint64>(root.value(QS("outputModified")).toDouble(-1));
+
+    const QJsonObject partsObject = root.value(QS("parts")).toObject();
+    for (auto it = partsObject.constBegin(); it != partsObject.constEnd(); ++it) {
+        const QJsonObject partObject = it.value().toObject();
+        KZipUtils::EntryInfo info;
+        info.path = it.key();
+        info.crc32 = static_cast<quint32>(partObject.value(QS("crc32")).toDouble());
+        info.size = static_cast<qint64>(partObject.value(QS("size")).toDouble());
+        parts.insert(info.path, info);
+    }
+
+    const QJsonArray blocksArray = root.value(QS("blocks")).toArray();
+    blocks.reserve(blocksArray.size());
+    for (const QJsonValue& value : blocksArray) {
+        const QJsonObject blockObject = value.toObject();
+        Block block;
+        block.hash = blockObject.value(QS("hash")).toString().toLatin1();
+        block.elementCount = blockObject.value(QS("count")).toInt();
+        block.fragment = blockObject.value(QS("xml")).toString().toUtf8();
+        blocks.append(block);
+    }
+
+    return true;
+}
+
+bool DocxConversionManifest::save(const QString& manifestPath) const
+{
+    QJsonObject partsObject;
+    for (auto it = parts.constBegin(); it != parts.constEnd(); ++it) {
+        QJsonObject partObject;
+        partObject[QS("crc32")] = static_cast<double>(it.value().crc32);
+        partObject[QS("size")] = static_cast<double>(it.value().size);
+        partsObject[it.key()] = partObject;
+    }
+
+    QJsonArray blocksArray;
+    for (const Block& block : blocks) {
+        QJsonObject blockObject;
+        blockObject[QS("hash")] = QString::fromLatin1(block.hash);
+        blockObject[QS("count")] = block.elementCount;
+        blockObject[QS("xml")] = QString::fromUtf8(block.fragment);
+        blocksArray.append(blockObject);
+    }
+
+    QJsonObject root;
+    root[QS("version")] = MANIFEST_VERSION;
+    root[QS("source")] = sourcePath;
+    root[QS("document")] = QString::fromLatin1(documentHash);
+    root[QS("prolog")] = QString::fromLatin1(prologHash);
+    root[QS("outputSize")] = static_cast<double>(outputSize);
+    root[QS("outputModified")] = static_cast<double>(outputModified);
+    root[QS("parts")] = partsObject;
+    root[QS("blocks")] = blocksArray;
+
+    // 先写临时文件再替换，避免中断时留下损坏的清单
+    QSaveFile file(manifestPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "无法写入增量清单:" << manifestPath;
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
+
+void DocxConversionManifest::clear()
+{
+    sourcePath.clear();
+    parts.clear();
+    documentHash.clear();
+    prologHash.clear();
+    blocks.clear();
+    outputSize = -1;
+    outputModified = -1;
+}
+
+int DocxConversionManifest::elementCount() const
+{
+    int count = 0;
+    for (const Block& block : blocks) {
+        count += block.elementCount;
+    }
+    return count;
+}
+
+bool DocxConversionManifest::matchesOutput(const QString& outputPath) const
+{
+    const QFileInfo info(outputPath);
+    return info.exists() && outputSize >= 0 && info.size() == outputSize &&
+           info.lastModified().toMSecsSinceEpoch() == outputModified;
+}
+
+void DocxConversionManifest::recordOutput(const QString& outputPath)
+{
+    const QFileInfo info(outputPath);
+    outputSize = info.exists() ? info.size() : -1;
+    outputModified = info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1;
+}
+
+bool DocxConversionManifest::isGlobalPart(const QString& path)
+{
+    if (path == QS("word/document.xml")) {
+        return false;
+    }
+    return path.startsWith(QS("word/")) || path == QS("[Content_Types].xml");
+}
+
+QByteArray DocxConversionManifest::entryDigest(const KZipUtils::EntryInfo& entry)
+{
+    return QByteArray::number(entry.crc32, 16) + ':' + QByteArray::number(entry.size);
+}
+
+QByteArray DocxConversionManifest::hashBlock(const QByteArray& data)
+{
+    return QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex();
+}
+
+bool DocxConversionManifest::splitBody(const QByteArray& documentXml, QByteArray& prolog,
+                                       QList<QByteArray>& blocks, QByteArray& epilog)
+{
+    blocks.clear();
+
+    const qsizetype size = documentXml.size();
+    qsizetype pos = 0;
+    int depth = 0;
+    bool inBody = false;
+    qsizetype bodyContentStart = -1;
+    qsizetype bodyEnd = -1;
+    qsizetype blockStart = -1;
+
+    while (pos < size) {
+        if (documentXml.at(pos) != '<') {
+            ++pos;
+            continue;
+        }
+
+        // 处理指令、注释、CDATA和DOCTYPE不影响层级
+        if (startsAt(documentXml, pos, "<?")) {
+            const qsizetype end = documentXml.indexOf("?>", pos);
+            if (end < 0) {
+                return false;
+            }
+            pos = end + 2;
+            continue;
+        }
+        if (startsAt(documentXml, pos, "<!--")) {
+            const qsizetype end = documentXml.indexOf("-->", pos);
+            if (end < 0) {
+                return false;
+            }
+            pos = end + 3;
+            continue;
+        }
+        if (startsAt(documentXml, pos, "<![CDATA[")) {
+            const qsizetype end = documentXml.indexOf("]]>", pos);
+            if (end < 0) {
+                return false;
+            }
+            pos = end + 3;
+            continue;
+        }
+        if (startsAt(documentXml, pos, "<!")) {
+            const qsizetype end = documentXml.indexOf('>', pos);
+            if (end < 0) {
+                return false;
+            }
+            pos = end + 1;
+            continue;
+        }
+
+        // 查找标签结束位置，跳过属性值中的'>'
+        const bool closing = pos + 1 < size && documentXml.at(pos + 1) == '/';
+        qsizetype tagEnd = pos + 1;
+        char quote = 0;
+        for (; tagEnd < size; ++tagEnd) {
+            const char c = documentXml.at(tagEnd);
+            if (quote) {
+                if (c == quote) {
+                    quote = 0;
+                }
+            } else if (c == '"' || c == '\'') {
+                quote = c;
+            } else if (c == '>') {
+                break;
+            }
+        }
+        if (tagEnd >= size) {
+            return false;
+        }
+
+        if (closing) {
+            --depth;
+            if (inBody && depth == 2 && blockStart >= 0) {
+                blocks.append(documentXml.mid(blockStart, tagEnd + 1 - blockStart));
+                blockStart = -1;
+            } else if (inBody && depth == 1) {
+                bodyEnd = pos;
+                inBody = false;
+            }
+        } else {
+            const bool selfClosing = documentXml.at(tagEnd - 1) == '/';
+            if (inBody && depth == 2) {
+                if (selfClosing) {
+                    blocks.append(documentXml.mid(pos, tagEnd + 1 - pos));
+                } else {
+                    blockStart = pos;
+                }
+            } else if (depth == 1 && bodyContentStart < 0 && tagLocalName(documentXml, pos + 1) == "body") {
+                if (selfClosing) {
+                    // 空文档
+                    bodyContentStart = tagEnd + 1;
+                    bodyEnd = tagEnd + 1;
+                } else {
+                    inBody = true;
+                    bodyContentStart = tagEnd + 1;
+                }
+            }
+            if (!selfClosing) {
+                ++depth;
+            }
+        }
+
+        pos = tagEnd + 1;
+    }
+
+    if (bodyContentStart < 0 || bodyEnd < 0 || depth != 0) {
+        return false;
+    }
+
+    prolog = documentXml.left(bodyContentStart);
+    epilog = documentXml.mid(bodyEnd);
+    return true;
+}
@@ -0,0 +1,129 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 11:05:00
+ * @LastEditTime: 2026-10-18 11:05:00
+ * @LastEditors: seelights
+ * @Description: DOCX增量转换清单
+ * @FilePath: \ReportMason\src\DocxConversionManifest.h
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#pragma once
+
+#include "KZipUtils.h"
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+#include <QString>
+
+/**
+ * @brief DOCX增量转换清单
+ *
+ * 记录上一次转换时各ZIP部件的(CRC32, 大小)，以及document.xml中
+ * w:body下每个顶层块（段落、表格、分节属性等）的内容哈希和对应的输出XML片段。
+ * 再次转换同一份报告时，只需重新解析发生变化的块，其余块直接复用旧片段。
+ */
+class DocxConversionManifest
+{
+public:
+    /**
+     * @brief 顶层块记录
+     */
+    struct Block {
+        QByteArray hash;     ///< 块原始字节的哈希
+        int elementCount;    ///< 该块生成的元素数量
+        QByteArray fragment; ///< 该块生成的输出XML片段
+
+        Block() : elementCount(0) {}
+    };
+
+    QString sourcePath;                          ///< 源文件路径
+    QMap<QString, KZipUtils::EntryInfo> parts;   ///< 影响全局解析结果的部件
+    QByteArray documentHash;                     ///< document.xml的(CRC32, 大小)摘要
+    QByteArray prologHash;                       ///< w:body之前内容（根元素、命名空间）的哈希
+    QList<Block> blocks;                         ///< 按文档顺序排列的顶层块
+    qint64 outputSize;                           ///< 写出的输出文件大小
+    qint64 outputModified;                       ///< 写出的输出文件修改时间（毫秒时间戳）
+
+    DocxConversionManifest() : outputSize(-1), outputModified(-1) {}
+
+    /**
+     * @brief 从文件加载清单
+     * @param manifestPath 清单文件路径
+     * @return 是否加载成功
+     */
+    bool load(const QString& manifestPath);
+
+    /**
+     * @brief 保存清单到文件
+     * @param manifestPath 清单文件路径
+     * @return 是否保存成功
+     */
+    bool save(const QString& manifestPath) const;
+
+    /**
+     * @brief 清空清单
+     */
+    void clear();
+
+    /**
+     * @brief 获取清单中记录的元素总数
+     */
+    int elementCount() const;
+
+    /**
+     * @brief 判断输出文件是否仍是本清单记录时写出的文件
+     *
+     * 输出文件被删除、被全量转换覆盖或被其他程序修改后，不能再直接沿用。
+     * @param outputPath 输出文件路径
+     * @return 大小和修改时间是否与记录一致
+     */
+    bool matchesOutput(const QString& outputPath) const;
+
+    /**
+     * @brief 记录输出文件的当前大小和修改时间
+     * @param outputPath 输出文件路径
+     */
+    void recordOutput(const QString& outputPath);
+
+    /**
+     * @brief 判断部件是否影响全局解析结果
+     *
+     * document.xml按块比较，docProps下的部件每次保存都会变化但不影响内容，
+     * 其余word/下的部件（样式、编号、关系、媒体等）变化时需要全部重新解析。
+     * @param path 部件路径
+     * @return 是否为全局部件
+     */
+    static bool isGlobalPart(const QString& path);
+
+    /**
+     * @brief 计算document.xml条目的摘要
+     * @param entry ZIP条目信息
+     * @return 摘要
+     */
+    static QByteArray entryDigest(const KZipUtils::EntryInfo& entry);
+
+    /**
+     * @brief 计算块内容哈希
+     * @param data 块原始字节
+     * @return 哈希值
+     */
+    static QByteArray hashBlock(const QByteArray& data);
+
+    /**
+     * @brief 按字节将document.xml拆分为w:body前缀、顶层块和后缀
+     *
+     * 只做标签层级扫描，不解码文本，拆分结果可以拼接为只含单个块的合法文档：
+     * prolog + block + epilog。
+     * @param documentXml document.xml内容
+     * @param prolog 输出的w:body开始标签及之前的内容
+     * @param blocks 输出的顶层块列表
+     * @param epilog 输出的w:body结束标签及之后的内容
+     * @return 是否拆分成功
+     */
+    static bool splitBody(const QByteArray& documentXml, QByteArray& prolog,
+                          QList<QByteArray>& blocks, QByteArray& epilog);
+
+private:
+    static const int MANIFEST_VERSION = 2;
+};
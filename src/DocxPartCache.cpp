@@ -0,0 +1,139 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 10:20:00
+ * @LastEditTime: 2026-10-18 10:20:00
+ * @LastEditors: seelights
+ * @Description: DOCX部件级解析结果缓存实现
+ * @FilePath: \ReportMason\src\DocxPartCache.cpp
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#include "DocxPartCache.h"
+#include "DocxStyleResolver.h"
+#include <QMutexLocker>
+
+DocxPartCache::DocxPartCache()
+    : m_relationships(DEFAULT_MAX_ENTRIES), m_imageMeta(DEFAULT_MAX_ENTRIES),
+      m_styles(DEFAULT_MAX_ENTRIES), m_hits(0), m_misses(0)
+{
+}
+
+DocxPartCache* DocxPartCache::instance()
+{
+    // 函数内静态变量的初始化是线程安全的
+    static DocxPartCache cache;
+    return &cache;
+}
+
+bool DocxPartCache::lookupRelationships(const PartKey& key,
+                                        QMap<QString, QString>& relationships)
+{
+    if (!key.isValid()) {
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    const QMap<QString, QString>* cached = m_relationships.object(key);
+    if (!cached) {
+        m_misses++;
+        return false;
+    }
+    relationships = *cached;
+    m_hits++;
+    return true;
+}
+
+void DocxPartCache::storeRelationships(const PartKey& key,
+                                       const QMap<QString, QString>& relationships)
+{
+    if (!key.isValid()) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_relationships.insert(key, new QMap<QString, QString>(relationships));
+}
+
+bool DocxPartCache::lookupImageMeta(const PartKey& key, ImageMeta& meta)
+{
+    if (!key.isValid()) {
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    const ImageMeta* cached = m_imageMeta.object(key);
+    if (!cached) {
+        m_misses++;
+        return false;
+    }
+    meta = *cached;
+    m_hits++;
+    return true;
+}
+
+void DocxPartCache::storeImageMeta(const PartKey& key, const ImageMeta& meta)
+{
+    if (!key.isValid()) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_imageMeta.insert(key, new ImageMeta(meta));
+}
+
+bool DocxPartCache::lookupStyles(const PartKey& key, QSharedPointer<const DocxStyleResolver>& resolver)
+{
+    if (!key.isValid()) {
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    const QSharedPointer<const DocxStyleResolver>* cached = m_styles.object(key);
+    if (!cached) {
+        m_misses++;
+        return false;
+    }
+    resolver = *cached;
+    m_hits++;
+    return true;
+}
+
+void DocxPartCache::storeStyles(const PartKey& key, const QSharedPointer<const DocxStyleResolver>& resolver)
+{
+    if (!key.isValid() || !resolver) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_styles.insert(key, new QSharedPointer<const DocxStyleResolver>(resolver));
+}
+
+void DocxPartCache::setMaxEntries(int maxEntries)
+{
+    QMutexLocker locker(&m_mutex);
+    m_relationships.setMaxCost(maxEntries);
+    m_imageMeta.setMaxCost(maxEntries);
+    m_styles.setMaxCost(maxEntries);
+}
+
+void DocxPartCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_relationships.clear();
+    m_imageMeta.clear();
+    m_styles.clear();
+    m_hits = 0;
+    m_misses = 0;
+}
+
+qint64 DocxPartCache::hitCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_hits;
+}
+
+qint64 DocxPartCache::missCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_misses;
+}
@@ -0,0 +1,150 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 10:20:00
+ * @LastEditTime: 2026-10-18 10:20:00
+ * @LastEditors: seelights
+ * @Description: DOCX部件级解析结果缓存
+ * @FilePath: \ReportMason\src\DocxPartCache.h
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#pragma once
+
+#include "KZipUtils.h"
+#include <QCache>
+#include <QMap>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QSize>
+#include <QString>
+
+class DocxStyleResolver;
+
+/**
+ * @brief DOCX部件级解析结果缓存
+ *
+ * 同一学校模板生成的DOCX文件中，样式、主题、编号、页眉和标志图片等部件
+ * 往往逐字节相同。该缓存以ZIP中央目录中的(CRC32, 大小)为键，
+ * 在进程范围内保存各部件的解析结果，命中时可以完全跳过该部件的读取和解析。
+ */
+class DocxPartCache
+{
+public:
+    /**
+     * @brief 缓存键：ZIP条目的CRC32与解压后大小
+     */
+    struct PartKey {
+        quint32 crc32;
+        qint64 size;
+
+        PartKey() : crc32(0), size(0) {}
+        PartKey(quint32 c, qint64 s) : crc32(c), size(s) {}
+        explicit PartKey(const KZipUtils::EntryInfo& entry)
+            : crc32(entry.crc32), size(entry.size) {}
+
+        bool isValid() const { return size > 0; }
+        bool operator==(const PartKey& other) const
+        {
+            return crc32 == other.crc32 && size == other.size;
+        }
+    };
+
+    /**
+     * @brief 图片部件的解码元数据
+     */
+    struct ImageMeta {
+        QSize size;     ///< 像素尺寸
+        QString format; ///< 实际图片格式
+    };
+
+    /**
+     * @brief 获取进程范围的单例
+     * @return 单例指针
+     */
+    static DocxPartCache* instance();
+
+    /**
+     * @brief 查询关系文件的解析结果
+     * @param key 部件键
+     * @param relationships 输出关系映射 (关系ID -> 目标路径)
+     * @return 是否命中
+     */
+    bool lookupRelationships(const PartKey& key, QMap<QString, QString>& relationships);
+
+    /**
+     * @brief 保存关系文件的解析结果
+     * @param key 部件键
+     * @param relationships 关系映射
+     */
+    void storeRelationships(const PartKey& key, const QMap<QString, QString>& relationships);
+
+    /**
+     * @brief 查询图片部件的元数据
+     * @param key 部件键
+     * @param meta 输出元数据
+     * @return 是否命中
+     */
+    bool lookupImageMeta(const PartKey& key, ImageMeta& meta);
+
+    /**
+     * @brief 保存图片部件的元数据
+     * @param key 部件键
+     * @param meta 元数据
+     */
+    void storeImageMeta(const PartKey& key, const ImageMeta& meta);
+
+    /**
+     * @brief 查询styles.xml展开后的样式表
+     * @param key 部件键
+     * @param resolver 输出样式解析器
+     * @return 是否命中
+     */
+    bool lookupStyles(const PartKey& key, QSharedPointer<const DocxStyleResolver>& resolver);
+
+    /**
+     * @brief 保存styles.xml展开后的样式表
+     * @param key 部件键
+     * @param resolver 样式解析器
+     */
+    void storeStyles(const PartKey& key, const QSharedPointer<const DocxStyleResolver>& resolver);
+
+    /**
+     * @brief 设置每类缓存的最大条目数
+     * @param maxEntries 最大条目数
+     */
+    void setMaxEntries(int maxEntries);
+
+    /**
+     * @brief 清空所有缓存
+     */
+    void clear();
+
+    /**
+     * @brief 获取命中次数
+     */
+    qint64 hitCount() const;
+
+    /**
+     * @brief 获取未命中次数
+     */
+    qint64 missCount() const;
+
+private:
+    DocxPartCache();
+    DocxPartCache(const DocxPartCache&) = delete;
+    DocxPartCache& operator=(const DocxPartCache&) = delete;
+
+    static const int DEFAULT_MAX_ENTRIES = 512;
+
+    mutable QMutex m_mutex;
+    QCache<PartKey, QMap<QString, QString>> m_relationships;
+    QCache<PartKey, ImageMeta> m_imageMeta;
+    QCache<PartKey, QSharedPointer<const DocxStyleResolver>> m_styles;
+    qint64 m_hits;
+    qint64 m_misses;
+};
+
+inline size_t qHash(const DocxPartCache::PartKey& key, size_t seed = 0)
+{
+    return qHashMulti(seed, key.crc32, key.size);
+}
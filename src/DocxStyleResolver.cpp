@@ -0,0 +1,489 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 12:10:00
+ * @LastEditTime: 2026-10-18 12:10:00
+ * @LastEditors: seelights
+ * @Description: DOCX样式继承解析器实现
+ * @FilePath: \ReportMason\src\DocxStyleResolver.cpp
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#include "DocxStyleResolver.h"
+#include "QtCompat.h"
+#include "OoxmlTags.h"
+#include <QDebug>
+#include <QLatin1String>
+
+namespace {
+
+/// 影响QFont的属性位
+const quint32 FONT_FIELDS = FormatDelta::FONT_FAMILY | FormatDelta::FONT_SIZE | FormatDelta::BOLD |
+                            FormatDelta::ITALIC | FormatDelta::UNDERLINE |
+                            FormatDelta::STRIKETHROUGH;
+
+/**
+ * @brief 按本地名读取属性值，不依赖命名空间前缀
+ */
+QStringView attributeValue(const QXmlStreamAttributes& attributes, QLatin1String localName)
+{
+    for (const QXmlStreamAttribute& attr : attributes) {
+        if (attr.name() == localName) {
+            return attr.value();
+        }
+    }
+    return QStringView();
+}
+
+/**
+ * @brief 解析开关属性（w:b、w:i等），省略w:val表示开启
+ */
+bool toggleValue(const QXmlStreamAttributes& attributes)
+{
+    const QStringView value = attributeValue(attributes, QLatin1String("val"));
+    if (value.isNull()) {
+        return true;
+    }
+    return !(value == QLatin1String("0") || value == QLatin1String("false") ||
+             value == QLatin1String("off") || value == QLatin1String("none"));
+}
+
+/**
+ * @brief 缇(1/20磅)转换为磅
+ */
+int twipsToPoints(QStringView twips)
+{
+    return qRound(twips.toInt() / 20.0);
+}
+
+} // namespace
+
+void FormatDelta::applyTo(FormatInfo& format) const
+{
+    if (mask == 0) {
+        return;
+    }
+    if (mask & FONT_FAMILY) format.fontFamily = values.fontFamily;
+    if (mask & FONT_SIZE) format.fontSize = values.fontSize;
+    if (mask & BOLD) format.bold = values.bold;
+    if (mask & ITALIC) format.italic = values.italic;
+    if (mask & UNDERLINE) format.underline = values.underline;
+    if (mask & STRIKETHROUGH) format.strikethrough = values.strikethrough;
+    if (mask & TEXT_COLOR) format.textColor = values.textColor;
+    if (mask & BACKGROUND_COLOR) format.backgroundColor = values.backgroundColor;
+    if (mask & ALIGNMENT) format.alignment = values.alignment;
+    if (mask & LINE_SPACING) format.lineSpacing = values.lineSpacing;
+    if (mask & PARAGRAPH_SPACING) format.paragraphSpacing = values.paragraphSpacing;
+    if (mask & LEFT_INDENT) format.leftIndent = values.leftIndent;
+    if (mask & RIGHT_INDENT) format.rightIndent = values.rightIndent;
+    if (mask & FIRST_LINE_INDENT) format.firstLineIndent = values.firstLineIndent;
+}
+
+void FormatDelta::merge(const FormatDelta& other)
+{
+    other.applyTo(values);
+    mask |= other.mask;
+}
+
+QSharedPointer<const DocxStyleResolver> DocxStyleResolver::fromStylesXml(const QByteArray& stylesXml)
+{
+    QSharedPointer<DocxStyleResolver> resolver(new DocxStyleResolver());
+    syncFont(resolver->m_defaultFormat);
+    resolver->m_defaultParagraphFormat = resolver->m_defaultFormat;
+    if (!stylesXml.isEmpty()) {
+        resolver->parseStyles(stylesXml);
+    }
+    return resolver;
+}
+
+QSharedPointer<const DocxStyleResolver> DocxStyleResolver::parseAndCache(const QByteArray& stylesXml,
+                                                                         const DocxPartCache::PartKey& partKey)
+{
+    const QSharedPointer<const DocxStyleResolver> resolver = fromStylesXml(stylesXml);
+    DocxPartCache::instance()->storeStyles(partKey, resolver);
+    return resolver;
+}
+
+const FormatInfo& DocxStyleResolver::paragraphFormat(const QString& styleId) const
+{
+    if (!styleId.isEmpty()) {
+        auto it = m_paragraphFormats.constFind(styleId);
+        if (it != m_paragraphFormats.constEnd()) {
+            return it.value();
+        }
+    }
+    // 未定义的样式（包括只在latentStyles中声明的样式）按默认段落样式处理，与Word一致
+    return m_defaultParagraphFormat;
+}
+
+FormatInfo DocxStyleResolver::resolveParagraph(const QString& styleId, const FormatDelta& paragraphDelta) const
+{
+    FormatInfo format = paragraphFormat(styleId);
+    paragraphDelta.applyTo(format);
+    if (paragraphDelta.mask & FONT_FIELDS) {
+        syncFont(format);
+    }
+    return format;
+}
+
+FormatInfo DocxStyleResolver::resolveRun(const QString& paragraphStyleId, const FormatDelta& paragraphDelta,
+                                         const QString& runStyleId, const FormatDelta& runDelta) const
+{
+    FormatInfo format = paragraphFormat(paragraphStyleId);
+    paragraphDelta.applyTo(format);
+
+    quint32 touched = paragraphDelta.mask | runDelta.mask;
+    const QString& characterStyleId = runStyleId.isEmpty() ? m_defaultCharacterStyleId : runStyleId;
+    if (!characterStyleId.isEmpty()) {
+        auto it = m_characterDeltas.constFind(characterStyleId);
+        if (it != m_characterDeltas.constEnd()) {
+            it.value().applyTo(format);
+            touched |= it.value().mask;
+        }
+    }
+
+    runDelta.applyTo(format);
+    if (touched & FONT_FIELDS) {
+        syncFont(format);
+    }
+    return format;
+}
+
+bool DocxStyleResolver::isKnownStyle(const QString& styleIdOrName) const
+{
+    return m_paragraphFormats.contains(styleIdOrName) || m_characterDeltas.contains(styleIdOrName) ||
+           m_latentStyles.contains(styleIdOrName);
+}
+
+void DocxStyleResolver::parseParagraphProperties(QXmlStreamReader& reader, FormatDelta& delta, QString* styleId)
+{
+    while (reader.readNextStartElement()) {
+        const QXmlStreamAttributes attrs = reader.attributes();
+
+        switch (OoxmlTags::lookup(reader.name())) {
+            case OoxmlTag::PStyle: {
+                if (styleId) {
+                    *styleId = attributeValue(attrs, QLatin1String("val")).toString();
+                }
+                break;
+            }
+            case OoxmlTag::Jc: {
+                const QStringView value = attributeValue(attrs, QLatin1String("val"));
+                if (value == QLatin1String("center")) {
+                    delta.values.alignment = Qt::AlignCenter;
+                } else if (value == QLatin1String("right") || value == QLatin1String("end")) {
+                    delta.values.alignment = Qt::AlignRight;
+                } else if (value == QLatin1String("both") || value == QLatin1String("distribute")) {
+                    delta.values.alignment = Qt::AlignJustify;
+                } else {
+                    delta.values.alignment = Qt::AlignLeft;
+                }
+                delta.mask |= FormatDelta::ALIGNMENT;
+                break;
+            }
+            case OoxmlTag::Spacing: {
+                const QStringView line = attributeValue(attrs, QLatin1String("line"));
+                const QStringView lineRule = attributeValue(attrs, QLatin1String("lineRule"));
+                // 只有auto规则下line表示倍数（240 = 单倍行距）
+                if (!line.isEmpty() && (lineRule.isEmpty() || lineRule == QLatin1String("auto"))) {
+                    delta.values.lineSpacing = line.toInt() / 240.0;
+                    delta.mask |= FormatDelta::LINE_SPACING;
+                }
+                const QStringView after = attributeValue(attrs, QLatin1String("after"));
+                if (!after.isEmpty()) {
+                    delta.values.paragraphSpacing = after.toInt() / 20.0;
+                    delta.mask |= FormatDelta::PARAGRAPH_SPACING;
+                }
+                break;
+            }
+            case OoxmlTag::Ind: {
+                QStringView left = attributeValue(attrs, QLatin1String("left"));
+                if (left.isEmpty()) {
+                    left = attributeValue(attrs, QLatin1String("start"));
+                }
+                if (!left.isEmpty()) {
+                    delta.values.leftIndent = twipsToPoints(left);
+                    delta.mask |= FormatDelta::LEFT_INDENT;
+                }
+                QStringView right = attributeValue(attrs, QLatin1String("right"));
+                if (right.isEmpty()) {
+                    right = attributeValue(attrs, QLatin1String("end"));
+                }
+                if (!right.isEmpty()) {
+                    delta.values.rightIndent = twipsToPoints(right);
+                    delta.mask |= FormatDelta::RIGHT_INDENT;
+                }
+                const QStringView firstLine = attributeValue(attrs, QLatin1String("firstLine"));
+                const QStringView hanging = attributeValue(attrs, QLatin1String("hanging"));
+                if (!firstLine.isEmpty()) {
+                    delta.values.firstLineIndent = twipsToPoints(firstLine);
+                    delta.mask |= FormatDelta::FIRST_LINE_INDENT;
+                } else if (!hanging.isEmpty()) {
+                    delta.values.firstLineIndent = -twipsToPoints(hanging);
+                    delta.mask |= FormatDelta::FIRST_LINE_INDENT;
+                }
+                break;
+            }
+            default:
+                // pPr中的rPr只作用于段落标记，不影响文本运行
+                break;
+        }
+
+        reader.skipCurrentElement();
+    }
+}
+
+void DocxStyleResolver::parseRunProperties(QXmlStreamReader& reader, FormatDelta& delta, QString* styleId)
+{
+    while (reader.readNextStartElement()) {
+        const QXmlStreamAttributes attrs = reader.attributes();
+
+        switch (OoxmlTags::lookup(reader.name())) {
+            case OoxmlTag::RStyle: {
+                if (styleId) {
+                    *styleId = attributeValue(attrs, QLatin1String("val")).toString();
+                }
+                break;
+            }
+            case OoxmlTag::RFonts: {
+                // 报告以中文为主，优先使用东亚字体
+                QStringView family = attributeValue(attrs, QLatin1String("eastAsia"));
+                if (family.isEmpty()) {
+                    family = attributeValue(attrs, QLatin1String("ascii"));
+                }
+                if (family.isEmpty()) {
+                    family = attributeValue(attrs, QLatin1String("hAnsi"));
+                }
+                if (!family.isEmpty()) {
+                    delta.values.fontFamily = family.toString();
+                    delta.mask |= FormatDelta::FONT_FAMILY;
+                }
+                break;
+            }
+            case OoxmlTag::Sz: {
+                // w:sz以半磅为单位
+                const QStringView value = attributeValue(attrs, QLatin1String("val"));
+                if (!value.isEmpty()) {
+                    delta.values.fontSize = qRound(value.toInt() / 2.0);
+                    delta.mask |= FormatDelta::FONT_SIZE;
+                }
+                break;
+            }
+            case OoxmlTag::B: {
+                delta.values.bold = toggleValue(attrs);
+                delta.mask |= FormatDelta::BOLD;
+                break;
+            }
+            case OoxmlTag::I: {
+                delta.values.italic = toggleValue(attrs);
+                delta.mask |= FormatDelta::ITALIC;
+                break;
+            }
+            case OoxmlTag::U: {
+                delta.values.underline = toggleValue(attrs);
+                delta.mask |= FormatDelta::UNDERLINE;
+                break;
+            }
+            case OoxmlTag::Strike:
+            case OoxmlTag::Dstrike: {
+                delta.values.strikethrough = toggleValue(attrs);
+                delta.mask |= FormatDelta::STRIKETHROUGH;
+                break;
+            }
+            case OoxmlTag::Color: {
+                const QStringView value = attributeValue(attrs, QLatin1String("val"));
+                if (!value.isEmpty() && value != QLatin1String("auto")) {
+                    delta.values.textColor = QColor(QS("#") + value.toString());
+                    delta.mask |= FormatDelta::TEXT_COLOR;
+                }
+                break;
+            }
+            case OoxmlTag::Highlight: {
+                const QStringView value = attributeValue(attrs, QLatin1String("val"));
+                if (!value.isEmpty() && value != QLatin1String("none")) {
+                    delta.values.backgroundColor = QColor(value.toString());
+                    delta.mask |= FormatDelta::BACKGROUND_COLOR;
+                }
+                break;
+            }
+            case OoxmlTag::Shd: {
+                const QStringView fill = attributeValue(attrs, QLatin1String("fill"));
+                if (!fill.isEmpty() && fill != QLatin1String("auto") && !(delta.mask & FormatDelta::BACKGROUND_COLOR)) {
+                    delta.values.backgroundColor = QColor(QS("#") + fill.toString());
+                    delta.mask |= FormatDelta::BACKGROUND_COLOR;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+
+        reader.skipCurrentElement();
+    }
+}
+
+void DocxStyleResolver::parseStyles(const QByteArray& stylesXml)
+{
+    QXmlStreamReader reader(stylesXml);
+    QHash<QString, RawStyle> rawStyles;
+
+    while (!reader.atEnd()) {
+        reader.readNext();
+        if (!reader.isStartElement()) {
+            continue;
+        }
+
+        switch (OoxmlTags::lookup(reader.name())) {
+            case OoxmlTag::DocDefaults:
+                parseDocDefaults(reader);
+                break;
+            case OoxmlTag::LatentStyles:
+                parseLatentStyles(reader);
+                break;
+            case OoxmlTag::Style:
+                parseStyle(reader, rawStyles);
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (reader.hasError()) {
+        qDebug() << QS("styles.xml解析错误:") << reader.errorString();
+    }
+
+    // 一次性展开所有basedOn继承链
+    QHash<QString, FormatDelta> flattened;
+    for (auto it = rawStyles.constBegin(); it != rawStyles.constEnd(); ++it) {
+        QSet<QString> visiting;
+        const FormatDelta delta = flattenStyle(it.key(), rawStyles, flattened, visiting);
+
+        if (it.value().type == QS("character")) {
+            m_characterDeltas.insert(it.key(), delta);
+        } else if (it.value().type == QS("paragraph")) {
+            FormatInfo format = m_defaultFormat;
+            delta.applyTo(format);
+            syncFont(format);
+            m_paragraphFormats.insert(it.key(), format);
+        }
+    }
+
+    m_defaultParagraphFormat = m_paragraphFormats.value(m_defaultParagraphStyleId, m_defaultFormat);
+}
+
+void DocxStyleResolver::parseDocDefaults(QXmlStreamReader& reader)
+{
+    FormatDelta delta;
+    while (reader.readNextStartElement()) {
+        // rPrDefault/rPr 与 pPrDefault/pPr
+        while (reader.readNextStartElement()) {
+            const OoxmlTag tag = OoxmlTags::lookup(reader.name());
+            if (tag == OoxmlTag::RPr) {
+                parseRunProperties(reader, delta);
+            } else if (tag == OoxmlTag::PPr) {
+                parseParagraphProperties(reader, delta);
+            } else {
+                reader.skipCurrentElement();
+            }
+        }
+    }
+
+    delta.applyTo(m_defaultFormat);
+    syncFont(m_defaultFormat);
+}
+
+void DocxStyleResolver::parseStyle(QXmlStreamReader& reader, QHash<QString, RawStyle>& rawStyles)
+{
+    const QXmlStreamAttributes styleAttrs = reader.attributes();
+    RawStyle style;
+    style.type = attributeValue(styleAttrs, QLatin1String("type")).toString();
+    const QString styleId = attributeValue(styleAttrs, QLatin1String("styleId")).toString();
+    const QStringView defaultValue = attributeValue(styleAttrs, QLatin1String("default"));
+    const bool isDefault = defaultValue == QLatin1String("1") || defaultValue == QLatin1String("true");
+
+    while (reader.readNextStartElement()) {
+        const OoxmlTag tag = OoxmlTags::lookup(reader.name());
+        const QXmlStreamAttributes attrs = reader.attributes();
+        if (tag == OoxmlTag::BasedOn) {
+            style.basedOn = attributeValue(attrs, QLatin1String("val")).toString();
+            reader.skipCurrentElement();
+        } else if (tag == OoxmlTag::PPr) {
+            parseParagraphProperties(reader, style.delta);
+        } else if (tag == OoxmlTag::RPr) {
+            parseRunProperties(reader, style.delta);
+        } else {
+            reader.skipCurrentElement();
+        }
+    }
+
+    if (styleId.isEmpty()) {
+        return;
+    }
+
+    if (isDefault) {
+        if (style.type == QS("paragraph")) {
+            m_defaultParagraphStyleId = styleId;
+        } else if (style.type == QS("character")) {
+            m_defaultCharacterStyleId = styleId;
+        }
+    }
+    rawStyles.insert(styleId, style);
+}
+
+void DocxStyleResolver::parseLatentStyles(QXmlStreamReader& reader)
+{
+    // 潜在样式只携带界面属性，没有格式定义，展开后等同于默认格式
+    while (reader.readNextStartElement()) {
+        if (OoxmlTags::lookup(reader.name()) == OoxmlTag::LsdException) {
+            const QXmlStreamAttributes attrs = reader.attributes();
+            const QStringView styleName = attributeValue(attrs, QLatin1String("name"));
+            if (!styleName.isEmpty()) {
+                m_latentStyles.insert(styleName.toString());
+            }
+        }
+        reader.skipCurrentElement();
+    }
+}
+
+FormatDelta DocxStyleResolver::flattenStyle(const QString& styleId, const QHash<QString, RawStyle>& rawStyles,
+                                            QHash<QString, FormatDelta>& flattened, QSet<QString>& visiting) const
+{
+    auto done = flattened.constFind(styleId);
+    if (done != flattened.constEnd()) {
+        return done.value();
+    }
+
+    auto raw = rawStyles.constFind(styleId);
+    if (raw == rawStyles.constEnd()) {
+        return FormatDelta();
+    }
+
+    // 防止损坏文档中的循环继承
+    if (visiting.contains(styleId)) {
+        qDebug() << QS("样式存在循环继承:") << styleId;
+        return raw.value().delta;
+    }
+    visiting.insert(styleId);
+
+    FormatDelta delta;
+    if (!raw.value().basedOn.isEmpty()) {
+        delta = flattenStyle(raw.value().basedOn, rawStyles, flattened, visiting);
+    }
+    delta.merge(raw.value().delta);
+
+    flattened.insert(styleId, delta);
+    return delta;
+}
+
+void DocxStyleResolver::syncFont(FormatInfo& format)
+{
+    if (!format.fontFamily.isEmpty()) {
+        format.font.setFamily(format.fontFamily);
+    }
+    if (format.fontSize > 0) {
+        format.font.setPointSize(format.fontSize);
+    }
+    format.font.setBold(format.bold);
+    format.font.setItalic(format.italic);
+    format.font.setUnderline(format.underline);
+    format.font.setStrikeOut(format.strikethrough);
+}
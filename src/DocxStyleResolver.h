@@ -0,0 +1,175 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 12:10:00
+ * @LastEditTime: 2026-10-18 12:10:00
+ * @LastEditors: seelights
+ * @Description: DOCX样式继承解析器
+ * @FilePath: \ReportMason\src\DocxStyleResolver.h
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#pragma once
+
+#include "LosslessDocumentConverter.h"
+#include "DocxPartCache.h"
+#include <QByteArray>
+#include <QHash>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+#include <QXmlStreamReader>
+
+/**
+ * @brief 格式增量：只记录显式设置过的属性
+ *
+ * 用于表示样式自身的属性、段落/文本运行的直接格式，
+ * 按顺序叠加到FormatInfo上即可得到最终格式。
+ */
+struct FormatDelta {
+    enum Field : quint32 {
+        FONT_FAMILY = 1u << 0,
+        FONT_SIZE = 1u << 1,
+        BOLD = 1u << 2,
+        ITALIC = 1u << 3,
+        UNDERLINE = 1u << 4,
+        STRIKETHROUGH = 1u << 5,
+        TEXT_COLOR = 1u << 6,
+        BACKGROUND_COLOR = 1u << 7,
+        ALIGNMENT = 1u << 8,
+        LINE_SPACING = 1u << 9,
+        PARAGRAPH_SPACING = 1u << 10,
+        LEFT_INDENT = 1u << 11,
+        RIGHT_INDENT = 1u << 12,
+        FIRST_LINE_INDENT = 1u << 13
+    };
+
+    quint32 mask;      ///< 已设置属性的位掩码
+    FormatInfo values; ///< 属性值（只有mask中的位有效）
+
+    FormatDelta() : mask(0) {}
+
+    bool isEmpty() const { return mask == 0; }
+    void clear() { mask = 0; }
+
+    /**
+     * @brief 将增量叠加到格式上
+     * @param format 目标格式
+     */
+    void applyTo(FormatInfo& format) const;
+
+    /**
+     * @brief 合并另一个增量，other中设置的属性覆盖当前值
+     * @param other 另一个增量
+     */
+    void merge(const FormatDelta& other);
+};
+
+/**
+ * @brief DOCX样式继承解析器
+ *
+ * 一次性解析styles.xml，把docDefaults、basedOn继承链和潜在样式全部展开为扁平表：
+ * 段落样式保存完整的FormatInfo，字符样式保存展开后的增量。
+ * 解析文档时每个文本运行只需一次表查找再叠加少量直接格式，不再逐级遍历样式链。
+ * 解析结果不可变，可以在线程间共享并通过DocxPartCache跨文档复用。
+ */
+class DocxStyleResolver
+{
+public:
+    /**
+     * @brief 从styles.xml创建解析器
+     * @param stylesXml styles.xml内容，为空时只使用默认格式
+     * @return 解析器
+     */
+    static QSharedPointer<const DocxStyleResolver> fromStylesXml(const QByteArray& stylesXml);
+
+    /**
+     * @brief 解析styles.xml并存入部件缓存
+     *
+     * 缓存查询应在解压之前按中央目录信息进行（DocxPartCache::lookupStyles），
+     * 只有未命中时才解压styles.xml并调用此函数。
+     * @param stylesXml styles.xml内容
+     * @param partKey styles.xml在压缩包中的缓存键
+     * @return 解析器
+     */
+    static QSharedPointer<const DocxStyleResolver> parseAndCache(const QByteArray& stylesXml,
+                                                                 const DocxPartCache::PartKey& partKey);
+
+    /**
+     * @brief 获取段落样式展开后的格式
+     * @param styleId 段落样式ID，为空或未定义时使用默认段落样式
+     * @return 格式信息
+     */
+    const FormatInfo& paragraphFormat(const QString& styleId) const;
+
+    /**
+     * @brief 计算段落的有效格式
+     * @param styleId 段落样式ID
+     * @param paragraphDelta 段落直接格式
+     * @return 格式信息
+     */
+    FormatInfo resolveParagraph(const QString& styleId, const FormatDelta& paragraphDelta) const;
+
+    /**
+     * @brief 计算文本运行的有效格式
+     * @param paragraphStyleId 所在段落的样式ID
+     * @param paragraphDelta 所在段落的直接格式
+     * @param runStyleId 字符样式ID
+     * @param runDelta 文本运行直接格式
+     * @return 格式信息
+     */
+    FormatInfo resolveRun(const QString& paragraphStyleId, const FormatDelta& paragraphDelta,
+                          const QString& runStyleId, const FormatDelta& runDelta) const;
+
+    /**
+     * @brief 判断样式ID或潜在样式名是否已知
+     * @param styleIdOrName 样式ID或名称
+     * @return 是否已知
+     */
+    bool isKnownStyle(const QString& styleIdOrName) const;
+
+    /**
+     * @brief 解析w:pPr元素
+     * @param reader 位于w:pPr开始标签的XML读取器，返回时位于其结束标签
+     * @param delta 输出的段落格式增量
+     * @param styleId 输出的w:pStyle值，可为nullptr
+     */
+    static void parseParagraphProperties(QXmlStreamReader& reader, FormatDelta& delta,
+                                         QString* styleId = nullptr);
+
+    /**
+     * @brief 解析w:rPr元素
+     * @param reader 位于w:rPr开始标签的XML读取器，返回时位于其结束标签
+     * @param delta 输出的文本格式增量
+     * @param styleId 输出的w:rStyle值，可为nullptr
+     */
+    static void parseRunProperties(QXmlStreamReader& reader, FormatDelta& delta,
+                                   QString* styleId = nullptr);
+
+private:
+    DocxStyleResolver() = default;
+
+    /**
+     * @brief 解析前的原始样式定义
+     */
+    struct RawStyle {
+        QString type;
+        QString basedOn;
+        FormatDelta delta; ///< 样式自身pPr和rPr的增量
+    };
+
+    void parseStyles(const QByteArray& stylesXml);
+    void parseDocDefaults(QXmlStreamReader& reader);
+    void parseStyle(QXmlStreamReader& reader, QHash<QString, RawStyle>& rawStyles);
+    void parseLatentStyles(QXmlStreamReader& reader);
+    FormatDelta flattenStyle(const QString& styleId, const QHash<QString, RawStyle>& rawStyles,
+                             QHash<QString, FormatDelta>& flattened, QSet<QString>& visiting) const;
+    static void syncFont(FormatInfo& format);
+
+    FormatInfo m_defaultFormat;                     ///< docDefaults展开后的格式
+    FormatInfo m_defaultParagraphFormat;            ///< 默认段落样式的格式
+    QString m_defaultParagraphStyleId;              ///< 默认段落样式ID
+    QString m_defaultCharacterStyleId;              ///< 默认字符样式ID
+    QHash<QString, FormatInfo> m_paragraphFormats;  ///< 段落样式ID -> 完整格式
+    QHash<QString, FormatDelta> m_characterDeltas;  ///< 字符样式ID -> 展开后的增量
+    QSet<QString> m_latentStyles;                   ///< 潜在样式名称
+};
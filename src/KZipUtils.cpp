@@ -13,8 +13,38 @@
 #include "kzip.h"
 #include "karchivedirectory.h"
 #include "karchivefile.h"
+#include "kzipfileentry.h"
+#include <QBuffer>
 #include <QFileInfo>
 #include <QDebug>
+#include <QRegularExpression>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <zlib.h>
+
+namespace {
+// 单个待读取条目：记录中央目录信息与读取结果
+struct PendingEntry {
+    QString path;
+    const KZipFileEntry* entry = nullptr;
+    QByteArray raw;
+    QByteArray content;
+    bool ok = false;
+};
+
+// 少于该数量的压缩条目不值得启用线程池
+constexpr int kMinParallelEntries = 4;
+
+// deflate的压缩比不超过约1032:1，声明的解压大小超出该比例的条目必然与数据不符
+constexpr qint64 kMaxDeflateRatio = 1032;
+
+// 单个条目解压后的大小上限
+constexpr qint64 kMaxInflatedSize = 512LL * 1024 * 1024;
+
+// 解压缓冲区的初始分配上限，实际输出更多时再逐步扩大，不按声明的大小一次分配
+constexpr qint64 kInitialInflateBuffer = 4LL * 1024 * 1024;
+} // namespace
 
 bool KZipUtils::readFileFromZip(const QString& zipPath, const QString& internalPath,
                                 QByteArray& content)
@@ -44,6 +74,228 @@ bool KZipUtils::readFileFromZip(const QString& zipPath, const QString& internalP
     return true;
 }
 
+bool KZipUtils::readFilesFromZip(const QString& zipPath, const QStringList& internalPaths,
+                                 QMap<QString, QByteArray>& contents, bool parallelInflate,
+                                 QMap<QString, EntryInfo>* entries, const SkipEntry& skip)
+{
+    KZip zip(zipPath);
+    if (!zip.open(QIODevice::ReadOnly)) {
+        qDebug() << "无法打开ZIP文件:" << zipPath;
+        return false;
+    }
+
+    if (!zip.directory()) {
+        qDebug() << "ZIP文件格式错误:" << zipPath;
+        zip.close();
+        return false;
+    }
+
+    readEntries(zip, pathsToRead(zip, internalPaths, entries, skip), contents, parallelInflate);
+    zip.close();
+    return true;
+}
+
+bool KZipUtils::readFilesFromZipData(const QByteArray& zipData, const QStringList& internalPaths,
+                                     QMap<QString, QByteArray>& contents, bool parallelInflate,
+                                     QMap<QString, EntryInfo>* entries, const SkipEntry& skip)
+{
+    QBuffer buffer;
+    buffer.setData(zipData);
+    KZip zip(&buffer);
+    if (!zip.open(QIODevice::ReadOnly)) {
+        qDebug() << "无法解析ZIP数据";
+        return false;
+    }
+
+    if (!zip.directory()) {
+        qDebug() << "ZIP数据格式错误";
+        zip.close();
+        return false;
+    }
+
+    readEntries(zip, pathsToRead(zip, internalPaths, entries, skip), contents, parallelInflate);
+    zip.close();
+    return true;
+}
+
+bool KZipUtils::readFilesFromZipByPattern(const QString& zipPath, const QString& pattern,
+                                          QMap<QString, QByteArray>& contents,
+                                          bool parallelInflate)
+{
+    KZip zip(zipPath);
+    if (!zip.open(QIODevice::ReadOnly)) {
+        qDebug() << "无法打开ZIP文件:" << zipPath;
+        return false;
+    }
+
+    const KArchiveDirectory* rootDir = zip.directory();
+    if (!rootDir) {
+        qDebug() << "ZIP文件格式错误:" << zipPath;
+        zip.close();
+        return false;
+    }
+
+    // 不含通配符时按前缀匹配，否则按通配符匹配（*不跨越目录）
+    const bool isWildcard = pattern.contains(QLatin1Char('*')) ||
+                            pattern.contains(QLatin1Char('?')) ||
+                            pattern.contains(QLatin1Char('['));
+    const QRegularExpression wildcard =
+        isWildcard ? QRegularExpression(QRegularExpression::wildcardToRegularExpression(pattern))
+                   : QRegularExpression();
+
+    QStringList matched;
+    const QStringList allFiles = getFilesRecursive(rootDir);
+    for (const QString& path : allFiles) {
+        if (isWildcard ? wildcard.match(path).hasMatch() : path.startsWith(pattern)) {
+            matched.append(path);
+        }
+    }
+
+    readEntries(zip, matched, contents, parallelInflate);
+    zip.close();
+    return true;
+}
+
+void KZipUtils::readEntries(KZip& zip, const QStringList& internalPaths,
+                            QMap<QString, QByteArray>& contents, bool parallelInflate)
+{
+    const KArchiveDirectory* rootDir = zip.directory();
+    QIODevice* device = zip.device();
+
+    QList<PendingEntry> pending;
+    pending.reserve(internalPaths.size());
+    for (const QString& path : internalPaths) {
+        const KArchiveFile* file = rootDir->file(path);
+        if (!file) {
+            qDebug() << "无法在ZIP中找到文件:" << path;
+            continue;
+        }
+        PendingEntry item;
+        item.path = path;
+        item.entry = static_cast<const KZipFileEntry*>(file);
+        pending.append(item);
+    }
+
+    // 按本地文件头偏移排序，保证对底层设备的顺序读取
+    std::sort(pending.begin(), pending.end(), [](const PendingEntry& a, const PendingEntry& b) {
+        return a.entry->headerStart() < b.entry->headerStart();
+    });
+
+    // 第一阶段：顺序读取原始（压缩）数据，仅访问一次文件句柄
+    int deflatedCount = 0;
+    for (PendingEntry& item : pending) {
+        const KZipFileEntry* entry = item.entry;
+        if (entry->encoding() != 0 && entry->encoding() != 8) {
+            qDebug() << "不支持的ZIP压缩方法:" << entry->encoding() << item.path;
+            continue;
+        }
+        if (!device->seek(entry->position())) {
+            qDebug() << "无法定位ZIP条目数据:" << item.path;
+            continue;
+        }
+        item.raw = device->read(entry->compressedSize());
+        if (item.raw.size() != entry->compressedSize()) {
+            qDebug() << "ZIP条目数据不完整:" << item.path;
+            item.raw.clear();
+            continue;
+        }
+        if (entry->encoding() == 0 || entry->compressedSize() == 0) {
+            item.content = item.raw;
+            item.raw.clear();
+            item.ok = true;
+        } else {
+            deflatedCount++;
+        }
+    }
+
+    // 第二阶段：解压，条目足够多时交给线程池
+    auto inflateItem = [](PendingEntry& item) {
+        if (item.ok || item.raw.isEmpty()) {
+            return;
+        }
+        item.ok = inflateRaw(item.raw, item.entry->size(), item.content);
+        item.raw.clear();
+    };
+
+    if (parallelInflate && deflatedCount >= kMinParallelEntries) {
+        QThreadPool pool;
+        pool.setMaxThreadCount(qMin(QThread::idealThreadCount(), deflatedCount));
+        for (PendingEntry& item : pending) {
+            if (!item.ok && !item.raw.isEmpty()) {
+                pool.start([&item, &inflateItem]() { inflateItem(item); });
+            }
+        }
+        pool.waitForDone();
+    } else {
+        for (PendingEntry& item : pending) {
+            inflateItem(item);
+        }
+    }
+
+    for (const PendingEntry& item : pending) {
+        if (item.ok) {
+            contents.insert(item.path, item.content);
+        } else {
+            qDebug() << "无法解压ZIP条目:" << item.path;
+        }
+    }
+}
+
+bool KZipUtils::inflateRaw(const QByteArray& compressed, qint64 uncompressedSize,
+                           QByteArray& content)
+{
+    content.clear();
+    // 声明大小来自中央目录，不可信：先排除不可能的值
+    if (uncompressedSize < 0 || uncompressedSize > kMaxInflatedSize ||
+        uncompressedSize > (compressed.size() + 1) * kMaxDeflateRatio) {
+        qDebug() << "ZIP条目声明的解压大小不可信:" << uncompressedSize << "压缩大小:" << compressed.size();
+        return false;
+    }
+
+    z_stream stream = {};
+    // 负的窗口位数表示ZIP中使用的原始deflate流（无zlib头）
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+        return false;
+    }
+
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed.constData()));
+    stream.avail_in = static_cast<uInt>(compressed.size());
+
+    // 缓冲区比声明大小多留一个字节，用来发现超出声明大小的输出
+    qint64 bufferLimit = kInitialInflateBuffer;
+    content.resize(qMin(uncompressedSize, bufferLimit) + 1);
+    bool ok = false;
+    while (true) {
+        stream.next_out = reinterpret_cast<Bytef*>(content.data()) + stream.total_out;
+        stream.avail_out = static_cast<uInt>(content.size() - static_cast<qint64>(stream.total_out));
+
+        const int result = inflate(&stream, Z_NO_FLUSH);
+        if (result == Z_STREAM_END) {
+            ok = static_cast<qint64>(stream.total_out) == uncompressedSize;
+            break;
+        }
+        if ((result != Z_OK && result != Z_BUF_ERROR) || stream.avail_out > 0) {
+            // 数据损坏，或输入已耗尽而流尚未结束
+            break;
+        }
+        if (content.size() > uncompressedSize) {
+            // 输出已超过声明的大小
+            break;
+        }
+        bufferLimit *= 2;
+        content.resize(qMin(uncompressedSize, bufferLimit) + 1);
+    }
+    inflateEnd(&stream);
+
+    if (!ok) {
+        qDebug() << "ZIP条目解压后的大小与声明不符:" << uncompressedSize;
+        content.clear();
+        return false;
+    }
+    content.resize(uncompressedSize);
+    return true;
+}
+
 QStringList KZipUtils::getFileList(const QString& zipPath)
 {
     QStringList fileList;
@@ -207,6 +459,68 @@ QMap<QString, qint64> KZipUtils::getZipInfo(const QString& zipPath)
     return info;
 }
 
+QMap<QString, KZipUtils::EntryInfo> KZipUtils::getZipEntries(const QString& zipPath)
+{
+    KZip zip(zipPath);
+    if (!zip.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+
+    QMap<QString, EntryInfo> entries = collectEntries(zip);
+    zip.close();
+    return entries;
+}
+
+QStringList KZipUtils::pathsToRead(const KZip& zip, const QStringList& internalPaths,
+                                   QMap<QString, EntryInfo>* entries, const SkipEntry& skip)
+{
+    if (!entries && !skip) {
+        return internalPaths;
+    }
+
+    const QMap<QString, EntryInfo> collected = collectEntries(zip);
+    QStringList paths = internalPaths;
+    if (skip) {
+        paths.removeIf([&collected, &skip](const QString& path) {
+            const auto it = collected.constFind(path);
+            return it != collected.constEnd() && skip(it.value());
+        });
+    }
+    if (entries) {
+        *entries = collected;
+    }
+    return paths;
+}
+
+QMap<QString, KZipUtils::EntryInfo> KZipUtils::collectEntries(const KZip& zip)
+{
+    QMap<QString, EntryInfo> entries;
+
+    const KArchiveDirectory* rootDir = zip.directory();
+    if (!rootDir) {
+        return entries;
+    }
+
+    const QStringList files = getFilesRecursive(rootDir);
+    for (const QString& path : files) {
+        const KArchiveFile* file = rootDir->file(path);
+        if (!file) {
+            continue;
+        }
+        const KZipFileEntry* entry = static_cast<const KZipFileEntry*>(file);
+
+        EntryInfo info;
+        info.path = path;
+        info.size = entry->size();
+        info.compressedSize = entry->compressedSize();
+        info.crc32 = static_cast<quint32>(entry->crc32());
+        info.headerStart = entry->headerStart();
+        entries.insert(path, info);
+    }
+
+    return entries;
+}
+
 QStringList KZipUtils::getFilesRecursive(const KArchiveDirectory* dir, const QString& prefix)
 {
     QStringList files;
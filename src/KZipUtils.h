@@ -14,6 +14,7 @@
 #include <QByteArray>
 #include <QStringList>
 #include <QMap>
+#include <functional>
 
 class KZip;
 class KArchiveDirectory;
@@ -26,6 +27,24 @@ class KArchiveFile;
 class KZipUtils
 {
 public:
+    /**
+     * @brief ZIP条目的中央目录信息
+     */
+    struct EntryInfo {
+        QString path;          ///< ZIP内部完整路径
+        qint64 size;           ///< 解压后大小
+        qint64 compressedSize; ///< 压缩后大小
+        quint32 crc32;         ///< 中央目录记录的CRC32
+        qint64 headerStart;    ///< 本地文件头偏移
+
+        EntryInfo() : size(0), compressedSize(0), crc32(0), headerStart(0) {}
+    };
+
+    /**
+     * @brief 按中央目录信息判断是否跳过某个条目，返回true的条目既不读取也不解压
+     */
+    using SkipEntry = std::function<bool(const EntryInfo &)>;
+
     /**
      * @brief 从ZIP文件中读取指定文件的内容
      * @param zipPath ZIP文件路径
@@ -37,6 +56,55 @@ public:
                                const QString &internalPath, 
                                QByteArray &content);
 
+    /**
+     * @brief 批量读取ZIP文件中的多个文件
+     * 只打开一次压缩包，按本地文件头偏移排序后顺序读取，可选在线程池中并行解压
+     * @param zipPath ZIP文件路径
+     * @param internalPaths ZIP内部文件路径列表
+     * @param contents 输出内容映射 (内部路径 -> 内容)，不存在的文件不会出现在映射中
+     * @param parallelInflate 是否在线程池中并行解压
+     * @param entries 可选输出，压缩包内所有文件的中央目录信息
+     * @param skip 可选，在解压前按中央目录信息排除条目（如部件缓存已有其解析结果）
+     * @return 是否成功打开ZIP文件
+     */
+    static bool readFilesFromZip(const QString &zipPath,
+                                 const QStringList &internalPaths,
+                                 QMap<QString, QByteArray> &contents,
+                                 bool parallelInflate = false,
+                                 QMap<QString, EntryInfo> *entries = nullptr,
+                                 const SkipEntry &skip = SkipEntry());
+
+    /**
+     * @brief 从内存中的ZIP数据批量读取文件
+     * 供已把整个压缩包读入内存的调用方（如分阶段转换流水线）解压，不再访问磁盘
+     * @param zipData ZIP文件内容
+     * @param internalPaths ZIP内部文件路径列表
+     * @param contents 输出内容映射 (内部路径 -> 内容)，不存在的文件不会出现在映射中
+     * @param parallelInflate 是否在线程池中并行解压
+     * @param entries 可选输出，压缩包内所有文件的中央目录信息
+     * @param skip 可选，在解压前按中央目录信息排除条目
+     * @return 是否成功解析ZIP数据
+     */
+    static bool readFilesFromZipData(const QByteArray &zipData,
+                                     const QStringList &internalPaths,
+                                     QMap<QString, QByteArray> &contents,
+                                     bool parallelInflate = false,
+                                     QMap<QString, EntryInfo> *entries = nullptr,
+                                     const SkipEntry &skip = SkipEntry());
+
+    /**
+     * @brief 按通配符或前缀批量读取ZIP文件中的文件
+     * @param zipPath ZIP文件路径
+     * @param pattern 通配符模式（如"word/media/*"），不含通配符时按前缀匹配
+     * @param contents 输出内容映射 (内部路径 -> 内容)
+     * @param parallelInflate 是否在线程池中并行解压
+     * @return 是否成功打开ZIP文件
+     */
+    static bool readFilesFromZipByPattern(const QString &zipPath,
+                                          const QString &pattern,
+                                          QMap<QString, QByteArray> &contents,
+                                          bool parallelInflate = false);
+
     /**
      * @brief 获取ZIP文件中的所有文件列表
      * @param zipPath ZIP文件路径
@@ -86,7 +154,53 @@ public:
      */
     static QMap<QString, qint64> getZipInfo(const QString &zipPath);
 
+    /**
+     * @brief 获取ZIP文件中所有文件的中央目录信息（含CRC32）
+     * @param zipPath ZIP文件路径
+     * @return 条目信息映射 (内部路径 -> 条目信息)
+     */
+    static QMap<QString, EntryInfo> getZipEntries(const QString &zipPath);
+
 private:
+    /**
+     * @brief 在已打开的ZIP中批量读取文件
+     * @param zip 已打开的ZIP
+     * @param internalPaths ZIP内部文件路径列表
+     * @param contents 输出内容映射
+     * @param parallelInflate 是否并行解压
+     */
+    static void readEntries(KZip &zip, const QStringList &internalPaths,
+                            QMap<QString, QByteArray> &contents, bool parallelInflate);
+
+    /**
+     * @brief 解压原始deflate数据
+     * 缓冲区随实际输出增长，不按声明大小一次分配；声明大小不可能成立或与实际输出不符时失败
+     * @param compressed 压缩数据
+     * @param uncompressedSize 中央目录声明的解压后大小
+     * @param content 输出内容
+     * @return 是否成功
+     */
+    static bool inflateRaw(const QByteArray &compressed, qint64 uncompressedSize,
+                           QByteArray &content);
+
+    /**
+     * @brief 从已打开的ZIP中收集中央目录信息
+     * @param zip 已打开的ZIP
+     * @return 条目信息映射
+     */
+    static QMap<QString, EntryInfo> collectEntries(const KZip &zip);
+
+    /**
+     * @brief 收集中央目录信息并去掉需要跳过的条目
+     * @param zip 已打开的ZIP
+     * @param internalPaths 请求读取的路径
+     * @param entries 可选输出，所有文件的中央目录信息
+     * @param skip 可选的跳过条件
+     * @return 实际需要读取的路径
+     */
+    static QStringList pathsToRead(const KZip &zip, const QStringList &internalPaths,
+                                   QMap<QString, EntryInfo> *entries, const SkipEntry &skip);
+
     /**
      * @brief 递归获取目录中的所有文件
      * @param dir 目录
@@ -11,12 +11,22 @@
 #include "LosslessDocumentConverter.h"
 #include "QtCompat.h"
 #include "KZipUtils.h"
+#include "DocxConversionManifest.h"
+#include "DocxStyleResolver.h"
+#include "OoxmlTags.h"
+#include "PdfDocumentPool.h"
+#include "PdfRegionRenderer.h"
+#include "PdfCoreDocument.h"
+#include "PdfTableDetector.h"
+#include "PdfStructureExtractor.h"
 #include "PopplerCompat.h"
+#include <QFile>
 #include <QFileInfo>
 #include <QDir>
 #include <QXmlStreamReader>
 #include <QXmlStreamWriter>
 #include <QDateTime>
+#include <QScopeGuard>
 #include <QCryptographicHash>
 
 // Poppler头文件
@@ -34,7 +44,8 @@
 #include "poppler-qt6.h"
 
 LosslessDocumentConverter::LosslessDocumentConverter(QObject *parent)
-    : QObject(parent), m_elementCounter(0)
+    : QObject(parent), m_elementCounter(0), m_pageTimeBudget(DEFAULT_PAGE_TIME_BUDGET_MS),
+      m_documentTimeBudget(DEFAULT_DOCUMENT_TIME_BUDGET_MS), m_cancelRequested(false)
 {
     // 初始化支持的格式
     m_supportedFormats[QS("docx")] = InputFormat::DOCX;
@@ -63,13 +74,14 @@ LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::convertToLos
     emit conversionProgress(10, QS("解析文档结构..."));
     
     QList<DocumentElement> elements;
+    std::shared_ptr<const PdfFontTable> fontTable;
     ConvertStatus status;
     
     QString extension = fileInfo.suffix().toLower();
     if (extension == QS("docx")) {
         status = parseDocxDocument(filePath, elements);
     } else if (extension == QS("pdf")) {
-        status = parsePdfDocument(filePath, elements);
+        status = parsePdfDocument(filePath, elements, fontTable);
     } else {
         status = ConvertStatus::INVALID_FORMAT;
     }
@@ -100,7 +112,7 @@ LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::convertToLos
     writer.setAutoFormatting(true);
     writer.setAutoFormattingIndent(2);
     
-    status = writeElementsToXml(elements, writer);
+    status = writeElementsToXml(elements, fontTable, writer);
     outputFile.close();
     
     if (status != ConvertStatus::SUCCESS) {
@@ -131,13 +143,14 @@ QByteArray LosslessDocumentConverter::convertToLosslessXmlByteArray(const QStrin
     }
     
     QList<DocumentElement> elements;
+    std::shared_ptr<const PdfFontTable> fontTable;
     ConvertStatus status;
     
     QString extension = QFileInfo(filePath).suffix().toLower();
     if (extension == QS("docx")) {
         status = parseDocxDocument(filePath, elements);
     } else if (extension == QS("pdf")) {
-        status = parsePdfDocument(filePath, elements);
+        status = parsePdfDocument(filePath, elements, fontTable);
     } else {
         return result;
     }
@@ -148,16 +161,209 @@ QByteArray LosslessDocumentConverter::convertToLosslessXmlByteArray(const QStrin
     
     establishElementRelationships(elements);
     
-    QBuffer buffer(&result);
-    buffer.open(QIODevice::WriteOnly);
+    return serializeElements(elements, fontTable);
+}
+
+LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::convertToLosslessXmlIncremental(const QString &filePath, const QString &outputPath, const QString &manifestPath)
+{
+    if (QFileInfo(filePath).suffix().toLower() != QS("docx")) {
+        // PDF没有可按部件比较的结构，直接全量转换
+        return convertToLosslessXml(filePath, outputPath);
+    }
     
-    QXmlStreamWriter writer(&buffer);
-    writer.setAutoFormatting(true);
-    writer.setAutoFormattingIndent(2);
+    emit conversionProgress(0, QS("开始增量转换..."));
     
-    writeElementsToXml(elements, writer);
+    if (!QFileInfo::exists(filePath)) {
+        emit conversionFinished(ConvertStatus::FILE_NOT_FOUND, QS("文件不存在"));
+        return ConvertStatus::FILE_NOT_FOUND;
+    }
     
-    return result;
+    const QString effectiveManifestPath = manifestPath.isEmpty() ? outputPath + QS(".manifest") : manifestPath;
+    
+    try {
+        // 只读取中央目录即可判断哪些部件发生了变化
+        const QMap<QString, KZipUtils::EntryInfo> entries = KZipUtils::getZipEntries(filePath);
+        if (!entries.contains(QS("word/document.xml"))) {
+            emit conversionFinished(ConvertStatus::PARSE_ERROR, QS("文档解析失败"));
+            return ConvertStatus::PARSE_ERROR;
+        }
+        
+        QMap<QString, KZipUtils::EntryInfo> globalParts;
+        for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+            if (DocxConversionManifest::isGlobalPart(it.key())) {
+                globalParts.insert(it.key(), it.value());
+            }
+        }
+        const QByteArray documentHash = DocxConversionManifest::entryDigest(entries.value(QS("word/document.xml")));
+        
+        // 样式、编号、关系等全局部件变化时所有块都需要重新解析
+        DocxConversionManifest previous;
+        bool reusable = previous.load(effectiveManifestPath);
+        if (reusable) {
+            reusable = previous.parts.size() == globalParts.size();
+            for (auto it = globalParts.constBegin(); reusable && it != globalParts.constEnd(); ++it) {
+                const KZipUtils::EntryInfo old = previous.parts.value(it.key());
+                reusable = old.crc32 == it.value().crc32 && old.size == it.value().size;
+            }
+        }
+        
+        // 输出文件可能已被全量转换或其他程序覆盖，必须仍是清单记录时写出的那一份才能直接沿用
+        if (reusable && previous.documentHash == documentHash && previous.matchesOutput(outputPath)) {
+            emit conversionProgress(100, QS("文档未变化，沿用上次转换结果"));
+            emit conversionFinished(ConvertStatus::SUCCESS, QS("增量转换成功"));
+            return ConvertStatus::SUCCESS;
+        }
+        
+        emit conversionProgress(10, QS("解析文档结构..."));
+        
+        QMap<QString, QByteArray> parts;
+        QSharedPointer<const DocxStyleResolver> cachedStyles;
+        if (!KZipUtils::readFilesFromZip(filePath, {QS("word/document.xml"), QS("word/styles.xml")}, parts, false,
+                                         nullptr, skipCachedStyles(cachedStyles)) ||
+            !parts.contains(QS("word/document.xml"))) {
+            emit conversionFinished(ConvertStatus::PARSE_ERROR, QS("文档解析失败"));
+            return ConvertStatus::PARSE_ERROR;
+        }
+        m_styleResolver = cachedStyles ? cachedStyles
+                                       : DocxStyleResolver::parseAndCache(parts.value(QS("word/styles.xml")),
+                                                                          DocxPartCache::PartKey(entries.value(QS("word/styles.xml"))));
+        
+        QByteArray prolog;
+        QByteArray epilog;
+        QList<QByteArray> rawBlocks;
+        if (!DocxConversionManifest::splitBody(parts.value(QS("word/document.xml")), prolog, rawBlocks, epilog)) {
+            // 全量转换会覆盖输出文件，旧清单与之不再对应
+            qDebug() << QS("无法拆分document.xml，回退到全量转换");
+            QFile::remove(effectiveManifestPath);
+            return convertToLosslessXml(filePath, outputPath);
+        }
+        
+        const QByteArray prologHash = DocxConversionManifest::hashBlock(prolog + epilog);
+        if (reusable && previous.prologHash != prologHash) {
+            reusable = false;
+        }
+        
+        const int blockCount = rawBlocks.size();
+        QList<QByteArray> blockHashes;
+        blockHashes.reserve(blockCount);
+        for (const QByteArray &rawBlock : rawBlocks) {
+            blockHashes.append(DocxConversionManifest::hashBlock(rawBlock));
+        }
+        
+        // 匹配公共前缀和公共后缀，只重新解析中间发生变化的块范围
+        const QList<DocxConversionManifest::Block> oldBlocks = reusable ? previous.blocks : QList<DocxConversionManifest::Block>();
+        const int oldCount = oldBlocks.size();
+        int prefix = 0;
+        while (prefix < blockCount && prefix < oldCount && oldBlocks[prefix].hash == blockHashes[prefix]) {
+            ++prefix;
+        }
+        int suffix = 0;
+        while (suffix < blockCount - prefix && suffix < oldCount - prefix &&
+               oldBlocks[oldCount - 1 - suffix].hash == blockHashes[blockCount - 1 - suffix]) {
+            ++suffix;
+        }
+        
+        emit conversionProgress(30, QString(QS("重新解析 %1/%2 个块...")).arg(blockCount - prefix - suffix).arg(blockCount));
+        
+        DocxConversionManifest manifest;
+        manifest.sourcePath = filePath;
+        manifest.parts = globalParts;
+        manifest.documentHash = documentHash;
+        manifest.prologHash = prologHash;
+        manifest.blocks.reserve(blockCount);
+        m_elementCounter = 0;
+        
+        QList<DocumentElement> elements;
+        for (int i = 0; i < blockCount; ++i) {
+            QList<DocumentElement> blockElements;
+            
+            if (i < prefix || i >= blockCount - suffix) {
+                // 未变化的块从旧片段还原元素，片段损坏时按新块重新解析
+                const DocxConversionManifest::Block &old = i < prefix ? oldBlocks[i] : oldBlocks[oldCount - (blockCount - i)];
+                QXmlStreamReader reader(QByteArray("<Fragment>") + old.fragment + QByteArray("</Fragment>"));
+                if (readElementsFromXml(reader, blockElements) == ConvertStatus::SUCCESS &&
+                    blockElements.size() == old.elementCount) {
+                    manifest.blocks.append(old);
+                    elements.append(blockElements);
+                    continue;
+                }
+                blockElements.clear();
+            }
+            
+            // 单个块与原始前缀、后缀拼接后仍是带完整命名空间声明的合法文档
+            ConvertStatus status = parseDocxDocumentXml(prolog + rawBlocks[i] + epilog, filePath, blockElements);
+            if (status != ConvertStatus::SUCCESS) {
+                emit conversionFinished(status, QS("文档解析失败"));
+                return status;
+            }
+            
+            DocxConversionManifest::Block block;
+            block.hash = blockHashes[i];
+            block.elementCount = blockElements.size();
+            block.fragment = serializeElementsFragment(blockElements);
+            manifest.blocks.append(block);
+            elements.append(blockElements);
+        }
+        
+        // 复用块的ID来自上一次转换，按文档顺序重新编号，写出时的排序和全量转换一致
+        for (int i = 0; i < elements.size(); ++i) {
+            elements[i].id = generateElementId(elements[i].type, i);
+            elements[i].position.relatedIds.clear();
+        }
+        m_elementCounter = elements.size();
+        
+        emit conversionProgress(50, QS("建立元素关系..."));
+        establishElementRelationships(elements);
+        
+        emit conversionProgress(70, QS("生成XML文件..."));
+        
+        QDir outputDir = QFileInfo(outputPath).absoluteDir();
+        if (!outputDir.exists()) {
+            outputDir.mkpath(QS("."));
+        }
+        
+        // 输出文件即将被覆盖，先作废旧清单，中途失败时下次不会误用
+        QFile::remove(effectiveManifestPath);
+        
+        QFile outputFile(outputPath);
+        if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            emit conversionFinished(ConvertStatus::WRITE_ERROR, QS("无法创建输出文件"));
+            return ConvertStatus::WRITE_ERROR;
+        }
+        
+        QXmlStreamWriter writer(&outputFile);
+        writer.setAutoFormatting(true);
+        writer.setAutoFormattingIndent(2);
+        
+        // DOCX没有字体表
+        ConvertStatus status = writeElementsToXml(elements, nullptr, writer);
+        outputFile.close();
+        
+        if (status != ConvertStatus::SUCCESS) {
+            emit conversionFinished(status, QS("XML写入失败"));
+            return status;
+        }
+        
+        emit conversionProgress(90, QS("验证转换完整性..."));
+        if (!validateConversionIntegrity(filePath, outputPath)) {
+            emit conversionFinished(ConvertStatus::PARSE_ERROR, QS("转换完整性验证失败"));
+            return ConvertStatus::PARSE_ERROR;
+        }
+        
+        manifest.recordOutput(outputPath);
+        if (!manifest.save(effectiveManifestPath)) {
+            qDebug() << QS("增量清单保存失败，下次将执行全量转换:") << effectiveManifestPath;
+        }
+        
+        emit conversionProgress(100, QS("转换完成"));
+        emit conversionFinished(ConvertStatus::SUCCESS, QS("增量转换成功"));
+        return ConvertStatus::SUCCESS;
+        
+    } catch (const std::exception &e) {
+        qDebug() << QS("增量转换异常:") << e.what();
+        emit conversionFinished(ConvertStatus::UNKNOWN_ERROR, QS("增量转换异常"));
+        return ConvertStatus::UNKNOWN_ERROR;
+    }
 }
 
 LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::restoreFromLosslessXml(const QString &xmlPath, const QString &outputPath, InputFormat targetFormat)
@@ -171,6 +377,97 @@ LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::restoreFromL
     return ConvertStatus::UNKNOWN_ERROR;
 }
 
+LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::readStage(StagedDocument &document)
+{
+    const QFileInfo fileInfo(document.filePath);
+    if (!fileInfo.exists()) {
+        return ConvertStatus::FILE_NOT_FOUND;
+    }
+    document.format = m_supportedFormats.value(fileInfo.suffix().toLower(), InputFormat::UNKNOWN);
+    if (document.format == InputFormat::UNKNOWN) {
+        return ConvertStatus::INVALID_FORMAT;
+    }
+    
+    QFile file(document.filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "无法读取文件:" << document.filePath << file.errorString();
+        return ConvertStatus::FILE_NOT_FOUND;
+    }
+    
+    if (document.format == InputFormat::DOCX) {
+        document.fileData = file.readAll();
+        return file.error() == QFileDevice::NoError ? ConvertStatus::SUCCESS : ConvertStatus::UNKNOWN_ERROR;
+    }
+    
+    // PDF由Poppler按路径随机访问，顺序读一遍使后续阶段命中系统缓存
+    QByteArray chunk(READ_AHEAD_CHUNK_SIZE, Qt::Uninitialized);
+    while (file.read(chunk.data(), chunk.size()) > 0) {
+    }
+    return file.error() == QFileDevice::NoError ? ConvertStatus::SUCCESS : ConvertStatus::UNKNOWN_ERROR;
+}
+
+LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::unpackStage(StagedDocument &document)
+{
+    try {
+        if (document.format == InputFormat::DOCX) {
+            const bool unpacked = KZipUtils::readFilesFromZipData(document.fileData,
+                                                                  {QS("word/document.xml"), QS("word/styles.xml"),
+                                                                   QS("word/_rels/document.xml.rels")},
+                                                                  document.parts, false, &document.entries,
+                                                                  skipCachedStyles(document.styles));
+            // 压缩包内容只在本阶段使用
+            document.fileData = QByteArray();
+            return unpacked && document.parts.contains(QS("word/document.xml")) ? ConvertStatus::SUCCESS
+                                                                                 : ConvertStatus::PARSE_ERROR;
+        }
+        
+        // 文档随后交给parse阶段的线程，不能是按线程借出的池中实例
+        document.pdfDocument = loadPdfDocument(document.filePath, false);
+        return document.pdfDocument ? ConvertStatus::SUCCESS : ConvertStatus::PARSE_ERROR;
+        
+    } catch (const std::exception &e) {
+        qDebug() << QS("解包异常:") << e.what();
+        return ConvertStatus::UNKNOWN_ERROR;
+    }
+}
+
+LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::parseStage(StagedDocument &document)
+{
+    ConvertStatus status = ConvertStatus::INVALID_FORMAT;
+    try {
+        if (document.format == InputFormat::DOCX) {
+            status = parseDocxParts(document.parts, document.entries, document.styles, document.filePath,
+                                    document.elements);
+            document.parts.clear();
+            document.entries.clear();
+            document.styles.reset();
+        } else if (document.format == InputFormat::PDF) {
+            // serialize阶段由另一个线程的转换器执行，字体表随文档传递
+            status = parsePdfDocument(document.filePath, std::move(document.pdfDocument), document.elements,
+                                      document.fontTable);
+            document.pdfDocument.reset();
+        }
+    } catch (const std::exception &e) {
+        qDebug() << QS("解析异常:") << e.what();
+        status = ConvertStatus::UNKNOWN_ERROR;
+    }
+    return status;
+}
+
+LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::extractStage(StagedDocument &document)
+{
+    establishElementRelationships(document.elements);
+    return ConvertStatus::SUCCESS;
+}
+
+LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::serializeStage(StagedDocument &document)
+{
+    document.xml = serializeElements(document.elements, document.fontTable);
+    document.elements.clear();
+    document.fontTable.reset();
+    return document.xml.isEmpty() ? ConvertStatus::WRITE_ERROR : ConvertStatus::SUCCESS;
+}
+
 bool LosslessDocumentConverter::isSupported(const QString &filePath) const
 {
     QFileInfo fileInfo(filePath);
@@ -183,50 +480,132 @@ QStringList LosslessDocumentConverter::getSupportedFormats() const
     return m_supportedFormats.keys();
 }
 
+QFuture<QList<PdfSignatureValidator::Validation>> LosslessDocumentConverter::signatureValidation() const
+{
+    return m_signatureValidation;
+}
+
+void LosslessDocumentConverter::setPageTimeBudget(int milliseconds)
+{
+    m_pageTimeBudget = milliseconds;
+}
+
+int LosslessDocumentConverter::pageTimeBudget() const
+{
+    return m_pageTimeBudget;
+}
+
+void LosslessDocumentConverter::setDocumentTimeBudget(int milliseconds)
+{
+    m_documentTimeBudget = milliseconds;
+}
+
+int LosslessDocumentConverter::documentTimeBudget() const
+{
+    return m_documentTimeBudget;
+}
+
+void LosslessDocumentConverter::cancel()
+{
+    m_cancelRequested = true;
+}
+
 LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::parseDocxDocument(const QString &filePath, QList<DocumentElement> &elements)
 {
     elements.clear();
     m_elementCounter = 0;
     
     try {
-        // 读取document.xml
-        QByteArray documentXml;
-        if (!KZipUtils::readFileFromZip(filePath, QS("word/document.xml"), documentXml)) {
+        // 一次打开压缩包读取document.xml、样式信息和关系文件
+        QMap<QString, QByteArray> parts;
+        QMap<QString, KZipUtils::EntryInfo> entries;
+        QSharedPointer<const DocxStyleResolver> cachedStyles;
+        if (!KZipUtils::readFilesFromZip(filePath,
+                                         {QS("word/document.xml"), QS("word/styles.xml"),
+                                          QS("word/_rels/document.xml.rels")},
+                                         parts, false, &entries, skipCachedStyles(cachedStyles)) ||
+            !parts.contains(QS("word/document.xml"))) {
             return ConvertStatus::PARSE_ERROR;
         }
+        return parseDocxParts(parts, entries, cachedStyles, filePath, elements);
         
-        // 读取样式信息
-        QByteArray stylesXml;
-        KZipUtils::readFileFromZip(filePath, QS("word/styles.xml"), stylesXml);
-        
-        // 读取关系文件
-        QByteArray relationshipsXml;
-        KZipUtils::readFileFromZip(filePath, QS("word/_rels/document.xml.rels"), relationshipsXml);
-        
-        // 解析主文档
-        QXmlStreamReader reader(documentXml);
-        DocumentElement currentElement;
-        bool inParagraph = false;
-        FormatInfo currentFormat;
+    } catch (const std::exception &e) {
+        qDebug() << QS("DOCX解析异常:") << e.what();
+        return ConvertStatus::UNKNOWN_ERROR;
+    }
+}
+
+LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::parseDocxParts(const QMap<QString, QByteArray> &parts, const QMap<QString, KZipUtils::EntryInfo> &entries, const QSharedPointer<const DocxStyleResolver> &cachedStyles, const QString &filePath, QList<DocumentElement> &elements)
+{
+    elements.clear();
+    m_elementCounter = 0;
+    
+    if (!parts.contains(QS("word/document.xml"))) {
+        return ConvertStatus::PARSE_ERROR;
+    }
+    
+    // 样式表展开一次后按styles.xml的(CRC32, 大小)跨文档复用
+    m_styleResolver = cachedStyles ? cachedStyles
+                                   : DocxStyleResolver::parseAndCache(parts.value(QS("word/styles.xml")),
+                                                                      DocxPartCache::PartKey(entries.value(QS("word/styles.xml"))));
+    
+    // 解析主文档
+    return parseDocxDocumentXml(parts.value(QS("word/document.xml")), filePath, elements);
+}
+
+KZipUtils::SkipEntry LosslessDocumentConverter::skipCachedStyles(QSharedPointer<const DocxStyleResolver> &styles)
+{
+    return [&styles](const KZipUtils::EntryInfo &entry) {
+        return entry.path == QS("word/styles.xml") &&
+               DocxPartCache::instance()->lookupStyles(DocxPartCache::PartKey(entry), styles);
+    };
+}
+
+LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::parseDocxDocumentXml(const QByteArray &documentXml, const QString &filePath, QList<DocumentElement> &elements)
+{
+    if (!m_styleResolver) {
+        m_styleResolver = DocxStyleResolver::fromStylesXml(QByteArray());
+    }
+    
+    QXmlStreamReader reader(documentXml);
+    OoxmlNamespaceTable namespaces;
+    DocumentElement currentElement;
+    bool inParagraph = false;
+    bool paragraphHasText = false;
+    FormatInfo currentFormat = m_styleResolver->paragraphFormat(QString());
+    QString paragraphStyleId;
+    FormatDelta paragraphDelta;
+    
+    while (!reader.atEnd()) {
+        reader.readNext();
         
-        while (!reader.atEnd()) {
-            reader.readNext();
+        if (reader.isStartElement()) {
+            if (!namespaces.isWordprocessingML(reader.namespaceUri())) {
+                continue;
+            }
             
-            if (reader.isStartElement()) {
-                QString elementName = reader.name().toString();
-                QString namespaceUri = reader.namespaceUri().toString();
-                
-                if (elementName == QS("p") && namespaceUri.contains(QS("w"))) {
+            switch (OoxmlTags::lookup(reader.name())) {
+                case OoxmlTag::P:
                     // 段落开始
                     inParagraph = true;
+                    paragraphHasText = false;
                     currentElement = DocumentElement();
                     currentElement.type = DocumentElementType::PARAGRAPH;
                     currentElement.id = generateElementId(DocumentElementType::PARAGRAPH, m_elementCounter++);
-                    
+                    paragraphStyleId.clear();
+                    paragraphDelta.clear();
+                    currentElement.format = m_styleResolver->paragraphFormat(paragraphStyleId);
+                    break;
+                
+                case OoxmlTag::PPr:
                     // 解析段落格式
-                    parseParagraphFormat(reader, currentElement.format);
-                    
-                } else if (elementName == QS("r") && namespaceUri.contains(QS("w"))) {
+                    parseParagraphFormat(reader, paragraphStyleId, paragraphDelta);
+                    if (inParagraph) {
+                        currentElement.format = m_styleResolver->resolveParagraph(paragraphStyleId, paragraphDelta);
+                    }
+                    break;
+                
+                case OoxmlTag::R:
                     // 文本运行开始
                     if (!inParagraph) {
                         // 如果没有段落，创建一个
@@ -235,18 +614,27 @@ LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::parseDocxDoc
                         currentElement.id = generateElementId(DocumentElementType::TEXT, m_elementCounter++);
                         inParagraph = true;
                     }
-                    
+                
+                    // 没有rPr的文本运行直接使用段落样式
+                    currentFormat = m_styleResolver->resolveRun(paragraphStyleId, paragraphDelta, QString(), FormatDelta());
+                    break;
+                
+                case OoxmlTag::RPr:
                     // 解析运行格式
-                    parseRunFormat(reader, currentFormat);
-                    
-                } else if (elementName == QS("t") && namespaceUri.contains(QS("w"))) {
+                    parseRunFormat(reader, paragraphStyleId, paragraphDelta, currentFormat);
+                    break;
+                
+                case OoxmlTag::T: {
                     // 文本内容
                     QString text = reader.readElementText();
                     if (!text.isEmpty()) {
                         if (inParagraph) {
                             currentElement.content += text;
-                            // 合并格式信息 - FormatInfo是结构体，不是QMap
-                            // 这里暂时不处理格式合并，因为FormatInfo是结构体
+                            // 段落元素的字符格式取第一个文本运行的有效格式
+                            if (!paragraphHasText) {
+                                currentElement.format = currentFormat;
+                                paragraphHasText = true;
+                            }
                         } else {
                             // 如果没有段落，创建一个文本元素
                             DocumentElement textElement;
@@ -257,81 +645,116 @@ LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::parseDocxDoc
                             elements.append(textElement);
                         }
                     }
-                    
-                } else if (elementName == QS("drawing") && namespaceUri.contains(QS("w"))) {
+                    break;
+                }
+                
+                case OoxmlTag::Drawing: {
                     // 图片或形状
                     DocumentElement imageElement;
                     imageElement.type = DocumentElementType::IMAGE;
                     imageElement.id = generateElementId(DocumentElementType::IMAGE, m_elementCounter++);
-                    
+                
                     parseDrawingElement(reader, imageElement, filePath);
                     elements.append(imageElement);
-                    
-                } else if (elementName == QS("tbl") && namespaceUri.contains(QS("w"))) {
+                    break;
+                }
+                
+                case OoxmlTag::Tbl: {
                     // 表格
                     DocumentElement tableElement;
                     tableElement.type = DocumentElementType::TABLE;
                     tableElement.id = generateElementId(DocumentElementType::TABLE, m_elementCounter++);
-                    
+                
                     parseTableElement(reader, tableElement);
                     elements.append(tableElement);
+                    break;
                 }
                 
-            } else if (reader.isEndElement()) {
-                QString elementName = reader.name().toString();
-                QString namespaceUri = reader.namespaceUri().toString();
-                
-                if (elementName == QS("p") && namespaceUri.contains(QS("w"))) {
-                    // 段落结束
-                    if (inParagraph && !currentElement.content.isEmpty()) {
-                        elements.append(currentElement);
-                    }
-                    inParagraph = false;
-                    
-                } else if (elementName == QS("r") && namespaceUri.contains(QS("w"))) {
-                    // 运行结束
-                    // 不需要特殊处理
+                default:
+                    break;
+            }
+            
+        } else if (reader.isEndElement()) {
+            if (OoxmlTags::lookup(reader.name()) == OoxmlTag::P &&
+                namespaces.isWordprocessingML(reader.namespaceUri())) {
+                // 段落结束
+                if (inParagraph && !currentElement.content.isEmpty()) {
+                    elements.append(currentElement);
                 }
+                inParagraph = false;
             }
         }
-        
-        if (reader.hasError()) {
-            qDebug() << QS("XML解析错误:") << reader.errorString();
-            return ConvertStatus::PARSE_ERROR;
-        }
-        
-        return ConvertStatus::SUCCESS;
-        
-    } catch (const std::exception &e) {
-        qDebug() << QS("DOCX解析异常:") << e.what();
-        return ConvertStatus::UNKNOWN_ERROR;
     }
+    
+    if (reader.hasError()) {
+        qDebug() << QS("XML解析错误:") << reader.errorString();
+        return ConvertStatus::PARSE_ERROR;
+    }
+    
+    return ConvertStatus::SUCCESS;
 }
 
-LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::parsePdfDocument(const QString &filePath, QList<DocumentElement> &elements)
+LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::parsePdfDocument(const QString &filePath, QList<DocumentElement> &elements,
+                                                                                    std::shared_ptr<const PdfFontTable> &fontTable)
+{
+    return parsePdfDocument(filePath, nullptr, elements, fontTable);
+}
+
+LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::parsePdfDocument(const QString &filePath, std::shared_ptr<Poppler::Document> document,
+                                                                                    QList<DocumentElement> &elements,
+                                                                                    std::shared_ptr<const PdfFontTable> &fontTable)
 {
     elements.clear();
+    fontTable.reset();
     m_elementCounter = 0;
+    // 取消请求在本次转换结束时才清除：转换开始前发出的cancel()同样生效
+    const auto clearCancel = qScopeGuard([this]() { m_cancelRequested = false; });
+    
+    // 文档时限覆盖加载、版面分析和页面处理，页面时限由它派生
+    const ProcessingDeadline deadline(m_documentTimeBudget, &m_cancelRequested);
+    const ProcessingDeadline::Scope deadlineScope(deadline);
     
     try {
-        // 1. 加载PDF文档
-        auto document = loadPdfDocument(filePath);
+        // 1. 加载PDF文档（分阶段转换时已在unpack阶段加载）
+        if (!document) {
+            document = loadPdfDocument(filePath);
+        }
         if (!document) {
             return ConvertStatus::PARSE_ERROR;
         }
         
-        // 2. 检查数字签名
-        bool hasSignatures = checkDigitalSignatures(document.get());
+        // 文本元素的字体编号指向该文档的字体表
+        fontTable = PdfTextLayoutCache::instance()->fontTable(document);
+        
+        // 2. 打开核心文档，表格和图片/图表区域检测需要直接访问poppler核心文档
+        m_coreDocument = std::make_unique<PdfCoreDocument>();
+        if (!m_coreDocument->open(filePath)) {
+            qDebug() << "Core document unavailable:" << m_coreDocument->lastError();
+            m_coreDocument.reset();
+        } else {
+            m_analysisRaster = std::make_unique<PdfAnalysisRaster>();
+        }
+        
+        // 3. 发现数字签名，验证在后台与页面处理并行进行
+        const QList<PdfSignatureValidator::Signature> signatures = discoverSignatures(filePath);
         
-        // 3. 处理所有页面
-        ConvertStatus pageStatus = processAllPages(document.get(), elements);
+        // 带标签的PDF直接使用结构树，无标签或结构树没有可用内容时回退到几何分析
+        ConvertStatus pageStatus = ConvertStatus::PARSE_ERROR;
+        if (m_coreDocument && PdfStructureExtractor::isTagged(*m_coreDocument)) {
+            pageStatus = processTaggedDocument(document, deadline, elements);
+        }
+        if (pageStatus != ConvertStatus::SUCCESS) {
+            pageStatus = processAllPages(document, deadline, elements);
+        }
+        m_analysisRaster.reset();
+        m_coreDocument.reset();
         if (pageStatus != ConvertStatus::SUCCESS) {
             return pageStatus;
         }
         
         // 4. 添加签名信息（如果有）
-        if (hasSignatures) {
-            addSignatureElements(elements);
+        if (!signatures.isEmpty()) {
+            addSignatureElements(signatures, elements);
         }
         
         qDebug() << "PDF parsing completed, extracted" << elements.size() << "elements";
@@ -343,17 +766,16 @@ LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::parsePdfDocu
     }
 }
 
-std::unique_ptr<Poppler::Document> LosslessDocumentConverter::loadPdfDocument(const QString &filePath)
+std::shared_ptr<Poppler::Document> LosslessDocumentConverter::loadPdfDocument(const QString &filePath, bool pooled)
 {
     try {
-        std::unique_ptr<Poppler::Document> document = Poppler::Document::load(filePath);
+        // 与同一线程中的PDF提取器共享同一个已解析的文档
+        QString errorMessage;
+        std::shared_ptr<Poppler::Document> document = pooled
+            ? PdfDocumentPool::instance()->acquire(filePath, &errorMessage)
+            : PdfDocumentPool::load(filePath, &errorMessage);
         if (!document) {
-            qDebug() << "Failed to load PDF document:" << filePath;
-            return nullptr;
-        }
-        
-        if (document->isLocked()) {
-            qDebug() << "PDF document is locked:" << filePath;
+            qDebug() << "Failed to load PDF document:" << filePath << errorMessage;
             return nullptr;
         }
         
@@ -372,26 +794,41 @@ std::unique_ptr<Poppler::Document> LosslessDocumentConverter::loadPdfDocument(co
     }
 }
 
-bool LosslessDocumentConverter::checkDigitalSignatures(Poppler::Document *document)
+QList<PdfSignatureValidator::Signature> LosslessDocumentConverter::discoverSignatures(const QString &filePath)
 {
-    try {
-        auto signatures = document->signatures();
-        bool hasSignatures = !signatures.empty();
-        if (hasSignatures) {
-            qDebug() << "PDF document has" << signatures.size() << "digital signatures";
-        }
-        return hasSignatures;
-    } catch (const std::exception &e) {
-        qDebug() << "Error checking signatures:" << e.what();
-        return false;
+    m_signatureValidation = QFuture<QList<PdfSignatureValidator::Validation>>();
+    if (!m_coreDocument) {
+        return QList<PdfSignatureValidator::Signature>();
+    }
+    
+    // 发现只读取字段树，不做密码学运算
+    const QList<PdfSignatureValidator::Signature> signatures = PdfSignatureValidator::discover(*m_coreDocument);
+    if (!signatures.isEmpty()) {
+        qDebug() << "PDF document has" << signatures.size() << "digital signatures";
+        m_signatureValidation = PdfSignatureValidator::instance()->validateAsync(filePath);
     }
+    return signatures;
 }
 
-LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::processAllPages(Poppler::Document *document, QList<DocumentElement> &elements)
+LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::processAllPages(const std::shared_ptr<Poppler::Document> &document,
+                                                                                    const ProcessingDeadline &deadline,
+                                                                                    QList<DocumentElement> &elements)
 {
     int pageCount = document->numPages();
     
     for (int pageIndex = 0; pageIndex < pageCount; ++pageIndex) {
+        // 文档超时或被取消，剩余页面以一个错误元素标明
+        if (deadline.hasExpired()) {
+            addParseErrorElement(pageIndex, pageCount - 1,
+                                 deadline.isCancelled() ? QS("cancelled") : QS("document_timeout"),
+                                 deadline.elapsed(), elements);
+            break;
+        }
+        
+        const qsizetype firstElement = elements.size();
+        const ProcessingDeadline pageDeadline(m_pageTimeBudget, deadline);
+        const ProcessingDeadline::Scope pageScope(pageDeadline);
+        
         try {
             std::unique_ptr<Poppler::Page> page = document->page(pageIndex);
             if (!page) {
@@ -399,23 +836,171 @@ LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::processAllPa
                 continue;
             }
             
+            // 文本版面只分析一次，在整个页面处理期间由各提取步骤共用
+            PdfTextLayoutCache::LayoutPtr textLayout =
+                PdfTextLayoutCache::instance()->acquire(document, page.get(), pageIndex, m_coreDocument.get());
+            
             // 处理单个页面
-            ConvertStatus pageStatus = processSinglePage(page.get(), pageIndex, elements);
+            ConvertStatus pageStatus = processSinglePage(page.get(), pageIndex, *textLayout, elements);
             if (pageStatus != ConvertStatus::SUCCESS) {
                 qDebug() << "Error processing page" << pageIndex;
-                continue; // 继续处理下一页
             }
             
         } catch (const std::exception &e) {
             qDebug() << "Error processing page" << pageIndex << ":" << e.what();
-            continue; // 继续处理下一页
+        }
+        
+        // 超时页面的提取被中途打断，部分结果不完整，以错误元素代替
+        if (pageDeadline.hasExpired()) {
+            qDebug() << "Page" << pageIndex << "exceeded its time budget after" << pageDeadline.elapsed() << "ms";
+            elements.remove(firstElement, elements.size() - firstElement);
+            QString reason = QS("page_timeout");
+            if (pageDeadline.isCancelled()) {
+                reason = QS("cancelled");
+            } else if (deadline.hasExpired()) {
+                reason = QS("document_timeout");
+            }
+            addParseErrorElement(pageIndex, pageIndex, reason, pageDeadline.elapsed(), elements);
         }
     }
     
     return ConvertStatus::SUCCESS;
 }
 
-LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::processSinglePage(Poppler::Page *page, int pageIndex, QList<DocumentElement> &elements)
+void LosslessDocumentConverter::addParseErrorElement(int firstPageIndex, int lastPageIndex, const QString &reason,
+                                                     qint64 elapsedMs, QList<DocumentElement> &elements)
+{
+    DocumentElement errorElement;
+    errorElement.type = DocumentElementType::PARSE_ERROR;
+    errorElement.id = generateElementId(DocumentElementType::PARSE_ERROR, m_elementCounter++);
+    errorElement.position.pageNumber = firstPageIndex + 1;
+    errorElement.content = firstPageIndex == lastPageIndex
+                               ? QS("第%1页未能在时限内处理").arg(firstPageIndex + 1)
+                               : QS("第%1-%2页未能在时限内处理").arg(firstPageIndex + 1).arg(lastPageIndex + 1);
+    errorElement.attributes[QS("reason")] = reason;
+    errorElement.attributes[QS("first_page")] = QString::number(firstPageIndex + 1);
+    errorElement.attributes[QS("last_page")] = QString::number(lastPageIndex + 1);
+    errorElement.attributes[QS("elapsed_ms")] = QString::number(elapsedMs);
+    errorElement.attributes[QS("page_budget_ms")] = QString::number(m_pageTimeBudget);
+    errorElement.attributes[QS("document_budget_ms")] = QString::number(m_documentTimeBudget);
+    elements.append(errorElement);
+}
+
+LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::processTaggedDocument(const std::shared_ptr<Poppler::Document> &document,
+                                                                                          const ProcessingDeadline &deadline,
+                                                                                          QList<DocumentElement> &elements)
+{
+    try {
+        // 结构树回放每页使用自己的页面时限，超时页面在下面以错误元素标明
+        QList<PdfStructureExtractor::PageTimeout> pageTimeouts;
+        const QList<PdfStructureExtractor::Element> structureElements =
+            PdfStructureExtractor::extractElements(*m_coreDocument, m_pageTimeBudget, &pageTimeouts);
+        // 因超时而没有内容时回退到几何分析只会再次超时
+        if (structureElements.isEmpty() && pageTimeouts.isEmpty() && !deadline.hasExpired()) {
+            qDebug() << "Structure tree has no usable content, falling back to layout analysis";
+            return ConvertStatus::PARSE_ERROR;
+        }
+        if (structureElements.isEmpty() && deadline.hasExpired()) {
+            addParseErrorElement(0, document->numPages() - 1,
+                                 deadline.isCancelled() ? QS("cancelled") : QS("document_timeout"),
+                                 deadline.elapsed(), elements);
+        }
+        
+        // 插图需要渲染区域图像，相邻元素通常在同一页，只保留当前页
+        std::unique_ptr<Poppler::Page> page;
+        int loadedPageIndex = -1;
+        int readingOrder = 0;
+        
+        for (const PdfStructureExtractor::Element &structureElement : structureElements) {
+            if (deadline.hasExpired()) {
+                const int pageIndex = qMax(0, structureElement.pageIndex);
+                addParseErrorElement(pageIndex, document->numPages() - 1,
+                                     deadline.isCancelled() ? QS("cancelled") : QS("document_timeout"),
+                                     deadline.elapsed(), elements);
+                break;
+            }
+            
+            DocumentElement element;
+            element.position.pageNumber = structureElement.pageIndex + 1;
+            element.position.boundingBox = structureElement.boundingBox.toAlignedRect();
+            element.attributes[QS("extraction_method")] = QS("structure_tree");
+            element.attributes[QS("reading_order")] = QString::number(readingOrder++);
+            
+            switch (structureElement.kind) {
+                case PdfStructureExtractor::ElementKind::PARAGRAPH:
+                    element.type = DocumentElementType::PARAGRAPH;
+                    element.content = structureElement.text;
+                    break;
+                case PdfStructureExtractor::ElementKind::HEADING:
+                    element.type = DocumentElementType::PARAGRAPH;
+                    element.content = structureElement.text;
+                    element.attributes[QS("role")] = QS("heading");
+                    element.attributes[QS("level")] = QString::number(structureElement.headingLevel);
+                    break;
+                case PdfStructureExtractor::ElementKind::FIGURE:
+                    element.type = DocumentElementType::IMAGE;
+                    element.content = structureElement.altText.isEmpty() ? structureElement.text : structureElement.altText;
+                    if (!structureElement.altText.isEmpty()) {
+                        element.attributes[QS("alt_text")] = structureElement.altText;
+                    }
+                    if (structureElement.pageIndex >= 0 && !structureElement.boundingBox.isEmpty()) {
+                        if (loadedPageIndex != structureElement.pageIndex) {
+                            page = document->page(structureElement.pageIndex);
+                            loadedPageIndex = structureElement.pageIndex;
+                        }
+                        if (page) {
+                            element.mimeType = QS("image/png");
+                            element.binaryData = PdfRegionRenderer::renderRegionToPng(page.get(), structureElement.boundingBox);
+                            element.attributes[QS("dpi")] = QString::number(qRound(PdfRegionRenderer::effectiveDpi(structureElement.boundingBox)));
+                        }
+                    }
+                    break;
+                case PdfStructureExtractor::ElementKind::TABLE:
+                    element.type = DocumentElementType::TABLE;
+                    element.content = structureElement.text;
+                    element.attributes[QS("rows")] = QString::number(structureElement.rowCount);
+                    element.attributes[QS("columns")] = QString::number(structureElement.columnCount);
+                    for (const PdfStructureExtractor::Cell &cell : structureElement.cells) {
+                        DocumentElement cellElement;
+                        cellElement.type = DocumentElementType::TEXT;
+                        cellElement.id = generateElementId(DocumentElementType::TEXT, m_elementCounter++);
+                        cellElement.content = cell.text;
+                        cellElement.position.pageNumber = element.position.pageNumber;
+                        cellElement.position.boundingBox = cell.boundingBox.toAlignedRect();
+                        cellElement.attributes[QS("row")] = QString::number(cell.row);
+                        cellElement.attributes[QS("column")] = QString::number(cell.column);
+                        cellElement.attributes[QS("row_span")] = QString::number(cell.rowSpan);
+                        cellElement.attributes[QS("column_span")] = QString::number(cell.columnSpan);
+                        if (cell.header) {
+                            cellElement.attributes[QS("header")] = QS("true");
+                        }
+                        element.children.append(cellElement);
+                    }
+                    break;
+            }
+            
+            element.id = generateElementId(element.type, m_elementCounter++);
+            elements.append(element);
+        }
+        
+        for (const PdfStructureExtractor::PageTimeout &timeout : pageTimeouts) {
+            qDebug() << "Page" << timeout.pageIndex << "exceeded its time budget after" << timeout.elapsedMs << "ms";
+            addParseErrorElement(timeout.pageIndex, timeout.pageIndex, QS("page_timeout"), timeout.elapsedMs, elements);
+        }
+        
+        qDebug() << "Tagged PDF processed from structure tree," << elements.size() << "elements";
+        return ConvertStatus::SUCCESS;
+        
+    } catch (const std::exception &e) {
+        qDebug() << "Error processing structure tree:" << e.what();
+        elements.clear();
+        return ConvertStatus::PARSE_ERROR;
+    }
+}
+
+LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::processSinglePage(Poppler::Page *page, int pageIndex,
+                                                                                      const PdfTextLayoutCache::Layout &textLayout,
+                                                                                      QList<DocumentElement> &elements)
 {
     try {
         // 获取页面尺寸
@@ -423,29 +1008,46 @@ LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::processSingl
         qDebug() << "Processing page" << pageIndex << "size:" << pageSize;
         
         // 1. 提取文本元素（最安全，不会崩溃）
-        extractTextElements(page, pageIndex, elements);
+        extractTextElements(textLayout, pageIndex, elements);
+        
+        // 每个步骤之前检查页面时限，超时的页面由processAllPages替换为错误元素
+        if (ProcessingDeadline::currentExpired()) {
+            return ConvertStatus::PARSE_ERROR;
+        }
+        
+        // 图片和图表共用一次内容流分析的结果
+        const QList<PdfRegionDetector::Region> regions = detectPageRegions(pageIndex);
+        if (ProcessingDeadline::currentExpired()) {
+            return ConvertStatus::PARSE_ERROR;
+        }
         
         // 2. 尝试提取图片元素（可能崩溃，添加保护）
         try {
-            extractImageElements(page, pageIndex, elements);
+            extractImageElements(page, pageIndex, regions, elements);
         } catch (const std::exception &e) {
             qDebug() << "Image extraction failed for page" << pageIndex << ":" << e.what();
         } catch (...) {
             qDebug() << "Image extraction failed for page" << pageIndex << "with unknown error";
         }
+        if (ProcessingDeadline::currentExpired()) {
+            return ConvertStatus::PARSE_ERROR;
+        }
         
         // 3. 提取表格元素（相对安全）
         try {
-            extractTableElements(page, pageIndex, elements);
+            extractTableElements(textLayout, pageIndex, elements);
         } catch (const std::exception &e) {
             qDebug() << "Table extraction failed for page" << pageIndex << ":" << e.what();
         } catch (...) {
             qDebug() << "Table extraction failed for page" << pageIndex << "with unknown error";
         }
+        if (ProcessingDeadline::currentExpired()) {
+            return ConvertStatus::PARSE_ERROR;
+        }
         
         // 4. 尝试提取图表元素（可能崩溃，添加保护）
         try {
-            extractChartElements(page, pageIndex, elements);
+            extractChartElements(page, pageIndex, regions, elements);
         } catch (const std::exception &e) {
             qDebug() << "Chart extraction failed for page" << pageIndex << ":" << e.what();
         } catch (...) {
@@ -463,12 +1065,13 @@ LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::processSingl
     }
 }
 
-void LosslessDocumentConverter::extractTextElements(Poppler::Page *page, int pageIndex, QList<DocumentElement> &elements)
+void LosslessDocumentConverter::extractTextElements(const PdfTextLayoutCache::Layout &textLayout, int pageIndex, QList<DocumentElement> &elements)
 {
     try {
-        // 使用textList()方法提取精确的文本位置信息
-        auto textBoxes = page->textList();
-        for (const auto &textBox : textBoxes) {
+        // 使用页面版面中的文本框提取精确的文本位置信息
+        const bool hasFonts = textLayout.hasFonts();
+        for (int boxIndex = 0; boxIndex < static_cast<int>(textLayout.boxes.size()); ++boxIndex) {
+            const auto &textBox = textLayout.boxes.at(boxIndex);
             if (!textBox) continue;
                 
             DocumentElement textElement;
@@ -488,6 +1091,9 @@ void LosslessDocumentConverter::extractTextElements(Poppler::Page *page, int pag
             
             // 设置格式信息
             extractTextBoxFormatInfo(textBox.get(), textElement);
+            if (hasFonts) {
+                applyPdfFont(*textLayout.fonts, textLayout.fontIds.at(boxIndex), textElement);
+            }
             
             elements.append(textElement);
         }
@@ -496,7 +1102,9 @@ void LosslessDocumentConverter::extractTextElements(Poppler::Page *page, int pag
     }
 }
 
-void LosslessDocumentConverter::extractImageElements(Poppler::Page *page, int pageIndex, QList<DocumentElement> &elements)
+void LosslessDocumentConverter::extractImageElements(Poppler::Page *page, int pageIndex,
+                                                     const QList<PdfRegionDetector::Region> &regions,
+                                                     QList<DocumentElement> &elements)
 {
     try {
         // 添加页面有效性检查
@@ -505,38 +1113,16 @@ void LosslessDocumentConverter::extractImageElements(Poppler::Page *page, int pa
             return;
         }
         
-        // 获取页面尺寸进行验证
-        QSizeF pageSize = page->pageSizeF();
-        if (pageSize.width() <= 0 || pageSize.height() <= 0) {
-            qDebug() << "Invalid page size, skipping image extraction";
-            return;
-        }
-        
-        // 渲染页面为图像进行分析，添加错误处理
-        QImage pageImage;
-        try {
-            // 使用较低的分辨率来避免内存问题
-            pageImage = page->renderToImage(72.0, 72.0); // 降低DPI从150到72
-        } catch (const std::exception &e) {
-            qDebug() << "Error rendering page to image:" << e.what();
-            return;
-        } catch (...) {
-            qDebug() << "Unknown error rendering page to image";
-            return;
-        }
-        
-        if (pageImage.isNull()) {
-            qDebug() << "Failed to render page to image";
-            return;
-        }
-        
-        // 检测图片区域（基于颜色和形状分析）
-        QList<QRect> imageRegions = detectImageRegions(pageImage);
-        
-        for (int i = 0; i < imageRegions.size(); ++i) {
-            const QRect &region = imageRegions[i];
+        int imageIndex = 0;
+        for (const PdfRegionDetector::Region &detected : regions) {
+            if (ProcessingDeadline::currentExpired()) {
+                break;
+            }
+            if (detected.type != PdfRegionDetector::RegionType::IMAGE) {
+                continue;
+            }
             
-            // 验证区域有效性
+            const QRect region = detected.boundingBox.toAlignedRect();
             if (region.width() <= 0 || region.height() <= 0) {
                 continue;
             }
@@ -544,23 +1130,15 @@ void LosslessDocumentConverter::extractImageElements(Poppler::Page *page, int pa
             DocumentElement imageElement;
             imageElement.type = DocumentElementType::IMAGE;
             imageElement.id = generateElementId(DocumentElementType::IMAGE, m_elementCounter++);
-            imageElement.content = QS("图片区域_%1_%2x%3").arg(i + 1).arg(region.width()).arg(region.height());
+            imageElement.content = QS("图片区域_%1_%2x%3").arg(++imageIndex).arg(region.width()).arg(region.height());
             imageElement.position.pageNumber = pageIndex + 1;
             imageElement.position.boundingBox = region;
             imageElement.mimeType = QS("image/png");
+            imageElement.attributes[QS("extraction_method")] = QS("vector_bbox");
             
-            // 裁剪并保存图片数据，添加错误处理
-            try {
-                QImage croppedImage = pageImage.copy(region);
-                if (!croppedImage.isNull()) {
-                    QBuffer buffer(&imageElement.binaryData);
-                    buffer.open(QIODevice::WriteOnly);
-                    croppedImage.save(&buffer, "PNG");
-                }
-            } catch (const std::exception &e) {
-                qDebug() << "Error processing image region:" << e.what();
-                continue;
-            }
+            // 只按目标分辨率渲染区域本身，大区域分块
+            imageElement.binaryData = PdfRegionRenderer::renderRegionToPng(page, detected.boundingBox);
+            imageElement.attributes[QS("dpi")] = QString::number(qRound(PdfRegionRenderer::effectiveDpi(detected.boundingBox)));
             
             elements.append(imageElement);
         }
@@ -571,31 +1149,44 @@ void LosslessDocumentConverter::extractImageElements(Poppler::Page *page, int pa
     }
 }
 
-void LosslessDocumentConverter::extractTableElements(Poppler::Page *page, int pageIndex, QList<DocumentElement> &elements)
+void LosslessDocumentConverter::extractTableElements(const PdfTextLayoutCache::Layout &textLayout, int pageIndex, QList<DocumentElement> &elements)
 {
     try {
-        // 使用Poppler的表格检测功能
-        auto textBoxes = page->textList();
+        if (!m_coreDocument) {
+            return;
+        }
         
-        // 直接使用std::vector，避免QList的unique_ptr问题
-        QList<QRectF> tableRegions = detectTableRegionsFromVector(textBoxes);
+        // 由矢量表格线构建单元格网格，再把文本框按位置归入单元格
+        QList<PdfTableDetector::Table> tables =
+            PdfTableDetector::buildTables(PdfTableDetector::collectRulings(*m_coreDocument, pageIndex));
+        if (tables.isEmpty()) {
+            return;
+        }
+        
+        QList<PdfTableDetector::TextFragment> fragments;
+        fragments.reserve(static_cast<qsizetype>(textLayout.boxes.size()));
+        for (const auto &textBox : textLayout.boxes) {
+            if (textBox) {
+                fragments.append({textBox->boundingBox(), textBox->text()});
+            }
+        }
+        PdfTableDetector::assignFragments(tables, fragments);
         
-        for (const QRectF &region : tableRegions) {
+        for (const PdfTableDetector::Table &table : tables) {
             DocumentElement tableElement;
             tableElement.type = DocumentElementType::TABLE;
             tableElement.id = generateElementId(DocumentElementType::TABLE, m_elementCounter++);
-            tableElement.content = QS("表格");
+            tableElement.content = table.toText();
             tableElement.position.pageNumber = pageIndex + 1;
             tableElement.position.boundingBox = QRect(
-                static_cast<int>(region.x()),
-                static_cast<int>(region.y()),
-                static_cast<int>(region.width()),
-                static_cast<int>(region.height())
+                static_cast<int>(table.boundingBox.x()),
+                static_cast<int>(table.boundingBox.y()),
+                static_cast<int>(table.boundingBox.width()),
+                static_cast<int>(table.boundingBox.height())
             );
-            
-            // 提取表格内容
-            QString tableContent = extractTableContentFromVector(textBoxes, region);
-            tableElement.content = tableContent;
+            tableElement.attributes[QS("rows")] = QString::number(table.rowCount);
+            tableElement.attributes[QS("columns")] = QString::number(table.columnCount);
+            tableElement.attributes[QS("extraction_method")] = QS("vector_rulings");
             
             elements.append(tableElement);
         }
@@ -604,7 +1195,9 @@ void LosslessDocumentConverter::extractTableElements(Poppler::Page *page, int pa
     }
 }
 
-void LosslessDocumentConverter::extractChartElements(Poppler::Page *page, int pageIndex, QList<DocumentElement> &elements)
+void LosslessDocumentConverter::extractChartElements(Poppler::Page *page, int pageIndex,
+                                                     const QList<PdfRegionDetector::Region> &regions,
+                                                     QList<DocumentElement> &elements)
 {
     try {
         // 添加页面有效性检查
@@ -613,29 +1206,15 @@ void LosslessDocumentConverter::extractChartElements(Poppler::Page *page, int pa
             return;
         }
         
-        // 渲染页面为图像进行分析，添加错误处理
-        QImage pageImage;
-        try {
-            // 使用较低的分辨率来避免内存问题
-            pageImage = page->renderToImage(72.0, 72.0); // 降低DPI从150到72
-        } catch (const std::exception &e) {
-            qDebug() << "Error rendering page to image for chart detection:" << e.what();
-            return;
-        } catch (...) {
-            qDebug() << "Unknown error rendering page to image for chart detection";
-            return;
-        }
-        
-        if (pageImage.isNull()) {
-            qDebug() << "Failed to render page to image for chart detection";
-            return;
-        }
-        
-        // 检测图表区域（基于颜色和形状分析）
-        QList<QRectF> chartRegions = detectChartRegions(pageImage);
-        
-        for (const QRectF &region : chartRegions) {
-            // 验证区域有效性
+        for (const PdfRegionDetector::Region &detected : regions) {
+            if (ProcessingDeadline::currentExpired()) {
+                break;
+            }
+            if (detected.type != PdfRegionDetector::RegionType::CHART) {
+                continue;
+            }
+            
+            const QRect region = detected.boundingBox.toAlignedRect();
             if (region.width() <= 0 || region.height() <= 0) {
                 continue;
             }
@@ -645,14 +1224,14 @@ void LosslessDocumentConverter::extractChartElements(Poppler::Page *page, int pa
             chartElement.id = generateElementId(DocumentElementType::CHART, m_elementCounter++);
             chartElement.content = QS("图表");
             chartElement.position.pageNumber = pageIndex + 1;
-            chartElement.position.boundingBox = QRect(
-                static_cast<int>(region.x()),
-                static_cast<int>(region.y()),
-                static_cast<int>(region.width()),
-                static_cast<int>(region.height())
-            );
+            chartElement.position.boundingBox = region;
+            chartElement.attributes[QS("paths")] = QString::number(detected.pathCount);
+            chartElement.attributes[QS("labels")] = QString::number(detected.textCount);
+            chartElement.attributes[QS("extraction_method")] = QS("vector_bbox");
             
             chartElement.mimeType = QS("image/chart");
+            chartElement.binaryData = PdfRegionRenderer::renderRegionToPng(page, detected.boundingBox);
+            chartElement.attributes[QS("dpi")] = QString::number(qRound(PdfRegionRenderer::effectiveDpi(detected.boundingBox)));
             elements.append(chartElement);
         }
     } catch (const std::exception &e) {
@@ -662,119 +1241,77 @@ void LosslessDocumentConverter::extractChartElements(Poppler::Page *page, int pa
     }
 }
 
-void LosslessDocumentConverter::addSignatureElements(QList<DocumentElement> &elements)
+void LosslessDocumentConverter::addSignatureElements(const QList<PdfSignatureValidator::Signature> &signatures,
+                                                     QList<DocumentElement> &elements)
 {
     try {
-        DocumentElement signatureElement;
-        signatureElement.type = DocumentElementType::SIGNATURE;
-        signatureElement.id = generateElementId(DocumentElementType::SIGNATURE, m_elementCounter++);
-        signatureElement.content = QS("数字签名信息");
-        signatureElement.position.pageNumber = 0; // 签名通常是文档级别的
-        signatureElement.mimeType = QS("application/pdf-signature");
-        
-        elements.append(signatureElement);
-        qDebug() << "Added signature element to document";
-    } catch (const std::exception &e) {
-        qDebug() << "Error processing signatures:" << e.what();
-    }
-}
-
-QList<QRect> LosslessDocumentConverter::detectImageRegions(const QImage &pageImage)
-{
-    QList<QRect> imageRegions;
-    
-    // 简单的图片检测：寻找非白色/非黑色的区域
-    for (int y = 0; y < pageImage.height(); y += 20) {
-        for (int x = 0; x < pageImage.width(); x += 20) {
-            QColor color = pageImage.pixelColor(x, y);
+        // 验证与页面处理并行进行，此处等待其结束，输出不随验证快慢而变化
+        QList<PdfSignatureValidator::Validation> validations;
+        m_signatureValidation.waitForFinished();
+        if (m_signatureValidation.resultCount() > 0) {
+            validations = m_signatureValidation.result();
+        }
+        
+        for (int i = 0; i < signatures.size(); ++i) {
+            const PdfSignatureValidator::Signature &signature = signatures.at(i);
+            
+            DocumentElement signatureElement;
+            signatureElement.type = DocumentElementType::SIGNATURE;
+            signatureElement.id = generateElementId(DocumentElementType::SIGNATURE, m_elementCounter++);
+            signatureElement.content = signature.fieldName.isEmpty() ? QS("数字签名信息") : signature.fieldName;
+            signatureElement.position.pageNumber = 0; // 签名通常是文档级别的
+            signatureElement.mimeType = QS("application/pdf-signature");
+            signatureElement.attributes[QS("field_name")] = signature.fieldName;
+            signatureElement.attributes[QS("signature_size")] = QString::number(signature.signatureSize);
             
-            // 检测非白色/非黑色的区域
-            if (color.red() != color.green() || color.green() != color.blue()) {
-                // 可能是图片区域
-                QRect region(x, y, 200, 200); // 假设图片大小
-                imageRegions.append(region);
+            QStringList byteRange;
+            for (qint64 value : signature.byteRange) {
+                byteRange.append(QString::number(value));
             }
-        }
-    }
-    
-    return imageRegions;
-}
-
-QList<QRectF> LosslessDocumentConverter::detectTableRegionsFromVector(const std::vector<std::unique_ptr<Poppler::TextBox>> &textBoxes)
-{
-    QList<QRectF> tableRegions;
-    
-    // 简单的表格检测算法：寻找对齐的文本块
-    QList<QRectF> textRects;
-    for (const auto &textBox : textBoxes) {
-        if (textBox) {
-            textRects.append(textBox->boundingBox());
-        }
-    }
-    
-    // 按Y坐标分组，检测列对齐
-    QMap<int, QList<QRectF>> rows;
-    for (const QRectF &rect : textRects) {
-        int y = static_cast<int>(rect.y());
-        rows[y].append(rect);
-    }
-    
-    // 检测表格模式
-    for (auto it = rows.begin(); it != rows.end(); ++it) {
-        if (it.value().size() >= 2) { // 至少2列
-            QRectF tableRect;
-            for (const QRectF &rect : it.value()) {
-                if (tableRect.isNull()) {
-                    tableRect = rect;
-                } else {
-                    tableRect = tableRect.united(rect);
+            signatureElement.attributes[QS("byte_range")] = byteRange.join(QS(" "));
+            
+            if (i < validations.size()) {
+                const PdfSignatureValidator::Validation &validation = validations.at(i);
+                signatureElement.attributes[QS("validation_status")] = QS("completed");
+                signatureElement.attributes[QS("signature_status")] = validation.signatureStatus;
+                signatureElement.attributes[QS("certificate_status")] = validation.certificateStatus;
+                signatureElement.attributes[QS("signer_name")] = validation.signerName;
+                if (validation.signingTime.isValid()) {
+                    signatureElement.attributes[QS("signing_time")] = validation.signingTime.toString(Qt::ISODate);
                 }
+            } else {
+                // 验证器无法打开文档或验证过程出错
+                signatureElement.attributes[QS("validation_status")] = QS("failed");
             }
-            tableRegions.append(tableRect);
+            
+            elements.append(signatureElement);
         }
+        qDebug() << "Added" << signatures.size() << "signature elements to document";
+    } catch (const std::exception &e) {
+        qDebug() << "Error processing signatures:" << e.what();
     }
-    
-    return tableRegions;
 }
 
-QString LosslessDocumentConverter::extractTableContentFromVector(const std::vector<std::unique_ptr<Poppler::TextBox>> &textBoxes, const QRectF &region)
+QList<PdfRegionDetector::Region> LosslessDocumentConverter::detectPageRegions(int pageIndex)
 {
-    QString content;
-    QList<QString> cells;
-    
-    for (const auto &textBox : textBoxes) {
-        if (textBox && region.contains(textBox->boundingBox())) {
-            cells.append(textBox->text());
-        }
+    if (!m_coreDocument) {
+        return QList<PdfRegionDetector::Region>();
     }
     
-    // 简单的表格格式化
-    content = cells.join(QS(" | "));
-    return content;
-}
-
-QList<QRectF> LosslessDocumentConverter::detectChartRegions(const QImage &pageImage)
-{
-    QList<QRectF> chartRegions;
-    
-    // 简单的图表检测：寻找彩色区域
-    for (int y = 0; y < pageImage.height(); y += 10) {
-        for (int x = 0; x < pageImage.width(); x += 10) {
-            QColor color = pageImage.pixelColor(x, y);
-            
-            // 检测非白色/非黑色的区域
-            if (color.red() != color.green() || color.green() != color.blue()) {
-                // 可能是图表区域
-                QRectF region(x, y, 100, 100); // 假设图表大小
-                chartRegions.append(region);
-            }
-        }
+    try {
+        // 先执行内容流收集绘制操作的边界框，只有存在候选区域时才做灰度渲染校验
+        return PdfRegionDetector::detectRegions(*m_coreDocument, pageIndex, m_analysisRaster.get());
+    } catch (const std::exception &e) {
+        qDebug() << "Error detecting regions on page" << pageIndex << ":" << e.what();
+    } catch (...) {
+        qDebug() << "Unknown error detecting regions on page" << pageIndex;
     }
-    
-    return chartRegions;
+    return QList<PdfRegionDetector::Region>();
 }
 
-LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::writeElementsToXml(const QList<DocumentElement> &elements, QXmlStreamWriter &writer)
+LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::writeElementsToXml(const QList<DocumentElement> &elements,
+                                                                                       const std::shared_ptr<const PdfFontTable> &fontTable,
+                                                                                       QXmlStreamWriter &writer)
 {
     writer.writeStartDocument(QS("1.0"), true);
     writer.writeStartElement(QS("LosslessDocument"));
@@ -782,6 +1319,26 @@ LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::writeElement
     writer.writeAttribute(QS("created"), QDateTime::currentDateTime().toString(Qt::ISODate));
     writer.writeAttribute(QS("elementCount"), QString::number(elements.size()));
     
+    // PDF文本元素通过font_id引用文档级字体表
+    if (fontTable && fontTable->size() > 0) {
+        writer.writeStartElement(QS("Fonts"));
+        const QList<PdfFontTable::Font> fonts = fontTable->fonts();
+        for (int fontId = 0; fontId < fonts.size(); ++fontId) {
+            const PdfFontTable::Font &font = fonts.at(fontId);
+            writer.writeStartElement(QS("Font"));
+            writer.writeAttribute(QS("id"), QString::number(fontId));
+            writer.writeAttribute(QS("family"), fontTable->family(font.familyId));
+            writer.writeAttribute(QS("size"), QString::number(font.size));
+            writer.writeAttribute(QS("bold"), font.bold ? QS("true") : QS("false"));
+            writer.writeAttribute(QS("italic"), font.italic ? QS("true") : QS("false"));
+            writer.writeAttribute(QS("fixedPitch"), font.fixedPitch ? QS("true") : QS("false"));
+            writer.writeAttribute(QS("serif"), font.serif ? QS("true") : QS("false"));
+            writer.writeAttribute(QS("color"), QColor::fromRgb(font.color).name());
+            writer.writeEndElement(); // Font
+        }
+        writer.writeEndElement(); // Fonts
+    }
+    
     // 按位置排序元素
     QList<DocumentElement> sortedElements = elements;
     std::sort(sortedElements.begin(), sortedElements.end(), DocumentElementComparator());
@@ -796,13 +1353,110 @@ LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::writeElement
     return ConvertStatus::SUCCESS;
 }
 
+QByteArray LosslessDocumentConverter::serializeElementsFragment(const QList<DocumentElement> &elements)
+{
+    QByteArray fragment;
+    QBuffer buffer(&fragment);
+    buffer.open(QIODevice::WriteOnly);
+    
+    QXmlStreamWriter writer(&buffer);
+    writer.setAutoFormatting(true);
+    writer.setAutoFormattingIndent(2);
+    
+    for (const DocumentElement &element : elements) {
+        writeElementToXml(element, writer);
+    }
+    
+    return fragment;
+}
+
+QByteArray LosslessDocumentConverter::serializeElements(const QList<DocumentElement> &elements,
+                                                       const std::shared_ptr<const PdfFontTable> &fontTable)
+{
+    QByteArray result;
+    QBuffer buffer(&result);
+    buffer.open(QIODevice::WriteOnly);
+    
+    QXmlStreamWriter writer(&buffer);
+    writer.setAutoFormatting(true);
+    writer.setAutoFormattingIndent(2);
+    
+    writeElementsToXml(elements, fontTable, writer);
+    
+    return result;
+}
+
 LosslessDocumentConverter::ConvertStatus LosslessDocumentConverter::readElementsFromXml(QXmlStreamReader &reader, QList<DocumentElement> &elements)
 {
-    // TODO: 实现从XML读取元素的功能
-    Q_UNUSED(reader)
-    Q_UNUSED(elements)
+    // 读取writeElementToXml写出的元素，跳过文档根元素和字体表等容器
+    while (!reader.atEnd()) {
+        reader.readNext();
+        if (!reader.isStartElement()) {
+            continue;
+        }
+        
+        const QXmlStreamAttributes attributes = reader.attributes();
+        if (!attributes.hasAttribute(QS("id")) || !attributes.hasAttribute(QS("type"))) {
+            if (reader.name() == QS("Fonts")) {
+                reader.skipCurrentElement();
+            }
+            continue;
+        }
+        
+        DocumentElement element;
+        element.id = attributes.value(QS("id")).toString();
+        element.type = static_cast<DocumentElementType>(attributes.value(QS("type")).toInt());
+        if (attributes.hasAttribute(QS("x"))) {
+            element.position.boundingBox = QRect(attributes.value(QS("x")).toInt(),
+                                                 attributes.value(QS("y")).toInt(),
+                                                 attributes.value(QS("width")).toInt(),
+                                                 attributes.value(QS("height")).toInt());
+        }
+        // 只有正页码会被写出
+        element.position.pageNumber = attributes.hasAttribute(QS("page")) ? attributes.value(QS("page")).toInt() : 0;
+        
+        while (reader.readNextStartElement()) {
+            const QStringView name = reader.name();
+            if (name == QS("Content")) {
+                element.content = reader.readElementText();
+            } else if (name == QS("Format")) {
+                const QXmlStreamAttributes format = reader.attributes();
+                element.format.bold = format.value(QS("bold")) == QS("true");
+                element.format.italic = format.value(QS("italic")) == QS("true");
+                element.format.underline = format.value(QS("underline")) == QS("true");
+                element.format.strikethrough = format.value(QS("strikethrough")) == QS("true");
+                element.format.fontSize = format.value(QS("fontSize")).toInt();
+                element.format.fontFamily = format.value(QS("fontFamily")).toString();
+                element.format.alignment = Qt::Alignment(format.value(QS("alignment")).toInt());
+                element.format.lineSpacing = format.value(QS("lineSpacing")).toDouble();
+                element.format.paragraphSpacing = format.value(QS("paragraphSpacing")).toDouble();
+                element.format.leftIndent = format.value(QS("leftIndent")).toInt();
+                element.format.rightIndent = format.value(QS("rightIndent")).toInt();
+                element.format.firstLineIndent = format.value(QS("firstLineIndent")).toInt();
+                reader.skipCurrentElement();
+            } else if (name == QS("Attributes")) {
+                for (const QXmlStreamAttribute &attribute : reader.attributes()) {
+                    element.attributes.insert(attribute.name().toString(), attribute.value().toString());
+                }
+                reader.skipCurrentElement();
+            } else if (name == QS("RelatedElements")) {
+                while (reader.readNextStartElement()) {
+                    element.position.relatedIds.append(reader.readElementText());
+                }
+            } else {
+                reader.skipCurrentElement();
+            }
+        }
+        
+        elements.append(element);
+    }
     
-    return ConvertStatus::UNKNOWN_ERROR;
+    if (reader.hasError()) {
+        qDebug() << QS("XML读取错误:") << reader.errorString();
+        return ConvertStatus::PARSE_ERROR;
+    }
+    
+    return ConvertStatus::SUCCESS;
 }
 
 QString LosslessDocumentConverter::generateElementId(DocumentElementType type, int index)
@@ -822,6 +1476,7 @@ QString LosslessDocumentConverter::generateElementId(DocumentElementType type, i
         case DocumentElementType::LINE_BREAK: typeStr = QS("linebreak"); break;
         case DocumentElementType::PARAGRAPH: typeStr = QS("para"); break;
         case DocumentElementType::SIGNATURE: typeStr = QS("signature"); break;
+        case DocumentElementType::PARSE_ERROR: typeStr = QS("parseerror"); break;
     }
     
     return QString(QS("%1_%2_%3"))
@@ -861,51 +1516,21 @@ bool LosslessDocumentConverter::validateConversionIntegrity(const QString &origi
 }
 
 // 辅助方法实现
-void LosslessDocumentConverter::parseParagraphFormat(QXmlStreamReader &reader, FormatInfo &format)
+void LosslessDocumentConverter::parseParagraphFormat(QXmlStreamReader &reader, QString &styleId, FormatDelta &delta)
 {
-    // 解析段落格式信息
-    QXmlStreamAttributes attributes = reader.attributes();
-    for (const QXmlStreamAttribute &attr : attributes) {
-        QString attrName = attr.name().toString();
-        QString attrValue = attr.value().toString();
-        
-        if (attrName == QS("w:val")) {
-            // 解析对齐方式
-            if (attrValue == QS("center")) {
-                format.alignment = Qt::AlignCenter;
-            } else if (attrValue == QS("right")) {
-                format.alignment = Qt::AlignRight;
-            } else {
-                format.alignment = Qt::AlignLeft;
-            }
-        } else if (attrName == QS("w:sz")) {
-            format.fontSize = attrValue.toInt();
-        } else if (attrName == QS("w:color")) {
-            // 颜色信息暂时不处理，因为FormatInfo没有color成员
-        }
-    }
+    // 只记录段落样式ID和直接格式增量，样式继承由样式解析器查表完成
+    styleId.clear();
+    delta.clear();
+    DocxStyleResolver::parseParagraphProperties(reader, delta, &styleId);
 }
 
-void LosslessDocumentConverter::parseRunFormat(QXmlStreamReader &reader, FormatInfo &format)
+void LosslessDocumentConverter::parseRunFormat(QXmlStreamReader &reader, const QString &paragraphStyleId,
+                                               const FormatDelta &paragraphDelta, FormatInfo &format)
 {
-    // 解析文本运行格式信息
-    QXmlStreamAttributes attributes = reader.attributes();
-    for (const QXmlStreamAttribute &attr : attributes) {
-        QString attrName = attr.name().toString();
-        QString attrValue = attr.value().toString();
-        
-        if (attrName == QS("w:sz")) {
-            format.fontSize = attrValue.toInt();
-        } else if (attrName == QS("w:b")) {
-            format.bold = (attrValue == QS("1") || attrValue.toLower() == QS("true"));
-        } else if (attrName == QS("w:i")) {
-            format.italic = (attrValue == QS("1") || attrValue.toLower() == QS("true"));
-        } else if (attrName == QS("w:u")) {
-            format.underline = (attrValue == QS("1") || attrValue.toLower() == QS("true"));
-        } else if (attrName == QS("w:strike")) {
-            format.strikethrough = (attrValue == QS("1") || attrValue.toLower() == QS("true"));
-        }
-    }
+    QString runStyleId;
+    FormatDelta runDelta;
+    DocxStyleResolver::parseRunProperties(reader, runDelta, &runStyleId);
+    format = m_styleResolver->resolveRun(paragraphStyleId, paragraphDelta, runStyleId, runDelta);
 }
 
 void LosslessDocumentConverter::parseDrawingElement(QXmlStreamReader &reader, DocumentElement &element, const QString &filePath)
@@ -923,11 +1548,16 @@ void LosslessDocumentConverter::parseTableElement(QXmlStreamReader &reader, Docu
     Q_UNUSED(element)
 }
 
-void LosslessDocumentConverter::parsePdfTextFormat(void *textBox, FormatInfo &format)
+void LosslessDocumentConverter::applyPdfFont(const PdfFontTable &fonts, int fontId, DocumentElement &element)
 {
-    // TODO: 解析PDF文本格式信息
-    Q_UNUSED(textBox)
-    Q_UNUSED(format)
+    const PdfFontTable::Font font = fonts.font(fontId);
+    element.format.bold = font.bold;
+    element.format.italic = font.italic;
+    element.format.fontSize = qMax(1, qRound(font.size));
+    // 族名在字体表中只存一份，QString隐式共享，这里不复制字符数据
+    element.format.fontFamily = fonts.family(font.familyId);
+    element.format.textColor = QColor::fromRgb(font.color);
+    element.attributes[QS("font_id")] = QString::number(fontId);
 }
 
 void LosslessDocumentConverter::writeElementToXml(const DocumentElement &element, QXmlStreamWriter &writer)
@@ -952,6 +1582,9 @@ void LosslessDocumentConverter::writeElementToXml(const DocumentElement &element
         case DocumentElementType::SHAPE:
             elementTypeName = QS("Shape");
             break;
+        case DocumentElementType::PARSE_ERROR:
+            elementTypeName = QS("ParseError");
+            break;
         default:
             elementTypeName = QS("Unknown");
             break;
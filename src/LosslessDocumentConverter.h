@@ -11,6 +11,12 @@
 #pragma once
 
 #include "QtCompat.h"
+#include "PdfRegionDetector.h"
+#include "PdfTextLayoutCache.h"
+#include "PdfSignatureValidator.h"
+#include "PdfFontTable.h"
+#include "ProcessingDeadline.h"
+#include "KZipUtils.h"
 #include <QObject>
 #include <QString>
 #include <QStringList>
@@ -18,6 +24,9 @@
 #include <QRect>
 #include <QFont>
 #include <QColor>
+#include <QFuture>
+#include <atomic>
+#include <memory>
 
 // Poppler前向声明
 namespace Poppler {
@@ -25,7 +34,10 @@ namespace Poppler {
     class Page;
     class TextBox;
 }
+class DocxStyleResolver;
+struct FormatDelta;
 #include <QMap>
+#include <QSharedPointer>
 #include <QList>
 #include <QXmlStreamWriter>
 #include <QXmlStreamReader>
@@ -46,7 +58,8 @@ enum class DocumentElementType {
     PAGE_BREAK,     ///< 分页符
     LINE_BREAK,     ///< 换行符
     PARAGRAPH,      ///< 段落
-    SIGNATURE       ///< 数字签名
+    SIGNATURE,      ///< 数字签名
+    PARSE_ERROR     ///< 解析错误（页面超时、取消等）
 };
 
 /**
@@ -158,6 +171,69 @@ public:
      */
     QByteArray convertToLosslessXmlByteArray(const QString &filePath);
 
+    /**
+     * @brief 增量转换DOCX文档为无损XML
+     *
+     * 根据上一次转换保存的清单（部件CRC32和顶层块哈希）只重新解析发生变化的块，
+     * 未变化的块从上一次的输出片段还原元素，合并后与全量转换一样建立元素关系、写出并验证，
+     * 输出与全量转换一致。没有可用清单或样式等全局部件变化时执行全量解析；
+     * 文档和输出文件都未变化时直接沿用上一次的结果。非DOCX文件直接执行全量转换。
+     * @param filePath 输入文件路径
+     * @param outputPath 输出XML文件路径
+     * @param manifestPath 清单文件路径，为空时使用 outputPath + ".manifest"
+     * @return 转换状态
+     */
+    ConvertStatus convertToLosslessXmlIncremental(const QString &filePath, const QString &outputPath,
+                                                  const QString &manifestPath = QString());
+
+    /**
+     * @brief 分阶段转换中的文档
+     *
+     * DocumentPipeline把一次无损转换拆成read → unpack → parse → extract → serialize五个阶段，
+     * 由不同线程依次处理，本结构在阶段之间传递。每个阶段结束时释放后续阶段不再需要的数据。
+     */
+    struct StagedDocument {
+        QString filePath;
+        InputFormat format = InputFormat::UNKNOWN;
+        QByteArray fileData;                            ///< read：DOCX文件内容
+        QMap<QString, QByteArray> parts;                ///< unpack：解压出的DOCX部件
+        QMap<QString, KZipUtils::EntryInfo> entries;    ///< unpack：DOCX中央目录信息
+        QSharedPointer<const DocxStyleResolver> styles; ///< unpack：部件缓存命中的样式表，此时不解压styles.xml
+        std::shared_ptr<Poppler::Document> pdfDocument; ///< unpack：已加载的PDF文档
+        QList<DocumentElement> elements;                ///< parse/extract：文档元素
+        std::shared_ptr<const PdfFontTable> fontTable;  ///< parse：PDF字体表，serialize阶段据此写出Fonts
+        QByteArray xml;                                 ///< serialize：无损XML
+    };
+
+    /**
+     * @brief read阶段：读入文件内容
+     *
+     * PDF由Poppler按路径打开，此阶段只把文件预读进系统缓存，不保留内容。
+     * @param document 分阶段文档，filePath须已设置
+     * @return 转换状态
+     */
+    ConvertStatus readStage(StagedDocument &document);
+
+    /**
+     * @brief unpack阶段：解压DOCX部件，或加载PDF文档的交叉引用表和页面树
+     */
+    ConvertStatus unpackStage(StagedDocument &document);
+
+    /**
+     * @brief parse阶段：解析文档内容生成元素，PDF的版面分析和表格/图片检测也在此阶段完成
+     */
+    ConvertStatus parseStage(StagedDocument &document);
+
+    /**
+     * @brief extract阶段：建立元素之间的结构和引用关系
+     */
+    ConvertStatus extractStage(StagedDocument &document);
+
+    /**
+     * @brief serialize阶段：把元素写成无损XML
+     */
+    ConvertStatus serializeStage(StagedDocument &document);
+
     /**
      * @brief 从无损XML还原为原格式
      * @param xmlPath XML文件路径
@@ -180,6 +256,45 @@ public:
      */
     QStringList getSupportedFormats() const;
 
+    /**
+     * @brief 获取最近一次PDF转换启动的签名验证任务
+     *
+     * 验证与页面处理并行，转换在写出签名元素前等待其完成，
+     * 调用方可从此任务取得完整的验证结果（含是否命中缓存）。
+     * @return 按签名发现顺序排列的验证结果；文档没有签名时为空任务
+     */
+    QFuture<QList<PdfSignatureValidator::Validation>> signatureValidation() const;
+
+    /**
+     * @brief 设置单个PDF页面的处理时限
+     *
+     * 超过时限的页面不输出部分结果，而是输出一个PARSE_ERROR元素。
+     * @param milliseconds 时限（毫秒），小于等于0表示只受文档时限约束
+     */
+    void setPageTimeBudget(int milliseconds);
+    int pageTimeBudget() const;
+
+    /**
+     * @brief 设置单个PDF文档的处理时限
+     *
+     * 超过时限后剩余页面不再处理，以一个PARSE_ERROR元素标明跳过的页面范围。
+     * @param milliseconds 时限（毫秒），小于等于0表示不限时
+     */
+    void setDocumentTimeBudget(int milliseconds);
+    int documentTimeBudget() const;
+
+    /**
+     * @brief 请求取消正在进行的PDF转换，可以从其他线程调用
+     *
+     * 取消在下一个检查点生效，效果与文档超时相同；当前没有转换时作用于下一次转换。
+     * 取消标志在转换结束时清除。
+     */
+    void cancel();
+
+    static constexpr int DEFAULT_PAGE_TIME_BUDGET_MS = 30 * 1000;
+    static constexpr int DEFAULT_DOCUMENT_TIME_BUDGET_MS = 10 * 60 * 1000;
+    static constexpr qint64 READ_AHEAD_CHUNK_SIZE = 1024 * 1024; ///< read阶段预读PDF的块大小
+
 signals:
     /**
      * @brief 转换进度信号
@@ -204,21 +319,67 @@ private:
      */
     ConvertStatus parseDocxDocument(const QString &filePath, QList<DocumentElement> &elements);
 
+    /**
+     * @brief 从已解压的部件解析DOCX文档
+     * @param parts 至少包含word/document.xml，可选word/styles.xml
+     * @param entries 压缩包中央目录信息，用于按styles.xml缓存样式表
+     * @param cachedStyles 解压前已从部件缓存取得的样式表，为空时解析parts中的styles.xml
+     * @param filePath 源文件路径
+     * @param elements 解析出的元素列表
+     * @return 解析状态
+     */
+    ConvertStatus parseDocxParts(const QMap<QString, QByteArray> &parts, const QMap<QString, KZipUtils::EntryInfo> &entries,
+                                 const QSharedPointer<const DocxStyleResolver> &cachedStyles, const QString &filePath,
+                                 QList<DocumentElement> &elements);
+
+    /**
+     * @brief 解压前查询styles.xml的部件缓存
+     *
+     * 作为KZipUtils读取函数的跳过条件：styles.xml按(CRC32, 大小)命中时取出样式表并跳过该部件。
+     * @param styles 命中时输出的样式表，须在读取期间保持有效
+     * @return 跳过条件
+     */
+    static KZipUtils::SkipEntry skipCachedStyles(QSharedPointer<const DocxStyleResolver> &styles);
+
     /**
      * @brief 解析PDF文档
      * @param filePath PDF文件路径
      * @param elements 解析出的元素列表
+     * @param fontTable 输出该文档的字体表，文本元素以font_id引用
+     * @return 解析状态
+     */
+    ConvertStatus parsePdfDocument(const QString &filePath, QList<DocumentElement> &elements,
+                                   std::shared_ptr<const PdfFontTable> &fontTable);
+
+    /**
+     * @brief 解析已加载的PDF文档
+     * @param filePath PDF文件路径
+     * @param document 已加载的文档，为空时在文档时限内加载
+     * @param elements 解析出的元素列表
+     * @param fontTable 输出该文档的字体表，文本元素以font_id引用
+     * @return 解析状态
+     */
+    ConvertStatus parsePdfDocument(const QString &filePath, std::shared_ptr<Poppler::Document> document,
+                                   QList<DocumentElement> &elements, std::shared_ptr<const PdfFontTable> &fontTable);
+
+    /**
+     * @brief 解析document.xml内容
+     * @param documentXml document.xml内容（可以是只含部分块的完整文档）
+     * @param filePath 源文件路径
+     * @param elements 追加输出的文档元素列表
      * @return 解析状态
      */
-    ConvertStatus parsePdfDocument(const QString &filePath, QList<DocumentElement> &elements);
+    ConvertStatus parseDocxDocumentXml(const QByteArray &documentXml, const QString &filePath, QList<DocumentElement> &elements);
 
     /**
      * @brief 将元素列表写入XML
      * @param elements 元素列表
+     * @param fontTable 文本元素font_id引用的字体表，为空时不写Fonts
      * @param writer XML写入器
      * @return 写入状态
      */
-    ConvertStatus writeElementsToXml(const QList<DocumentElement> &elements, QXmlStreamWriter &writer);
+    ConvertStatus writeElementsToXml(const QList<DocumentElement> &elements,
+                                     const std::shared_ptr<const PdfFontTable> &fontTable, QXmlStreamWriter &writer);
 
     /**
      * @brief 从XML读取元素列表
@@ -228,6 +389,22 @@ private:
      */
     ConvertStatus readElementsFromXml(QXmlStreamReader &reader, QList<DocumentElement> &elements);
 
+    /**
+     * @brief 将元素序列化为不含文档头的XML片段
+     * @param elements 元素列表
+     * @return XML片段
+     */
+    QByteArray serializeElementsFragment(const QList<DocumentElement> &elements);
+
+    /**
+     * @brief 将元素序列化为完整的无损XML文档
+     * @param elements 元素列表
+     * @param fontTable 文本元素font_id引用的字体表，为空时不写Fonts
+     * @return XML文档
+     */
+    QByteArray serializeElements(const QList<DocumentElement> &elements,
+                                 const std::shared_ptr<const PdfFontTable> &fontTable);
+
     /**
      * @brief 生成元素ID
      * @param type 元素类型
@@ -251,30 +428,37 @@ private:
     bool validateConversionIntegrity(const QString &originalPath, const QString &xmlPath);
 
     // PDF处理辅助方法
-    std::unique_ptr<Poppler::Document> loadPdfDocument(const QString &filePath);
-    bool checkDigitalSignatures(Poppler::Document *document);
-    ConvertStatus processAllPages(Poppler::Document *document, QList<DocumentElement> &elements);
-    ConvertStatus processSinglePage(Poppler::Page *page, int pageIndex, QList<DocumentElement> &elements);
+    std::shared_ptr<Poppler::Document> loadPdfDocument(const QString &filePath, bool pooled = true);
+    QList<PdfSignatureValidator::Signature> discoverSignatures(const QString &filePath);
+    ConvertStatus processAllPages(const std::shared_ptr<Poppler::Document> &document, const ProcessingDeadline &deadline,
+                                  QList<DocumentElement> &elements);
+    ConvertStatus processSinglePage(Poppler::Page *page, int pageIndex, const PdfTextLayoutCache::Layout &textLayout,
+                                    QList<DocumentElement> &elements);
+    ConvertStatus processTaggedDocument(const std::shared_ptr<Poppler::Document> &document, const ProcessingDeadline &deadline,
+                                        QList<DocumentElement> &elements);
+    void addParseErrorElement(int firstPageIndex, int lastPageIndex, const QString &reason, qint64 elapsedMs,
+                              QList<DocumentElement> &elements);
     
     // 元素提取方法
-    void extractTextElements(Poppler::Page *page, int pageIndex, QList<DocumentElement> &elements);
-    void extractImageElements(Poppler::Page *page, int pageIndex, QList<DocumentElement> &elements);
-    void extractTableElements(Poppler::Page *page, int pageIndex, QList<DocumentElement> &elements);
-    void extractChartElements(Poppler::Page *page, int pageIndex, QList<DocumentElement> &elements);
-    void addSignatureElements(QList<DocumentElement> &elements);
+    void extractTextElements(const PdfTextLayoutCache::Layout &textLayout, int pageIndex, QList<DocumentElement> &elements);
+    void extractImageElements(Poppler::Page *page, int pageIndex, const QList<PdfRegionDetector::Region> &regions,
+                              QList<DocumentElement> &elements);
+    void extractTableElements(const PdfTextLayoutCache::Layout &textLayout, int pageIndex, QList<DocumentElement> &elements);
+    void extractChartElements(Poppler::Page *page, int pageIndex, const QList<PdfRegionDetector::Region> &regions,
+                              QList<DocumentElement> &elements);
+    void addSignatureElements(const QList<PdfSignatureValidator::Signature> &signatures,
+                              QList<DocumentElement> &elements);
     
     // 检测算法
-    QList<QRect> detectImageRegions(const QImage &pageImage);
-    QList<QRectF> detectTableRegionsFromVector(const std::vector<std::unique_ptr<Poppler::TextBox>> &textBoxes);
-    QString extractTableContentFromVector(const std::vector<std::unique_ptr<Poppler::TextBox>> &textBoxes, const QRectF &region);
-    QList<QRectF> detectChartRegions(const QImage &pageImage);
+    QList<PdfRegionDetector::Region> detectPageRegions(int pageIndex);
     
     // 辅助方法声明
-    void parseParagraphFormat(QXmlStreamReader &reader, FormatInfo &format);
-    void parseRunFormat(QXmlStreamReader &reader, FormatInfo &format);
+    void parseParagraphFormat(QXmlStreamReader &reader, QString &styleId, FormatDelta &delta);
+    void parseRunFormat(QXmlStreamReader &reader, const QString &paragraphStyleId,
+                        const FormatDelta &paragraphDelta, FormatInfo &format);
     void parseDrawingElement(QXmlStreamReader &reader, DocumentElement &element, const QString &filePath);
     void parseTableElement(QXmlStreamReader &reader, DocumentElement &element);
-    void parsePdfTextFormat(void *textBox, FormatInfo &format); // 使用void*避免Poppler类型问题
+    void applyPdfFont(const PdfFontTable &fonts, int fontId, DocumentElement &element);
     void writeElementToXml(const DocumentElement &element, QXmlStreamWriter &writer);
     void extractTextBoxFormatInfo(void *textBox, DocumentElement &element);
     
@@ -286,6 +470,13 @@ private:
 private:
     QMap<QString, InputFormat> m_supportedFormats;
     int m_elementCounter;
+    QSharedPointer<const DocxStyleResolver> m_styleResolver; ///< 当前DOCX文档的样式解析器
+    std::unique_ptr<PdfCoreDocument> m_coreDocument;         ///< 当前PDF文档的核心文档，供矢量分析使用
+    std::unique_ptr<PdfAnalysisRaster> m_analysisRaster;     ///< 当前PDF文档的灰度分析光栅
+    QFuture<QList<PdfSignatureValidator::Validation>> m_signatureValidation; ///< 最近一次PDF转换的后台签名验证
+    int m_pageTimeBudget;                                    ///< 单页处理时限（毫秒）
+    int m_documentTimeBudget;                                ///< 单个PDF文档处理时限（毫秒）
+    std::atomic_bool m_cancelRequested;                      ///< cancel()设置的取消标志
 };
 
 /**
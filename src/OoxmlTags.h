@@ -0,0 +1,323 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 13:00:00
+ * @LastEditTime: 2026-10-18 13:00:00
+ * @LastEditors: seelights
+ * @Description: OOXML标签编译期查找表与命名空间驻留
+ * @FilePath: \ReportMason\src\OoxmlTags.h
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <QLatin1String>
+#include <QString>
+#include <QStringView>
+#include <QVarLengthArray>
+#include <array>
+
+/**
+ * @brief DOCX解析关心的WordprocessingML/DrawingML元素（按本地名）
+ */
+enum class OoxmlTag : quint8 {
+    Unknown = 0,
+    Document,
+    Body,
+    P,
+    R,
+    T,
+    PPr,
+    RPr,
+    PStyle,
+    RStyle,
+    Tab,
+    Br,
+    Drawing,
+    Pict,
+    Tbl,
+    TblPr,
+    Tr,
+    Tc,
+    Sdt,
+    SdtPr,
+    SdtContent,
+    Tag,
+    Alias,
+    Blip,
+    Pic,
+    Inline,
+    Anchor,
+    Extent,
+    SimplePos,
+    PositionH,
+    PositionV,
+    PosOffset,
+    DocPr,
+    Graphic,
+    GraphicData,
+    Chart,
+    Style,
+    BasedOn,
+    DocDefaults,
+    RPrDefault,
+    PPrDefault,
+    LatentStyles,
+    LsdException,
+    RFonts,
+    Sz,
+    B,
+    I,
+    U,
+    Strike,
+    Dstrike,
+    Color,
+    Highlight,
+    Shd,
+    Jc,
+    Spacing,
+    Ind,
+    Relationship,
+    Left,
+    Top,
+    Width,
+    Height,
+    Count
+};
+
+/**
+ * @brief DOCX解析关心的命名空间
+ */
+enum class OoxmlNamespace : quint8 {
+    Unknown = 0,
+    WordprocessingML,      ///< w:
+    DrawingML,             ///< a:
+    WordprocessingDrawing, ///< wp:
+    Picture,               ///< pic:
+    Chart,                 ///< c:
+    Relationships,         ///< r:
+    PackageRelationships,  ///< .rels文件
+    Vml                    ///< v:
+};
+
+namespace OoxmlTags {
+
+struct Entry {
+    const char* name;
+    int length;
+    OoxmlTag tag;
+};
+
+/// 标签表，新增标签时编译期会校验哈希无冲突
+constexpr Entry ENTRIES[] = {
+    {"document", 8, OoxmlTag::Document},
+    {"body", 4, OoxmlTag::Body},
+    {"p", 1, OoxmlTag::P},
+    {"r", 1, OoxmlTag::R},
+    {"t", 1, OoxmlTag::T},
+    {"pPr", 3, OoxmlTag::PPr},
+    {"rPr", 3, OoxmlTag::RPr},
+    {"pStyle", 6, OoxmlTag::PStyle},
+    {"rStyle", 6, OoxmlTag::RStyle},
+    {"tab", 3, OoxmlTag::Tab},
+    {"br", 2, OoxmlTag::Br},
+    {"drawing", 7, OoxmlTag::Drawing},
+    {"pict", 4, OoxmlTag::Pict},
+    {"tbl", 3, OoxmlTag::Tbl},
+    {"tblPr", 5, OoxmlTag::TblPr},
+    {"tr", 2, OoxmlTag::Tr},
+    {"tc", 2, OoxmlTag::Tc},
+    {"sdt", 3, OoxmlTag::Sdt},
+    {"sdtPr", 5, OoxmlTag::SdtPr},
+    {"sdtContent", 10, OoxmlTag::SdtContent},
+    {"tag", 3, OoxmlTag::Tag},
+    {"alias", 5, OoxmlTag::Alias},
+    {"blip", 4, OoxmlTag::Blip},
+    {"pic", 3, OoxmlTag::Pic},
+    {"inline", 6, OoxmlTag::Inline},
+    {"anchor", 6, OoxmlTag::Anchor},
+    {"extent", 6, OoxmlTag::Extent},
+    {"simplePos", 9, OoxmlTag::SimplePos},
+    {"positionH", 9, OoxmlTag::PositionH},
+    {"positionV", 9, OoxmlTag::PositionV},
+    {"posOffset", 9, OoxmlTag::PosOffset},
+    {"docPr", 5, OoxmlTag::DocPr},
+    {"graphic", 7, OoxmlTag::Graphic},
+    {"graphicData", 11, OoxmlTag::GraphicData},
+    {"chart", 5, OoxmlTag::Chart},
+    {"style", 5, OoxmlTag::Style},
+    {"basedOn", 7, OoxmlTag::BasedOn},
+    {"docDefaults", 11, OoxmlTag::DocDefaults},
+    {"rPrDefault", 10, OoxmlTag::RPrDefault},
+    {"pPrDefault", 10, OoxmlTag::PPrDefault},
+    {"latentStyles", 12, OoxmlTag::LatentStyles},
+    {"lsdException", 12, OoxmlTag::LsdException},
+    {"rFonts", 6, OoxmlTag::RFonts},
+    {"sz", 2, OoxmlTag::Sz},
+    {"b", 1, OoxmlTag::B},
+    {"i", 1, OoxmlTag::I},
+    {"u", 1, OoxmlTag::U},
+    {"strike", 6, OoxmlTag::Strike},
+    {"dstrike", 7, OoxmlTag::Dstrike},
+    {"color", 5, OoxmlTag::Color},
+    {"highlight", 9, OoxmlTag::Highlight},
+    {"shd", 3, OoxmlTag::Shd},
+    {"jc", 2, OoxmlTag::Jc},
+    {"spacing", 7, OoxmlTag::Spacing},
+    {"ind", 3, OoxmlTag::Ind},
+    {"Relationship", 12, OoxmlTag::Relationship},
+    {"left", 4, OoxmlTag::Left},
+    {"top", 3, OoxmlTag::Top},
+    {"width", 5, OoxmlTag::Width},
+    {"height", 6, OoxmlTag::Height},
+};
+
+constexpr int ENTRY_COUNT = static_cast<int>(sizeof(ENTRIES) / sizeof(ENTRIES[0]));
+constexpr int TABLE_SIZE = 256;
+constexpr int MAX_NAME_LENGTH = 16;
+constexpr quint8 EMPTY_SLOT = 0xFF;
+
+static_assert(ENTRY_COUNT < EMPTY_SLOT, "OOXML标签表过大");
+
+/**
+ * @brief 完美哈希：只取长度、首字符、中间字符和末字符
+ */
+template <typename Char>
+constexpr int hashName(const Char* name, int length)
+{
+    return (length + static_cast<int>(name[0]) * 29 + static_cast<int>(name[length - 1]) * 3 +
+            static_cast<int>(name[length / 2])) %
+           TABLE_SIZE;
+}
+
+struct Table {
+    std::array<quint8, TABLE_SIZE> slots;
+    bool collisionFree;
+};
+
+constexpr Table buildTable()
+{
+    Table table{};
+    table.collisionFree = true;
+    for (int i = 0; i < TABLE_SIZE; ++i) {
+        table.slots[i] = EMPTY_SLOT;
+    }
+    for (int i = 0; i < ENTRY_COUNT; ++i) {
+        const int slot = hashName(ENTRIES[i].name, ENTRIES[i].length);
+        if (table.slots[slot] != EMPTY_SLOT || ENTRIES[i].length > MAX_NAME_LENGTH) {
+            table.collisionFree = false;
+        }
+        table.slots[slot] = static_cast<quint8>(i);
+    }
+    return table;
+}
+
+constexpr Table TABLE = buildTable();
+static_assert(TABLE.collisionFree, "OOXML标签哈希冲突，请调整hashName系数或TABLE_SIZE");
+
+/**
+ * @brief 按本地名查找标签，不分配内存
+ * @param localName 元素本地名（QXmlStreamReader::name()）
+ * @return 标签，不在表中时返回OoxmlTag::Unknown
+ */
+inline OoxmlTag lookup(QStringView localName)
+{
+    const int length = static_cast<int>(localName.size());
+    if (length == 0 || length > MAX_NAME_LENGTH) {
+        return OoxmlTag::Unknown;
+    }
+
+    const char16_t* chars = localName.utf16();
+    const quint8 slot = TABLE.slots[hashName(chars, length)];
+    if (slot == EMPTY_SLOT) {
+        return OoxmlTag::Unknown;
+    }
+
+    const Entry& entry = ENTRIES[slot];
+    if (entry.length != length) {
+        return OoxmlTag::Unknown;
+    }
+    for (int i = 0; i < length; ++i) {
+        if (chars[i] != static_cast<char16_t>(entry.name[i])) {
+            return OoxmlTag::Unknown;
+        }
+    }
+    return entry.tag;
+}
+
+} // namespace OoxmlTags
+
+/**
+ * @brief 单次解析内的命名空间驻留表
+ *
+ * 一个文档中出现的命名空间URI只有少数几个，首次出现时分类并驻留，
+ * 之后每个元素只需按长度和内容比较驻留的URI，不再分配QString。
+ * 同时识别Transitional和Strict两种OOXML命名空间。
+ */
+class OoxmlNamespaceTable
+{
+public:
+    /**
+     * @brief 解析命名空间URI
+     * @param uri 命名空间URI（QXmlStreamReader::namespaceUri()）
+     * @return 命名空间
+     */
+    OoxmlNamespace resolve(QStringView uri)
+    {
+        for (const Interned& interned : m_interned) {
+            if (interned.uri.size() == uri.size() && QStringView(interned.uri) == uri) {
+                return interned.ns;
+            }
+        }
+
+        const OoxmlNamespace ns = classify(uri);
+        m_interned.append({uri.toString(), ns});
+        return ns;
+    }
+
+    /**
+     * @brief 判断URI是否为WordprocessingML命名空间
+     */
+    bool isWordprocessingML(QStringView uri) { return resolve(uri) == OoxmlNamespace::WordprocessingML; }
+
+private:
+    struct Interned {
+        QString uri;
+        OoxmlNamespace ns;
+    };
+
+    static OoxmlNamespace classify(QStringView uri)
+    {
+        if (uri.endsWith(QLatin1String("/wordprocessingml/2006/main")) ||
+            uri.endsWith(QLatin1String("/ooxml/wordprocessingml/main"))) {
+            return OoxmlNamespace::WordprocessingML;
+        }
+        if (uri.endsWith(QLatin1String("/drawingml/2006/main")) ||
+            uri.endsWith(QLatin1String("/ooxml/drawingml/main"))) {
+            return OoxmlNamespace::DrawingML;
+        }
+        if (uri.endsWith(QLatin1String("/wordprocessingDrawing"))) {
+            return OoxmlNamespace::WordprocessingDrawing;
+        }
+        if (uri.endsWith(QLatin1String("/drawingml/2006/picture")) ||
+            uri.endsWith(QLatin1String("/ooxml/drawingml/picture"))) {
+            return OoxmlNamespace::Picture;
+        }
+        if (uri.endsWith(QLatin1String("/drawingml/2006/chart")) ||
+            uri.endsWith(QLatin1String("/ooxml/drawingml/chart"))) {
+            return OoxmlNamespace::Chart;
+        }
+        if (uri.endsWith(QLatin1String("/officeDocument/2006/relationships")) ||
+            uri.endsWith(QLatin1String("/ooxml/officeDocument/relationships"))) {
+            return OoxmlNamespace::Relationships;
+        }
+        if (uri.endsWith(QLatin1String("/package/2006/relationships"))) {
+            return OoxmlNamespace::PackageRelationships;
+        }
+        if (uri == QLatin1String("urn:schemas-microsoft-com:vml")) {
+            return OoxmlNamespace::Vml;
+        }
+        return OoxmlNamespace::Unknown;
+    }
+
+    QVarLengthArray<Interned, 8> m_interned;
+};
@@ -0,0 +1,194 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 17:50:00
+ * @LastEditTime: 2026-10-18 17:50:00
+ * @LastEditors: seelights
+ * @Description: 版面分析用的8位灰度页面光栅实现
+ * @FilePath: \ReportMason\src\PdfAnalysisRaster.cpp
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#include "PdfAnalysisRaster.h"
+#include "ProcessingDeadline.h"
+#include "QtCompat.h"
+#include <QDebug>
+#include <QtMath>
+
+#include <PDFDoc.h>
+#include <SplashOutputDev.h>
+#include <SplashBitmap.h>
+
+namespace {
+
+/**
+ * @brief 注释显示回调：分析时跳过所有注释
+ */
+bool skipAnnotations(Annot* /*annot*/, void* /*userData*/)
+{
+    return false;
+}
+
+} // namespace
+
+PdfAnalysisRaster::PdfAnalysisRaster()
+    : m_startedDocument(nullptr), m_pageIndex(-1), m_dpi(DEFAULT_DPI)
+{
+}
+
+PdfAnalysisRaster::~PdfAnalysisRaster() = default;
+
+bool PdfAnalysisRaster::render(PdfCoreDocument& document, int pageIndex, double dpi)
+{
+    m_pageIndex = -1;
+
+    PDFDoc* doc = document.document();
+    if (!doc) {
+        m_lastError = QS("文档未打开");
+        return false;
+    }
+    if (pageIndex < 0 || pageIndex >= doc->getNumPages()) {
+        m_lastError = QS("页码超出范围: %1").arg(pageIndex + 1);
+        return false;
+    }
+
+    try {
+        // 换文档时重建设备，同一文档只执行一次startDoc
+        if (!m_outputDev || m_startedDocument != doc) {
+            SplashColor paperColor;
+            paperColor[0] = 0xff;
+            m_outputDev = std::make_unique<SplashOutputDev>(splashModeMono8, 1, false, paperColor, true,
+                                                            splashThinLineDefault, false);
+            m_outputDev->setFontAntialias(false);
+            m_outputDev->setVectorAntialias(false);
+            m_outputDev->setFreeTypeHinting(false, false);
+            m_outputDev->startDoc(doc);
+            m_startedDocument = doc;
+        }
+
+        doc->displayPage(m_outputDev.get(), pageIndex + 1, dpi, dpi, 0, false, true, false,
+                         ProcessingDeadline::abortCheck, nullptr, skipAnnotations, nullptr);
+        if (!m_outputDev->getBitmap()) {
+            m_lastError = QS("页面渲染失败: %1").arg(pageIndex + 1);
+            return false;
+        }
+
+        m_pageIndex = pageIndex;
+        m_dpi = dpi;
+        return true;
+    } catch (const std::exception& e) {
+        m_lastError = QS("渲染页面时发生异常: %1").arg(QString::fromUtf8(e.what()));
+        qDebug() << "PdfAnalysisRaster:" << m_lastError;
+        clear();
+        return false;
+    }
+}
+
+void PdfAnalysisRaster::clear()
+{
+    m_outputDev.reset();
+    m_startedDocument = nullptr;
+    m_pageIndex = -1;
+}
+
+bool PdfAnalysisRaster::isValid() const
+{
+    return m_pageIndex >= 0 && m_outputDev && m_outputDev->getBitmap();
+}
+
+int PdfAnalysisRaster::pageIndex() const
+{
+    return m_pageIndex;
+}
+
+double PdfAnalysisRaster::dpi() const
+{
+    return m_dpi;
+}
+
+int PdfAnalysisRaster::width() const
+{
+    return isValid() ? m_outputDev->getBitmap()->getWidth() : 0;
+}
+
+int PdfAnalysisRaster::height() const
+{
+    return isValid() ? m_outputDev->getBitmap()->getHeight() : 0;
+}
+
+int PdfAnalysisRaster::bytesPerLine() const
+{
+    return isValid() ? m_outputDev->getBitmap()->getRowSize() : 0;
+}
+
+const uchar* PdfAnalysisRaster::bits() const
+{
+    if (!isValid()) {
+        return nullptr;
+    }
+    const SplashBitmap* bitmap = m_outputDev->getBitmap();
+    return bitmap->getDataPtr();
+}
+
+QImage PdfAnalysisRaster::image() const
+{
+    if (!isValid()) {
+        return QImage();
+    }
+    return QImage(bits(), width(), height(), bytesPerLine(), QImage::Format_Grayscale8);
+}
+
+QRect PdfAnalysisRaster::toPixels(const QRectF& region) const
+{
+    const double scale = m_dpi / 72.0;
+    const int left = qBound(0, qFloor(region.left() * scale), width());
+    const int top = qBound(0, qFloor(region.top() * scale), height());
+    const int right = qBound(0, qCeil(region.right() * scale), width());
+    const int bottom = qBound(0, qCeil(region.bottom() * scale), height());
+    return QRect(QPoint(left, top), QPoint(right - 1, bottom - 1));
+}
+
+QRectF PdfAnalysisRaster::inkBounds(const QRectF& region, int threshold) const
+{
+    const QRect pixels = toPixels(region);
+    if (!isValid() || pixels.isEmpty()) {
+        return QRectF();
+    }
+
+    const uchar* data = bits();
+    const int stride = bytesPerLine();
+    int minX = pixels.right() + 1;
+    int maxX = pixels.left() - 1;
+    int minY = pixels.bottom() + 1;
+    int maxY = pixels.top() - 1;
+
+    for (int y = pixels.top(); y <= pixels.bottom(); ++y) {
+        const uchar* row = data + static_cast<qsizetype>(y) * stride;
+        int first = pixels.left();
+        while (first <= pixels.right() && row[first] >= threshold) {
+            ++first;
+        }
+        if (first > pixels.right()) {
+            continue;
+        }
+        int last = pixels.right();
+        while (row[last] >= threshold) {
+            --last;
+        }
+        minX = qMin(minX, first);
+        maxX = qMax(maxX, last);
+        minY = qMin(minY, y);
+        maxY = qMax(maxY, y);
+    }
+
+    if (maxX < minX || maxY < minY) {
+        return QRectF();
+    }
+
+    const double scale = m_dpi / 72.0;
+    return QRectF(minX / scale, minY / scale, (maxX - minX + 1) / scale, (maxY - minY + 1) / scale);
+}
+
+QString PdfAnalysisRaster::lastError() const
+{
+    return m_lastError;
+}
@@ -0,0 +1,102 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 17:50:00
+ * @LastEditTime: 2026-10-18 17:50:00
+ * @LastEditors: seelights
+ * @Description: 版面分析用的8位灰度页面光栅
+ * @FilePath: \ReportMason\src\PdfAnalysisRaster.h
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#pragma once
+
+#include "PdfCoreDocument.h"
+#include <QImage>
+#include <QRect>
+#include <QRectF>
+#include <QString>
+#include <memory>
+
+class SplashOutputDev;
+
+/**
+ * @brief 版面分析用的8位灰度页面光栅
+ *
+ * 版面分析只需要亮度：直接让SplashOutputDev以splashModeMono8渲染，
+ * 关闭文字/图形抗锯齿和细线模式，并跳过注释，渲染结果是每像素1字节的缓冲区，
+ * 内存带宽只有默认ARGB32路径的1/4。
+ * 同一文档的多页复用同一个SplashOutputDev（字体引擎只初始化一次）。
+ * 单个实例不是线程安全的。
+ */
+class PdfAnalysisRaster
+{
+public:
+    PdfAnalysisRaster();
+    ~PdfAnalysisRaster();
+
+    PdfAnalysisRaster(const PdfAnalysisRaster&) = delete;
+    PdfAnalysisRaster& operator=(const PdfAnalysisRaster&) = delete;
+
+    /**
+     * @brief 渲染页面
+     * @param document 已打开的核心文档
+     * @param pageIndex 从0开始的页码
+     * @param dpi 分辨率
+     * @return 是否成功
+     */
+    bool render(PdfCoreDocument& document, int pageIndex, double dpi = DEFAULT_DPI);
+
+    /**
+     * @brief 释放光栅和渲染设备
+     */
+    void clear();
+
+    /**
+     * @brief 是否有可用的光栅
+     */
+    bool isValid() const;
+
+    int pageIndex() const;
+    double dpi() const;
+    int width() const;
+    int height() const;
+    int bytesPerLine() const;
+
+    /**
+     * @brief 获取灰度数据，每像素1字节，0为黑色
+     */
+    const uchar* bits() const;
+
+    /**
+     * @brief 以Grayscale8格式包装光栅数据（不复制，光栅失效后不可再使用）
+     */
+    QImage image() const;
+
+    /**
+     * @brief 计算区域内着墨像素的边界
+     * @param region 区域（点，原点在页面左上角）
+     * @param threshold 亮度低于该值的像素视为着墨
+     * @return 着墨边界（点），区域内没有着墨像素时为空矩形
+     */
+    QRectF inkBounds(const QRectF& region, int threshold = INK_THRESHOLD) const;
+
+    /**
+     * @brief 获取最后的错误信息
+     */
+    QString lastError() const;
+
+    static constexpr double DEFAULT_DPI = 72.0;
+    static constexpr int INK_THRESHOLD = 250;
+
+private:
+    /**
+     * @brief 将点坐标区域换算为光栅像素矩形（已裁剪到光栅范围）
+     */
+    QRect toPixels(const QRectF& region) const;
+
+    std::unique_ptr<SplashOutputDev> m_outputDev;
+    PDFDoc* m_startedDocument;
+    int m_pageIndex;
+    double m_dpi;
+    QString m_lastError;
+};
@@ -0,0 +1,122 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 15:00:00
+ * @LastEditTime: 2026-10-18 15:00:00
+ * @LastEditors: seelights
+ * @Description: poppler核心PDFDoc封装实现
+ * @FilePath: \ReportMason\src\PdfCoreDocument.cpp
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#include "PdfCoreDocument.h"
+#include "PopplerCompat.h"
+#include "QtCompat.h"
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+
+#include <Error.h>
+#include <GlobalParams.h>
+#include <GooString.h>
+#include <PDFDoc.h>
+
+#include "poppler-private.h"
+
+PdfCoreDocument::PdfCoreDocument() = default;
+
+PdfCoreDocument::~PdfCoreDocument()
+{
+    close();
+}
+
+bool PdfCoreDocument::open(const QString& filePath)
+{
+    close();
+    m_errorCode = 0;
+
+    if (!QFileInfo::exists(filePath)) {
+        m_lastError = QS("PDF文件不存在: %1").arg(filePath);
+        return false;
+    }
+
+    try {
+        // 预热持有的引用保证globalParams及其字体、CMap缓存不会随最后一个文档关闭而释放
+        PopplerCompat::warmUp();
+        // 错误回调与Poppler::Document一致（实际生效的是预热时安装的同一个回调）
+        m_globalParams = std::make_unique<GlobalParamsIniter>(Poppler::qt6ErrorFunction);
+
+#ifdef _WIN32
+        m_document = std::make_unique<PDFDoc>(reinterpret_cast<wchar_t*>(const_cast<ushort*>(filePath.utf16())),
+                                              filePath.length());
+#else
+        m_document = std::make_unique<PDFDoc>(std::make_unique<GooString>(QFile::encodeName(filePath).constData()));
+#endif
+
+        if (!m_document->isOk()) {
+            m_errorCode = m_document->getErrorCode();
+            m_lastError = QS("无法解析PDF文档，错误码: %1").arg(m_document->getErrorCode());
+            close();
+            return false;
+        }
+
+        m_filePath = filePath;
+        return true;
+    } catch (const std::exception& e) {
+        m_lastError = QS("打开PDF文档时发生异常: %1").arg(QString::fromUtf8(e.what()));
+        close();
+        return false;
+    }
+}
+
+void PdfCoreDocument::close()
+{
+    // PDFDoc必须先于globalParams释放
+    m_document.reset();
+    m_globalParams.reset();
+    m_filePath.clear();
+}
+
+bool PdfCoreDocument::isOpen() const
+{
+    return m_document != nullptr;
+}
+
+PDFDoc* PdfCoreDocument::document() const
+{
+    return m_document.get();
+}
+
+int PdfCoreDocument::pageCount() const
+{
+    return m_document ? m_document->getNumPages() : 0;
+}
+
+QSizeF PdfCoreDocument::pageSize(int pageIndex) const
+{
+    if (!m_document || pageIndex < 0 || pageIndex >= m_document->getNumPages()) {
+        return QSizeF();
+    }
+
+    const int pageNumber = pageIndex + 1;
+    const double cropWidth = m_document->getPageCropWidth(pageNumber);
+    const double cropHeight = m_document->getPageCropHeight(pageNumber);
+    if (m_document->getPageRotate(pageNumber) % 180 != 0) {
+        return QSizeF(cropHeight, cropWidth);
+    }
+    return QSizeF(cropWidth, cropHeight);
+}
+
+QString PdfCoreDocument::filePath() const
+{
+    return m_filePath;
+}
+
+QString PdfCoreDocument::lastError() const
+{
+    return m_lastError;
+}
+
+int PdfCoreDocument::errorCode() const
+{
+    return m_errorCode;
+}
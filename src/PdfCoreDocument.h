@@ -0,0 +1,92 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 15:00:00
+ * @LastEditTime: 2026-10-18 15:00:00
+ * @LastEditors: seelights
+ * @Description: poppler核心PDFDoc封装
+ * @FilePath: \ReportMason\src\PdfCoreDocument.h
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <QSizeF>
+#include <QString>
+#include <memory>
+
+class PDFDoc;
+class GlobalParamsIniter;
+
+/**
+ * @brief poppler核心PDFDoc封装
+ *
+ * poppler-qt6的Poppler::Document不暴露内部的PDFDoc，
+ * 需要直接驱动OutputDev（TextOutputDev、自定义分析设备等）时使用本类打开文档。
+ * 负责globalParams的引用计数初始化和平台相关的文件名处理。
+ * 单个实例不是线程安全的。
+ */
+class PdfCoreDocument
+{
+public:
+    PdfCoreDocument();
+    ~PdfCoreDocument();
+
+    PdfCoreDocument(const PdfCoreDocument&) = delete;
+    PdfCoreDocument& operator=(const PdfCoreDocument&) = delete;
+
+    /**
+     * @brief 打开PDF文件
+     * @param filePath 文件路径
+     * @return 是否成功
+     */
+    bool open(const QString& filePath);
+
+    /**
+     * @brief 关闭文件
+     */
+    void close();
+
+    /**
+     * @brief 是否已打开文件
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief 获取底层PDFDoc，未打开时为nullptr
+     */
+    PDFDoc* document() const;
+
+    /**
+     * @brief 获取页数
+     */
+    int pageCount() const;
+
+    /**
+     * @brief 获取页面显示尺寸（点），已考虑页面旋转
+     * @param pageIndex 从0开始的页码
+     * @return 页面尺寸
+     */
+    QSizeF pageSize(int pageIndex) const;
+
+    /**
+     * @brief 获取打开的文件路径
+     */
+    QString filePath() const;
+
+    /**
+     * @brief 获取最后的错误信息
+     */
+    QString lastError() const;
+
+    /**
+     * @brief 获取最后一次打开失败时poppler的错误码（ErrorCodes.h），成功时为0
+     */
+    int errorCode() const;
+
+private:
+    std::unique_ptr<GlobalParamsIniter> m_globalParams; ///< 保证globalParams在使用期间有效
+    std::unique_ptr<PDFDoc> m_document;
+    QString m_filePath;
+    QString m_lastError;
+    int m_errorCode = 0;
+};
@@ -0,0 +1,185 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 13:40:00
+ * @LastEditTime: 2026-10-18 13:40:00
+ * @LastEditors: seelights
+ * @Description: 共享Poppler文档池实现
+ * @FilePath: \ReportMason\src\PdfDocumentPool.cpp
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#include "PdfDocumentPool.h"
+#include "PopplerCompat.h"
+#include "QtCompat.h"
+#include <QDebug>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QThread>
+#include <poppler-qt6.h>
+
+PdfDocumentPool::PdfDocumentPool()
+    : m_capacity(DEFAULT_CAPACITY), m_hits(0), m_misses(0)
+{
+}
+
+PdfDocumentPool* PdfDocumentPool::instance()
+{
+    // 函数内静态变量的初始化是线程安全的
+    static PdfDocumentPool pool;
+    return &pool;
+}
+
+std::shared_ptr<Poppler::Document> PdfDocumentPool::acquire(const QString& filePath, QString* errorMessage)
+{
+    const QFileInfo fileInfo(filePath);
+    const QString canonicalPath = fileInfo.canonicalFilePath();
+    if (canonicalPath.isEmpty()) {
+        if (errorMessage) {
+            *errorMessage = QS("文件不存在: %1").arg(filePath);
+        }
+        return nullptr;
+    }
+    const QDateTime lastModified = fileInfo.lastModified();
+    const qint64 size = fileInfo.size();
+    const Qt::HANDLE thread = QThread::currentThreadId();
+
+    {
+        QMutexLocker locker(&m_mutex);
+        const int index = findLocked(canonicalPath, lastModified, size, thread);
+        if (index >= 0) {
+            m_entries.move(index, 0);
+            m_entries.first().owner = thread;
+            m_hits++;
+            return m_entries.first().document;
+        }
+        m_misses++;
+    }
+
+    // 加载可能很慢，不持有锁；其他线程同时加载同一文件时各自得到一个实例
+    std::shared_ptr<Poppler::Document> document = load(canonicalPath, errorMessage);
+    if (!document) {
+        return nullptr;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    if (m_capacity > 0) {
+        Entry entry;
+        entry.canonicalPath = canonicalPath;
+        entry.lastModified = lastModified;
+        entry.size = size;
+        entry.document = document;
+        entry.owner = thread;
+        m_entries.prepend(entry);
+        evictLocked();
+    }
+    return document;
+}
+
+std::shared_ptr<Poppler::Document> PdfDocumentPool::load(const QString& filePath, QString* errorMessage)
+{
+    // 首次加载前确保进程级预热已完成
+    PopplerCompat::warmUp();
+    std::shared_ptr<Poppler::Document> document(Poppler::Document::load(filePath).release());
+    if (!document) {
+        if (errorMessage) {
+            *errorMessage = QS("无法加载PDF文档");
+        }
+        return nullptr;
+    }
+    if (document->isLocked()) {
+        if (errorMessage) {
+            *errorMessage = QS("PDF文档已加密");
+        }
+        return nullptr;
+    }
+    return document;
+}
+
+void PdfDocumentPool::release(const QString& filePath)
+{
+    const QString canonicalPath = QFileInfo(filePath).canonicalFilePath();
+    if (canonicalPath.isEmpty()) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    for (int i = m_entries.size() - 1; i >= 0; --i) {
+        if (m_entries.at(i).canonicalPath == canonicalPath) {
+            m_entries.removeAt(i);
+        }
+    }
+}
+
+void PdfDocumentPool::setCapacity(int capacity)
+{
+    QMutexLocker locker(&m_mutex);
+    m_capacity = qMax(0, capacity);
+    evictLocked();
+}
+
+int PdfDocumentPool::capacity() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_capacity;
+}
+
+int PdfDocumentPool::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.size();
+}
+
+void PdfDocumentPool::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+    m_hits = 0;
+    m_misses = 0;
+}
+
+qint64 PdfDocumentPool::hitCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_hits;
+}
+
+qint64 PdfDocumentPool::missCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_misses;
+}
+
+int PdfDocumentPool::findLocked(const QString& canonicalPath, const QDateTime& lastModified, qint64 size,
+                                Qt::HANDLE thread)
+{
+    int idle = -1;
+    for (int i = 0; i < m_entries.size(); ++i) {
+        const Entry& entry = m_entries.at(i);
+        if (entry.canonicalPath != canonicalPath) {
+            continue;
+        }
+        if (entry.lastModified != lastModified || entry.size != size) {
+            // 文件已被修改，丢弃旧文档（借用者持有的实例不受影响）
+            m_entries.removeAt(i--);
+            continue;
+        }
+        // 只有文档池持有引用时实例空闲。引用计数只在此处持锁借出时从1增加，
+        // 读到1说明确实没有借用者；借用者正在释放时读到的值偏大，至多多加载一个实例
+        if (entry.document.use_count() > 1) {
+            if (entry.owner == thread) {
+                return i;
+            }
+        } else if (idle < 0) {
+            idle = i;
+        }
+    }
+    return idle;
+}
+
+void PdfDocumentPool::evictLocked()
+{
+    while (m_entries.size() > m_capacity) {
+        qDebug() << "PdfDocumentPool: 淘汰文档" << m_entries.last().canonicalPath;
+        m_entries.removeLast();
+    }
+}
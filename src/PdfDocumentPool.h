@@ -0,0 +1,121 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 13:40:00
+ * @LastEditTime: 2026-10-18 13:40:00
+ * @LastEditors: seelights
+ * @Description: 共享Poppler文档池
+ * @FilePath: \ReportMason\src\PdfDocumentPool.h
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <QDateTime>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <memory>
+
+namespace Poppler {
+class Document;
+}
+
+/**
+ * @brief 共享Poppler文档池
+ *
+ * 同一份PDF在一次转换中会被图片、表格、图表提取器和无损转换器分别打开，
+ * 每次都要重新解析xref、对象流和字体。文档池以规范路径+修改时间+文件大小为键，
+ * 缓存已加载的Poppler::Document，各调用方通过shared_ptr借用同一个实例。
+ *
+ * 超出容量时按最近最少使用淘汰；被淘汰的文档在最后一个借用者释放后才真正关闭。
+ * 文件被修改（时间或大小变化）后会自动重新加载。
+ *
+ * Poppler::Document不是线程安全的，因此每个实例同一时间只借给一个线程：
+ * 同一线程内的借用者共享实例，其他线程借用同一文件时得到另一个空闲或新加载的实例。
+ * 借用者不得把文档交给其他线程，需要跨线程传递的文档用load()单独加载。
+ */
+class PdfDocumentPool
+{
+public:
+    /**
+     * @brief 获取全局实例
+     */
+    static PdfDocumentPool* instance();
+
+    /**
+     * @brief 为当前线程借用文档，未命中时加载
+     * @param filePath PDF文件路径
+     * @param errorMessage 输出的错误信息，可为nullptr
+     * @return 文档，失败（文件不存在、无法解析或已加密）时返回nullptr
+     */
+    std::shared_ptr<Poppler::Document> acquire(const QString& filePath, QString* errorMessage = nullptr);
+
+    /**
+     * @brief 加载不进入文档池的文档，调用方独占，可以在线程之间传递
+     * @param filePath PDF文件路径
+     * @param errorMessage 输出的错误信息，可为nullptr
+     * @return 文档，失败（无法解析或已加密）时返回nullptr
+     */
+    static std::shared_ptr<Poppler::Document> load(const QString& filePath, QString* errorMessage = nullptr);
+
+    /**
+     * @brief 从池中移除指定文件的文档（借用者持有的实例不受影响）
+     * @param filePath PDF文件路径
+     */
+    void release(const QString& filePath);
+
+    /**
+     * @brief 设置最多缓存的文档数量
+     * @param capacity 容量，0表示不缓存
+     */
+    void setCapacity(int capacity);
+
+    /**
+     * @brief 获取容量
+     */
+    int capacity() const;
+
+    /**
+     * @brief 获取当前缓存的文档数量
+     */
+    int size() const;
+
+    /**
+     * @brief 清空文档池并重置统计
+     */
+    void clear();
+
+    qint64 hitCount() const;
+    qint64 missCount() const;
+
+private:
+    PdfDocumentPool();
+    PdfDocumentPool(const PdfDocumentPool&) = delete;
+    PdfDocumentPool& operator=(const PdfDocumentPool&) = delete;
+
+    /**
+     * @brief 文档池条目
+     */
+    struct Entry {
+        QString canonicalPath;
+        QDateTime lastModified;
+        qint64 size;
+        std::shared_ptr<Poppler::Document> document;
+        Qt::HANDLE owner = nullptr; ///< 最近借用该实例的线程，document仍有池外引用时只借给它
+    };
+
+    /**
+     * @brief 当前线程可以借用的条目，同时移除文件已被修改的条目
+     * @return 条目位置，没有时为-1
+     */
+    int findLocked(const QString& canonicalPath, const QDateTime& lastModified, qint64 size, Qt::HANDLE thread);
+    void evictLocked();
+
+    static const int DEFAULT_CAPACITY = 4;
+
+    mutable QMutex m_mutex;
+    QList<Entry> m_entries; ///< 按使用时间排序，最近使用的在前；同一文件可以有多个实例
+    int m_capacity;
+    qint64 m_hits;
+    qint64 m_misses;
+};
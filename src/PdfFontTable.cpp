@@ -0,0 +1,71 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 22:00:00
+ * @LastEditTime: 2026-10-18 22:00:00
+ * @LastEditors: seelights
+ * @Description: 文档级PDF字体描述符表实现
+ * @FilePath: \ReportMason\src\PdfFontTable.cpp
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#include "PdfFontTable.h"
+#include <QMutexLocker>
+#include <cmath>
+
+int PdfFontTable::internFamily(const QString& family)
+{
+    QMutexLocker locker(&m_mutex);
+    const auto it = m_familyIds.constFind(family);
+    if (it != m_familyIds.constEnd()) {
+        return it.value();
+    }
+
+    const int familyId = m_families.size();
+    m_families.append(family);
+    m_familyIds.insert(family, familyId);
+    return familyId;
+}
+
+int PdfFontTable::intern(const Font& font)
+{
+    const int centiPoints = static_cast<int>(std::lround(font.size * 100.0));
+    const int flags = (font.bold ? 1 : 0) | (font.italic ? 2 : 0) | (font.fixedPitch ? 4 : 0) | (font.serif ? 8 : 0);
+    const Key key{font.familyId, centiPoints, flags, font.color};
+
+    QMutexLocker locker(&m_mutex);
+    const auto it = m_fontIds.constFind(key);
+    if (it != m_fontIds.constEnd()) {
+        return it.value();
+    }
+
+    Font stored = font;
+    stored.size = centiPoints / 100.0;
+    const int fontId = m_fonts.size();
+    m_fonts.append(stored);
+    m_fontIds.insert(key, fontId);
+    return fontId;
+}
+
+PdfFontTable::Font PdfFontTable::font(int fontId) const
+{
+    QMutexLocker locker(&m_mutex);
+    return fontId >= 0 && fontId < m_fonts.size() ? m_fonts.at(fontId) : Font();
+}
+
+QString PdfFontTable::family(int familyId) const
+{
+    QMutexLocker locker(&m_mutex);
+    return familyId >= 0 && familyId < m_families.size() ? m_families.at(familyId) : QString();
+}
+
+QList<PdfFontTable::Font> PdfFontTable::fonts() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_fonts;
+}
+
+int PdfFontTable::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_fonts.size();
+}
@@ -0,0 +1,108 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 22:00:00
+ * @LastEditTime: 2026-10-18 22:00:00
+ * @LastEditors: seelights
+ * @Description: 文档级PDF字体描述符表
+ * @FilePath: \ReportMason\src\PdfFontTable.h
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <QColor>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief 文档级PDF字体描述符表
+ *
+ * 一个文档中成千上万个单词通常只用到几十种(字体, 字号, 样式, 颜色)组合。
+ * 本表对这些组合做驻留（interning）：每种组合只保存一次，
+ * 文本框和文档元素只记录表中的编号，不再为每个文本框复制QFont和字体族名。
+ * 字体族名另外单独驻留，描述符只保存族名编号。
+ * 编号在表的生命周期内稳定，可以跨页面、跨线程使用。
+ */
+class PdfFontTable
+{
+public:
+    /**
+     * @brief 字体描述符
+     */
+    struct Font {
+        int familyId = -1;       ///< 字体族名编号，见family()
+        double size = 0.0;       ///< 字号（点），保留两位小数
+        bool bold = false;
+        bool italic = false;
+        bool fixedPitch = false; ///< 等宽字体
+        bool serif = false;      ///< 衬线字体
+        QRgb color = 0xff000000; ///< 文字填充颜色
+    };
+
+    PdfFontTable() = default;
+
+    PdfFontTable(const PdfFontTable&) = delete;
+    PdfFontTable& operator=(const PdfFontTable&) = delete;
+
+    /**
+     * @brief 驻留字体族名
+     * @param family 已去掉子集前缀的字体名
+     * @return 族名编号
+     */
+    int internFamily(const QString& family);
+
+    /**
+     * @brief 驻留字体描述符，相同的描述符总是返回同一个编号
+     * @param font 描述符，familyId须来自internFamily
+     * @return 字体编号
+     */
+    int intern(const Font& font);
+
+    /**
+     * @brief 按编号获取描述符，编号无效时返回默认描述符
+     */
+    Font font(int fontId) const;
+
+    /**
+     * @brief 按编号获取字体族名，编号无效时为空
+     */
+    QString family(int familyId) const;
+
+    /**
+     * @brief 全部描述符，下标即字体编号
+     */
+    QList<Font> fonts() const;
+
+    int size() const;
+
+private:
+    /**
+     * @brief 描述符的驻留键，字号以1/100点为单位避免浮点比较
+     */
+    struct Key {
+        int familyId;
+        int centiPoints;
+        int flags;
+        QRgb color;
+
+        bool operator==(const Key& other) const
+        {
+            return familyId == other.familyId && centiPoints == other.centiPoints && flags == other.flags
+                   && color == other.color;
+        }
+    };
+
+    friend size_t qHash(const Key& key, size_t seed)
+    {
+        return qHashMulti(seed, key.familyId, key.centiPoints, key.flags, key.color);
+    }
+
+    mutable QMutex m_mutex;
+    QStringList m_families;
+    QHash<QString, int> m_familyIds;
+    QList<Font> m_fonts;
+    QHash<Key, int> m_fontIds;
+};
@@ -0,0 +1,155 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 20:00:00
+ * @LastEditTime: 2026-10-18 20:00:00
+ * @LastEditors: seelights
+ * @Description: 基于Poppler表单API的AcroForm字段读取器实现
+ * @FilePath: \ReportMason\src\PdfFormReader.cpp
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#include "PdfFormReader.h"
+#include "QtCompat.h"
+#include <QDebug>
+#include <QHash>
+#include <poppler-qt6.h>
+#include <poppler-form.h>
+
+namespace {
+
+/**
+ * @brief 读取单个控件的类型和值
+ */
+void readWidget(const Poppler::FormField* widget, PdfFormReader::Field& field)
+{
+    switch (widget->type()) {
+    case Poppler::FormField::FormText:
+        field.type = PdfFormReader::FieldType::TEXT;
+        field.value = static_cast<const Poppler::FormFieldText*>(widget)->text();
+        break;
+    case Poppler::FormField::FormButton: {
+        const auto* button = static_cast<const Poppler::FormFieldButton*>(widget);
+        switch (button->buttonType()) {
+        case Poppler::FormFieldButton::CheckBox:
+            field.type = PdfFormReader::FieldType::CHECKBOX;
+            field.value = button->state() ? QS("true") : QS("false");
+            break;
+        case Poppler::FormFieldButton::Radio:
+            field.type = PdfFormReader::FieldType::RADIO;
+            if (button->state()) {
+                field.value = button->caption().isEmpty() ? QS("true") : button->caption();
+            }
+            break;
+        case Poppler::FormFieldButton::Push:
+            field.type = PdfFormReader::FieldType::PUSH;
+            field.value = button->caption();
+            break;
+        }
+        break;
+    }
+    case Poppler::FormField::FormChoice: {
+        const auto* choice = static_cast<const Poppler::FormFieldChoice*>(widget);
+        field.type = PdfFormReader::FieldType::CHOICE;
+        field.options = choice->choices();
+        QStringList selected;
+        for (int index : choice->currentChoices()) {
+            if (index >= 0 && index < field.options.size()) {
+                selected.append(field.options.at(index));
+            }
+        }
+        // 可编辑组合框的输入值优先
+        const QString edited = choice->editChoice();
+        field.value = edited.isEmpty() ? selected.join(QS("; ")) : edited;
+        break;
+    }
+    case Poppler::FormField::FormSignature:
+        // 签名只记录位置，验证在需要时单独进行
+        field.type = PdfFormReader::FieldType::SIGNATURE;
+        break;
+    }
+}
+
+} // namespace
+
+QList<PdfFormReader::Field> PdfFormReader::readFields(const std::shared_ptr<Poppler::Document>& document)
+{
+    QList<Field> fields;
+    if (!document) {
+        return fields;
+    }
+
+    try {
+        // 没有AcroForm的文档不需要加载任何页面
+        if (document->formType() == Poppler::Document::NoForm) {
+            return fields;
+        }
+
+        QHash<QString, int> fieldIndexes;
+        const int pageCount = document->numPages();
+        for (int pageIndex = 0; pageIndex < pageCount; ++pageIndex) {
+            std::unique_ptr<Poppler::Page> page = document->page(pageIndex);
+            if (!page) {
+                continue;
+            }
+
+            // formFields只读取页面的控件注释，不执行内容流
+            const std::vector<std::unique_ptr<Poppler::FormField>> widgets = page->formFields();
+            if (widgets.empty()) {
+                continue;
+            }
+            const QSizeF pageSize = page->pageSizeF();
+
+            for (const auto& widget : widgets) {
+                if (!widget) {
+                    continue;
+                }
+
+                const QString name = widget->fullyQualifiedName();
+                Field field;
+                field.name = name.isEmpty() ? widget->name() : name;
+                field.label = widget->uiName();
+                field.type = FieldType::TEXT;
+                field.pageIndex = pageIndex;
+                // rect()以页面尺寸归一化
+                const QRectF normalized = widget->rect();
+                field.rect = QRectF(normalized.x() * pageSize.width(), normalized.y() * pageSize.height(),
+                                    normalized.width() * pageSize.width(), normalized.height() * pageSize.height());
+                field.readOnly = widget->isReadOnly();
+                field.visible = widget->isVisible();
+                readWidget(widget.get(), field);
+
+                const auto existing = fieldIndexes.constFind(field.name);
+                if (existing == fieldIndexes.constEnd()) {
+                    fieldIndexes.insert(field.name, fields.size());
+                    fields.append(field);
+                } else if (!field.value.isEmpty() && field.type == FieldType::RADIO) {
+                    // 单选按钮组取选中的控件
+                    fields[existing.value()].value = field.value;
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        qDebug() << "PdfFormReader: 读取表单字段时发生异常" << e.what();
+    }
+
+    return fields;
+}
+
+QString PdfFormReader::typeName(FieldType type)
+{
+    switch (type) {
+    case FieldType::TEXT:
+        return QS("text");
+    case FieldType::CHECKBOX:
+        return QS("checkbox");
+    case FieldType::RADIO:
+        return QS("radio");
+    case FieldType::PUSH:
+        return QS("button");
+    case FieldType::CHOICE:
+        return QS("choice");
+    case FieldType::SIGNATURE:
+        return QS("signature");
+    }
+    return QString();
+}
@@ -0,0 +1,72 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 20:00:00
+ * @LastEditTime: 2026-10-18 20:00:00
+ * @LastEditors: seelights
+ * @Description: 基于Poppler表单API的AcroForm字段读取器
+ * @FilePath: \ReportMason\src\PdfFormReader.h
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <QList>
+#include <QRectF>
+#include <QString>
+#include <QStringList>
+#include <memory>
+
+namespace Poppler {
+class Document;
+}
+
+/**
+ * @brief 基于Poppler表单API的AcroForm字段读取器
+ *
+ * 只遍历AcroForm字典和各页的控件注释（Widget），不解析页面内容流，
+ * 对填写式报告模板而言是主要的提取路径，通常只需数毫秒。
+ * 同名字段的多个控件（如单选按钮组）合并为一个字段，
+ * 位置取第一个控件，值取选中的控件。
+ */
+class PdfFormReader
+{
+public:
+    /**
+     * @brief 字段类型
+     */
+    enum class FieldType {
+        TEXT,      ///< 文本框
+        CHECKBOX,  ///< 复选框
+        RADIO,     ///< 单选按钮组
+        PUSH,      ///< 按钮
+        CHOICE,    ///< 列表框/组合框
+        SIGNATURE  ///< 签名域
+    };
+
+    /**
+     * @brief 表单字段
+     */
+    struct Field {
+        QString name;       ///< 完全限定名称（父字段名以.连接）
+        QString label;      ///< 界面显示名称（TU），可能为空
+        QString value;      ///< 当前值：文本内容、选中项、复选框为true/false
+        QStringList options; ///< 选择字段的可选项
+        FieldType type;
+        int pageIndex;      ///< 第一个控件所在页（从0开始）
+        QRectF rect;        ///< 第一个控件的位置，单位为点，原点在页面左上角
+        bool readOnly;
+        bool visible;
+    };
+
+    /**
+     * @brief 读取文档中的全部表单字段
+     * @param document 文档
+     * @return 按页码和出现顺序排列的字段，文档没有AcroForm时为空
+     */
+    static QList<Field> readFields(const std::shared_ptr<Poppler::Document>& document);
+
+    /**
+     * @brief 获取字段类型名称
+     */
+    static QString typeName(FieldType type);
+};
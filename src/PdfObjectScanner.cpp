@@ -0,0 +1,522 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 21:00:00
+ * @LastEditTime: 2026-10-18 21:00:00
+ * @LastEditors: seelights
+ * @Description: 字节级PDF对象扫描器实现
+ * @FilePath: \ReportMason\src\PdfObjectScanner.cpp
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#include "PdfObjectScanner.h"
+#include "QtCompat.h"
+#include <QDebug>
+#include <cstring>
+
+namespace {
+
+/// endstream之后查找endobj的最大距离，超过时认为对象残缺
+const qsizetype MAX_TRAILING_BYTES = 64;
+
+/// 数组/字典的最大嵌套深度，防止损坏文件导致递归过深
+const int MAX_NESTING = 64;
+
+bool isWhitespace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\f' || c == '\0';
+}
+
+bool isDelimiter(char c)
+{
+    return c == '(' || c == ')' || c == '<' || c == '>' || c == '[' || c == ']' || c == '{' || c == '}'
+        || c == '/' || c == '%';
+}
+
+bool isRegular(char c)
+{
+    return !isWhitespace(c) && !isDelimiter(c);
+}
+
+bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+/**
+ * @brief 跳过空白，返回第一个非空白字符的位置
+ */
+qsizetype skipWhitespace(QByteArrayView data, qsizetype pos)
+{
+    while (pos < data.size() && isWhitespace(data[pos])) {
+        ++pos;
+    }
+    return pos;
+}
+
+/**
+ * @brief 向前读取一个十进制整数，end为数字之后的位置
+ * @return 数字起始位置，不是数字时为-1
+ */
+qsizetype digitsBefore(QByteArrayView data, qsizetype end)
+{
+    qsizetype begin = end;
+    while (begin > 0 && isDigit(data[begin - 1])) {
+        --begin;
+    }
+    return begin == end ? -1 : begin;
+}
+
+/**
+ * @brief 跳过字面字符串，pos指向'('，返回')'之后的位置
+ */
+qsizetype skipLiteralString(QByteArrayView data, qsizetype pos)
+{
+    int depth = 0;
+    while (pos < data.size()) {
+        const char c = data[pos++];
+        if (c == '\\') {
+            ++pos;
+        } else if (c == '(') {
+            ++depth;
+        } else if (c == ')' && --depth == 0) {
+            break;
+        }
+    }
+    return pos;
+}
+
+/**
+ * @brief 跳过一个完整的值记号，返回记号之后的位置（不是合法记号时原样返回pos）
+ */
+qsizetype skipValue(QByteArrayView data, qsizetype pos, int nesting = 0)
+{
+    if (pos >= data.size() || nesting > MAX_NESTING) {
+        return pos;
+    }
+
+    const char c = data[pos];
+    if (c == '(') {
+        return skipLiteralString(data, pos);
+    }
+    if (c == '/') {
+        ++pos;
+        while (pos < data.size() && isRegular(data[pos])) {
+            ++pos;
+        }
+        return pos;
+    }
+    if (c == '<' && pos + 1 < data.size() && data[pos + 1] == '<') {
+        pos += 2;
+        while (true) {
+            pos = skipWhitespace(data, pos);
+            if (pos >= data.size()) {
+                return pos;
+            }
+            if (data[pos] == '>' && pos + 1 < data.size() && data[pos + 1] == '>') {
+                return pos + 2;
+            }
+            const qsizetype next = skipValue(data, pos, nesting + 1);
+            pos = next == pos ? pos + 1 : next;
+        }
+    }
+    if (c == '<') {
+        const qsizetype close = data.indexOf('>', pos);
+        return close < 0 ? data.size() : close + 1;
+    }
+    if (c == '[') {
+        ++pos;
+        while (true) {
+            pos = skipWhitespace(data, pos);
+            if (pos >= data.size()) {
+                return pos;
+            }
+            if (data[pos] == ']') {
+                return pos + 1;
+            }
+            const qsizetype next = skipValue(data, pos, nesting + 1);
+            pos = next == pos ? pos + 1 : next;
+        }
+    }
+
+    while (pos < data.size() && isRegular(data[pos])) {
+        ++pos;
+    }
+    // 间接引用"N G R"作为一个记号
+    const qsizetype generationBegin = skipWhitespace(data, pos);
+    qsizetype generationEnd = generationBegin;
+    while (generationEnd < data.size() && isDigit(data[generationEnd])) {
+        ++generationEnd;
+    }
+    if (generationEnd > generationBegin) {
+        const qsizetype r = skipWhitespace(data, generationEnd);
+        if (r < data.size() && data[r] == 'R' && (r + 1 == data.size() || !isRegular(data[r + 1]))) {
+            return r + 1;
+        }
+    }
+    return pos;
+}
+
+} // namespace
+
+PdfObjectScanner::PdfObjectScanner()
+    : m_mapped(nullptr), m_position(0), m_indexed(false)
+{
+}
+
+PdfObjectScanner::PdfObjectScanner(QByteArrayView data)
+    : m_mapped(nullptr), m_data(data), m_position(0), m_indexed(false)
+{
+}
+
+PdfObjectScanner::~PdfObjectScanner()
+{
+    close();
+}
+
+bool PdfObjectScanner::open(const QString& filePath)
+{
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_lastError = QS("无法打开PDF文件: %1").arg(filePath);
+        return false;
+    }
+
+    const qint64 size = m_file.size();
+    if (size > 0) {
+        // 映射后按需分页读入，文件内容不占用堆内存
+        m_mapped = m_file.map(0, size);
+    }
+    if (m_mapped) {
+        m_data = QByteArrayView(reinterpret_cast<const char*>(m_mapped), static_cast<qsizetype>(size));
+    } else {
+        m_buffer = m_file.readAll();
+        m_data = QByteArrayView(m_buffer);
+    }
+    return true;
+}
+
+void PdfObjectScanner::close()
+{
+    if (m_mapped) {
+        m_file.unmap(m_mapped);
+        m_mapped = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_buffer.clear();
+    m_data = QByteArrayView();
+    m_position = 0;
+    m_indexed = false;
+    m_index.clear();
+}
+
+bool PdfObjectScanner::isOpen() const
+{
+    return !m_data.isEmpty();
+}
+
+QByteArrayView PdfObjectScanner::data() const
+{
+    return m_data;
+}
+
+QString PdfObjectScanner::lastError() const
+{
+    return m_lastError;
+}
+
+bool PdfObjectScanner::next(Object& object)
+{
+    while (m_position < m_data.size()) {
+        const qsizetype keyword = indexOf(m_data, "obj", m_position);
+        if (keyword < 0) {
+            m_position = m_data.size();
+            return false;
+        }
+        if (parseObjectAt(keyword, object)) {
+            m_position = object.end;
+            return true;
+        }
+        m_position = keyword + 3;
+    }
+    return false;
+}
+
+void PdfObjectScanner::rewind()
+{
+    m_position = 0;
+}
+
+bool PdfObjectScanner::findObject(int number, Object& object)
+{
+    if (!m_indexed) {
+        buildIndex();
+    }
+
+    const auto it = m_index.constFind(number);
+    return it != m_index.constEnd() && parseObjectAt(it.value(), object);
+}
+
+QByteArrayView PdfObjectScanner::body(const Object& object) const
+{
+    if (object.bodyBegin < 0 || object.bodyEnd < object.bodyBegin) {
+        return QByteArrayView();
+    }
+    return m_data.sliced(object.bodyBegin, object.bodyEnd - object.bodyBegin);
+}
+
+QByteArrayView PdfObjectScanner::stream(const Object& object) const
+{
+    if (!object.hasStream() || object.streamEnd < object.streamBegin) {
+        return QByteArrayView();
+    }
+    return m_data.sliced(object.streamBegin, object.streamEnd - object.streamBegin);
+}
+
+QList<QByteArrayView> PdfObjectScanner::plainStreams() const
+{
+    QList<QByteArrayView> streams;
+    qsizetype pos = 0;
+    Object object;
+    while (pos < m_data.size()) {
+        const qsizetype keyword = indexOf(m_data, "obj", pos);
+        if (keyword < 0) {
+            break;
+        }
+        if (!parseObjectAt(keyword, object)) {
+            pos = keyword + 3;
+            continue;
+        }
+        pos = object.end;
+        if (object.hasStream() && value(body(object), "Filter").isEmpty()) {
+            streams.append(stream(object));
+        }
+    }
+    return streams;
+}
+
+QByteArrayView PdfObjectScanner::value(QByteArrayView dictionary, QByteArrayView key)
+{
+    int depth = 0;
+    qsizetype pos = 0;
+    while (pos < dictionary.size()) {
+        const char c = dictionary[pos];
+        if (c == '(') {
+            pos = skipLiteralString(dictionary, pos);
+            continue;
+        }
+        if (c == '<' && pos + 1 < dictionary.size() && dictionary[pos + 1] == '<') {
+            ++depth;
+            pos += 2;
+            continue;
+        }
+        if (c == '>' && pos + 1 < dictionary.size() && dictionary[pos + 1] == '>') {
+            --depth;
+            pos += 2;
+            continue;
+        }
+        if (c == '<') {
+            // 十六进制字符串
+            const qsizetype close = dictionary.indexOf('>', pos);
+            pos = close < 0 ? dictionary.size() : close + 1;
+            continue;
+        }
+        if (c != '/') {
+            ++pos;
+            continue;
+        }
+
+        // 名称记号：只有位于最外层字典中的键才比较
+        const qsizetype nameBegin = pos + 1;
+        qsizetype nameEnd = nameBegin;
+        while (nameEnd < dictionary.size() && isRegular(dictionary[nameEnd])) {
+            ++nameEnd;
+        }
+        if (depth == 1 && dictionary.sliced(nameBegin, nameEnd - nameBegin) == key) {
+            const qsizetype valueBegin = skipWhitespace(dictionary, nameEnd);
+            const qsizetype valueEnd = skipValue(dictionary, valueBegin);
+            return dictionary.sliced(valueBegin, valueEnd - valueBegin);
+        }
+        // 键之后的值整体跳过，避免把值中的名称当成键
+        if (depth == 1) {
+            const qsizetype valueBegin = skipWhitespace(dictionary, nameEnd);
+            const qsizetype valueEnd = skipValue(dictionary, valueBegin);
+            pos = valueEnd == valueBegin ? valueBegin + 1 : valueEnd;
+        } else {
+            pos = nameEnd;
+        }
+    }
+    return QByteArrayView();
+}
+
+QByteArray PdfObjectScanner::name(QByteArrayView dictionary, QByteArrayView key)
+{
+    QByteArrayView raw = value(dictionary, key);
+    if (!raw.isEmpty() && raw.front() == '[') {
+        raw = raw.sliced(skipWhitespace(raw, 1));
+    }
+    if (raw.isEmpty() || raw.front() != '/') {
+        return QByteArray();
+    }
+
+    qsizetype end = 1;
+    while (end < raw.size() && isRegular(raw[end])) {
+        ++end;
+    }
+    return raw.sliced(1, end - 1).toByteArray();
+}
+
+int PdfObjectScanner::integer(QByteArrayView dictionary, QByteArrayView key, int defaultValue)
+{
+    const QByteArrayView raw = value(dictionary, key);
+    // 间接引用需要读取其他对象，这里不解析
+    if (raw.isEmpty() || raw.back() == 'R') {
+        return defaultValue;
+    }
+    bool ok = false;
+    const int result = raw.toInt(&ok);
+    return ok ? result : defaultValue;
+}
+
+qsizetype PdfObjectScanner::indexOf(QByteArrayView haystack, QByteArrayView needle, qsizetype from)
+{
+    if (needle.isEmpty() || from < 0) {
+        return -1;
+    }
+
+    const char* data = haystack.data();
+    const qsizetype last = haystack.size() - needle.size();
+    const char first = needle.front();
+    qsizetype pos = from;
+    while (pos <= last) {
+        // memchr由C库以向量指令实现，扫描速度接近内存带宽
+        const void* hit = std::memchr(data + pos, first, static_cast<size_t>(last - pos + 1));
+        if (!hit) {
+            return -1;
+        }
+        pos = static_cast<const char*>(hit) - data;
+        if (std::memcmp(data + pos + 1, needle.data() + 1, static_cast<size_t>(needle.size() - 1)) == 0) {
+            return pos;
+        }
+        ++pos;
+    }
+    return -1;
+}
+
+bool PdfObjectScanner::parseObjectAt(qsizetype objKeyword, Object& object) const
+{
+    const qsizetype bodyBegin = objKeyword + 3;
+    if (bodyBegin < m_data.size() && isRegular(m_data[bodyBegin])) {
+        return false;
+    }
+
+    // "obj"之前必须是"编号 空白 代数 空白"
+    qsizetype pos = objKeyword;
+    if (pos == 0 || !isWhitespace(m_data[pos - 1])) {
+        return false;
+    }
+    while (pos > 0 && isWhitespace(m_data[pos - 1])) {
+        --pos;
+    }
+    const qsizetype generationBegin = digitsBefore(m_data, pos);
+    if (generationBegin <= 0 || !isWhitespace(m_data[generationBegin - 1])) {
+        return false;
+    }
+    pos = generationBegin;
+    while (pos > 0 && isWhitespace(m_data[pos - 1])) {
+        --pos;
+    }
+    const qsizetype numberBegin = digitsBefore(m_data, pos);
+    if (numberBegin < 0 || (numberBegin > 0 && isRegular(m_data[numberBegin - 1]))) {
+        return false;
+    }
+
+    object = Object();
+    object.number = m_data.sliced(numberBegin, pos - numberBegin).toInt();
+    object.generation = m_data.sliced(generationBegin, objKeyword - generationBegin).trimmed().toInt();
+    object.offset = numberBegin;
+    object.bodyBegin = bodyBegin;
+
+    const qsizetype endobj = indexOf(m_data, "endobj", bodyBegin);
+    // stream关键字只可能出现在本对象内，不带流的对象不必搜索到文件末尾
+    const QByteArrayView objectData = endobj >= 0 ? m_data.first(endobj) : m_data;
+    // 只有紧跟在对象字典">>"之后（允许空白）且以CRLF或LF结束的stream才是流关键字，
+    // 字典中的"(Upstream)"、"/Livestream"等不算
+    qsizetype streamKeyword = -1;
+    const qsizetype dictionaryBegin = skipWhitespace(objectData, bodyBegin);
+    if (objectData.sliced(dictionaryBegin).startsWith("<<")) {
+        const qsizetype keyword = skipWhitespace(objectData, skipValue(objectData, dictionaryBegin));
+        const QByteArrayView rest = m_data.sliced(keyword);
+        if (rest.startsWith("stream\n") || rest.startsWith("stream\r\n")) {
+            streamKeyword = keyword;
+        }
+    }
+
+    if (streamKeyword < 0) {
+        object.bodyEnd = endobj < 0 ? m_data.size() : endobj;
+        object.end = endobj < 0 ? m_data.size() : endobj + 6;
+        return true;
+    }
+
+    object.bodyEnd = streamKeyword;
+    qsizetype streamBegin = streamKeyword + 6;
+    if (streamBegin < m_data.size() && m_data[streamBegin] == '\r') {
+        ++streamBegin;
+    }
+    if (streamBegin < m_data.size() && m_data[streamBegin] == '\n') {
+        ++streamBegin;
+    }
+    object.streamBegin = streamBegin;
+
+    // 优先使用直接给出的Length，校验失败时再查找endstream
+    qsizetype streamEnd = -1;
+    const int length = integer(body(object), "Length");
+    if (length >= 0 && streamBegin + length <= m_data.size()) {
+        const qsizetype keyword = skipWhitespace(m_data, streamBegin + length);
+        if (m_data.sliced(keyword).startsWith("endstream")) {
+            streamEnd = streamBegin + length;
+        }
+    }
+    if (streamEnd < 0) {
+        const qsizetype keyword = indexOf(m_data, "endstream", streamBegin);
+        streamEnd = keyword < 0 ? m_data.size() : keyword;
+        if (streamEnd > streamBegin && m_data[streamEnd - 1] == '\n') {
+            --streamEnd;
+        }
+        if (streamEnd > streamBegin && m_data[streamEnd - 1] == '\r') {
+            --streamEnd;
+        }
+    }
+    object.streamEnd = streamEnd;
+
+    const qsizetype endstream = indexOf(m_data, "endstream", streamEnd);
+    const qsizetype afterStream = endstream < 0 ? m_data.size() : endstream + 9;
+    const qsizetype trailing = indexOf(m_data.first(qMin(m_data.size(), afterStream + MAX_TRAILING_BYTES)), "endobj", afterStream);
+    object.end = trailing < 0 ? afterStream : trailing + 6;
+    return true;
+}
+
+void PdfObjectScanner::buildIndex()
+{
+    m_index.clear();
+    qsizetype pos = 0;
+    Object object;
+    while (pos < m_data.size()) {
+        const qsizetype keyword = indexOf(m_data, "obj", pos);
+        if (keyword < 0) {
+            break;
+        }
+        if (parseObjectAt(keyword, object)) {
+            // 增量更新时后出现的定义覆盖前面的
+            m_index.insert(object.number, keyword);
+            pos = object.end;
+        } else {
+            pos = keyword + 3;
+        }
+    }
+    m_indexed = true;
+    qDebug() << "PdfObjectScanner: 索引了" << m_index.size() << "个对象";
+}
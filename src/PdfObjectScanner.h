@@ -0,0 +1,152 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 21:00:00
+ * @LastEditTime: 2026-10-18 21:00:00
+ * @LastEditors: seelights
+ * @Description: 字节级PDF对象扫描器
+ * @FilePath: \ReportMason\src\PdfObjectScanner.h
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+/**
+ * @brief 字节级PDF对象扫描器
+ *
+ * 旧的回退路径把整个PDF用QString::fromUtf8解码后再跑正则表达式，
+ * 既复制两份文件又把二进制数据交给UTF-8解码器（图片数据因此被破坏）。
+ * 本类在内存映射的文件上直接工作：用memchr定位关键字的首字节再比较，
+ * 找出"N G obj"/"stream"/"endstream"/"endobj"边界，字典键值按字节读取，不做任何解码。
+ * 只能看到文件顶层的对象，对象流（ObjStm）中的压缩对象需要走Poppler路径。
+ * 单个实例不是线程安全的。
+ */
+class PdfObjectScanner
+{
+public:
+    /**
+     * @brief 一个间接对象的字节范围（相对文件开头的偏移）
+     */
+    struct Object {
+        int number = 0;
+        int generation = 0;
+        qsizetype offset = -1;      ///< "N G obj"的起始位置
+        qsizetype bodyBegin = -1;   ///< "obj"之后
+        qsizetype bodyEnd = -1;     ///< 对象体结束（流对象为"stream"关键字处）
+        qsizetype streamBegin = -1; ///< 流数据起始，没有流时为-1
+        qsizetype streamEnd = -1;   ///< 流数据结束（不含行尾）
+        qsizetype end = -1;         ///< "endobj"之后
+
+        bool hasStream() const { return streamBegin >= 0; }
+    };
+
+    PdfObjectScanner();
+
+    /**
+     * @brief 扫描调用方持有的数据（不复制，数据须在扫描器使用期间有效）
+     */
+    explicit PdfObjectScanner(QByteArrayView data);
+
+    ~PdfObjectScanner();
+
+    PdfObjectScanner(const PdfObjectScanner&) = delete;
+    PdfObjectScanner& operator=(const PdfObjectScanner&) = delete;
+
+    /**
+     * @brief 以内存映射方式打开文件，映射失败时才读入内存
+     * @param filePath 文件路径
+     * @return 是否成功
+     */
+    bool open(const QString& filePath);
+
+    /**
+     * @brief 关闭文件并解除映射
+     */
+    void close();
+
+    bool isOpen() const;
+    QByteArrayView data() const;
+    QString lastError() const;
+
+    /**
+     * @brief 顺序读取下一个对象
+     * @param object 输出对象
+     * @return 没有更多对象时返回false
+     */
+    bool next(Object& object);
+
+    /**
+     * @brief 回到文件开头重新顺序扫描
+     */
+    void rewind();
+
+    /**
+     * @brief 按对象编号查找对象（首次调用时扫描全文件建立索引，同号对象取最后一次定义）
+     * @param number 对象编号
+     * @param object 输出对象
+     * @return 是否找到
+     */
+    bool findObject(int number, Object& object);
+
+    /**
+     * @brief 对象体（流对象为流字典）
+     */
+    QByteArrayView body(const Object& object) const;
+
+    /**
+     * @brief 原始流数据（未解码），没有流时为空
+     */
+    QByteArrayView stream(const Object& object) const;
+
+    /**
+     * @brief 收集所有未经过滤器编码的流数据（不影响顺序扫描位置）
+     * @return 各流数据的视图，按在文件中出现的顺序
+     */
+    QList<QByteArrayView> plainStreams() const;
+
+    /**
+     * @brief 读取字典顶层键的原始值
+     *
+     * 只匹配最外层字典中的键，跳过字符串和嵌套字典；
+     * 返回值为一个记号：名称（含/）、数组、字典、字符串、数字或"N G R"引用。
+     * @param dictionary 字典字节（可以带前导空白和<<>>）
+     * @param key 不带/的键名
+     * @return 没有该键时为空
+     */
+    static QByteArrayView value(QByteArrayView dictionary, QByteArrayView key);
+
+    /**
+     * @brief 读取名称值（去掉/），数组取第一个名称，例如/Filter [/FlateDecode]
+     */
+    static QByteArray name(QByteArrayView dictionary, QByteArrayView key);
+
+    /**
+     * @brief 读取整数值，不存在或不是直接整数时返回defaultValue
+     */
+    static int integer(QByteArrayView dictionary, QByteArrayView key, int defaultValue = -1);
+
+    /**
+     * @brief 查找子串（memchr定位首字节后memcmp比较）
+     * @return 位置，找不到时为-1
+     */
+    static qsizetype indexOf(QByteArrayView haystack, QByteArrayView needle, qsizetype from = 0);
+
+private:
+    bool parseObjectAt(qsizetype objKeyword, Object& object) const;
+    void buildIndex();
+
+    QFile m_file;
+    uchar* m_mapped;
+    QByteArray m_buffer; ///< 无法映射时的文件内容
+    QByteArrayView m_data;
+    qsizetype m_position;
+    bool m_indexed;
+    QHash<int, qsizetype> m_index; ///< 对象编号 -> "obj"关键字位置
+    QString m_lastError;
+};
@@ -0,0 +1,147 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 20:30:00
+ * @LastEditTime: 2026-10-18 20:30:00
+ * @LastEditors: seelights
+ * @Description: PDF快速探测实现
+ * @FilePath: \ReportMason\src\PdfProbe.cpp
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#include "PdfProbe.h"
+#include "PdfCoreDocument.h"
+#include "QtCompat.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFileInfo>
+
+#include <Catalog.h>
+#include <ErrorCodes.h>
+#include <Form.h>
+#include <PDFDoc.h>
+#include <Page.h>
+#include <UTF.h>
+#include <XRef.h>
+
+namespace {
+
+/// 探测的Info字典标准项
+const char* const INFO_KEYS[] = { "Title", "Author", "Subject", "Keywords", "Creator", "Producer", "CreationDate", "ModDate" };
+
+/**
+ * @brief 递归查找签名域（只访问表单字段树，不访问页面）
+ */
+bool containsSignature(const FormField* field)
+{
+    if (!field) {
+        return false;
+    }
+    if (field->getType() == formSignature) {
+        return true;
+    }
+    for (int i = 0; i < field->getNumChildren(); ++i) {
+        if (containsSignature(field->getChildren(i))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+PdfProbe::Result::Result()
+    : valid(false), fileSize(0), pageCount(0), linearized(false), encrypted(false), needsPassword(false),
+      tagged(false), hasForms(false), hasXfa(false), hasSignatures(false), hasText(false)
+{
+}
+
+PdfProbe::Result PdfProbe::probe(const QString& filePath)
+{
+    Result result;
+    QElapsedTimer timer;
+    timer.start();
+
+    const QFileInfo fileInfo(filePath);
+    if (!fileInfo.exists()) {
+        result.error = QS("PDF文件不存在: %1").arg(filePath);
+        return result;
+    }
+    result.fileSize = fileInfo.size();
+
+    // PDFDoc构造只读取文件头、trailer和交叉引用表，不解析页面
+    PdfCoreDocument coreDocument;
+    if (!coreDocument.open(filePath)) {
+        if (coreDocument.errorCode() == errEncrypted) {
+            result.encrypted = true;
+            result.needsPassword = true;
+            result.error = QS("PDF文件已加密，需要密码");
+        } else {
+            result.error = coreDocument.lastError();
+        }
+        return result;
+    }
+
+    try {
+        PDFDoc* doc = coreDocument.document();
+        Catalog* catalog = doc->getCatalog();
+
+        result.version = QS("%1.%2").arg(doc->getPDFMajorVersion()).arg(doc->getPDFMinorVersion());
+        result.linearized = doc->isLinearized();
+        result.encrypted = doc->isEncrypted();
+        // 线性化文件取线性化字典中的页数，否则取页面树根的Count
+        result.pageCount = doc->getNumPages();
+
+        for (const char* key : INFO_KEYS) {
+            const std::unique_ptr<GooString> value = doc->getDocInfoStringEntry(key);
+            if (value && !value->toStr().empty()) {
+                result.info.insert(QString::fromLatin1(key), QString::fromStdString(TextStringToUtf8(value->toStr())));
+            }
+        }
+
+        const std::unique_ptr<GooString> xmp = doc->readMetadata();
+        if (xmp) {
+            result.xmpMetadata = QString::fromStdString(xmp->toStr());
+        }
+
+        // 结构树可能很大，只检查Catalog中是否存在StructTreeRoot而不解析它
+        const Object catalogObject = doc->getXRef()->getCatalog();
+        result.tagged = (catalog->getMarkInfo() & Catalog::markInfoMarked) && catalogObject.isDict()
+            && catalogObject.getDict()->hasKey("StructTreeRoot");
+
+        const Catalog::FormType formType = catalog->getFormType();
+        result.hasXfa = formType == Catalog::XfaForm;
+        if (formType != Catalog::NoForm) {
+            const Form* form = catalog->getForm();
+            result.hasForms = form && form->getNumFields() > 0;
+            // SigFlags第1位表示文档至少含有一个签名
+            Object* acroForm = catalog->getAcroForm();
+            if (acroForm->isDict()) {
+                const Object sigFlags = acroForm->dictLookup("SigFlags");
+                result.hasSignatures = sigFlags.isInt() && (sigFlags.getInt() & 1);
+            }
+            for (int i = 0; form && !result.hasSignatures && i < form->getNumFields(); ++i) {
+                result.hasSignatures = containsSignature(form->getRootField(i));
+            }
+        }
+
+        if (result.pageCount > 0) {
+            // 线性化文件的首页通过提示表定位，非线性化文件只展开到首页的页面树
+            result.firstPageSize = coreDocument.pageSize(0);
+            Page* firstPage = doc->getPage(1);
+            Dict* resources = firstPage ? firstPage->getResourceDict() : nullptr;
+            if (resources) {
+                const Object fonts = resources->lookup("Font");
+                result.hasText = fonts.isDict() && fonts.dictGetLength() > 0;
+            }
+        }
+
+        result.valid = true;
+    } catch (const std::exception& e) {
+        result.error = QS("探测PDF文档时发生异常: %1").arg(QString::fromUtf8(e.what()));
+        qDebug() << "PdfProbe:" << result.error;
+    }
+
+    qDebug() << "PdfProbe:" << filePath << "pages" << result.pageCount << "linearized" << result.linearized
+             << "forms" << result.hasForms << "in" << timer.elapsed() << "ms";
+    return result;
+}
@@ -0,0 +1,60 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 20:30:00
+ * @LastEditTime: 2026-10-18 20:30:00
+ * @LastEditors: seelights
+ * @Description: PDF快速探测：不加载页面即可获得路由所需的文档信息
+ * @FilePath: \ReportMason\src\PdfProbe.h
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <QMap>
+#include <QSizeF>
+#include <QString>
+
+/**
+ * @brief PDF快速探测
+ *
+ * 路由上传文件前需要页数、Info/XMP元数据、加密、签名以及是否含表单或文本等信息。
+ * 完整加载文档（Poppler::Document）或整文件扫描的开销随文件大小增长，
+ * 本类只读取文件头、trailer、交叉引用表以及Catalog/Info/AcroForm对象：
+ * 线性化文件的页数和首页取自线性化字典和提示表（Linearization/Hints），
+ * 非线性化文件的页数取自页面树根的Count。
+ * 是否含文本只检查首页资源中是否有字体，不解析任何内容流。
+ */
+class PdfProbe
+{
+public:
+    /**
+     * @brief 探测结果
+     */
+    struct Result {
+        bool valid;              ///< 文件可以解析（加密且需要密码时为false）
+        QString error;           ///< 无法解析时的错误信息
+        qint64 fileSize;         ///< 文件大小（字节）
+        QString version;         ///< PDF版本，例如"1.7"
+        int pageCount;           ///< 页数
+        QSizeF firstPageSize;    ///< 首页显示尺寸（点），已考虑旋转
+        bool linearized;         ///< 是否为线性化（快速Web查看）文件
+        bool encrypted;          ///< 是否加密
+        bool needsPassword;      ///< 是否需要用户密码才能打开
+        bool tagged;             ///< 是否为带标签的PDF
+        bool hasForms;           ///< 是否包含AcroForm字段
+        bool hasXfa;             ///< 是否包含XFA表单
+        bool hasSignatures;      ///< 是否包含签名域
+        bool hasText;            ///< 首页是否引用了字体
+        QMap<QString, QString> info; ///< Info字典中的标准字符串项（Title、Author等）
+        QString xmpMetadata;     ///< Catalog中的XMP元数据包，没有时为空
+
+        Result();
+    };
+
+    /**
+     * @brief 探测PDF文件
+     * @param filePath 文件路径
+     * @return 探测结果，失败时valid为false并给出error
+     */
+    static Result probe(const QString& filePath);
+};
@@ -0,0 +1,297 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 16:30:00
+ * @LastEditTime: 2026-10-18 16:30:00
+ * @LastEditors: seelights
+ * @Description: 基于绘制操作边界框的PDF图片/图表区域检测器实现
+ * @FilePath: \ReportMason\src\PdfRegionDetector.cpp
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#include "PdfRegionDetector.h"
+#include "ProcessingDeadline.h"
+#include <QDebug>
+#include <QMap>
+#include <algorithm>
+#include <numeric>
+
+#include <DrawingRegionOutputDev.h>
+#include <PDFDoc.h>
+
+namespace {
+
+int findRoot(QList<int>& parents, int index)
+{
+    while (parents.at(index) != index) {
+        parents[index] = parents.at(parents.at(index));
+        index = parents.at(index);
+    }
+    return index;
+}
+
+/**
+ * @brief 按间距将矩形分组
+ *
+ * 按左边界排序后扫描，只比较水平方向可能相邻的矩形，再用并查集合并。
+ * @return 每组矩形在输入中的下标
+ */
+QList<QList<int>> groupRects(const QList<QRectF>& rects, double gap)
+{
+    QList<int> order(rects.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [&rects](int a, int b) { return rects.at(a).left() < rects.at(b).left(); });
+
+    QList<int> parents(rects.size());
+    std::iota(parents.begin(), parents.end(), 0);
+    for (int i = 0; i < order.size(); ++i) {
+        const QRectF expanded = rects.at(order.at(i)).adjusted(-gap, -gap, gap, gap);
+        for (int j = i + 1; j < order.size(); ++j) {
+            const QRectF& other = rects.at(order.at(j));
+            if (other.left() > expanded.right()) {
+                break;
+            }
+            if (expanded.intersects(other)) {
+                parents[findRoot(parents, order.at(i))] = findRoot(parents, order.at(j));
+            }
+        }
+    }
+
+    QMap<int, QList<int>> groups;
+    for (int i = 0; i < rects.size(); ++i) {
+        groups[findRoot(parents, i)].append(i);
+    }
+    return groups.values();
+}
+
+/**
+ * @brief 计算一组矩形的并集
+ */
+QRectF unitedRect(const QList<QRectF>& rects, const QList<int>& indexes)
+{
+    QRectF result;
+    for (int index : indexes) {
+        result = result.isNull() ? rects.at(index) : result.united(rects.at(index));
+    }
+    return result;
+}
+
+/**
+ * @brief 计算矩形面积，退化矩形为0
+ */
+double rectArea(const QRectF& rect)
+{
+    return rect.isValid() ? rect.width() * rect.height() : 0.0;
+}
+
+/**
+ * @brief 把零宽/零高的矩形（细线、发丝线）扩成至少1点，QRectF的相交判断会忽略空矩形
+ */
+QRectF paddedRect(const QRectF& rect)
+{
+    QRectF result = rect.normalized();
+    if (result.width() < 1.0) {
+        const double pad = (1.0 - result.width()) / 2;
+        result.adjust(-pad, 0, pad, 0);
+    }
+    if (result.height() < 1.0) {
+        const double pad = (1.0 - result.height()) / 2;
+        result.adjust(0, -pad, 0, pad);
+    }
+    return result;
+}
+
+} // namespace
+
+QList<PdfRegionDetector::Region> PdfRegionDetector::detectRegions(PdfCoreDocument& document, int pageIndex,
+                                                                 PdfAnalysisRaster* raster)
+{
+    const QList<Primitive> primitives = collectPrimitives(document, pageIndex);
+    if (primitives.isEmpty()) {
+        return QList<Region>();
+    }
+
+    const QList<Region> regions = clusterPrimitives(primitives, document.pageSize(pageIndex));
+    if (!raster || regions.isEmpty()) {
+        return regions;
+    }
+    if (!raster->render(document, pageIndex)) {
+        qDebug() << "PdfRegionDetector: 分析光栅不可用" << raster->lastError();
+        return regions;
+    }
+    return refineRegions(regions, *raster);
+}
+
+QList<PdfRegionDetector::Primitive> PdfRegionDetector::collectPrimitives(PdfCoreDocument& document, int pageIndex)
+{
+    QList<Primitive> primitives;
+
+    PDFDoc* doc = document.document();
+    if (!doc || pageIndex < 0 || pageIndex >= doc->getNumPages()) {
+        return primitives;
+    }
+
+    try {
+        DrawingRegionOutputDev regionDev;
+        doc->displayPage(&regionDev, pageIndex + 1, 72.0, 72.0, 0, false, true, false, ProcessingDeadline::abortCheck, nullptr);
+
+        const std::vector<DrawingPrimitive> drawn = regionDev.takePrimitives();
+        primitives.reserve(static_cast<qsizetype>(drawn.size()));
+        for (const DrawingPrimitive& item : drawn) {
+            Primitive primitive;
+            switch (item.kind) {
+            case DrawingPrimitive::kindImage:
+                primitive.kind = Primitive::Kind::IMAGE;
+                break;
+            case DrawingPrimitive::kindPath:
+                primitive.kind = Primitive::Kind::PATH;
+                break;
+            case DrawingPrimitive::kindText:
+                primitive.kind = Primitive::Kind::TEXT;
+                break;
+            }
+            primitive.rect = QRectF(QPointF(item.x1, item.y1), QPointF(item.x2, item.y2));
+            primitive.filled = item.filled;
+            primitive.rectilinear = item.rectilinear;
+            primitive.colored = item.colored;
+            primitives.append(primitive);
+        }
+    } catch (const std::exception& e) {
+        qDebug() << "PdfRegionDetector: 收集绘制操作时发生异常" << pageIndex + 1 << e.what();
+        primitives.clear();
+    }
+    return primitives;
+}
+
+QList<PdfRegionDetector::Region> PdfRegionDetector::clusterPrimitives(const QList<Primitive>& primitives,
+                                                                    const QSizeF& pageSize)
+{
+    const double pageArea = pageSize.width() * pageSize.height();
+
+    QList<QRectF> imageRects;
+    QList<QRectF> graphicRects;   // 曲线、斜线、彩色填充：图表的主体
+    QList<QRectF> supportRects;   // 水平/竖直线条：坐标轴、网格线
+    QList<QRectF> textRects;
+    for (const Primitive& primitive : primitives) {
+        const QRectF rect = paddedRect(primitive.rect);
+        switch (primitive.kind) {
+        case Primitive::Kind::IMAGE:
+            imageRects.append(rect);
+            break;
+        case Primitive::Kind::TEXT:
+            textRects.append(rect);
+            break;
+        case Primitive::Kind::PATH:
+            // 整页背景和页面边框不参与聚类
+            if (pageArea > 0 && rectArea(rect) > BACKGROUND_COVERAGE * pageArea) {
+                break;
+            }
+            if (!primitive.rectilinear || (primitive.filled && primitive.colored)) {
+                graphicRects.append(rect);
+            } else {
+                supportRects.append(rect);
+            }
+            break;
+        }
+    }
+
+    // 1. 图表候选：邻近的图形路径聚成一组
+    QList<Region> charts;
+    for (const QList<int>& group : groupRects(graphicRects, CLUSTER_GAP)) {
+        const QRectF bounds = unitedRect(graphicRects, group);
+        if (group.size() < MIN_CHART_PATHS || bounds.width() < MIN_CHART_SIZE || bounds.height() < MIN_CHART_SIZE) {
+            continue;
+        }
+        charts.append(Region{RegionType::CHART, bounds, 0, static_cast<int>(group.size()), 0});
+    }
+
+    // 2. 吸收外扩范围内完整包含的坐标轴线和文字标签（只扩展一次，避免蔓延到整页）
+    for (Region& chart : charts) {
+        const QRectF reach = chart.boundingBox.adjusted(-LABEL_MARGIN, -LABEL_MARGIN, LABEL_MARGIN, LABEL_MARGIN);
+        QRectF grown = chart.boundingBox;
+        for (const QRectF& rect : supportRects) {
+            if (reach.contains(rect)) {
+                grown = grown.united(rect);
+                chart.pathCount++;
+            }
+        }
+        for (const QRectF& rect : textRects) {
+            if (reach.contains(rect)) {
+                grown = grown.united(rect);
+                chart.textCount++;
+            }
+        }
+        chart.boundingBox = grown;
+    }
+
+    // 扩展后相互重叠的图表合并
+    for (int i = 0; i < charts.size(); ++i) {
+        for (int j = i + 1; j < charts.size();) {
+            if (charts.at(i).boundingBox.intersects(charts.at(j).boundingBox)) {
+                charts[i].boundingBox = charts.at(i).boundingBox.united(charts.at(j).boundingBox);
+                charts[i].pathCount += charts.at(j).pathCount;
+                charts[i].textCount += charts.at(j).textCount;
+                charts.removeAt(j);
+                j = i + 1;
+            } else {
+                ++j;
+            }
+        }
+    }
+
+    // 3. 图片区域：相互重叠的图片绘制（分块图片、蒙版叠加）合并，位于图表内的归入图表
+    QList<Region> regions;
+    for (const QList<int>& group : groupRects(imageRects, 1.0)) {
+        const QRectF bounds = unitedRect(imageRects, group);
+        if (bounds.width() < MIN_IMAGE_SIZE || bounds.height() < MIN_IMAGE_SIZE) {
+            continue;
+        }
+
+        bool insideChart = false;
+        for (Region& chart : charts) {
+            if (rectArea(chart.boundingBox.intersected(bounds)) > 0.5 * rectArea(bounds)) {
+                chart.imageCount += static_cast<int>(group.size());
+                insideChart = true;
+                break;
+            }
+        }
+        if (!insideChart) {
+            regions.append(Region{RegionType::IMAGE, bounds, static_cast<int>(group.size()), 0, 0});
+        }
+    }
+    regions.append(charts);
+
+    std::sort(regions.begin(), regions.end(), [](const Region& a, const Region& b) {
+        if (!qFuzzyCompare(a.boundingBox.top() + 1, b.boundingBox.top() + 1)) {
+            return a.boundingBox.top() < b.boundingBox.top();
+        }
+        return a.boundingBox.left() < b.boundingBox.left();
+    });
+    return regions;
+}
+
+QList<PdfRegionDetector::Region> PdfRegionDetector::refineRegions(const QList<Region>& regions,
+                                                                 const PdfAnalysisRaster& raster)
+{
+    if (!raster.isValid()) {
+        return regions;
+    }
+
+    const double pixel = 72.0 / raster.dpi();
+    QList<Region> refined;
+    refined.reserve(regions.size());
+    for (const Region& region : regions) {
+        const QRectF ink = raster.inkBounds(region.boundingBox);
+        if (ink.isEmpty()) {
+            continue;
+        }
+
+        Region result = region;
+        if (region.type == RegionType::CHART) {
+            // 留出一个像素的余量，避免裁掉落在像素边界上的细线
+            result.boundingBox = ink.adjusted(-pixel, -pixel, pixel, pixel).intersected(region.boundingBox);
+        }
+        refined.append(result);
+    }
+    return refined;
+}
@@ -0,0 +1,104 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 16:30:00
+ * @LastEditTime: 2026-10-18 16:30:00
+ * @LastEditors: seelights
+ * @Description: 基于绘制操作边界框的PDF图片/图表区域检测器
+ * @FilePath: \ReportMason\src\PdfRegionDetector.h
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#pragma once
+
+#include "PdfCoreDocument.h"
+#include "PdfAnalysisRaster.h"
+#include <QList>
+#include <QRectF>
+#include <QSizeF>
+
+/**
+ * @brief 基于绘制操作边界框的PDF图片/图表区域检测器
+ *
+ * 用DrawingRegionOutputDev执行一次内容流（不光栅化），分别收集图片绘制、
+ * 矢量路径和文本行的设备空间边界框：相互重叠的图片合并为图片区域；
+ * 曲线、斜线和彩色填充按邻近关系聚类为图表候选，再吸收框内的坐标轴线和文字标签。
+ * 纯水平/竖直的黑白线条（表格线、分隔线）不会单独形成图表。
+ * 提供分析光栅时，只对有候选区域的页面做一次8位灰度渲染，
+ * 去掉没有着墨的区域（白色占位图、不可见对象）并把图表收紧到实际着墨范围。
+ */
+class PdfRegionDetector
+{
+public:
+    /**
+     * @brief 区域类型
+     */
+    enum class RegionType {
+        IMAGE, ///< 嵌入的位图
+        CHART  ///< 矢量图形
+    };
+
+    /**
+     * @brief 单个绘制操作（坐标单位为点，原点在页面左上角）
+     */
+    struct Primitive {
+        enum class Kind { IMAGE, PATH, TEXT };
+
+        Kind kind;
+        QRectF rect;
+        bool filled;      ///< 路径：填充或渐变，而不是描边
+        bool rectilinear; ///< 路径：只包含水平/竖直直线段
+        bool colored;     ///< 路径：颜色不是灰度
+    };
+
+    /**
+     * @brief 检测到的区域
+     */
+    struct Region {
+        RegionType type;
+        QRectF boundingBox; ///< 坐标单位为点，原点在页面左上角
+        int imageCount;     ///< 区域内的图片绘制数量
+        int pathCount;      ///< 区域内的路径数量
+        int textCount;      ///< 区域内的文本行数量
+    };
+
+    /**
+     * @brief 检测页面上的图片和图表区域
+     * @param document 已打开的核心文档
+     * @param pageIndex 从0开始的页码
+     * @param raster 分析光栅，为nullptr时不做着墨校验
+     * @return 按从上到下、从左到右排列的区域列表
+     */
+    static QList<Region> detectRegions(PdfCoreDocument& document, int pageIndex,
+                                       PdfAnalysisRaster* raster = nullptr);
+
+    /**
+     * @brief 执行内容流并收集绘制操作
+     * @param document 已打开的核心文档
+     * @param pageIndex 从0开始的页码
+     * @return 绘制操作列表
+     */
+    static QList<Primitive> collectPrimitives(PdfCoreDocument& document, int pageIndex);
+
+    /**
+     * @brief 将绘制操作聚类为区域
+     * @param primitives 绘制操作列表
+     * @param pageSize 页面尺寸，用于识别整页背景
+     * @return 按从上到下、从左到右排列的区域列表
+     */
+    static QList<Region> clusterPrimitives(const QList<Primitive>& primitives, const QSizeF& pageSize);
+
+    /**
+     * @brief 用灰度光栅校验区域：去掉没有着墨的区域，图表收紧到着墨边界
+     * @param regions 区域列表
+     * @param raster 已渲染同一页面的分析光栅
+     * @return 校验后的区域列表
+     */
+    static QList<Region> refineRegions(const QList<Region>& regions, const PdfAnalysisRaster& raster);
+
+    static constexpr double MIN_IMAGE_SIZE = 16.0;        ///< 图片区域最小边长（点）
+    static constexpr double MIN_CHART_SIZE = 40.0;        ///< 图表区域最小边长（点）
+    static constexpr int MIN_CHART_PATHS = 4;             ///< 图表候选最少的图形路径数
+    static constexpr double CLUSTER_GAP = 8.0;            ///< 聚类时路径间的最大间距（点）
+    static constexpr double LABEL_MARGIN = 12.0;          ///< 吸收坐标轴和标签的外扩距离（点）
+    static constexpr double BACKGROUND_COVERAGE = 0.8;    ///< 覆盖页面面积超过该比例的路径视为背景
+};
@@ -0,0 +1,139 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 17:10:00
+ * @LastEditTime: 2026-10-18 17:10:00
+ * @LastEditors: seelights
+ * @Description: PDF页面局部区域的高分辨率分块渲染实现
+ * @FilePath: \ReportMason\src\PdfRegionRenderer.cpp
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#include "PdfRegionRenderer.h"
+#include "ProcessingDeadline.h"
+#include <QBuffer>
+#include <QDebug>
+#include <QtMath>
+#include <cstring>
+
+#include <poppler-qt6.h>
+
+namespace {
+
+/**
+ * @brief 渲染一块区域，内容流解释期间检查当前线程的处理截止时间
+ */
+QImage renderTile(Poppler::Page* page, double dpi, int x, int y, int width, int height)
+{
+    return page->renderToImage(dpi, dpi, x, y, width, height, Poppler::Page::Rotate0, nullptr, nullptr,
+                               ProcessingDeadline::shouldAbort, QVariant());
+}
+
+} // namespace
+
+double PdfRegionRenderer::effectiveDpi(const QRectF& region, const Options& options)
+{
+    const double dpi = options.dpi > 0 ? options.dpi : DEFAULT_DPI;
+    const double area = region.width() * region.height();
+    if (area <= 0 || options.maxPixels <= 0) {
+        return dpi;
+    }
+
+    // 像素数与分辨率的平方成正比
+    const double scale = dpi / 72.0;
+    const double pixels = area * scale * scale;
+    if (pixels <= static_cast<double>(options.maxPixels)) {
+        return dpi;
+    }
+    return dpi * qSqrt(static_cast<double>(options.maxPixels) / pixels);
+}
+
+QImage PdfRegionRenderer::renderRegion(Poppler::Page* page, const QRectF& region, const Options& options)
+{
+    if (!page || region.width() <= 0 || region.height() <= 0) {
+        return QImage();
+    }
+
+    const double dpi = effectiveDpi(region, options);
+    const double scale = dpi / 72.0;
+
+    // 区域换算为目标分辨率下的像素矩形，并限制在页面范围内
+    const QSizeF pageSize = page->pageSizeF();
+    const int pageWidth = qCeil(pageSize.width() * scale);
+    const int pageHeight = qCeil(pageSize.height() * scale);
+    const int left = qBound(0, qFloor(region.left() * scale), pageWidth);
+    const int top = qBound(0, qFloor(region.top() * scale), pageHeight);
+    const int right = qBound(0, qCeil(region.right() * scale), pageWidth);
+    const int bottom = qBound(0, qCeil(region.bottom() * scale), pageHeight);
+    const int width = right - left;
+    const int height = bottom - top;
+    if (width <= 0 || height <= 0) {
+        return QImage();
+    }
+
+    const int tileSize = options.tileSize > 0 ? options.tileSize : DEFAULT_TILE_SIZE;
+    if (width <= tileSize && height <= tileSize) {
+        QImage image = renderTile(page, dpi, left, top, width, height);
+        if (!image.isNull()) {
+            image.setDotsPerMeterX(qRound(dpi / 0.0254));
+            image.setDotsPerMeterY(qRound(dpi / 0.0254));
+        }
+        return image;
+    }
+
+    // 大区域分块渲染，逐行拷贝到结果图像
+    QImage result;
+    for (int tileTop = 0; tileTop < height; tileTop += tileSize) {
+        const int tileHeight = qMin(tileSize, height - tileTop);
+        for (int tileLeft = 0; tileLeft < width; tileLeft += tileSize) {
+            const int tileWidth = qMin(tileSize, width - tileLeft);
+            if (ProcessingDeadline::currentExpired()) {
+                qDebug() << "PdfRegionRenderer: 超过处理时限，停止分块渲染";
+                return QImage();
+            }
+            QImage tile = renderTile(page, dpi, left + tileLeft, top + tileTop, tileWidth, tileHeight);
+            if (tile.isNull()) {
+                qDebug() << "PdfRegionRenderer: 分块渲染失败" << tileLeft << tileTop << tileWidth << tileHeight;
+                return QImage();
+            }
+
+            if (result.isNull()) {
+                const QImage::Format format = tile.depth() == 32 ? tile.format() : QImage::Format_ARGB32;
+                result = QImage(width, height, format);
+                if (result.isNull()) {
+                    qDebug() << "PdfRegionRenderer: 无法分配图像" << width << "x" << height;
+                    return QImage();
+                }
+                result.setDotsPerMeterX(qRound(dpi / 0.0254));
+                result.setDotsPerMeterY(qRound(dpi / 0.0254));
+            }
+            if (tile.format() != result.format()) {
+                tile = tile.convertToFormat(result.format());
+            }
+
+            const int rows = qMin(tile.height(), tileHeight);
+            const size_t rowBytes = static_cast<size_t>(qMin(tile.width(), tileWidth)) * 4;
+            for (int row = 0; row < rows; ++row) {
+                std::memcpy(result.scanLine(tileTop + row) + static_cast<size_t>(tileLeft) * 4,
+                            tile.constScanLine(row), rowBytes);
+            }
+        }
+    }
+    return result;
+}
+
+QByteArray PdfRegionRenderer::renderRegionToPng(Poppler::Page* page, const QRectF& region, const Options& options)
+{
+    QByteArray pngData;
+
+    const QImage image = renderRegion(page, region, options);
+    if (image.isNull()) {
+        return pngData;
+    }
+
+    QBuffer buffer(&pngData);
+    buffer.open(QIODevice::WriteOnly);
+    if (!image.save(&buffer, "PNG")) {
+        pngData.clear();
+    }
+    return pngData;
+}
@@ -0,0 +1,72 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 17:10:00
+ * @LastEditTime: 2026-10-18 17:10:00
+ * @LastEditors: seelights
+ * @Description: PDF页面局部区域的高分辨率分块渲染
+ * @FilePath: \ReportMason\src\PdfRegionRenderer.h
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QImage>
+#include <QRectF>
+
+// Poppler前向声明
+namespace Poppler {
+    class Page;
+}
+
+/**
+ * @brief PDF页面局部区域渲染器
+ *
+ * 通过renderToImage的x/y/w/h参数只光栅化目标区域，开销与区域面积成正比而不是页面面积。
+ * 区域超过单块尺寸时按块渲染后拼接，限制单次Splash位图的内存峰值；
+ * 总像素数超过上限时自动降低分辨率。
+ */
+class PdfRegionRenderer
+{
+public:
+    /**
+     * @brief 渲染参数
+     */
+    struct Options {
+        double dpi;       ///< 目标分辨率
+        int tileSize;     ///< 单块最大边长（像素）
+        qint64 maxPixels; ///< 输出图像的最大像素数
+
+        Options() : dpi(DEFAULT_DPI), tileSize(DEFAULT_TILE_SIZE), maxPixels(DEFAULT_MAX_PIXELS) {}
+    };
+
+    /**
+     * @brief 渲染页面区域
+     * @param page 页面
+     * @param region 区域（点，原点在页面左上角）
+     * @param options 渲染参数
+     * @return 区域图像，失败时为空图像
+     */
+    static QImage renderRegion(Poppler::Page* page, const QRectF& region, const Options& options = Options());
+
+    /**
+     * @brief 渲染页面区域并编码为PNG
+     * @param page 页面
+     * @param region 区域（点，原点在页面左上角）
+     * @param options 渲染参数
+     * @return PNG数据，失败时为空
+     */
+    static QByteArray renderRegionToPng(Poppler::Page* page, const QRectF& region, const Options& options = Options());
+
+    /**
+     * @brief 计算区域实际使用的分辨率（受像素数上限约束）
+     * @param region 区域（点）
+     * @param options 渲染参数
+     * @return 分辨率
+     */
+    static double effectiveDpi(const QRectF& region, const Options& options = Options());
+
+    static constexpr double DEFAULT_DPI = 300.0;
+    static constexpr int DEFAULT_TILE_SIZE = 2048;
+    static constexpr qint64 DEFAULT_MAX_PIXELS = 40 * 1000 * 1000;
+};
@@ -0,0 +1,318 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 21:30:00
+ * @LastEditTime: 2026-10-18 21:30:00
+ * @LastEditors: seelights
+ * @Description: 数字签名的快速发现与延迟、缓存验证实现
+ * @FilePath: \ReportMason\src\PdfSignatureValidator.cpp
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#include "PdfSignatureValidator.h"
+#include "PdfCoreDocument.h"
+#include "QtCompat.h"
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutexLocker>
+#include <QPromise>
+#include <memory>
+#include <vector>
+
+#include <Catalog.h>
+#include <Form.h>
+#include <PDFDoc.h>
+#include <SignatureInfo.h>
+#include <UTF.h>
+
+namespace {
+
+/// 计算字节范围摘要时每次读取的块大小
+constexpr qint64 HASH_CHUNK_SIZE = 1024 * 1024;
+
+/**
+ * @brief 递归收集字段树中的签名域
+ */
+void collectSignatureFields(FormField* field, std::vector<FormFieldSignature*>& fields)
+{
+    if (!field) {
+        return;
+    }
+    if (field->getType() == formSignature) {
+        fields.push_back(static_cast<FormFieldSignature*>(field));
+    }
+    for (int i = 0; i < field->getNumChildren(); ++i) {
+        collectSignatureFields(field->getChildren(i), fields);
+    }
+}
+
+/**
+ * @brief 查找签名域，优先只访问字段树
+ */
+std::vector<FormFieldSignature*> findSignatureFields(PDFDoc* doc)
+{
+    std::vector<FormFieldSignature*> fields;
+    Catalog* catalog = doc->getCatalog();
+    if (catalog->getFormType() == Catalog::NoForm) {
+        return fields;
+    }
+
+    const Form* form = catalog->getForm();
+    for (int i = 0; form && i < form->getNumFields(); ++i) {
+        collectSignatureFields(form->getRootField(i), fields);
+    }
+    if (!fields.empty()) {
+        return fields;
+    }
+
+    // 字段树中没有签名但SigFlags声明有签名，签名控件只存在于页面注释中，需要加载页面
+    Object* acroForm = catalog->getAcroForm();
+    if (acroForm->isDict()) {
+        const Object sigFlags = acroForm->dictLookup("SigFlags");
+        if (sigFlags.isInt() && (sigFlags.getInt() & 1)) {
+            fields = doc->getSignatureFields();
+        }
+    }
+    return fields;
+}
+
+QString fieldName(FormFieldSignature* field)
+{
+    const GooString* name = field->getFullyQualifiedName();
+    return name ? QString::fromStdString(TextStringToUtf8(name->toStr())) : QString();
+}
+
+QList<qint64> byteRangeOf(FormFieldSignature* field)
+{
+    QList<qint64> byteRange;
+    const Object* array = field->getByteRange();
+    if (!array->isArray()) {
+        return byteRange;
+    }
+    for (int i = 0; i < array->arrayGetLength(); ++i) {
+        const Object item = array->arrayGet(i);
+        if (!item.isIntOrInt64()) {
+            return QList<qint64>();
+        }
+        byteRange.append(item.getIntOrInt64());
+    }
+    return byteRange;
+}
+
+/**
+ * @brief 计算签名覆盖的字节范围的SHA-256
+ * @return 范围无效或读取失败时为空
+ */
+QByteArray hashSignedRanges(QFile& file, const QList<qint64>& byteRange)
+{
+    if (byteRange.size() < 2 || byteRange.size() % 2 != 0) {
+        return QByteArray();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    for (int i = 0; i + 1 < byteRange.size(); i += 2) {
+        const qint64 offset = byteRange.at(i);
+        qint64 remaining = byteRange.at(i + 1);
+        if (offset < 0 || remaining < 0 || offset + remaining > file.size() || !file.seek(offset)) {
+            return QByteArray();
+        }
+        while (remaining > 0) {
+            const QByteArray chunk = file.read(qMin(remaining, HASH_CHUNK_SIZE));
+            if (chunk.isEmpty()) {
+                return QByteArray();
+            }
+            hash.addData(chunk);
+            remaining -= chunk.size();
+        }
+    }
+    return hash.result();
+}
+
+QString signatureStatusName(SignatureValidationStatus status)
+{
+    switch (status) {
+    case SIGNATURE_VALID:
+        return QS("valid");
+    case SIGNATURE_INVALID:
+        return QS("invalid");
+    case SIGNATURE_DIGEST_MISMATCH:
+        return QS("digest_mismatch");
+    case SIGNATURE_DECODING_ERROR:
+        return QS("decoding_error");
+    case SIGNATURE_GENERIC_ERROR:
+        return QS("generic_error");
+    case SIGNATURE_NOT_FOUND:
+        return QS("not_found");
+    case SIGNATURE_NOT_VERIFIED:
+        return QS("not_verified");
+    }
+    return QString();
+}
+
+QString certificateStatusName(CertificateValidationStatus status)
+{
+    switch (status) {
+    case CERTIFICATE_TRUSTED:
+        return QS("trusted");
+    case CERTIFICATE_UNTRUSTED_ISSUER:
+        return QS("untrusted_issuer");
+    case CERTIFICATE_UNKNOWN_ISSUER:
+        return QS("unknown_issuer");
+    case CERTIFICATE_REVOKED:
+        return QS("revoked");
+    case CERTIFICATE_EXPIRED:
+        return QS("expired");
+    case CERTIFICATE_GENERIC_ERROR:
+        return QS("generic_error");
+    case CERTIFICATE_NOT_VERIFIED:
+        return QS("not_verified");
+    }
+    return QString();
+}
+
+} // namespace
+
+PdfSignatureValidator* PdfSignatureValidator::instance()
+{
+    // 函数内静态变量的初始化是线程安全的
+    static PdfSignatureValidator validator;
+    return &validator;
+}
+
+PdfSignatureValidator::PdfSignatureValidator()
+{
+    // 验证是离线的，但要重新解析整份文件并对签名范围做哈希和验签，属于CPU密集型任务；
+    // 它与页面处理并行执行，限制为两个线程，避免与版面提取争抢CPU
+    m_pool.setMaxThreadCount(2);
+}
+
+QList<PdfSignatureValidator::Signature> PdfSignatureValidator::discover(PdfCoreDocument& document)
+{
+    QList<Signature> signatures;
+    if (!document.isOpen()) {
+        return signatures;
+    }
+
+    try {
+        for (FormFieldSignature* field : findSignatureFields(document.document())) {
+            Signature signature;
+            signature.fieldName = fieldName(field);
+            signature.byteRange = byteRangeOf(field);
+            const GooString* contents = field->getSignature();
+            signature.signatureSize = contents ? contents->getLength() : 0;
+            signatures.append(signature);
+        }
+    } catch (const std::exception& e) {
+        qDebug() << "PdfSignatureValidator: 查找签名时发生异常" << e.what();
+    }
+
+    if (!signatures.isEmpty()) {
+        qDebug() << "PdfSignatureValidator: 发现" << signatures.size() << "个签名域";
+    }
+    return signatures;
+}
+
+QFuture<QList<PdfSignatureValidator::Validation>> PdfSignatureValidator::validateAsync(const QString& filePath)
+{
+    // QThreadPool::start要求可复制的任务，QPromise只能移动，因此用共享指针持有
+    auto promise = std::make_shared<QPromise<QList<Validation>>>();
+    QFuture<QList<Validation>> future = promise->future();
+    promise->start();
+
+    m_pool.start([this, promise, filePath]() {
+        promise->addResult(validateFile(filePath));
+        promise->finish();
+    });
+    return future;
+}
+
+void PdfSignatureValidator::clearCache()
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.clear();
+}
+
+int PdfSignatureValidator::cacheSize() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.size();
+}
+
+QList<PdfSignatureValidator::Validation> PdfSignatureValidator::validateFile(const QString& filePath)
+{
+    QList<Validation> results;
+    QElapsedTimer timer;
+    timer.start();
+
+    // 后台任务使用自己的PDFDoc，PDFDoc不能跨线程共享
+    PdfCoreDocument document;
+    QFile file(filePath);
+    if (!document.open(filePath) || !file.open(QIODevice::ReadOnly)) {
+        qDebug() << "PdfSignatureValidator: 无法打开文档" << filePath << document.lastError();
+        return results;
+    }
+
+    int cacheHits = 0;
+    try {
+        for (FormFieldSignature* field : findSignatureFields(document.document())) {
+            Validation validation;
+            validation.fieldName = fieldName(field);
+
+            const GooString* contents = field->getSignature();
+            if (!contents || contents->getLength() == 0) {
+                validation.signatureStatus = QS("unsigned");
+                validation.certificateStatus = certificateStatusName(CERTIFICATE_NOT_VERIFIED);
+                results.append(validation);
+                continue;
+            }
+
+            // 缓存键：签名字节范围的摘要 + 整个Contents的摘要。Contents是包含签名值和证书的CMS数据，
+            // 被签内容相同而签名值被篡改或换了证书时都不会命中
+            const QByteArray rangeHash = hashSignedRanges(file, byteRangeOf(field));
+            const QByteArray key = rangeHash.isEmpty()
+                ? QByteArray()
+                : rangeHash + QCryptographicHash::hash(QByteArrayView(contents->c_str(), contents->getLength()),
+                                                       QCryptographicHash::Sha256);
+            if (!key.isEmpty()) {
+                QMutexLocker locker(&m_mutex);
+                const auto cached = m_cache.constFind(key);
+                if (cached != m_cache.constEnd()) {
+                    validation = cached.value();
+                    validation.fieldName = fieldName(field);
+                    validation.fromCache = true;
+                    results.append(validation);
+                    ++cacheHits;
+                    continue;
+                }
+            }
+
+            // 离线验证：不访问OCSP和AIA，结果只取决于文件内容和本地证书库，可以安全缓存
+            const SignatureInfo* info = field->validateSignatureAsync(true, false, -1, false, false, {});
+            const SignatureValidationStatus signatureStatus = info->getSignatureValStatus();
+            validation.signatureStatus = signatureStatusName(signatureStatus);
+            // 只有签名有效时才会启动证书验证，否则等待结果会一直阻塞
+            validation.certificateStatus = certificateStatusName(
+                signatureStatus == SIGNATURE_VALID ? field->validateSignatureResult() : CERTIFICATE_NOT_VERIFIED);
+            validation.signerName = QString::fromStdString(info->getSignerName());
+            if (info->getSigningTime() > 0) {
+                validation.signingTime = QDateTime::fromSecsSinceEpoch(info->getSigningTime());
+            }
+            results.append(validation);
+
+            if (!key.isEmpty()) {
+                QMutexLocker locker(&m_mutex);
+                if (m_cache.size() >= MAX_CACHE_ENTRIES) {
+                    m_cache.clear();
+                }
+                m_cache.insert(key, validation);
+            }
+        }
+    } catch (const std::exception& e) {
+        qDebug() << "PdfSignatureValidator: 验证签名时发生异常" << e.what();
+    }
+
+    qDebug() << "PdfSignatureValidator: 验证了" << results.size() << "个签名域，缓存命中" << cacheHits
+             << "，耗时" << timer.elapsed() << "ms";
+    return results;
+}
@@ -0,0 +1,102 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 21:30:00
+ * @LastEditTime: 2026-10-18 21:30:00
+ * @LastEditors: seelights
+ * @Description: 数字签名的快速发现与延迟、缓存验证
+ * @FilePath: \ReportMason\src\PdfSignatureValidator.h
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QFuture>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QThreadPool>
+
+class PdfCoreDocument;
+
+/**
+ * @brief PDF数字签名验证器
+ *
+ * 签名发现只遍历AcroForm字段树并读取ByteRange和Contents，不做任何密码学运算，
+ * 可以在解析流程中同步调用。完整验证（NSS/GPGME后端的摘要与证书链检查）
+ * 与版面提取无关且可能很慢，由validateAsync在独立线程池中执行。
+ * 验证结果按(签名字节范围的SHA-256, 整个Contents的SHA-256)缓存，
+ * 重复处理同一份已签名模板时不会再次验证。
+ */
+class PdfSignatureValidator
+{
+public:
+    /**
+     * @brief 发现阶段得到的签名信息
+     */
+    struct Signature {
+        QString fieldName;         ///< 签名域的完全限定名
+        QList<qint64> byteRange;   ///< ByteRange中的(偏移, 长度)对
+        qint64 signatureSize = 0;  ///< Contents中签名数据的字节数，未签名时为0
+    };
+
+    /**
+     * @brief 验证结果
+     */
+    struct Validation {
+        QString fieldName;         ///< 签名域的完全限定名
+        QString signatureStatus;   ///< 签名状态，例如"valid"、"digest_mismatch"
+        QString certificateStatus; ///< 证书状态，例如"trusted"、"unknown_issuer"
+        QString signerName;        ///< 签名者
+        QDateTime signingTime;     ///< 签名时间
+        bool fromCache = false;    ///< 结果是否来自缓存
+    };
+
+    /**
+     * @brief 获取单例实例
+     * @return 验证器实例
+     */
+    static PdfSignatureValidator* instance();
+
+    /**
+     * @brief 发现文档中的签名域（不验证）
+     *
+     * 只访问表单字段树；字段树中没有签名但SigFlags声明有签名时，
+     * 才回退到逐页查找只存在于页面注释中的签名控件。
+     * @param document 已打开的核心文档
+     * @return 签名列表
+     */
+    static QList<Signature> discover(PdfCoreDocument& document);
+
+    /**
+     * @brief 在后台验证文件中的所有签名
+     *
+     * 后台任务自行打开文档，不与调用方共享PDFDoc。
+     * @param filePath PDF文件路径
+     * @return 按发现顺序排列的验证结果
+     */
+    QFuture<QList<Validation>> validateAsync(const QString& filePath);
+
+    /**
+     * @brief 清空验证结果缓存
+     */
+    void clearCache();
+
+    /**
+     * @brief 缓存的验证结果数
+     */
+    int cacheSize() const;
+
+private:
+    PdfSignatureValidator();
+
+    QList<Validation> validateFile(const QString& filePath);
+
+    mutable QMutex m_mutex;
+    QHash<QByteArray, Validation> m_cache; ///< 缓存键 -> 验证结果
+    QThreadPool m_pool;                    ///< 验证任务专用线程池，不占用全局线程池
+
+    static constexpr int MAX_CACHE_ENTRIES = 1024;
+};
@@ -0,0 +1,497 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 19:30:00
+ * @LastEditTime: 2026-10-18 19:30:00
+ * @LastEditors: seelights
+ * @Description: 基于结构树的带标签PDF内容提取器实现
+ * @FilePath: \ReportMason\src\PdfStructureExtractor.cpp
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#include "PdfStructureExtractor.h"
+#include "ProcessingDeadline.h"
+#include "QtCompat.h"
+#include <QDebug>
+#include <QStringList>
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+#include <Catalog.h>
+#include <MarkedContentCollectorOutputDev.h>
+#include <PDFDoc.h>
+#include <StructElement.h>
+#include <StructTreeRoot.h>
+#include <UTF.h>
+
+namespace {
+
+/// 单元格跨度上限，防止损坏的属性值撑爆占用网格
+const int MAX_SPAN = 1000;
+
+/**
+ * @brief 注释显示回调：标记内容只出现在页面内容流中，跳过所有注释
+ */
+bool skipAnnotations(Annot* /*annot*/, void* /*userData*/)
+{
+    return false;
+}
+
+/**
+ * @brief PDF文本字符串（PDFDocEncoding或UTF-16BE）转换为QString
+ */
+QString textString(const GooString* value)
+{
+    if (!value) {
+        return QString();
+    }
+    return QString::fromStdString(TextStringToUtf8(value->toStr())).trimmed();
+}
+
+/**
+ * @brief 文本和边界框的汇总目标（元素或单元格）
+ */
+struct Slot {
+    QString text;
+    QRectF boundingBox;
+    int pageIndex = -1;
+    bool fixedText = false; ///< 已有ActualText，只收集边界框
+};
+
+/**
+ * @brief 指向某页某内容流中一个MCID的引用
+ */
+struct ContentRef {
+    int pageIndex;
+    Ref stmRef;
+    int mcid;
+    int slot;
+};
+
+/**
+ * @brief 结构树遍历器：生成元素并登记待解析的内容引用
+ */
+class StructureWalker
+{
+public:
+    StructureWalker(PDFDoc* doc, qint64 pageBudgetMs) : m_doc(doc), m_pageBudgetMs(pageBudgetMs) {}
+
+    void visit(const StructElement* element);
+    void resolve(QList<PdfStructureExtractor::PageTimeout>* timeouts);
+    QList<PdfStructureExtractor::Element> takeElements();
+
+private:
+    void addBlock(const StructElement* element, PdfStructureExtractor::ElementKind kind, int headingLevel = 0);
+    void addTable(const StructElement* table);
+    void collectRows(const StructElement* element, QList<const StructElement*>& rows);
+    int newSlot(const StructElement* element);
+    void collectContent(const StructElement* element, int slot);
+
+    PDFDoc* m_doc;
+    qint64 m_pageBudgetMs;
+    QList<PdfStructureExtractor::Element> m_elements;
+    QList<int> m_elementSlots;       ///< 每个元素对应的汇总目标
+    QList<QList<int>> m_cellSlots;   ///< 每个元素的单元格对应的汇总目标
+    std::vector<Slot> m_slots;
+    std::vector<ContentRef> m_refs;
+};
+
+void StructureWalker::visit(const StructElement* element)
+{
+    if (!element || element->isContent()) {
+        return;
+    }
+
+    using ElementKind = PdfStructureExtractor::ElementKind;
+    switch (element->getType()) {
+    case StructElement::Document:
+    case StructElement::Part:
+    case StructElement::Art:
+    case StructElement::Sect:
+    case StructElement::Div:
+    case StructElement::NonStruct:
+    case StructElement::Private:
+    case StructElement::L:
+    case StructElement::TOC:
+    case StructElement::Index:
+        // 分组元素只决定顺序，本身不产生内容
+        for (unsigned i = 0; i < element->getNumChildren(); ++i) {
+            visit(element->getChild(i));
+        }
+        return;
+    case StructElement::Unknown:
+        // 没有映射到标准类型的自定义元素：含有子结构时按分组处理
+        for (unsigned i = 0; i < element->getNumChildren(); ++i) {
+            const StructElement* child = element->getChild(i);
+            if (child && !child->isContent()) {
+                for (unsigned j = 0; j < element->getNumChildren(); ++j) {
+                    visit(element->getChild(j));
+                }
+                return;
+            }
+        }
+        addBlock(element, ElementKind::PARAGRAPH);
+        return;
+    case StructElement::H:
+        addBlock(element, ElementKind::HEADING, 0);
+        return;
+    case StructElement::H1:
+    case StructElement::H2:
+    case StructElement::H3:
+    case StructElement::H4:
+    case StructElement::H5:
+    case StructElement::H6:
+        addBlock(element, ElementKind::HEADING, element->getType() - StructElement::H1 + 1);
+        return;
+    case StructElement::Figure:
+    case StructElement::Formula:
+        addBlock(element, ElementKind::FIGURE);
+        return;
+    case StructElement::Table:
+        addTable(element);
+        return;
+    default:
+        // P、LI、Caption、BlockQuote等块级元素以及位于块级位置的行内元素
+        addBlock(element, ElementKind::PARAGRAPH);
+        return;
+    }
+}
+
+void StructureWalker::addBlock(const StructElement* element, PdfStructureExtractor::ElementKind kind, int headingLevel)
+{
+    PdfStructureExtractor::Element block;
+    block.kind = kind;
+    block.headingLevel = headingLevel;
+    block.altText = textString(element->getAltText());
+
+    m_elements.append(block);
+    m_elementSlots.append(newSlot(element));
+    m_cellSlots.append(QList<int>());
+}
+
+void StructureWalker::addTable(const StructElement* table)
+{
+    QList<const StructElement*> rows;
+    collectRows(table, rows);
+
+    PdfStructureExtractor::Element tableElement;
+    tableElement.kind = PdfStructureExtractor::ElementKind::TABLE;
+    tableElement.rowCount = static_cast<int>(rows.size());
+    tableElement.altText = textString(table->getAltText());
+
+    // 按行扫描，跳过被上方跨行单元格占用的位置
+    std::vector<std::vector<bool>> occupied(static_cast<size_t>(rows.size()));
+    QList<int> cellSlots;
+    for (int r = 0; r < rows.size(); ++r) {
+        const StructElement* row = rows.at(r);
+        int column = 0;
+        for (unsigned i = 0; i < row->getNumChildren(); ++i) {
+            const StructElement* cellElement = row->getChild(i);
+            if (!cellElement || (cellElement->getType() != StructElement::TH && cellElement->getType() != StructElement::TD)) {
+                continue;
+            }
+
+            std::vector<bool>& rowCells = occupied[static_cast<size_t>(r)];
+            while (column < static_cast<int>(rowCells.size()) && rowCells[static_cast<size_t>(column)]) {
+                ++column;
+            }
+
+            int rowSpan = 1;
+            int columnSpan = 1;
+            const Attribute* attribute = cellElement->findAttribute(Attribute::RowSpan, false, Attribute::Table);
+            if (attribute && attribute->getValue()->isInt()) {
+                rowSpan = std::clamp(attribute->getValue()->getInt(), 1, static_cast<int>(rows.size()) - r);
+            }
+            attribute = cellElement->findAttribute(Attribute::ColSpan, false, Attribute::Table);
+            if (attribute && attribute->getValue()->isInt()) {
+                columnSpan = std::clamp(attribute->getValue()->getInt(), 1, MAX_SPAN);
+            }
+
+            for (int rr = r; rr < r + rowSpan; ++rr) {
+                std::vector<bool>& spanned = occupied[static_cast<size_t>(rr)];
+                if (static_cast<int>(spanned.size()) < column + columnSpan) {
+                    spanned.resize(static_cast<size_t>(column + columnSpan), false);
+                }
+                std::fill(spanned.begin() + column, spanned.begin() + column + columnSpan, true);
+            }
+
+            PdfStructureExtractor::Cell cell;
+            cell.row = r;
+            cell.column = column;
+            cell.rowSpan = rowSpan;
+            cell.columnSpan = columnSpan;
+            cell.header = cellElement->getType() == StructElement::TH;
+            tableElement.cells.append(cell);
+            cellSlots.append(newSlot(cellElement));
+
+            tableElement.columnCount = std::max(tableElement.columnCount, column + columnSpan);
+            column += columnSpan;
+        }
+    }
+
+    m_elements.append(tableElement);
+    m_elementSlots.append(-1);
+    m_cellSlots.append(cellSlots);
+
+    // 表格标题作为独立段落紧随表格
+    for (unsigned i = 0; i < table->getNumChildren(); ++i) {
+        const StructElement* child = table->getChild(i);
+        if (child && child->getType() == StructElement::Caption) {
+            addBlock(child, PdfStructureExtractor::ElementKind::PARAGRAPH);
+        }
+    }
+}
+
+void StructureWalker::collectRows(const StructElement* element, QList<const StructElement*>& rows)
+{
+    for (unsigned i = 0; i < element->getNumChildren(); ++i) {
+        const StructElement* child = element->getChild(i);
+        if (!child || child->isContent()) {
+            continue;
+        }
+        if (child->getType() == StructElement::TR) {
+            rows.append(child);
+        } else if (child->getType() == StructElement::THead || child->getType() == StructElement::TBody
+                   || child->getType() == StructElement::TFoot) {
+            collectRows(child, rows);
+        }
+    }
+}
+
+int StructureWalker::newSlot(const StructElement* element)
+{
+    Slot slot;
+    const QString actualText = textString(element->getActualText());
+    if (!actualText.isEmpty()) {
+        slot.text = actualText;
+        slot.fixedText = true;
+    }
+    m_slots.push_back(slot);
+
+    const int index = static_cast<int>(m_slots.size()) - 1;
+    collectContent(element, index);
+    return index;
+}
+
+void StructureWalker::collectContent(const StructElement* element, int slot)
+{
+    if (element->isContent()) {
+        // OBJR指向注释或表单控件，不在内容流中
+        if (element->isObjectRef()) {
+            return;
+        }
+        Ref pageRef;
+        if (!element->getPageRef(pageRef)) {
+            return;
+        }
+        const int pageNumber = m_doc->findPage(pageRef);
+        if (pageNumber <= 0) {
+            return;
+        }
+        Ref stmRef;
+        if (!element->getStmRef(stmRef)) {
+            stmRef = Ref::INVALID();
+        }
+        m_refs.push_back(ContentRef { pageNumber - 1, stmRef, element->getMCID(), slot });
+        return;
+    }
+
+    for (unsigned i = 0; i < element->getNumChildren(); ++i) {
+        const StructElement* child = element->getChild(i);
+        if (child) {
+            collectContent(child, slot);
+        }
+    }
+}
+
+void StructureWalker::resolve(QList<PdfStructureExtractor::PageTimeout>* timeouts)
+{
+    // 按页归组，保持同一页内的结构顺序
+    std::stable_sort(m_refs.begin(), m_refs.end(),
+                     [](const ContentRef& a, const ContentRef& b) { return a.pageIndex < b.pageIndex; });
+
+    MarkedContentCollectorOutputDev collector;
+    size_t begin = 0;
+    while (begin < m_refs.size()) {
+        const int pageIndex = m_refs[begin].pageIndex;
+        size_t end = begin;
+        while (end < m_refs.size() && m_refs[end].pageIndex == pageIndex) {
+            ++end;
+        }
+
+        // 文档超时或被取消，剩余页面不再回放，其元素因没有内容被丢弃
+        if (ProcessingDeadline::currentExpired()) {
+            qDebug() << "PdfStructureExtractor: 文档时限已到，跳过第" << pageIndex + 1 << "页及之后的内容";
+            break;
+        }
+
+        const ProcessingDeadline* documentDeadline = ProcessingDeadline::current();
+        std::optional<ProcessingDeadline> pageDeadline;
+        if (documentDeadline) {
+            pageDeadline.emplace(m_pageBudgetMs, *documentDeadline);
+        } else {
+            pageDeadline.emplace(m_pageBudgetMs);
+        }
+        const ProcessingDeadline::Scope pageScope(*pageDeadline);
+
+        // 每页只执行一次内容流，收集全部MCID
+        m_doc->displayPage(&collector, pageIndex + 1, 72.0, 72.0, 0, false, true, false,
+                           ProcessingDeadline::abortCheck, nullptr, skipAnnotations, nullptr);
+
+        // 被打断的页面只收集到部分内容，整页丢弃；文档超时由下一轮检查处理
+        if (pageDeadline->hasExpired()) {
+            if (timeouts && !(documentDeadline && documentDeadline->hasExpired())) {
+                timeouts->append({pageIndex, pageDeadline->elapsed()});
+            }
+            begin = end;
+            continue;
+        }
+
+        for (size_t i = begin; i < end; ++i) {
+            const ContentRef& ref = m_refs[i];
+            const MarkedContentItem* item = collector.find(ref.stmRef, ref.mcid);
+            if (!item) {
+                continue;
+            }
+
+            Slot& slot = m_slots[static_cast<size_t>(ref.slot)];
+            if (!slot.fixedText && !item->text.empty()) {
+                const QString text = QString::fromUcs4(reinterpret_cast<const char32_t*>(item->text.data()),
+                                                       static_cast<qsizetype>(item->text.size()));
+                // 相邻的MCID通常是不同的行，缺少分隔时补空格
+                if (!slot.text.isEmpty() && !slot.text.back().isSpace() && !text.front().isSpace()) {
+                    slot.text += QLatin1Char(' ');
+                }
+                slot.text += text;
+            }
+            if (item->hasBox) {
+                if (slot.pageIndex < 0) {
+                    slot.pageIndex = pageIndex;
+                }
+                // 跨页元素只保留第一页上的边界框
+                if (slot.pageIndex == pageIndex) {
+                    const QRectF box(QPointF(item->x1, item->y1), QPointF(item->x2, item->y2));
+                    slot.boundingBox = slot.boundingBox.isNull() ? box : slot.boundingBox.united(box);
+                }
+            }
+        }
+        begin = end;
+    }
+}
+
+QList<PdfStructureExtractor::Element> StructureWalker::takeElements()
+{
+    QList<PdfStructureExtractor::Element> result;
+    result.reserve(m_elements.size());
+
+    for (int i = 0; i < m_elements.size(); ++i) {
+        PdfStructureExtractor::Element element = m_elements.at(i);
+
+        if (element.kind == PdfStructureExtractor::ElementKind::TABLE) {
+            const QList<int>& cellSlots = m_cellSlots.at(i);
+            for (int c = 0; c < element.cells.size(); ++c) {
+                const Slot& slot = m_slots[static_cast<size_t>(cellSlots.at(c))];
+                PdfStructureExtractor::Cell& cell = element.cells[c];
+                cell.text = slot.text.simplified();
+                if (slot.pageIndex >= 0 && (element.pageIndex < 0 || slot.pageIndex < element.pageIndex)) {
+                    element.pageIndex = slot.pageIndex;
+                }
+            }
+            // 表格边界框为第一页上所有单元格的并集
+            QStringList rows;
+            for (int r = 0; r < element.rowCount; ++r) {
+                QStringList rowCells;
+                for (int c = 0; c < element.cells.size(); ++c) {
+                    PdfStructureExtractor::Cell& cell = element.cells[c];
+                    const Slot& slot = m_slots[static_cast<size_t>(cellSlots.at(c))];
+                    if (cell.row != r) {
+                        continue;
+                    }
+                    rowCells.append(cell.text);
+                    if (slot.pageIndex == element.pageIndex) {
+                        cell.boundingBox = slot.boundingBox;
+                        element.boundingBox = element.boundingBox.isNull() ? slot.boundingBox
+                                                                           : element.boundingBox.united(slot.boundingBox);
+                    }
+                }
+                rows.append(rowCells.join(QS(" | ")));
+            }
+            element.text = rows.join(QLatin1Char('\n'));
+            if (element.cells.isEmpty()) {
+                continue;
+            }
+        } else {
+            const Slot& slot = m_slots[static_cast<size_t>(m_elementSlots.at(i))];
+            element.text = slot.text.simplified();
+            element.pageIndex = slot.pageIndex;
+            element.boundingBox = slot.boundingBox;
+            if (element.kind == PdfStructureExtractor::ElementKind::FIGURE) {
+                // 插图只要有可见内容或替代文本就保留
+                if (element.pageIndex < 0 && element.altText.isEmpty()) {
+                    continue;
+                }
+            } else if (element.text.isEmpty()) {
+                continue;
+            }
+        }
+
+        result.append(element);
+    }
+    return result;
+}
+
+} // namespace
+
+PdfStructureExtractor::Element::Element()
+    : kind(ElementKind::PARAGRAPH), pageIndex(-1), headingLevel(0), rowCount(0), columnCount(0)
+{
+}
+
+bool PdfStructureExtractor::isTagged(PdfCoreDocument& document)
+{
+    PDFDoc* doc = document.document();
+    if (!doc) {
+        return false;
+    }
+
+    try {
+        // Marked为false的文档可能包含不可靠的结构树（例如只有空的根元素）
+        if (!(doc->getCatalog()->getMarkInfo() & Catalog::markInfoMarked)) {
+            return false;
+        }
+        const StructTreeRoot* root = doc->getStructTreeRoot();
+        return root && root->getNumChildren() > 0;
+    } catch (const std::exception& e) {
+        qDebug() << "PdfStructureExtractor: 检查结构树时发生异常" << e.what();
+        return false;
+    }
+}
+
+QList<PdfStructureExtractor::Element> PdfStructureExtractor::extractElements(PdfCoreDocument& document, qint64 pageBudgetMs,
+                                                                             QList<PageTimeout>* timeouts)
+{
+    PDFDoc* doc = document.document();
+    if (!doc) {
+        return QList<Element>();
+    }
+
+    try {
+        const StructTreeRoot* root = doc->getStructTreeRoot();
+        if (!root) {
+            return QList<Element>();
+        }
+
+        StructureWalker walker(doc, pageBudgetMs);
+        for (unsigned i = 0; i < root->getNumChildren(); ++i) {
+            walker.visit(root->getChild(i));
+        }
+        walker.resolve(timeouts);
+
+        QList<Element> elements = walker.takeElements();
+        qDebug() << "PdfStructureExtractor: 从结构树提取了" << elements.size() << "个元素";
+        return elements;
+    } catch (const std::exception& e) {
+        qDebug() << "PdfStructureExtractor: 提取结构树时发生异常" << e.what();
+        return QList<Element>();
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 19:30:00
+ * @LastEditTime: 2026-10-18 19:30:00
+ * @LastEditors: seelights
+ * @Description: 基于结构树的带标签PDF内容提取器
+ * @FilePath: \ReportMason\src\PdfStructureExtractor.h
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#pragma once
+
+#include "PdfCoreDocument.h"
+#include <QList>
+#include <QRectF>
+#include <QString>
+
+/**
+ * @brief 基于结构树的带标签PDF内容提取器
+ *
+ * 带标签的PDF（MarkInfo/Marked为true且有StructTreeRoot）已经由生成工具标明了
+ * 段落、标题、插图和表格（Table/TR/TH/TD）及其阅读顺序，无需再用几何启发式推断。
+ * 本类按结构树的顺序遍历元素，把叶子上的标记内容（MCID）按页归组，
+ * 每页只用MarkedContentCollectorOutputDev执行一次内容流即可解析出全部MCID的文本和边界框，
+ * 避免StructElement::getText()为每个MCID单独执行一次页面内容流。
+ * 表格单元格按RowSpan/ColSpan属性放入占用网格，得到行列坐标。
+ */
+class PdfStructureExtractor
+{
+public:
+    /**
+     * @brief 元素类型
+     */
+    enum class ElementKind {
+        PARAGRAPH, ///< 段落（P、列表项及其他块级元素）
+        HEADING,   ///< 标题（H、H1-H6）
+        FIGURE,    ///< 插图或公式
+        TABLE      ///< 表格
+    };
+
+    /**
+     * @brief 表格单元格
+     */
+    struct Cell {
+        int row;
+        int column;
+        int rowSpan;
+        int columnSpan;
+        bool header;        ///< TH单元格
+        QString text;
+        QRectF boundingBox; ///< 坐标单位为点，原点在页面左上角；没有可见内容时为空
+    };
+
+    /**
+     * @brief 结构元素
+     */
+    struct Element {
+        ElementKind kind;
+        int pageIndex;      ///< 第一段内容所在页（从0开始），没有内容时为-1
+        QRectF boundingBox; ///< 第一页上内容的边界框
+        QString text;       ///< 文本（ActualText优先）
+        QString altText;    ///< 替代文本（插图）
+        int headingLevel;   ///< 标题级别，H为0
+        int rowCount;       ///< 表格行数
+        int columnCount;    ///< 表格列数
+        QList<Cell> cells;  ///< 表格单元格，按行优先排列
+
+        Element();
+    };
+
+    /**
+     * @brief 超过单页时限的页面
+     */
+    struct PageTimeout {
+        int pageIndex;    ///< 页面索引（从0开始）
+        qint64 elapsedMs; ///< 该页回放内容流的耗时
+    };
+
+    /**
+     * @brief 判断文档是否为带标签的PDF
+     * @param document 已打开的核心文档
+     * @return MarkInfo标记为Marked且结构树非空时返回true
+     */
+    static bool isTagged(PdfCoreDocument& document);
+
+    /**
+     * @brief 按结构树顺序提取全部元素
+     *
+     * 每页回放内容流时使用从当前线程活动截止时间派生的页面截止时间；
+     * 超时页面的内容被丢弃，文档截止时间到期后不再回放剩余页面。
+     * @param document 已打开的核心文档
+     * @param pageBudgetMs 单页时间预算（毫秒），小于等于0表示只受文档截止时间约束
+     * @param timeouts 输出超过单页时限的页面，可以为空
+     * @return 元素列表，没有可见内容且没有替代文本的元素会被丢弃
+     */
+    static QList<Element> extractElements(PdfCoreDocument& document, qint64 pageBudgetMs = 0,
+                                          QList<PageTimeout>* timeouts = nullptr);
+};
@@ -0,0 +1,353 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 15:40:00
+ * @LastEditTime: 2026-10-18 15:40:00
+ * @LastEditors: seelights
+ * @Description: 基于矢量表格线的PDF表格检测器实现
+ * @FilePath: \ReportMason\src\PdfTableDetector.cpp
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#include "PdfTableDetector.h"
+#include "ProcessingDeadline.h"
+#include "QtCompat.h"
+#include <QDebug>
+#include <QMap>
+#include <algorithm>
+#include <numeric>
+
+#include <PDFDoc.h>
+#include <RulingOutputDev.h>
+
+namespace {
+
+/**
+ * @brief 单条表格线：pos为水平线的y或竖直线的x，[start, end]为另一方向的范围
+ */
+struct Rule {
+    double pos;
+    double start;
+    double end;
+};
+
+/**
+ * @brief 合并共线且相接的线段
+ *
+ * 先把位置相近的线段聚成一组并取平均位置，再在组内按起点排序合并重叠部分。
+ */
+QList<Rule> mergeRules(QList<Rule> rules, double tolerance)
+{
+    std::sort(rules.begin(), rules.end(), [](const Rule& a, const Rule& b) { return a.pos < b.pos; });
+
+    QList<Rule> merged;
+    int groupStart = 0;
+    while (groupStart < rules.size()) {
+        int groupEnd = groupStart + 1;
+        double sum = rules.at(groupStart).pos;
+        while (groupEnd < rules.size() && rules.at(groupEnd).pos - rules.at(groupEnd - 1).pos <= tolerance) {
+            sum += rules.at(groupEnd).pos;
+            ++groupEnd;
+        }
+        const double pos = sum / (groupEnd - groupStart);
+
+        QList<Rule> group = rules.mid(groupStart, groupEnd - groupStart);
+        std::sort(group.begin(), group.end(), [](const Rule& a, const Rule& b) { return a.start < b.start; });
+        Rule current = {pos, group.first().start, group.first().end};
+        for (int i = 1; i < group.size(); ++i) {
+            if (group.at(i).start <= current.end + tolerance) {
+                current.end = qMax(current.end, group.at(i).end);
+            } else {
+                merged.append(current);
+                current = {pos, group.at(i).start, group.at(i).end};
+            }
+        }
+        merged.append(current);
+
+        groupStart = groupEnd;
+    }
+    return merged;
+}
+
+/**
+ * @brief 判断位置pos处是否有线段覆盖point
+ */
+bool hasRuleAt(const QList<Rule>& rules, double pos, double point, double tolerance)
+{
+    for (const Rule& rule : rules) {
+        if (qAbs(rule.pos - pos) <= tolerance && rule.start - tolerance <= point && point <= rule.end + tolerance) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 取不重复的线段位置
+ */
+QList<double> distinctPositions(const QList<Rule>& rules, double tolerance)
+{
+    QList<double> positions;
+    for (const Rule& rule : rules) {
+        positions.append(rule.pos);
+    }
+    std::sort(positions.begin(), positions.end());
+
+    QList<double> result;
+    for (double pos : positions) {
+        if (result.isEmpty() || pos - result.last() > tolerance) {
+            result.append(pos);
+        }
+    }
+    return result;
+}
+
+int findRoot(QList<int>& parents, int index)
+{
+    while (parents.at(index) != index) {
+        parents[index] = parents.at(parents.at(index));
+        index = parents.at(index);
+    }
+    return index;
+}
+
+/**
+ * @brief 在边界数组中查找value所在的区间
+ * @return 区间下标，不在任何区间内时返回-1
+ */
+int findInterval(const QList<double>& edges, double value)
+{
+    if (edges.size() < 2 || value < edges.first() || value > edges.last()) {
+        return -1;
+    }
+    const auto it = std::upper_bound(edges.cbegin(), edges.cend(), value);
+    const int index = static_cast<int>(it - edges.cbegin()) - 1;
+    return qBound(0, index, static_cast<int>(edges.size()) - 2);
+}
+
+} // namespace
+
+int PdfTableDetector::Table::cellAt(int row, int column) const
+{
+    if (row < 0 || row >= rowCount || column < 0 || column >= columnCount) {
+        return -1;
+    }
+    return cellGrid.at(row * columnCount + column);
+}
+
+QString PdfTableDetector::Table::toText() const
+{
+    QStringList rows;
+    for (int r = 0; r < rowCount; ++r) {
+        QStringList rowCells;
+        for (const Cell& cell : cells) {
+            if (cell.row == r) {
+                rowCells.append(cell.text);
+            }
+        }
+        rows.append(rowCells.join(QS(" | ")));
+    }
+    return rows.join(QLatin1Char('\n'));
+}
+
+QList<PdfTableDetector::Table> PdfTableDetector::detectTables(PdfCoreDocument& document, int pageIndex,
+                                                              const QList<TextFragment>& fragments)
+{
+    QList<Table> tables = buildTables(collectRulings(document, pageIndex));
+    if (!tables.isEmpty() && !fragments.isEmpty()) {
+        assignFragments(tables, fragments);
+    }
+    return tables;
+}
+
+QList<QLineF> PdfTableDetector::collectRulings(PdfCoreDocument& document, int pageIndex)
+{
+    QList<QLineF> rulings;
+
+    PDFDoc* doc = document.document();
+    if (!doc || pageIndex < 0 || pageIndex >= doc->getNumPages()) {
+        return rulings;
+    }
+
+    try {
+        RulingOutputDev rulingDev;
+        doc->displayPage(&rulingDev, pageIndex + 1, 72.0, 72.0, 0, false, true, false, ProcessingDeadline::abortCheck, nullptr);
+
+        const std::vector<RulingSegment> segments = rulingDev.takeSegments();
+        rulings.reserve(static_cast<qsizetype>(segments.size()));
+        for (const RulingSegment& segment : segments) {
+            rulings.append(QLineF(segment.x1, segment.y1, segment.x2, segment.y2));
+        }
+    } catch (const std::exception& e) {
+        qDebug() << "PdfTableDetector: 收集表格线时发生异常" << pageIndex + 1 << e.what();
+        rulings.clear();
+    }
+    return rulings;
+}
+
+QList<PdfTableDetector::Table> PdfTableDetector::buildTables(const QList<QLineF>& rulings, double tolerance)
+{
+    QList<Table> tables;
+
+    // 1. 拆分为水平线和竖直线并合并共线线段
+    QList<Rule> horizontalRules;
+    QList<Rule> verticalRules;
+    for (const QLineF& line : rulings) {
+        if (qAbs(line.dy()) <= qAbs(line.dx())) {
+            horizontalRules.append({(line.y1() + line.y2()) / 2, qMin(line.x1(), line.x2()), qMax(line.x1(), line.x2())});
+        } else {
+            verticalRules.append({(line.x1() + line.x2()) / 2, qMin(line.y1(), line.y2()), qMax(line.y1(), line.y2())});
+        }
+    }
+    if (horizontalRules.size() < 2 || verticalRules.size() < 2) {
+        return tables;
+    }
+    horizontalRules = mergeRules(horizontalRules, tolerance);
+    verticalRules = mergeRules(verticalRules, tolerance);
+
+    // 2. 按相交关系分组，每组是一个候选表格
+    const int horizontalCount = horizontalRules.size();
+    const int verticalCount = verticalRules.size();
+    QList<int> parents(horizontalCount + verticalCount);
+    std::iota(parents.begin(), parents.end(), 0);
+    for (int h = 0; h < horizontalCount; ++h) {
+        // 线段很多时求交是O(H*V)，超时则放弃整页的表格
+        if (ProcessingDeadline::currentExpired()) {
+            return tables;
+        }
+        const Rule& horizontal = horizontalRules.at(h);
+        for (int v = 0; v < verticalCount; ++v) {
+            const Rule& vertical = verticalRules.at(v);
+            if (vertical.pos >= horizontal.start - tolerance && vertical.pos <= horizontal.end + tolerance
+                && horizontal.pos >= vertical.start - tolerance && horizontal.pos <= vertical.end + tolerance) {
+                parents[findRoot(parents, h)] = findRoot(parents, horizontalCount + v);
+            }
+        }
+    }
+
+    QMap<int, QPair<QList<Rule>, QList<Rule>>> groups;
+    for (int h = 0; h < horizontalCount; ++h) {
+        groups[findRoot(parents, h)].first.append(horizontalRules.at(h));
+    }
+    for (int v = 0; v < verticalCount; ++v) {
+        groups[findRoot(parents, horizontalCount + v)].second.append(verticalRules.at(v));
+    }
+
+    // 3. 每组线段的位置构成网格，缺失的内部边框合并为跨行/跨列单元格
+    for (auto it = groups.cbegin(); it != groups.cend(); ++it) {
+        const QList<Rule>& horizontals = it.value().first;
+        const QList<Rule>& verticals = it.value().second;
+        if (horizontals.size() < 2 || verticals.size() < 2) {
+            continue;
+        }
+
+        Table table;
+        table.rowEdges = distinctPositions(horizontals, tolerance);
+        table.columnEdges = distinctPositions(verticals, tolerance);
+        table.rowCount = table.rowEdges.size() - 1;
+        table.columnCount = table.columnEdges.size() - 1;
+        // 单个边框（如文本框）不视为表格
+        if (table.rowCount < 1 || table.columnCount < 1 || table.rowCount * table.columnCount < 2) {
+            continue;
+        }
+
+        const QList<double>& ys = table.rowEdges;
+        const QList<double>& xs = table.columnEdges;
+        table.cellGrid = QList<int>(table.rowCount * table.columnCount, -1);
+
+        for (int r = 0; r < table.rowCount; ++r) {
+            if (ProcessingDeadline::currentExpired()) {
+                return tables;
+            }
+            for (int c = 0; c < table.columnCount; ++c) {
+                if (table.cellGrid.at(r * table.columnCount + c) >= 0) {
+                    continue;
+                }
+
+                Cell cell;
+                cell.row = r;
+                cell.column = c;
+
+                // 右侧边框缺失时向右合并
+                const double rowMiddle = (ys.at(r) + ys.at(r + 1)) / 2;
+                while (c + cell.columnSpan < table.columnCount
+                       && table.cellGrid.at(r * table.columnCount + c + cell.columnSpan) < 0
+                       && !hasRuleAt(verticals, xs.at(c + cell.columnSpan), rowMiddle, tolerance)) {
+                    cell.columnSpan++;
+                }
+
+                // 下方边框在整个跨度内都缺失时向下合并
+                while (r + cell.rowSpan < table.rowCount) {
+                    bool bordered = false;
+                    for (int k = c; k < c + cell.columnSpan && !bordered; ++k) {
+                        const double columnMiddle = (xs.at(k) + xs.at(k + 1)) / 2;
+                        bordered = hasRuleAt(horizontals, ys.at(r + cell.rowSpan), columnMiddle, tolerance)
+                                   || table.cellGrid.at((r + cell.rowSpan) * table.columnCount + k) >= 0;
+                    }
+                    if (bordered) {
+                        break;
+                    }
+                    cell.rowSpan++;
+                }
+
+                cell.rect = QRectF(QPointF(xs.at(c), ys.at(r)),
+                                   QPointF(xs.at(c + cell.columnSpan), ys.at(r + cell.rowSpan)));
+
+                const int cellIndex = table.cells.size();
+                for (int rr = r; rr < r + cell.rowSpan; ++rr) {
+                    for (int cc = c; cc < c + cell.columnSpan; ++cc) {
+                        table.cellGrid[rr * table.columnCount + cc] = cellIndex;
+                    }
+                }
+                table.cells.append(cell);
+            }
+        }
+
+        table.boundingBox = QRectF(QPointF(xs.first(), ys.first()), QPointF(xs.last(), ys.last()));
+        tables.append(table);
+    }
+
+    std::sort(tables.begin(), tables.end(), [](const Table& a, const Table& b) {
+        return a.boundingBox.top() < b.boundingBox.top();
+    });
+    return tables;
+}
+
+void PdfTableDetector::assignFragments(QList<Table>& tables, const QList<TextFragment>& fragments)
+{
+    // 记录每个单元格最后一个片段的底边，用于判断是否换行
+    QList<QList<double>> lastBottoms;
+    lastBottoms.reserve(tables.size());
+    for (const Table& table : tables) {
+        lastBottoms.append(QList<double>(table.cells.size(), 0.0));
+    }
+
+    for (const TextFragment& fragment : fragments) {
+        if (ProcessingDeadline::currentExpired()) {
+            return;
+        }
+        const QPointF center = fragment.boundingBox.center();
+        for (int t = 0; t < tables.size(); ++t) {
+            Table& table = tables[t];
+            if (!table.boundingBox.contains(center)) {
+                continue;
+            }
+
+            const int row = findInterval(table.rowEdges, center.y());
+            const int column = findInterval(table.columnEdges, center.x());
+            const int cellIndex = table.cellAt(row, column);
+            if (cellIndex < 0) {
+                break;
+            }
+
+            Cell& cell = table.cells[cellIndex];
+            if (!cell.text.isEmpty()) {
+                const bool newLine = fragment.boundingBox.top() >= lastBottoms.at(t).at(cellIndex)
+                                                                   - fragment.boundingBox.height() / 2;
+                cell.text += newLine ? QLatin1Char('\n') : QLatin1Char(' ');
+            }
+            cell.text += fragment.text;
+            lastBottoms[t][cellIndex] = fragment.boundingBox.bottom();
+            break;
+        }
+    }
+}
@@ -0,0 +1,111 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 15:40:00
+ * @LastEditTime: 2026-10-18 15:40:00
+ * @LastEditors: seelights
+ * @Description: 基于矢量表格线的PDF表格检测器
+ * @FilePath: \ReportMason\src\PdfTableDetector.h
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#pragma once
+
+#include "PdfCoreDocument.h"
+#include <QLineF>
+#include <QList>
+#include <QRectF>
+#include <QString>
+
+/**
+ * @brief 基于矢量表格线的PDF表格检测器
+ *
+ * 用RulingOutputDev执行一次内容流（不光栅化），只收集描边和细矩形填充产生的
+ * 水平/竖直线段；合并共线线段后按相交关系分组，每组线段的位置构成表格网格，
+ * 缺失的内部边框被识别为合并单元格。文本片段按中心点在网格边界上二分查找归入单元格。
+ */
+class PdfTableDetector
+{
+public:
+    /**
+     * @brief 待分配的文本片段（坐标单位为点，原点在页面左上角）
+     */
+    struct TextFragment {
+        QRectF boundingBox;
+        QString text;
+    };
+
+    /**
+     * @brief 单元格
+     */
+    struct Cell {
+        int row;
+        int column;
+        int rowSpan;
+        int columnSpan;
+        QRectF rect;
+        QString text;
+
+        Cell() : row(0), column(0), rowSpan(1), columnSpan(1) {}
+    };
+
+    /**
+     * @brief 检测到的表格
+     */
+    struct Table {
+        QRectF boundingBox;
+        int rowCount;
+        int columnCount;
+        QList<Cell> cells;
+        QList<double> rowEdges;    ///< 行边界（rowCount + 1个）
+        QList<double> columnEdges; ///< 列边界（columnCount + 1个）
+        QList<int> cellGrid;       ///< 网格位置 -> cells下标，按行优先存储
+
+        Table() : rowCount(0), columnCount(0) {}
+
+        /**
+         * @brief 获取网格位置所属的单元格
+         * @return 单元格下标，越界时返回-1
+         */
+        int cellAt(int row, int column) const;
+
+        /**
+         * @brief 转换为文本：单元格之间用" | "分隔，行之间换行
+         */
+        QString toText() const;
+    };
+
+    /**
+     * @brief 检测页面上的表格并填充单元格文本
+     * @param document 已打开的核心文档
+     * @param pageIndex 从0开始的页码
+     * @param fragments 页面上的文本片段，按阅读顺序排列
+     * @return 表格列表
+     */
+    static QList<Table> detectTables(PdfCoreDocument& document, int pageIndex,
+                                     const QList<TextFragment>& fragments = QList<TextFragment>());
+
+    /**
+     * @brief 收集页面上的水平/竖直表格线
+     * @param document 已打开的核心文档
+     * @param pageIndex 从0开始的页码
+     * @return 线段列表
+     */
+    static QList<QLineF> collectRulings(PdfCoreDocument& document, int pageIndex);
+
+    /**
+     * @brief 由表格线构建表格网格
+     * @param rulings 水平/竖直线段
+     * @param tolerance 对齐容差（点）
+     * @return 表格列表（单元格不含文本）
+     */
+    static QList<Table> buildTables(const QList<QLineF>& rulings, double tolerance = DEFAULT_TOLERANCE);
+
+    /**
+     * @brief 将文本片段分配到单元格
+     * @param tables 表格列表
+     * @param fragments 文本片段，按阅读顺序排列
+     */
+    static void assignFragments(QList<Table>& tables, const QList<TextFragment>& fragments);
+
+    static constexpr double DEFAULT_TOLERANCE = 2.0;
+};
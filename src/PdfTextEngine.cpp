@@ -0,0 +1,247 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 14:20:00
+ * @LastEditTime: 2026-10-18 14:20:00
+ * @LastEditors: seelights
+ * @Description: 基于TextOutputDev的PDF文本提取引擎实现
+ * @FilePath: \ReportMason\src\PdfTextEngine.cpp
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#include "PdfTextEngine.h"
+#include "ProcessingDeadline.h"
+#include "QtCompat.h"
+#include <QDebug>
+
+#include <GooString.h>
+#include <PDFDoc.h>
+#include <TextOutputDev.h>
+
+namespace {
+
+QRectF rectFromBBox(double xMin, double yMin, double xMax, double yMax)
+{
+    return QRectF(QPointF(xMin, yMin), QPointF(xMax, yMax));
+}
+
+} // namespace
+
+QString PdfTextEngine::Line::text() const
+{
+    QString result;
+    for (int i = 0; i < words.size(); ++i) {
+        result += words.at(i).text;
+        if (words.at(i).spaceAfter && i + 1 < words.size()) {
+            result += QLatin1Char(' ');
+        }
+    }
+    return result;
+}
+
+QString PdfTextEngine::Block::text() const
+{
+    QString result;
+    for (int i = 0; i < lines.size(); ++i) {
+        if (i > 0) {
+            result += QLatin1Char('\n');
+        }
+        result += lines.at(i).text();
+    }
+    return result;
+}
+
+QString PdfTextEngine::Page::text() const
+{
+    QString result;
+    for (int i = 0; i < blocks.size(); ++i) {
+        if (i > 0) {
+            result += QS("\n\n");
+        }
+        result += blocks.at(i).text();
+    }
+    return result;
+}
+
+int PdfTextEngine::Page::wordCount() const
+{
+    int count = 0;
+    for (const Block& block : blocks) {
+        for (const Line& line : block.lines) {
+            count += line.words.size();
+        }
+    }
+    return count;
+}
+
+PdfTextEngine::PdfTextEngine() = default;
+
+PdfTextEngine::~PdfTextEngine() = default;
+
+bool PdfTextEngine::open(const QString& filePath)
+{
+    if (!m_document.open(filePath)) {
+        m_lastError = m_document.lastError();
+        return false;
+    }
+    return true;
+}
+
+void PdfTextEngine::close()
+{
+    m_document.close();
+}
+
+bool PdfTextEngine::isOpen() const
+{
+    return m_document.isOpen();
+}
+
+int PdfTextEngine::pageCount() const
+{
+    return m_document.pageCount();
+}
+
+bool PdfTextEngine::extractPage(int pageIndex, Page& page)
+{
+    page = Page();
+
+    PDFDoc* document = m_document.document();
+    if (!document) {
+        m_lastError = QS("PDF文档未打开");
+        return false;
+    }
+    if (pageIndex < 0 || pageIndex >= document->getNumPages()) {
+        m_lastError = QS("页码超出范围: %1").arg(pageIndex);
+        return false;
+    }
+
+    try {
+        page.pageIndex = pageIndex;
+        page.size = m_document.pageSize(pageIndex);
+
+        // fileName为nullptr时不写文件，只在内存中构建TextPage；
+        // physLayout和rawOrder都为false时getFlows按阅读顺序返回
+        TextOutputDev textDev(nullptr, false, 0, false, false);
+        if (!textDev.isOk()) {
+            m_lastError = QS("无法创建文本输出设备");
+            return false;
+        }
+        // 当前线程有活动截止时间时，内容流解释在到期后中止
+        document->displayPage(&textDev, pageIndex + 1, 72.0, 72.0, 0, false, true, false,
+                              ProcessingDeadline::abortCheck, nullptr);
+
+        int flowIndex = 0;
+        for (const TextFlow* flow = textDev.getFlows(); flow; flow = flow->getNext(), ++flowIndex) {
+            for (const TextBlock* textBlock = flow->getBlocks(); textBlock; textBlock = textBlock->getNext()) {
+                Block block;
+                block.flowIndex = flowIndex;
+                double xMin, yMin, xMax, yMax;
+                textBlock->getBBox(&xMin, &yMin, &xMax, &yMax);
+                block.boundingBox = rectFromBBox(xMin, yMin, xMax, yMax);
+
+                for (const TextLine* textLine = textBlock->getLines(); textLine; textLine = textLine->getNext()) {
+                    Line line;
+                    line.hyphenated = textLine->isHyphenated();
+                    for (const TextWord* textWord = textLine->getWords(); textWord; textWord = textWord->getNext()) {
+                        Word word = convertWord(textWord);
+                        line.boundingBox = line.boundingBox.isNull() ? word.boundingBox
+                                                                     : line.boundingBox.united(word.boundingBox);
+                        line.words.append(word);
+                    }
+                    if (!line.words.isEmpty()) {
+                        block.lines.append(line);
+                    }
+                }
+
+                if (!block.lines.isEmpty()) {
+                    page.blocks.append(block);
+                }
+            }
+        }
+        return true;
+    } catch (const std::exception& e) {
+        m_lastError = QS("提取第%1页文本时发生异常: %2").arg(pageIndex + 1).arg(QString::fromUtf8(e.what()));
+        return false;
+    }
+}
+
+bool PdfTextEngine::extractPages(const PageCallback& callback)
+{
+    const int count = pageCount();
+    for (int i = 0; i < count; ++i) {
+        Page page;
+        if (!extractPage(i, page)) {
+            return false;
+        }
+        if (callback && !callback(page)) {
+            break;
+        }
+    }
+    return isOpen();
+}
+
+QString PdfTextEngine::lastError() const
+{
+    return m_lastError;
+}
+
+PdfTextEngine::Word PdfTextEngine::convertWord(const TextWord* textWord)
+{
+    Word word;
+
+    const int length = textWord->getLength();
+    word.text.reserve(length);
+    for (int i = 0; i < length; ++i) {
+        const char32_t ucs4 = static_cast<char32_t>(*textWord->getChar(i));
+        if (QChar::requiresSurrogates(ucs4)) {
+            word.text += QChar(QChar::highSurrogate(ucs4));
+            word.text += QChar(QChar::lowSurrogate(ucs4));
+        } else {
+            word.text += QChar(static_cast<char16_t>(ucs4));
+        }
+    }
+
+    double xMin, yMin, xMax, yMax;
+    textWord->getBBox(&xMin, &yMin, &xMax, &yMax);
+    word.boundingBox = rectFromBBox(xMin, yMin, xMax, yMax);
+
+    double r, g, b;
+    textWord->getColor(&r, &g, &b);
+    word.color = QColor::fromRgbF(static_cast<float>(r), static_cast<float>(g), static_cast<float>(b));
+
+    word.fontSize = textWord->getFontSize();
+    word.spaceAfter = textWord->getSpaceAfter();
+    word.rotation = textWord->getRotation();
+
+    if (length > 0) {
+        if (const TextFontInfo* fontInfo = textWord->getFontInfo(0)) {
+            if (const GooString* fontName = fontInfo->getFontName()) {
+                word.fontName = normalizeFontName(QString::fromLatin1(fontName->c_str()));
+            }
+            // 许多字体没有设置描述符标志，再用字体名补充判断
+            word.bold = fontInfo->isBold() || word.fontName.contains(QS("Bold"), Qt::CaseInsensitive);
+            word.italic = fontInfo->isItalic() || word.fontName.contains(QS("Italic"), Qt::CaseInsensitive)
+                          || word.fontName.contains(QS("Oblique"), Qt::CaseInsensitive);
+        }
+    }
+
+    return word;
+}
+
+QString PdfTextEngine::normalizeFontName(const QString& fontName)
+{
+    // 子集字体名形如"ABCDEF+SimSun"
+    if (fontName.size() > 7 && fontName.at(6) == QLatin1Char('+')) {
+        bool allUpper = true;
+        for (int i = 0; i < 6; ++i) {
+            if (fontName.at(i) < QLatin1Char('A') || fontName.at(i) > QLatin1Char('Z')) {
+                allUpper = false;
+                break;
+            }
+        }
+        if (allUpper) {
+            return fontName.mid(7);
+        }
+    }
+    return fontName;
+}
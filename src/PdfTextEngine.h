@@ -0,0 +1,168 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 14:20:00
+ * @LastEditTime: 2026-10-18 14:20:00
+ * @LastEditors: seelights
+ * @Description: 基于TextOutputDev的PDF文本提取引擎
+ * @FilePath: \ReportMason\src\PdfTextEngine.h
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#pragma once
+
+#include "PdfCoreDocument.h"
+#include <QColor>
+#include <QList>
+#include <QRectF>
+#include <QSizeF>
+#include <QString>
+#include <functional>
+
+class TextWord;
+
+/**
+ * @brief 基于TextOutputDev的PDF文本提取引擎
+ *
+ * 直接驱动poppler核心的TextOutputDev逐页解析内容流（包括压缩流），
+ * 按阅读顺序输出文本块、行和单词，附带坐标与字体信息。
+ * 文件由PDFDoc按需读取，整个文件不会被转换成字符串；
+ * 每页的TextPage在回调返回后立即释放，内存占用只与单页内容有关。
+ * 单个实例不是线程安全的，多线程提取时每个线程使用独立的实例。
+ */
+class PdfTextEngine
+{
+public:
+    /**
+     * @brief 单词（坐标单位为点，原点在页面左上角）
+     */
+    struct Word {
+        QString text;
+        QRectF boundingBox;
+        QString fontName;  ///< 已去掉子集前缀的字体名
+        double fontSize;
+        bool bold;
+        bool italic;
+        QColor color;
+        bool spaceAfter;   ///< 与下一个单词之间是否有空格
+        int rotation;      ///< 0-3，表示0/90/180/270度
+
+        Word() : fontSize(0.0), bold(false), italic(false), spaceAfter(false), rotation(0) {}
+    };
+
+    /**
+     * @brief 文本行
+     */
+    struct Line {
+        QRectF boundingBox;
+        QList<Word> words;
+        bool hyphenated; ///< 行尾是否为连字符
+
+        Line() : hyphenated(false) {}
+
+        /**
+         * @brief 获取整行文本
+         */
+        QString text() const;
+    };
+
+    /**
+     * @brief 文本块（段落），flowIndex相同的块属于同一栏
+     */
+    struct Block {
+        QRectF boundingBox;
+        QList<Line> lines;
+        int flowIndex;
+
+        Block() : flowIndex(0) {}
+
+        /**
+         * @brief 获取块文本，行之间用换行分隔
+         */
+        QString text() const;
+    };
+
+    /**
+     * @brief 单页文本布局
+     */
+    struct Page {
+        int pageIndex; ///< 从0开始的页码
+        QSizeF size;   ///< 页面尺寸（点）
+        QList<Block> blocks;
+
+        Page() : pageIndex(-1) {}
+
+        /**
+         * @brief 获取整页文本，块之间用空行分隔
+         */
+        QString text() const;
+
+        /**
+         * @brief 获取单词总数
+         */
+        int wordCount() const;
+    };
+
+    /**
+     * @brief 逐页回调，返回false时停止提取
+     */
+    using PageCallback = std::function<bool(const Page&)>;
+
+    PdfTextEngine();
+    ~PdfTextEngine();
+
+    PdfTextEngine(const PdfTextEngine&) = delete;
+    PdfTextEngine& operator=(const PdfTextEngine&) = delete;
+
+    /**
+     * @brief 打开PDF文件
+     * @param filePath 文件路径
+     * @return 是否成功
+     */
+    bool open(const QString& filePath);
+
+    /**
+     * @brief 关闭文件
+     */
+    void close();
+
+    /**
+     * @brief 是否已打开文件
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief 获取页数
+     */
+    int pageCount() const;
+
+    /**
+     * @brief 提取单页文本布局
+     * @param pageIndex 从0开始的页码
+     * @param page 输出的页面布局
+     * @return 是否成功
+     */
+    bool extractPage(int pageIndex, Page& page);
+
+    /**
+     * @brief 按顺序逐页提取，每页完成后调用回调
+     * @param callback 页面回调
+     * @return 是否全部成功（回调主动停止也视为成功）
+     */
+    bool extractPages(const PageCallback& callback);
+
+    /**
+     * @brief 获取最后的错误信息
+     */
+    QString lastError() const;
+
+    /**
+     * @brief 去掉字体名的子集前缀，例如"ABCDEF+SimSun"得到"SimSun"
+     */
+    static QString normalizeFontName(const QString& fontName);
+
+private:
+    static Word convertWord(const TextWord* textWord);
+
+    PdfCoreDocument m_document;
+    QString m_lastError;
+};
@@ -0,0 +1,378 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 18:30:00
+ * @LastEditTime: 2026-10-18 18:30:00
+ * @LastEditors: seelights
+ * @Description: PDF页面文本版面缓存实现
+ * @FilePath: \ReportMason\src\PdfTextLayoutCache.cpp
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#include "PdfTextLayoutCache.h"
+#include "PdfCoreDocument.h"
+#include "PdfFontTable.h"
+#include "PdfTextEngine.h"
+#include "ProcessingDeadline.h"
+#include "QtCompat.h"
+#include <QDebug>
+#include <QHash>
+#include <QMutexLocker>
+#include <QStringList>
+#include <poppler-qt6.h>
+
+#include <GooString.h>
+#include <PDFDoc.h>
+#include <TextOutputDev.h>
+
+namespace {
+
+/**
+ * @brief 判断两个指针是否指向同一个文档（按控制块比较，不受地址复用影响）
+ */
+bool sameDocument(const std::weak_ptr<Poppler::Document>& a, const std::shared_ptr<Poppler::Document>& b)
+{
+    return !a.owner_before(b) && !b.owner_before(a);
+}
+
+} // namespace
+
+PdfTextLayoutCache::Layout::Layout() : pageIndex(-1) {}
+
+PdfTextLayoutCache::Layout::~Layout() = default;
+
+bool PdfTextLayoutCache::Layout::hasFonts() const
+{
+    return fonts && fontIds.size() == static_cast<qsizetype>(boxes.size());
+}
+
+PdfTextLayoutCache::PdfTextLayoutCache()
+    : m_capacity(DEFAULT_CAPACITY), m_hits(0), m_misses(0)
+{
+}
+
+PdfTextLayoutCache* PdfTextLayoutCache::instance()
+{
+    // 函数内静态变量的初始化是线程安全的
+    static PdfTextLayoutCache cache;
+    return &cache;
+}
+
+PdfTextLayoutCache::LayoutPtr PdfTextLayoutCache::acquire(const std::shared_ptr<Poppler::Document>& document,
+                                                          int pageIndex)
+{
+    if (!document || pageIndex < 0 || pageIndex >= document->numPages()) {
+        return nullptr;
+    }
+
+    LayoutPtr layout = lookup(document, pageIndex);
+    if (layout) {
+        return layout;
+    }
+
+    std::unique_ptr<Poppler::Page> page = document->page(pageIndex);
+    if (!page) {
+        return nullptr;
+    }
+    layout = build(page.get(), pageIndex);
+    store(document, layout);
+    return layout;
+}
+
+PdfTextLayoutCache::LayoutPtr PdfTextLayoutCache::acquire(const std::shared_ptr<Poppler::Document>& document,
+                                                          Poppler::Page* page, int pageIndex,
+                                                          PdfCoreDocument* coreDocument)
+{
+    if (!page) {
+        return nullptr;
+    }
+    if (!document) {
+        return coreDocument ? build(*coreDocument, std::make_shared<PdfFontTable>(), pageIndex) : build(page, pageIndex);
+    }
+
+    // 其他调用方缓存的版面可能没有字体信息，需要字体时重新分析
+    LayoutPtr layout = lookup(document, pageIndex);
+    if (layout && (!coreDocument || layout->hasFonts())) {
+        return layout;
+    }
+
+    layout = coreDocument ? build(*coreDocument, fontTable(document), pageIndex) : build(page, pageIndex);
+    store(document, layout);
+    return layout;
+}
+
+PdfTextLayoutCache::LayoutPtr PdfTextLayoutCache::build(Poppler::Page* page, int pageIndex)
+{
+    auto layout = std::make_shared<Layout>();
+    layout->pageIndex = pageIndex;
+    if (!page) {
+        return layout;
+    }
+
+    try {
+        layout->boxes = page->textList(Poppler::Page::Rotate0, ProcessingDeadline::shouldAbort, QVariant());
+    } catch (const std::exception& e) {
+        qDebug() << "PdfTextLayoutCache: 分析页面文本时发生异常" << pageIndex + 1 << e.what();
+        layout->boxes.clear();
+        return layout;
+    }
+
+    // textList按阅读顺序返回，同一行内的单词由nextWord相连
+    QStringList lineTexts;
+    QString lineText;
+    const Poppler::TextBox* previous = nullptr;
+    for (int i = 0; i < static_cast<int>(layout->boxes.size()); ++i) {
+        const Poppler::TextBox* box = layout->boxes.at(i).get();
+        if (!box) {
+            continue;
+        }
+
+        if (previous && previous->nextWord() == box && !layout->lines.isEmpty()) {
+            Line& line = layout->lines.last();
+            line.boundingBox = line.boundingBox.united(box->boundingBox());
+            line.boxCount = i - line.firstBox + 1;
+            if (previous->hasSpaceAfter()) {
+                lineText += QLatin1Char(' ');
+            }
+        } else {
+            if (!layout->lines.isEmpty()) {
+                lineTexts.append(lineText);
+                lineText.clear();
+            }
+            layout->lines.append(Line{box->boundingBox(), i, 1});
+        }
+        lineText += box->text();
+        previous = box;
+    }
+    if (!layout->lines.isEmpty()) {
+        lineTexts.append(lineText);
+    }
+    layout->text = lineTexts.join(QLatin1Char('\n'));
+
+    return layout;
+}
+
+PdfTextLayoutCache::LayoutPtr PdfTextLayoutCache::build(PdfCoreDocument& coreDocument,
+                                                        const std::shared_ptr<PdfFontTable>& fonts, int pageIndex)
+{
+    auto layout = std::make_shared<Layout>();
+    layout->pageIndex = pageIndex;
+    layout->fonts = fonts;
+    PDFDoc* doc = coreDocument.document();
+    if (!doc || !fonts || pageIndex < 0 || pageIndex >= doc->getNumPages()) {
+        return layout;
+    }
+
+    /**
+     * @brief 同一TextFontInfo的字体族和样式只解析一次
+     */
+    struct FontStyle {
+        int familyId;
+        bool bold;
+        bool italic;
+        bool fixedPitch;
+        bool serif;
+    };
+
+    try {
+        // 与Poppler::Page::textList相同的参数：72dpi、不旋转、不裁剪，坐标原点在页面左上角
+        // 单词列表引用输出设备持有的TextPage，输出设备须在整个转换期间存活
+        TextOutputDev output(nullptr, false, 0, false, false);
+        if (!output.isOk()) {
+            return layout;
+        }
+        doc->displayPage(&output, pageIndex + 1, 72.0, 72.0, 0, false, false, false, ProcessingDeadline::abortCheck, nullptr);
+        const std::unique_ptr<TextWordList> words = output.makeWordList();
+
+        const int wordCount = words ? words->getLength() : 0;
+        layout->boxes.reserve(wordCount);
+        layout->fontIds.reserve(wordCount);
+        QHash<const TextFontInfo*, FontStyle> styles;
+        QStringList lineTexts;
+        QString lineText;
+        const TextWord* previous = nullptr;
+
+        for (int i = 0; i < wordCount; ++i) {
+            const TextWord* word = words->get(i);
+            const std::unique_ptr<GooString> text(word->getText());
+            double xMin, yMin, xMax, yMax;
+            word->getBBox(&xMin, &yMin, &xMax, &yMax);
+            const QRectF boundingBox(xMin, yMin, xMax - xMin, yMax - yMin);
+            const QString boxText = QString::fromUtf8(text->c_str());
+            const int boxIndex = static_cast<int>(layout->boxes.size());
+            layout->boxes.push_back(std::make_unique<Poppler::TextBox>(boxText, boundingBox));
+
+            PdfFontTable::Font font;
+            const TextFontInfo* fontInfo = word->getLength() > 0 ? word->getFontInfo(0) : nullptr;
+            auto style = styles.constFind(fontInfo);
+            if (style == styles.constEnd()) {
+                FontStyle resolved{ -1, false, false, false, false };
+                if (fontInfo) {
+                    const GooString* fontName = fontInfo->getFontName();
+                    const QString family =
+                        fontName ? PdfTextEngine::normalizeFontName(QString::fromLatin1(fontName->c_str())) : QString();
+                    resolved.familyId = fonts->internFamily(family);
+                    // 许多字体没有设置描述符标志，再用字体名补充判断
+                    resolved.bold = fontInfo->isBold() || family.contains(QS("Bold"), Qt::CaseInsensitive);
+                    resolved.italic = fontInfo->isItalic() || family.contains(QS("Italic"), Qt::CaseInsensitive)
+                                      || family.contains(QS("Oblique"), Qt::CaseInsensitive);
+                    resolved.fixedPitch = fontInfo->isFixedWidth();
+                    resolved.serif = fontInfo->isSerif();
+                }
+                style = styles.insert(fontInfo, resolved);
+            }
+            font.familyId = style->familyId;
+            font.bold = style->bold;
+            font.italic = style->italic;
+            font.fixedPitch = style->fixedPitch;
+            font.serif = style->serif;
+            font.size = word->getFontSize();
+            double r, g, b;
+            word->getColor(&r, &g, &b);
+            font.color = qRgb(qRound(r * 255), qRound(g * 255), qRound(b * 255));
+            layout->fontIds.append(fonts->intern(font));
+
+            // 单词列表按阅读顺序排列，同一行内的单词由nextWord相连
+            if (previous && previous->nextWord() == word && !layout->lines.isEmpty()) {
+                Line& line = layout->lines.last();
+                line.boundingBox = line.boundingBox.united(boundingBox);
+                line.boxCount = boxIndex - line.firstBox + 1;
+                if (previous->hasSpaceAfter()) {
+                    lineText += QLatin1Char(' ');
+                }
+            } else {
+                if (!layout->lines.isEmpty()) {
+                    lineTexts.append(lineText);
+                    lineText.clear();
+                }
+                layout->lines.append(Line{boundingBox, boxIndex, 1});
+            }
+            lineText += boxText;
+            previous = word;
+        }
+        if (!layout->lines.isEmpty()) {
+            lineTexts.append(lineText);
+        }
+        layout->text = lineTexts.join(QLatin1Char('\n'));
+    } catch (const std::exception& e) {
+        qDebug() << "PdfTextLayoutCache: 分析页面文本时发生异常" << pageIndex + 1 << e.what();
+        layout->boxes.clear();
+        layout->lines.clear();
+        layout->fontIds.clear();
+        layout->text.clear();
+    }
+
+    return layout;
+}
+
+std::shared_ptr<PdfFontTable> PdfTextLayoutCache::fontTable(const std::shared_ptr<Poppler::Document>& document)
+{
+    QMutexLocker locker(&m_mutex);
+    for (int i = 0; i < m_fontTables.size();) {
+        const FontTableEntry& entry = m_fontTables.at(i);
+        if (entry.document.expired()) {
+            m_fontTables.removeAt(i);
+            continue;
+        }
+        if (sameDocument(entry.document, document)) {
+            return entry.table;
+        }
+        ++i;
+    }
+
+    FontTableEntry entry;
+    entry.document = document;
+    entry.table = std::make_shared<PdfFontTable>();
+    m_fontTables.append(entry);
+    return entry.table;
+}
+
+void PdfTextLayoutCache::setCapacity(int capacity)
+{
+    QMutexLocker locker(&m_mutex);
+    m_capacity = qMax(0, capacity);
+    evictLocked();
+}
+
+int PdfTextLayoutCache::capacity() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_capacity;
+}
+
+void PdfTextLayoutCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+    m_hits = 0;
+    m_misses = 0;
+}
+
+qint64 PdfTextLayoutCache::hitCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_hits;
+}
+
+qint64 PdfTextLayoutCache::missCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_misses;
+}
+
+PdfTextLayoutCache::LayoutPtr PdfTextLayoutCache::lookup(const std::shared_ptr<Poppler::Document>& document,
+                                                         int pageIndex)
+{
+    QMutexLocker locker(&m_mutex);
+    for (int i = 0; i < m_entries.size();) {
+        const Entry& entry = m_entries.at(i);
+        if (entry.document.expired()) {
+            // 文档已关闭，条目失效
+            m_entries.removeAt(i);
+            continue;
+        }
+        if (entry.pageIndex == pageIndex && sameDocument(entry.document, document)) {
+            m_entries.move(i, 0);
+            m_hits++;
+            return m_entries.first().layout;
+        }
+        ++i;
+    }
+    m_misses++;
+    return nullptr;
+}
+
+void PdfTextLayoutCache::store(const std::shared_ptr<Poppler::Document>& document, const LayoutPtr& layout)
+{
+    // 分析被截止时间中断时版面不完整，不能缓存
+    if (ProcessingDeadline::currentExpired()) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    if (m_capacity <= 0 || !layout) {
+        return;
+    }
+
+    for (int i = 0; i < m_entries.size(); ++i) {
+        const Entry& entry = m_entries.at(i);
+        if (entry.pageIndex == layout->pageIndex && sameDocument(entry.document, document)) {
+            // 其他调用方已经分析了同一页面
+            m_entries.removeAt(i);
+            break;
+        }
+    }
+
+    Entry entry;
+    entry.document = document;
+    entry.pageIndex = layout->pageIndex;
+    entry.layout = layout;
+    m_entries.prepend(entry);
+    evictLocked();
+}
+
+void PdfTextLayoutCache::evictLocked()
+{
+    while (m_entries.size() > m_capacity) {
+        m_entries.removeLast();
+    }
+}
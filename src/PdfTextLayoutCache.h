@@ -0,0 +1,179 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 18:30:00
+ * @LastEditTime: 2026-10-18 18:30:00
+ * @LastEditors: seelights
+ * @Description: PDF页面文本版面缓存
+ * @FilePath: \ReportMason\src\PdfTextLayoutCache.h
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <QList>
+#include <QMutex>
+#include <QRectF>
+#include <QString>
+#include <memory>
+#include <vector>
+
+namespace Poppler {
+class Document;
+class Page;
+class TextBox;
+}
+class PdfCoreDocument;
+class PdfFontTable;
+
+/**
+ * @brief PDF页面文本版面缓存
+ *
+ * 文本版面分析（Poppler::Page::textList）是最耗时的Poppler调用之一，
+ * 而同一页面的文本元素、表格单元格和图表关键词检测都需要它。
+ * 缓存以(文档, 页码)为键保存每页的分析结果：按阅读顺序排列的文本框、
+ * 由nextWord链划分的文本行以及拼接好的纯文本，各调用方通过shared_ptr借用同一份结果。
+ *
+ * 调用方提供核心文档时直接驱动TextOutputDev分析页面，版面同时带有每个单词的字体信息，
+ * 字体描述符驻留在文档级的PdfFontTable中，文本框只记录字体编号。
+ *
+ * 条目只对仍然存活的文档有效；超出容量时按最近最少使用淘汰，
+ * 借用者持有的版面不受淘汰影响，可在整个页面处理期间安全使用。
+ */
+class PdfTextLayoutCache
+{
+public:
+    /**
+     * @brief 文本行：layout.boxes中[firstBox, firstBox + boxCount)范围内的文本框
+     */
+    struct Line {
+        QRectF boundingBox;
+        int firstBox;
+        int boxCount;
+    };
+
+    /**
+     * @brief 单页文本版面（构建后不可变）
+     */
+    struct Layout {
+        int pageIndex;
+        std::vector<std::unique_ptr<Poppler::TextBox>> boxes; ///< 按阅读顺序排列的文本框
+        QList<Line> lines;                                     ///< 按阅读顺序排列的文本行
+        QString text;                                          ///< 行之间以换行分隔的纯文本
+        QList<int> fontIds;                                    ///< 与boxes一一对应的字体编号，没有字体信息时为空
+        std::shared_ptr<const PdfFontTable> fonts;             ///< 字体编号所在的文档级字体表
+
+        Layout();
+        ~Layout();
+
+        /**
+         * @brief 版面是否带有字体信息
+         */
+        bool hasFonts() const;
+    };
+
+    using LayoutPtr = std::shared_ptr<const Layout>;
+
+    /**
+     * @brief 获取全局实例
+     */
+    static PdfTextLayoutCache* instance();
+
+    /**
+     * @brief 借用页面版面，未命中时分析
+     * @param document 文档
+     * @param pageIndex 从0开始的页码
+     * @return 版面，页面无法加载时返回nullptr
+     */
+    LayoutPtr acquire(const std::shared_ptr<Poppler::Document>& document, int pageIndex);
+
+    /**
+     * @brief 借用页面版面，未命中时使用调用方已加载的页面分析
+     *
+     * 提供核心文档时版面带有字体信息；已缓存的版面没有字体信息时会重新分析并替换。
+     * @param document 文档
+     * @param page 已加载的页面
+     * @param pageIndex 从0开始的页码
+     * @param coreDocument 同一文件的核心文档，可为nullptr
+     * @return 版面
+     */
+    LayoutPtr acquire(const std::shared_ptr<Poppler::Document>& document, Poppler::Page* page, int pageIndex,
+                      PdfCoreDocument* coreDocument = nullptr);
+
+    /**
+     * @brief 分析页面版面（不经过缓存）
+     * @param page 页面
+     * @param pageIndex 从0开始的页码
+     * @return 版面
+     */
+    static LayoutPtr build(Poppler::Page* page, int pageIndex);
+
+    /**
+     * @brief 直接驱动TextOutputDev分析页面版面（不经过缓存），单词字体驻留到fonts中
+     * @param coreDocument 核心文档
+     * @param fonts 文档级字体表
+     * @param pageIndex 从0开始的页码
+     * @return 版面
+     */
+    static LayoutPtr build(PdfCoreDocument& coreDocument, const std::shared_ptr<PdfFontTable>& fonts, int pageIndex);
+
+    /**
+     * @brief 获取文档的字体表，同一文档的所有版面共用一张表
+     * @param document 文档
+     * @return 字体表
+     */
+    std::shared_ptr<PdfFontTable> fontTable(const std::shared_ptr<Poppler::Document>& document);
+
+    /**
+     * @brief 设置最多缓存的页面数量
+     * @param capacity 容量，0表示不缓存
+     */
+    void setCapacity(int capacity);
+
+    /**
+     * @brief 获取容量
+     */
+    int capacity() const;
+
+    /**
+     * @brief 清空缓存并重置统计
+     */
+    void clear();
+
+    qint64 hitCount() const;
+    qint64 missCount() const;
+
+private:
+    PdfTextLayoutCache();
+    PdfTextLayoutCache(const PdfTextLayoutCache&) = delete;
+    PdfTextLayoutCache& operator=(const PdfTextLayoutCache&) = delete;
+
+    /**
+     * @brief 缓存条目，document用于判断文档是否仍然存活（地址可能被新文档复用）
+     */
+    struct Entry {
+        std::weak_ptr<Poppler::Document> document;
+        int pageIndex;
+        LayoutPtr layout;
+    };
+
+    /**
+     * @brief 文档级字体表条目
+     */
+    struct FontTableEntry {
+        std::weak_ptr<Poppler::Document> document;
+        std::shared_ptr<PdfFontTable> table;
+    };
+
+    LayoutPtr lookup(const std::shared_ptr<Poppler::Document>& document, int pageIndex);
+    void store(const std::shared_ptr<Poppler::Document>& document, const LayoutPtr& layout);
+    void evictLocked();
+
+    static const int DEFAULT_CAPACITY = 16;
+
+    mutable QMutex m_mutex;
+    QList<Entry> m_entries; ///< 按使用时间排序，最近使用的在前
+    QList<FontTableEntry> m_fontTables;
+    int m_capacity;
+    qint64 m_hits;
+    qint64 m_misses;
+};
@@ -1,5 +1,9 @@
 #include "QtCompat.h"
 #include "PdfToXmlConverter.h"
+#include "PdfTextEngine.h"
+#include "PdfDocumentPool.h"
+#include "PdfFormReader.h"
+#include "PdfProbe.h"
 #include <QFile>
 #include <QFileInfo>
 #include <QDebug>
@@ -16,10 +20,6 @@
 // 静态常量定义
 const QStringList PdfToXmlConverter::SUPPORTED_EXTENSIONS = {QS("pdf")};
 
-const QRegularExpression PdfToXmlConverter::TEXT_PATTERN(QS(R"((?:BT\s+)(?:[^E]*?)(?:ET))"));
-const QRegularExpression PdfToXmlConverter::FORM_FIELD_PATTERN(QS(R"(\/T\s+\(([^)]+)\))"));
-const QRegularExpression PdfToXmlConverter::METADATA_PATTERN(QS(R"(\/([A-Za-z]+)\s+\(([^)]+)\))"));
-
 // 注意：PdfToXmlConverter专注于PDF到XML的无损转换
 // 实验报告字段识别功能应该在其他专门的类中实现
 
@@ -213,24 +213,27 @@ FileConverter::ConvertStatus PdfToXmlConverter::extractTextContent(const QString
                                                                    QString& textContent)
 {
     try {
-        // 读取PDF文件
-        QFile pdfFile(pdfPath);
-        if (!pdfFile.open(QIODevice::ReadOnly)) {
-            setLastError(QS("无法打开PDF文件"));
-            return ConvertStatus::FILE_NOT_FOUND;
-        }
-
-        QByteArray pdfData = pdfFile.readAll();
-        pdfFile.close();
-
-        if (pdfData.isEmpty()) {
-            setLastError(QS("PDF文件为空"));
-            return ConvertStatus::PARSE_ERROR;
-        }
-
-        // 提取文本内容
-        if (!extractTextFromPdfData(pdfData, textContent)) {
-            setLastError(QS("无法从PDF中提取文本内容"));
+        // 使用TextOutputDev逐页提取，不再把整个文件读入内存
+        PdfTextEngine engine;
+        if (!engine.open(pdfPath)) {
+            setLastError(engine.lastError());
+            return QFileInfo::exists(pdfPath) ? ConvertStatus::PARSE_ERROR
+                                              : ConvertStatus::FILE_NOT_FOUND;
+        }
+
+        textContent.clear();
+        const bool ok = engine.extractPages([&textContent](const PdfTextEngine::Page& page) {
+            const QString pageText = page.text();
+            if (!pageText.isEmpty()) {
+                if (!textContent.isEmpty()) {
+                    textContent += QS("\n\n");
+                }
+                textContent += pageText;
+            }
+            return true;
+        });
+        if (!ok) {
+            setLastError(QS("无法从PDF中提取文本内容: %1").arg(engine.lastError()));
             return ConvertStatus::PARSE_ERROR;
         }
 
@@ -253,31 +256,38 @@ FileConverter::ConvertStatus PdfToXmlConverter::extractFormFields(
     const QString& pdfPath, QMap<QString, FieldInfo>& formFields)
 {
     try {
-        // 读取PDF文件
-        QFile pdfFile(pdfPath);
-        if (!pdfFile.open(QIODevice::ReadOnly)) {
-            setLastError(QS("无法打开PDF文件"));
+        // 通过Poppler表单API读取AcroForm，只访问表单字典和控件注释
+        QString errorMessage;
+        std::shared_ptr<Poppler::Document> document = PdfDocumentPool::instance()->acquire(pdfPath, &errorMessage);
+        if (!document) {
+            setLastError(QS("无法打开PDF文件: %1").arg(errorMessage));
             return ConvertStatus::FILE_NOT_FOUND;
         }
 
-        QByteArray pdfData = pdfFile.readAll();
-        pdfFile.close();
-
-        // 简单的PDF表单字段提取（基于正则表达式）
-        QString pdfContent = QString::fromUtf8(pdfData);
-        QRegularExpressionMatchIterator matches = FORM_FIELD_PATTERN.globalMatch(pdfContent);
-
-        while (matches.hasNext()) {
-            QRegularExpressionMatch match = matches.next();
-            QString fieldName = match.captured(1);
+        const QList<PdfFormReader::Field> pdfFields = PdfFormReader::readFields(document);
+        for (const PdfFormReader::Field& pdfField : pdfFields) {
+            if (pdfField.name.isEmpty()) {
+                continue;
+            }
 
-            if (!fieldName.isEmpty()) {
-                FieldInfo field(fieldName);
-                field.description = QString(QS("PDF表单字段: %1")).arg(fieldName);
-                formFields[fieldName] = field;
+            FieldInfo field(pdfField.name, pdfField.value);
+            field.description = QString(QS("PDF表单字段: %1 [%2] 第%3页 (%4, %5, %6x%7)"))
+                                    .arg(pdfField.label.isEmpty() ? pdfField.name : pdfField.label)
+                                    .arg(PdfFormReader::typeName(pdfField.type))
+                                    .arg(pdfField.pageIndex + 1)
+                                    .arg(pdfField.rect.x(), 0, 'f', 1)
+                                    .arg(pdfField.rect.y(), 0, 'f', 1)
+                                    .arg(pdfField.rect.width(), 0, 'f', 1)
+                                    .arg(pdfField.rect.height(), 0, 'f', 1);
+            field.keywords.append(PdfFormReader::typeName(pdfField.type));
+            if (!pdfField.label.isEmpty()) {
+                field.keywords.append(pdfField.label);
             }
+            field.keywords.append(pdfField.options);
+            formFields[pdfField.name] = field;
         }
 
+        qDebug() << "PdfToXmlConverter: 读取到" << pdfFields.size() << "个表单字段";
         return ConvertStatus::SUCCESS;
     } catch (const std::exception& e) {
         setLastError(QString(QS("提取PDF表单字段时发生异常: %1")).arg(QString::fromUtf8(e.what())));
@@ -289,29 +299,29 @@ FileConverter::ConvertStatus PdfToXmlConverter::extractMetadata(const QString& p
                                                                 QMap<QString, QString>& metadata)
 {
     try {
-        // 读取PDF文件
-        QFile pdfFile(pdfPath);
-        if (!pdfFile.open(QIODevice::ReadOnly)) {
-            setLastError(QS("无法打开PDF文件"));
-            return ConvertStatus::FILE_NOT_FOUND;
+        // 只读取trailer、交叉引用表和Catalog/Info对象，耗时与文件大小无关
+        const PdfProbe::Result probe = PdfProbe::probe(pdfPath);
+        if (!probe.valid) {
+            setLastError(probe.error);
+            return probe.needsPassword ? ConvertStatus::PARSE_ERROR : ConvertStatus::FILE_NOT_FOUND;
         }
 
-        QByteArray pdfData = pdfFile.readAll();
-        pdfFile.close();
-
-        // 简单的PDF元数据提取
-        QString pdfContent = QString::fromUtf8(pdfData);
-        QRegularExpressionMatchIterator matches = METADATA_PATTERN.globalMatch(pdfContent);
-
-        while (matches.hasNext()) {
-            QRegularExpressionMatch match = matches.next();
-            QString key = match.captured(1);
-            QString value = match.captured(2);
-
-            if (!key.isEmpty() && !value.isEmpty()) {
-                metadata[key] = value;
+        for (auto it = probe.info.constBegin(); it != probe.info.constEnd(); ++it) {
+            if (!it.value().isEmpty()) {
+                metadata[it.key()] = it.value();
             }
         }
+        metadata[QS("PageCount")] = QString::number(probe.pageCount);
+        metadata[QS("Version")] = probe.version;
+        metadata[QS("Encrypted")] = probe.encrypted ? QS("true") : QS("false");
+        metadata[QS("Linearized")] = probe.linearized ? QS("true") : QS("false");
+        metadata[QS("Tagged")] = probe.tagged ? QS("true") : QS("false");
+        metadata[QS("HasForms")] = probe.hasForms ? QS("true") : QS("false");
+        metadata[QS("HasSignatures")] = probe.hasSignatures ? QS("true") : QS("false");
+        metadata[QS("HasText")] = probe.hasText ? QS("true") : QS("false");
+        if (!probe.xmpMetadata.isEmpty()) {
+            metadata[QS("XMP")] = probe.xmpMetadata;
+        }
 
         return ConvertStatus::SUCCESS;
     } catch (const std::exception& e) {
@@ -326,52 +336,6 @@ void PdfToXmlConverter::setExtractionOptions(bool preserveLayout, bool extractIm
     m_extractImages = extractImages;
 }
 
-bool PdfToXmlConverter::extractTextFromPdfData(const QByteArray& pdfData, QString& textContent)
-{
-    // 这是一个简化的PDF文本提取实现
-    // 在实际项目中，建议使用专门的PDF处理库如Poppler-Qt或MuPDF
-
-    QString pdfContent = QString::fromUtf8(pdfData);
-
-    // 查找文本流对象
-    QRegularExpressionMatchIterator matches = TEXT_PATTERN.globalMatch(pdfContent);
-
-    while (matches.hasNext()) {
-        QRegularExpressionMatch match = matches.next();
-        QString streamContent = match.captured(0);
-
-        // 简单的文本提取（实际PDF解析会更复杂）
-        if (streamContent.contains(QS("Tj")) || streamContent.contains(QS("TJ"))) {
-            // 提取文本内容
-            QString text = streamContent;
-            text.remove(QRegularExpression(QS(R"(BT\s+)")));
-            text.remove(QRegularExpression(QS(R"(\s+ET)")));
-            text.remove(QRegularExpression(QS("[^a-zA-Z0-9\\u4e00-\\u9fff\\s]")));
-            textContent += text + QS(" ");
-        }
-    }
-
-    // 如果上面的方法没有提取到文本，尝试更简单的方法
-    if (textContent.isEmpty()) {
-        // 提取PDF中可见的文本（这是一个非常简化的实现）
-        QRegularExpression simpleTextPattern(QS(R"(\(([^)]+)\))"));
-        QRegularExpressionMatchIterator simpleMatches = simpleTextPattern.globalMatch(pdfContent);
-
-        while (simpleMatches.hasNext()) {
-            QRegularExpressionMatch match = simpleMatches.next();
-            QString text = match.captured(1);
-
-            // 过滤掉明显不是文本的内容
-            if (text.length() > 1 && text.length() < 100 &&
-                !text.contains(QRegularExpression(QS(R"([0-9]+\.[0-9]+)")))) {
-                textContent += text + QS(" ");
-            }
-        }
-    }
-
-    return !textContent.isEmpty();
-}
-
 bool PdfToXmlConverter::parsePdfStream(const QByteArray& streamData, QString& textContent)
 {
     // 简化的PDF流解析
@@ -72,14 +72,6 @@ public:
     void setExtractionOptions(bool preserveLayout = true, bool extractImages = false);
 
 protected:
-    /**
-     * @brief 从PDF原始内容中提取文本（简单实现）
-     * @param pdfData PDF文件数据
-     * @param textContent 输出的文本内容
-     * @return 是否提取成功
-     */
-    bool extractTextFromPdfData(const QByteArray& pdfData, QString& textContent);
-
     /**
      * @brief 解析PDF流对象中的文本
      * @param streamData 流数据
@@ -164,11 +156,6 @@ private:
     // 当前处理的文件路径
     QString m_currentFilePath; ///< 当前处理的文件路径
 
-    // PDF文本提取的正则表达式模式
-    static const QRegularExpression TEXT_PATTERN;
-    static const QRegularExpression FORM_FIELD_PATTERN;
-    static const QRegularExpression METADATA_PATTERN;
-
     // 实验报告相关的字段识别模式
     // 注意：实验报告字段识别功能已移除，专注于PDF到XML的无损转换
 };
@@ -9,6 +9,31 @@
 #include <QDebug>
 #include <QLibrary>
 #include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <atomic>
+#include <mutex>
+
+#include <CharCodeToUnicode.h>
+#include <CMap.h>
+#include <Error.h>
+#include <GlobalParams.h>
+#include <GooString.h>
+
+#include "poppler-private.h"
+
+namespace {
+
+std::once_flag s_warmUpOnce;
+std::atomic_bool s_warmedUp{false};
+
+/// 字符集合：CID到Unicode映射在使用中文字体时几乎必然用到，Adobe-GB1放在最后使其位于缓存最前
+const char* const CID_COLLECTIONS[] = { "Adobe-Japan1", "Adobe-Korea1", "Adobe-CNS1", "Adobe-GB1" };
+
+/// 中文文档最常用的预定义CMap（CMap缓存只有4个条目）
+const char* const GB1_CMAPS[] = { "GB-EUC-H", "GBK-EUC-H", "UniGB-UTF16-H", "UniGB-UCS2-H" };
+
+} // namespace
 
 // 静态成员变量定义
 QString PopplerCompat::s_lastError;
@@ -119,3 +144,64 @@ void PopplerCompat::cleanupCompatibility()
 }
 
 QString PopplerCompat::getLastError() { return s_lastError; }
+
+void PopplerCompat::warmUp(bool background)
+{
+    if (s_warmedUp.load()) {
+        return;
+    }
+    if (background) {
+        QThreadPool::globalInstance()->start([]() { std::call_once(s_warmUpOnce, performWarmUp); });
+        return;
+    }
+    std::call_once(s_warmUpOnce, performWarmUp);
+}
+
+bool PopplerCompat::isWarmedUp()
+{
+    return s_warmedUp.load();
+}
+
+void PopplerCompat::performWarmUp()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    try {
+        // 有意不释放：在进程生命周期内保持globalParams存活，
+        // 也避免与poppler内部静态对象的析构顺序问题。
+        // poppler只在第一个GlobalParamsIniter构造时设置错误回调，此后各加载器传入的回调都不再生效，
+        // 因此这里使用Poppler::Document同样安装的回调，错误照常经由Poppler::setDebugErrorFunction输出
+        new GlobalParamsIniter(Poppler::qt6ErrorFunction);
+
+        // 建立基础14字体到系统字体文件的映射（Windows下扫描系统字体目录，fontconfig下由其负责）
+        globalParams->setupBaseFonts(nullptr);
+
+        // 文本提取使用的UTF-8输出映射
+        globalParams->getUtf8Map();
+        globalParams->getTextEncoding();
+
+        for (const char* collectionName : CID_COLLECTIONS) {
+            const GooString collection(collectionName);
+            if (CharCodeToUnicode* ctu = globalParams->getCIDToUnicode(&collection)) {
+                // 缓存保留自己的引用
+                ctu->decRefCnt();
+            }
+        }
+
+        const GooString gb1(CID_COLLECTIONS[3]);
+        int cMapCount = 0;
+        for (const char* cMapName : GB1_CMAPS) {
+            const GooString name(cMapName);
+            if (globalParams->getCMap(&gb1, &name)) {
+                ++cMapCount;
+            }
+        }
+
+        qDebug() << "PopplerCompat: 预热完成，CMap" << cMapCount << "个，耗时" << timer.elapsed() << "ms";
+    } catch (const std::exception& e) {
+        qDebug() << "PopplerCompat: 预热时发生异常" << e.what();
+    }
+
+    s_warmedUp.store(true);
+}
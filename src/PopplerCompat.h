@@ -53,7 +53,26 @@ public:
      */
     static QString getLastError();
 
+    /**
+     * @brief 进程级预热：初始化globalParams并预加载常用的字体映射和CMap
+     *
+     * globalParams由各文档持有的GlobalParamsIniter引用计数，最后一个文档关闭时即被释放，
+     * 下一个文档要重新扫描系统字体、重建CMap和Unicode映射缓存。
+     * 预热在进程生命周期内持有一个引用，并提前完成这些一次性工作，
+     * 首次转换不再比后续转换慢数倍。整个进程只执行一次，重复调用立即返回；
+     * 预热正在后台进行时，同步调用会等待其完成。
+     * @param background 为true时在全局线程池中执行并立即返回
+     */
+    static void warmUp(bool background = false);
+
+    /**
+     * @brief 预热是否已经完成
+     */
+    static bool isWarmedUp();
+
 private:
+    static void performWarmUp();
+
     static QString s_lastError;
     static bool s_initialized;
     static bool s_popplerAvailable;
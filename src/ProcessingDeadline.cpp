@@ -0,0 +1,77 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 23:30:00
+ * @LastEditTime: 2026-10-18 23:30:00
+ * @LastEditors: seelights
+ * @Description: 文档/页面处理的时间预算与协作式取消实现
+ * @FilePath: \ReportMason\src\ProcessingDeadline.cpp
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#include "ProcessingDeadline.h"
+
+namespace {
+
+/// 当前线程的活动截止时间
+thread_local const ProcessingDeadline *t_current = nullptr;
+
+} // namespace
+
+ProcessingDeadline::ProcessingDeadline(qint64 budgetMs, const std::atomic_bool *cancelFlag)
+    : m_deadline(budgetMs > 0 ? QDeadlineTimer(budgetMs) : QDeadlineTimer(QDeadlineTimer::Forever)),
+      m_budgetMs(qMax<qint64>(budgetMs, 0)),
+      m_cancelFlag(cancelFlag)
+{
+    m_elapsed.start();
+}
+
+ProcessingDeadline::ProcessingDeadline(qint64 budgetMs, const ProcessingDeadline &parent)
+    : ProcessingDeadline(budgetMs, parent.m_cancelFlag)
+{
+    // 不晚于上级截止时间
+    if (parent.m_deadline < m_deadline) {
+        m_deadline = parent.m_deadline;
+    }
+}
+
+bool ProcessingDeadline::hasExpired() const
+{
+    return isCancelled() || m_deadline.hasExpired();
+}
+
+bool ProcessingDeadline::isCancelled() const
+{
+    return m_cancelFlag && m_cancelFlag->load(std::memory_order_relaxed);
+}
+
+ProcessingDeadline::Scope::Scope(const ProcessingDeadline &deadline) : m_previous(t_current)
+{
+    t_current = &deadline;
+}
+
+ProcessingDeadline::Scope::~Scope()
+{
+    t_current = m_previous;
+}
+
+const ProcessingDeadline *ProcessingDeadline::current()
+{
+    return t_current;
+}
+
+bool ProcessingDeadline::currentExpired()
+{
+    return t_current && t_current->hasExpired();
+}
+
+bool ProcessingDeadline::abortCheck(void *data)
+{
+    const ProcessingDeadline *deadline = data ? static_cast<const ProcessingDeadline *>(data) : t_current;
+    return deadline && deadline->hasExpired();
+}
+
+bool ProcessingDeadline::shouldAbort(const QVariant &closure)
+{
+    Q_UNUSED(closure);
+    return currentExpired();
+}
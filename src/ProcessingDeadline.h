@@ -0,0 +1,109 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-18 23:30:00
+ * @LastEditTime: 2026-10-18 23:30:00
+ * @LastEditors: seelights
+ * @Description: 文档/页面处理的时间预算与协作式取消
+ * @FilePath: \ReportMason\src\ProcessingDeadline.h
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <QDeadlineTimer>
+#include <QElapsedTimer>
+#include <QVariant>
+#include <atomic>
+
+/**
+ * @brief 处理截止时间
+ *
+ * 页面截止时间由文档截止时间派生，不会晚于文档截止时间，并共享文档的取消标志。
+ * 截止时间不会强行终止任何操作，而是由各处理环节协作检查：
+ * 提取循环调用currentExpired()，内容流解释通过Poppler的abortCheckCbk（abortCheck）、
+ * Qt层渲染和文本提取通过ShouldAbortQueryFunc（shouldAbort）在每批操作符之间检查。
+ * Scope把截止时间设为当前线程的活动截止时间，被调用的模块无需修改接口即可检查。
+ */
+class ProcessingDeadline
+{
+public:
+    /**
+     * @brief 创建文档级截止时间
+     * @param budgetMs 时间预算（毫秒），小于等于0表示不限时
+     * @param cancelFlag 外部取消标志，为true时视为已超时；可以为空
+     */
+    explicit ProcessingDeadline(qint64 budgetMs, const std::atomic_bool *cancelFlag = nullptr);
+
+    /**
+     * @brief 创建从属于parent的截止时间（例如页面截止时间）
+     * @param budgetMs 时间预算（毫秒），小于等于0表示只受parent约束
+     * @param parent 上级截止时间
+     */
+    ProcessingDeadline(qint64 budgetMs, const ProcessingDeadline &parent);
+
+    ProcessingDeadline(const ProcessingDeadline &) = delete;
+    ProcessingDeadline &operator=(const ProcessingDeadline &) = delete;
+
+    /**
+     * @brief 是否已超时或已被取消
+     */
+    bool hasExpired() const;
+
+    /**
+     * @brief 是否已被取消
+     */
+    bool isCancelled() const;
+
+    /**
+     * @brief 自身的时间预算（毫秒），不限时为0
+     */
+    qint64 budget() const { return m_budgetMs; }
+
+    /**
+     * @brief 创建以来经过的时间（毫秒）
+     */
+    qint64 elapsed() const { return m_elapsed.elapsed(); }
+
+    /**
+     * @brief 在作用域内把截止时间设为当前线程的活动截止时间，作用域结束时恢复上一个
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(const ProcessingDeadline &deadline);
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        const ProcessingDeadline *m_previous;
+    };
+
+    /**
+     * @brief 当前线程的活动截止时间，没有时为空
+     */
+    static const ProcessingDeadline *current();
+
+    /**
+     * @brief 当前线程的活动截止时间是否已到期，没有活动截止时间时为false
+     */
+    static bool currentExpired();
+
+    /**
+     * @brief Poppler核心的abortCheckCbk回调（PDFDoc::displayPage）
+     * @param data 截止时间指针，为空时检查当前线程的活动截止时间
+     */
+    static bool abortCheck(void *data);
+
+    /**
+     * @brief Poppler Qt的ShouldAbortQueryFunc回调，检查当前线程的活动截止时间
+     */
+    static bool shouldAbort(const QVariant &closure);
+
+private:
+    QDeadlineTimer m_deadline;
+    QElapsedTimer m_elapsed;
+    qint64 m_budgetMs;
+    const std::atomic_bool *m_cancelFlag;
+};
@@ -0,0 +1,154 @@
+/*
+ * @Author: seelights
+ * @Date: 2026-10-19 03:10:00
+ * @LastEditTime: 2026-10-19 03:10:00
+ * @LastEditors: seelights
+ * @Description: 分阶段流水线与直接转换的输出一致性测试
+ * @FilePath: \ReportMason\tests\DocumentPipelineTest.cpp
+ * Copyright (c) 2025 by seelights@git.cn, All Rights Reserved.
+ */
+
+#include "DocumentPipeline.h"
+#include "KZipUtils.h"
+#include "LosslessDocumentConverter.h"
+#include "QtCompat.h"
+#include <QFont>
+#include <QMutex>
+#include <QPainter>
+#include <QPdfWriter>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+#include <QtTest>
+
+/**
+ * @brief 流水线输出必须与LosslessDocumentConverter直接转换逐字节一致
+ *
+ * 两次转换之间只有生成时间和元素ID中的时间戳不同，比较前把它们替换为固定值。
+ */
+class DocumentPipelineTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void pipelineMatchesDirectConversion_data();
+    void pipelineMatchesDirectConversion();
+
+private:
+    static QByteArray normalized(QByteArray xml);
+    QByteArray runPipeline(const QString& filePath);
+
+    QTemporaryDir m_dir;
+    QString m_pdfPath;
+    QString m_docxPath;
+};
+
+void DocumentPipelineTest::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+
+    // 两种字体的文本，直接转换的输出带有Fonts字体表
+    m_pdfPath = m_dir.filePath(QS("fonts.pdf"));
+    {
+        QPdfWriter writer(m_pdfPath);
+        writer.setResolution(72);
+        QPainter painter(&writer);
+        QFont serif(QS("Times"), 14);
+        serif.setStyleHint(QFont::Serif);
+        painter.setFont(serif);
+        painter.drawText(72, 96, QS("Quarterly report"));
+        QFont sans(QS("Helvetica"), 10);
+        sans.setStyleHint(QFont::SansSerif);
+        sans.setBold(true);
+        painter.setFont(sans);
+        painter.drawText(72, 140, QS("Revenue grew in every region."));
+        writer.newPage();
+        painter.setFont(serif);
+        painter.drawText(72, 96, QS("Appendix"));
+    }
+
+    m_docxPath = m_dir.filePath(QS("report.docx"));
+    QMap<QString, QByteArray> parts;
+    parts.insert(QS("[Content_Types].xml"),
+                 "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>"
+                 "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\">"
+                 "<Default Extension=\"rels\" ContentType=\"application/vnd.openxmlformats-package.relationships+xml\"/>"
+                 "<Default Extension=\"xml\" ContentType=\"application/xml\"/>"
+                 "<Override PartName=\"/word/document.xml\" "
+                 "ContentType=\"application/vnd.openxmlformats-officedocument.wordprocessingml.document.main+xml\"/>"
+                 "</Types>");
+    parts.insert(QS("_rels/.rels"),
+                 "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>"
+                 "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+                 "<Relationship Id=\"rId1\" "
+                 "Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/officeDocument\" "
+                 "Target=\"word/document.xml\"/>"
+                 "</Relationships>");
+    parts.insert(QS("word/document.xml"),
+                 "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>"
+                 "<w:document xmlns:w=\"http://schemas.openxmlformats.org/wordprocessingml/2006/main\"><w:body>"
+                 "<w:p><w:r><w:rPr><w:b/></w:rPr><w:t>Quarterly report</w:t></w:r></w:p>"
+                 "<w:p><w:r><w:t>Revenue grew in every region.</w:t></w:r></w:p>"
+                 "<w:tbl><w:tr><w:tc><w:p><w:r><w:t>Q1</w:t></w:r></w:p></w:tc></w:tr></w:tbl>"
+                 "</w:body></w:document>");
+    QVERIFY(KZipUtils::createZip(m_docxPath, parts));
+}
+
+void DocumentPipelineTest::pipelineMatchesDirectConversion_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::newRow("pdf") << QS("fonts.pdf");
+    QTest::newRow("docx") << QS("report.docx");
+}
+
+void DocumentPipelineTest::pipelineMatchesDirectConversion()
+{
+    QFETCH(QString, fileName);
+    const QString filePath = m_dir.filePath(fileName);
+
+    LosslessDocumentConverter converter;
+    const QByteArray direct = converter.convertToLosslessXmlByteArray(filePath);
+    QVERIFY(!direct.isEmpty());
+
+    const QByteArray staged = runPipeline(filePath);
+    QVERIFY(!staged.isEmpty());
+
+    if (fileName.endsWith(QS(".pdf"))) {
+        QVERIFY(direct.contains("<Fonts>"));
+    }
+    QCOMPARE(normalized(staged), normalized(direct));
+}
+
+QByteArray DocumentPipelineTest::normalized(QByteArray xml)
+{
+    QString text = QString::fromUtf8(xml);
+    text.replace(QRegularExpression(QS("created=\"[^\"]*\"")), QS("created=\"\""));
+    // 元素ID格式为 类型_毫秒时间戳_序号
+    text.replace(QRegularExpression(QS("([a-z]+)_\\d+_(\\d+)")), QS("\\1_0_\\2"));
+    return text.toUtf8();
+}
+
+QByteArray DocumentPipelineTest::runPipeline(const QString& filePath)
+{
+    DocumentPipeline pipeline;
+    QMutex mutex;
+    QByteArray xml;
+    // 信号在流水线线程中发出
+    connect(&pipeline, &DocumentPipeline::documentFinished, this,
+            [&mutex, &xml](const DocumentPipeline::Result& result) {
+                QMutexLocker locker(&mutex);
+                if (result.status == LosslessDocumentConverter::ConvertStatus::SUCCESS) {
+                    xml = result.xml;
+                }
+            },
+            Qt::DirectConnection);
+
+    if (!pipeline.start({{filePath, QString()}}) || !pipeline.waitForFinished(60000)) {
+        return QByteArray();
+    }
+    QMutexLocker locker(&mutex);
+    return xml;
+}
+
+QTEST_MAIN(DocumentPipelineTest)
+#include "DocumentPipelineTest.moc"
@@ -10,12 +10,15 @@
 
 #include "DocxImageExtractor.h"
 #include "QtCompat.h"
+#include "../../src/OoxmlTags.h"
 #include <QFileInfo>
 #include <QDir>
 #include <QXmlStreamReader>
 #include <QXmlStreamWriter>
 #include <QDateTime>
 #include <QStandardPaths>
+#include <QBuffer>
+#include <QImageReader>
 
 // 静态常量定义
 const QStringList DocxImageExtractor::SUPPORTED_EXTENSIONS = {QS("docx")};
@@ -47,11 +50,26 @@ ImageExtractor::ExtractStatus DocxImageExtractor::extractImages(const QString& f
     }
     
     try {
-        // 读取document.xml
-        QByteArray documentXml;
-        if (!KZipUtils::readFileFromZip(filePath, DOCX_DOCUMENT_PATH, documentXml)) {
+        // 一次打开压缩包读取document.xml和关系文件
+        QMap<QString, QByteArray> parts;
+        QMap<QString, KZipUtils::EntryInfo> entries;
+        // 关系文件按中央目录中的(CRC32, 大小)命中部件缓存时不再解压和解析
+        DocxPartCache* partCache = DocxPartCache::instance();
+        QMap<QString, QString> imageRelationships;
+        bool relationshipsCached = false;
+        const auto skipCachedRelationships = [partCache, &imageRelationships, &relationshipsCached](const KZipUtils::EntryInfo& entry) {
+            if (entry.path != DOCX_RELATIONSHIPS_PATH) {
+                return false;
+            }
+            relationshipsCached = partCache->lookupRelationships(DocxPartCache::PartKey(entry), imageRelationships);
+            return relationshipsCached;
+        };
+        if (!KZipUtils::readFilesFromZip(filePath, {DOCX_DOCUMENT_PATH, DOCX_RELATIONSHIPS_PATH}, parts, false, &entries,
+                                         skipCachedRelationships) ||
+            !parts.contains(DOCX_DOCUMENT_PATH)) {
             return ExtractStatus::FILE_NOT_FOUND;
         }
+        const QByteArray documentXml = parts.value(DOCX_DOCUMENT_PATH);
         
         // 提取图片引用
         QList<QString> imageRefs = extractImageReferences(documentXml);
@@ -60,22 +78,36 @@ ImageExtractor::ExtractStatus DocxImageExtractor::extractImages(const QString& f
         }
         
         // 提取位置信息
-        QMap<QString, QRect> positions = extractImagePositions(filePath, imageRefs);
+        QMap<QString, QRect> positions = extractImagePositions(documentXml, imageRefs);
         
-        // 读取关系文件
-        QByteArray relationshipsXml;
-        if (!KZipUtils::readFileFromZip(filePath, DOCX_RELATIONSHIPS_PATH, relationshipsXml)) {
-            return ExtractStatus::PARSE_ERROR;
+        // 解析关系文件
+        if (!relationshipsCached) {
+            if (!parts.contains(DOCX_RELATIONSHIPS_PATH)) {
+                return ExtractStatus::PARSE_ERROR;
+            }
+            imageRelationships = parseImageRelationships(parts.value(DOCX_RELATIONSHIPS_PATH));
+            partCache->storeRelationships(DocxPartCache::PartKey(entries.value(DOCX_RELATIONSHIPS_PATH)), imageRelationships);
         }
-        QMap<QString, QString> imageRelationships = parseImageRelationships(relationshipsXml);
+        
+        // 收集所有图片路径后批量读取，避免每张图片重新打开压缩包
+        QStringList imagePaths;
+        for (const QString& imageRef : imageRefs) {
+            QString imagePath = imageRelationships.value(imageRef);
+            if (!imagePath.isEmpty() && !imagePaths.contains(QS("word/") + imagePath)) {
+                imagePaths.append(QS("word/") + imagePath);
+            }
+        }
+        QMap<QString, QByteArray> imageDataMap;
+        KZipUtils::readFilesFromZip(filePath, imagePaths, imageDataMap, true);
         
         // 提取图片数据
         for (const QString& imageRef : imageRefs) {
             QString imagePath = imageRelationships.value(imageRef);
             if (!imagePath.isEmpty()) {
-                QByteArray imageData;
-                if (KZipUtils::readFileFromZip(filePath, QS("word/") + imagePath, imageData)) {
-                    ImageInfo imageInfo = createImageInfoFromData(imageData, imagePath, positions.value(imageRef));
+                auto it = imageDataMap.constFind(QS("word/") + imagePath);
+                if (it != imageDataMap.constEnd()) {
+                    const DocxPartCache::PartKey imageKey(entries.value(it.key()));
+                    ImageInfo imageInfo = createImageInfoFromData(it.value(), imagePath, positions.value(imageRef), imageKey);
                     if (!imageInfo.originalPath.isEmpty()) {
                         images.append(imageInfo);
                     }
@@ -99,8 +131,8 @@ QList<QString> DocxImageExtractor::extractImageReferences(const QByteArray& docu
         reader.readNext();
         
         if (reader.isStartElement()) {
-            QString elementName = reader.name().toString();
-            if (elementName == QS("blip") || elementName == QS("pic")) {
+            const OoxmlTag tag = OoxmlTags::lookup(reader.name());
+            if (tag == OoxmlTag::Blip || tag == OoxmlTag::Pic) {
                 QString rId = reader.attributes().value(QS("r:embed")).toString();
                 if (!rId.isEmpty()) {
                     imageRefs.append(rId);
@@ -112,31 +144,27 @@ QList<QString> DocxImageExtractor::extractImageReferences(const QByteArray& docu
     return imageRefs;
 }
 
-QMap<QString, QRect> DocxImageExtractor::extractImagePositions(const QString& zipPath, const QStringList& imageRefs) const
+QMap<QString, QRect> DocxImageExtractor::extractImagePositions(const QByteArray& documentXml, const QStringList& imageRefs) const
 {
     QMap<QString, QRect> positions;
     
     try {
-        QByteArray documentXml;
-        if (!KZipUtils::readFileFromZip(zipPath, DOCX_DOCUMENT_PATH, documentXml)) {
-            return positions;
-        }
-        
         QXmlStreamReader reader(documentXml);
+        OoxmlNamespaceTable namespaces;
         int imageIndex = 0;
         
         while (!reader.atEnd() && imageIndex < imageRefs.size()) {
             reader.readNext();
             
             if (reader.isStartElement()) {
-                QString elementName = reader.name().toString();
-                QString namespaceUri = reader.namespaceUri().toString();
+                const OoxmlTag tag = OoxmlTags::lookup(reader.name());
+                const OoxmlNamespace ns = namespaces.resolve(reader.namespaceUri());
                 
-                if (elementName == QS("anchor") && namespaceUri.contains(QS("wp"))) {
+                if (tag == OoxmlTag::Anchor && ns == OoxmlNamespace::WordprocessingDrawing) {
                     QRect position = parseAnchorPosition(reader);
                     positions.insert(imageRefs[imageIndex], position);
                     imageIndex++;
-                } else if (elementName == QS("inline") && namespaceUri.contains(QS("wp"))) {
+                } else if (tag == OoxmlTag::Inline && ns == OoxmlNamespace::WordprocessingDrawing) {
                     QRect position = parseInlinePosition(reader);
                     positions.insert(imageRefs[imageIndex], position);
                     imageIndex++;
@@ -158,31 +186,31 @@ QRect DocxImageExtractor::parseAnchorPosition(QXmlStreamReader& reader) const
     while (!reader.atEnd()) {
         reader.readNext();
         
-        if (reader.isEndElement() && reader.name().toString() == QS("anchor")) {
+        if (reader.isEndElement() && OoxmlTags::lookup(reader.name()) == OoxmlTag::Anchor) {
             break;
         }
         
         if (reader.isStartElement()) {
-            QString elementName = reader.name().toString();
+            const OoxmlTag tag = OoxmlTags::lookup(reader.name());
             
-            if (elementName == QS("simplePos")) {
+            if (tag == OoxmlTag::SimplePos) {
                 QString x = reader.attributes().value(QS("x")).toString();
                 QString y = reader.attributes().value(QS("y")).toString();
                 if (!x.isEmpty() && !y.isEmpty()) {
                     position.setX(emuToPixels(x.toLongLong()));
                     position.setY(emuToPixels(y.toLongLong()));
                 }
-            } else if (elementName == QS("positionH")) {
+            } else if (tag == OoxmlTag::PositionH) {
                 QString posOffset = reader.attributes().value(QS("posOffset")).toString();
                 if (!posOffset.isEmpty()) {
                     position.setX(emuToPixels(posOffset.toLongLong()));
                 }
-            } else if (elementName == QS("positionV")) {
+            } else if (tag == OoxmlTag::PositionV) {
                 QString posOffset = reader.attributes().value(QS("posOffset")).toString();
                 if (!posOffset.isEmpty()) {
                     position.setY(emuToPixels(posOffset.toLongLong()));
                 }
-            } else if (elementName == QS("extent")) {
+            } else if (tag == OoxmlTag::Extent) {
                 QString cx = reader.attributes().value(QS("cx")).toString();
                 QString cy = reader.attributes().value(QS("cy")).toString();
                 if (!cx.isEmpty() && !cy.isEmpty()) {
@@ -203,14 +231,14 @@ QRect DocxImageExtractor::parseInlinePosition(QXmlStreamReader& reader) const
     while (!reader.atEnd()) {
         reader.readNext();
         
-        if (reader.isEndElement() && reader.name().toString() == QS("inline")) {
+        if (reader.isEndElement() && OoxmlTags::lookup(reader.name()) == OoxmlTag::Inline) {
             break;
         }
         
         if (reader.isStartElement()) {
-            QString elementName = reader.name().toString();
+            const OoxmlTag tag = OoxmlTags::lookup(reader.name());
             
-            if (elementName == QS("extent")) {
+            if (tag == OoxmlTag::Extent) {
                 QString cx = reader.attributes().value(QS("cx")).toString();
                 QString cy = reader.attributes().value(QS("cy")).toString();
                 if (!cx.isEmpty() && !cy.isEmpty()) {
@@ -231,14 +259,14 @@ QRect DocxImageExtractor::parseDrawingPosition(QXmlStreamReader& reader) const
     while (!reader.atEnd()) {
         reader.readNext();
         
-        if (reader.isEndElement() && reader.name().toString() == QS("drawing")) {
+        if (reader.isEndElement() && OoxmlTags::lookup(reader.name()) == OoxmlTag::Drawing) {
             break;
         }
         
         if (reader.isStartElement()) {
-            QString elementName = reader.name().toString();
+            const OoxmlTag tag = OoxmlTags::lookup(reader.name());
             
-            if (elementName == QS("posOffset")) {
+            if (tag == OoxmlTag::PosOffset) {
                 QString value = reader.readElementText();
                 if (!value.isEmpty()) {
                     bool ok;
@@ -253,7 +281,7 @@ QRect DocxImageExtractor::parseDrawingPosition(QXmlStreamReader& reader) const
                         }
                     }
                 }
-            } else if (elementName == QS("extent")) {
+            } else if (tag == OoxmlTag::Extent) {
                 QString cx = reader.attributes().value(QS("cx")).toString();
                 QString cy = reader.attributes().value(QS("cy")).toString();
                 if (!cx.isEmpty() && !cy.isEmpty()) {
@@ -270,21 +298,22 @@ QRect DocxImageExtractor::parseDrawingPosition(QXmlStreamReader& reader) const
 QRect DocxImageExtractor::parseDrawingPositionNew(QXmlStreamReader& reader) const
 {
     QRect position(0, 0, 100, 100); // 默认位置和尺寸
+    OoxmlNamespaceTable namespaces;
     
     while (!reader.atEnd()) {
         reader.readNext();
         
-        if (reader.isEndElement() && reader.name().toString() == QS("drawing")) {
+        if (reader.isEndElement() && OoxmlTags::lookup(reader.name()) == OoxmlTag::Drawing) {
             break;
         }
         
         if (reader.isStartElement()) {
-            QString elementName = reader.name().toString();
-            QString namespaceUri = reader.namespaceUri().toString();
+            const OoxmlTag tag = OoxmlTags::lookup(reader.name());
+            const OoxmlNamespace ns = namespaces.resolve(reader.namespaceUri());
             
-            if (elementName == QS("anchor") && namespaceUri.contains(QS("wp"))) {
+            if (tag == OoxmlTag::Anchor && ns == OoxmlNamespace::WordprocessingDrawing) {
                 return parseAnchorPosition(reader);
-            } else if (elementName == QS("inline") && namespaceUri.contains(QS("wp"))) {
+            } else if (tag == OoxmlTag::Inline && ns == OoxmlNamespace::WordprocessingDrawing) {
                 return parseInlinePosition(reader);
             }
         }
@@ -300,29 +329,29 @@ QRect DocxImageExtractor::parsePictPosition(QXmlStreamReader& reader) const
     while (!reader.atEnd()) {
         reader.readNext();
         
-        if (reader.isEndElement() && reader.name().toString() == QS("pict")) {
+        if (reader.isEndElement() && OoxmlTags::lookup(reader.name()) == OoxmlTag::Pict) {
             break;
         }
         
         if (reader.isStartElement()) {
-            QString elementName = reader.name().toString();
+            const OoxmlTag tag = OoxmlTags::lookup(reader.name());
             
-            if (elementName == QS("left")) {
+            if (tag == OoxmlTag::Left) {
                 QString value = reader.readElementText();
                 if (!value.isEmpty()) {
                     position.setX(value.toInt());
                 }
-            } else if (elementName == QS("top")) {
+            } else if (tag == OoxmlTag::Top) {
                 QString value = reader.readElementText();
                 if (!value.isEmpty()) {
                     position.setY(value.toInt());
                 }
-            } else if (elementName == QS("width")) {
+            } else if (tag == OoxmlTag::Width) {
                 QString value = reader.readElementText();
                 if (!value.isEmpty()) {
                     position.setWidth(value.toInt());
                 }
-            } else if (elementName == QS("height")) {
+            } else if (tag == OoxmlTag::Height) {
                 QString value = reader.readElementText();
                 if (!value.isEmpty()) {
                     position.setHeight(value.toInt());
@@ -342,7 +371,7 @@ QMap<QString, QString> DocxImageExtractor::parseImageRelationships(const QByteAr
     while (!reader.atEnd()) {
         reader.readNext();
         
-        if (reader.isStartElement() && reader.name().toString() == QS("Relationship")) {
+        if (reader.isStartElement() && OoxmlTags::lookup(reader.name()) == OoxmlTag::Relationship) {
             QString id = reader.attributes().value(QS("Id")).toString();
             QString target = reader.attributes().value(QS("Target")).toString();
             QString type = reader.attributes().value(QS("Type")).toString();
@@ -357,7 +386,8 @@ QMap<QString, QString> DocxImageExtractor::parseImageRelationships(const QByteAr
     return relationships;
 }
 
-ImageInfo DocxImageExtractor::createImageInfoFromData(const QByteArray& imageData, const QString& imagePath, const QRect& position)
+ImageInfo DocxImageExtractor::createImageInfoFromData(const QByteArray& imageData, const QString& imagePath, const QRect& position,
+                                                      const DocxPartCache::PartKey& partKey)
 {
     ImageInfo imageInfo;
     imageInfo.originalPath = imagePath;
@@ -366,9 +396,16 @@ ImageInfo DocxImageExtractor::createImageInfoFromData(const QByteArray& imageDat
     imageInfo.format = QFileInfo(imagePath).suffix().toLower();
     imageInfo.isEmbedded = true;
     
-    // 获取图片尺寸
-    QSize imageSize = getImageSize(imageData);
-    imageInfo.size = imageSize;
+    // 获取图片尺寸，相同的图片部件（如学校标志）只探测一次
+    DocxPartCache::ImageMeta meta;
+    if (DocxPartCache::instance()->lookupImageMeta(partKey, meta)) {
+        imageInfo.size = meta.size;
+    } else {
+        imageInfo.size = getImageSize(imageData);
+        meta.size = imageInfo.size;
+        meta.format = imageInfo.format;
+        DocxPartCache::instance()->storeImageMeta(partKey, meta);
+    }
     
     // 生成唯一ID
     imageInfo.id = QS("img_") + QString::number(QDateTime::currentMSecsSinceEpoch()) + QS("_") + QString::number(qHash(imagePath));
@@ -390,9 +427,16 @@ ImageInfo DocxImageExtractor::createImageInfoFromData(const QByteArray& imageDat
 
 QSize DocxImageExtractor::getImageSize(const QByteArray& imageData) const
 {
-    // 简单的图片尺寸获取，实际项目中可能需要更复杂的解析
-    // 这里返回默认尺寸，实际使用时可以集成图片库来获取真实尺寸
-    return QSize(100, 100);
+    // 只读取图片头部获取尺寸，不解码像素数据
+    QBuffer buffer;
+    buffer.setData(imageData);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer);
+    QSize size = reader.size();
+    if (!size.isValid()) {
+        return QSize(100, 100);
+    }
+    return size;
 }
 
 int DocxImageExtractor::emuToPixels(qint64 emu) const
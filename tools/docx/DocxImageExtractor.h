@@ -12,6 +12,7 @@
 
 #include "../base/ImageExtractor.h"
 #include "../../src/KZipUtils.h"
+#include "../../src/DocxPartCache.h"
 #include <QXmlStreamReader>
 #include <QXmlStreamWriter>
 
@@ -155,17 +156,19 @@ protected:
      * @param imageData 图片数据
      * @param imagePath 图片路径
      * @param position 图片位置
+     * @param partKey 图片部件在压缩包中的缓存键，有效时优先使用部件缓存中的尺寸
      * @return 图片信息
      */
-    ImageInfo createImageInfoFromData(const QByteArray &imageData, const QString &imagePath, const QRect &position = QRect());
+    ImageInfo createImageInfoFromData(const QByteArray &imageData, const QString &imagePath, const QRect &position = QRect(),
+                                      const DocxPartCache::PartKey &partKey = DocxPartCache::PartKey());
 
     /**
      * @brief 从DOCX文档中提取图片位置信息
-     * @param zipPath ZIP文件路径
+     * @param documentXml document.xml内容
      * @param imageRefs 图片引用列表
      * @return 图片位置映射
      */
-    QMap<QString, QRect> extractImagePositions(const QString &zipPath, const QStringList &imageRefs) const;
+    QMap<QString, QRect> extractImagePositions(const QByteArray &documentXml, const QStringList &imageRefs) const;
 
     /**
      * @brief 解析drawing元素获取位置信息
@@ -11,6 +11,7 @@
 #include "QtCompat.h"
 #include "DocxTableExtractor.h"
 #include "../utils/ContentUtils.h"
+#include "../../src/OoxmlTags.h"
 #include <QFileInfo>
 #include <QDebug>
 
@@ -116,9 +117,9 @@ bool DocxTableExtractor::parseDocumentXml(const QByteArray& xmlContent, QList<Ta
         QXmlStreamReader::TokenType token = reader.readNext();
 
         if (token == QXmlStreamReader::StartElement) {
-            QString elementName = reader.name().toString();
+            const OoxmlTag tag = OoxmlTags::lookup(reader.name());
 
-            if (elementName == QS("tbl")) {
+            if (tag == OoxmlTag::Tbl) {
                 parseTableElement(reader, tables);
             }
         }
@@ -139,17 +140,17 @@ bool DocxTableExtractor::parseTableElement(QXmlStreamReader& reader, QList<Table
         QXmlStreamReader::TokenType token = reader.readNext();
 
         if (token == QXmlStreamReader::StartElement) {
-            QString elementName = reader.name().toString();
+            const OoxmlTag tag = OoxmlTags::lookup(reader.name());
 
-            if (elementName == QS("tr")) {
+            if (tag == OoxmlTag::Tr) {
                 // 解析表格行
                 if (parseTableRow(reader, table)) {
                     table.rows++;
                 }
             }
         } else if (token == QXmlStreamReader::EndElement) {
-            QString elementName = reader.name().toString();
-            if (elementName == QS("tbl")) {
+            const OoxmlTag tag = OoxmlTags::lookup(reader.name());
+            if (tag == OoxmlTag::Tbl) {
                 break;
             }
         }
@@ -183,9 +184,9 @@ bool DocxTableExtractor::parseTableRow(QXmlStreamReader& reader, TableInfo& tabl
         QXmlStreamReader::TokenType token = reader.readNext();
 
         if (token == QXmlStreamReader::StartElement) {
-            QString elementName = reader.name().toString();
+            const OoxmlTag tag = OoxmlTags::lookup(reader.name());
 
-            if (elementName == QS("tc")) {
+            if (tag == OoxmlTag::Tc) {
                 // 解析表格单元格
                 CellInfo cell;
                 cell.row = currentRow;
@@ -195,8 +196,8 @@ bool DocxTableExtractor::parseTableRow(QXmlStreamReader& reader, TableInfo& tabl
                 currentCol++;
             }
         } else if (token == QXmlStreamReader::EndElement) {
-            QString elementName = reader.name().toString();
-            if (elementName == QS("tr")) {
+            const OoxmlTag tag = OoxmlTags::lookup(reader.name());
+            if (tag == OoxmlTag::Tr) {
                 break;
             }
         }
@@ -230,13 +231,13 @@ QString DocxTableExtractor::parseTableCell(QXmlStreamReader& reader) const
         QXmlStreamReader::TokenType token = reader.readNext();
 
         if (token == QXmlStreamReader::StartElement) {
-            QString elementName = reader.name().toString();
+            const OoxmlTag tag = OoxmlTags::lookup(reader.name());
 
-            if (elementName == QS("t")) {
+            if (tag == OoxmlTag::T) {
                 // 读取文本内容
                 QString text = reader.readElementText();
                 content += text;
-            } else if (elementName == QS("p")) {
+            } else if (tag == OoxmlTag::P) {
                 // 段落，递归解析
                 QString paragraphContent;
                 if (parseCellContent(reader, paragraphContent)) {
@@ -247,8 +248,8 @@ QString DocxTableExtractor::parseTableCell(QXmlStreamReader& reader) const
                 }
             }
         } else if (token == QXmlStreamReader::EndElement) {
-            QString elementName = reader.name().toString();
-            if (elementName == QS("tc")) {
+            const OoxmlTag tag = OoxmlTags::lookup(reader.name());
+            if (tag == OoxmlTag::Tc) {
                 break;
             }
         }
@@ -299,10 +300,10 @@ bool DocxTableExtractor::getTablePosition(QXmlStreamReader& reader, QRect& posit
         QXmlStreamReader::TokenType token = reader.readNext();
         
         if (token == QXmlStreamReader::StartElement) {
-            QString elementName = reader.name().toString();
+            const OoxmlTag tag = OoxmlTags::lookup(reader.name());
             QXmlStreamAttributes attributes = reader.attributes();
             
-            if (elementName == QS("tbl")) {
+            if (tag == OoxmlTag::Tbl) {
                 // 表格元素，解析其属性
                 QString left = attributes.value(QS("left")).toString();
                 QString top = attributes.value(QS("top")).toString();
@@ -330,7 +331,7 @@ bool DocxTableExtractor::getTablePosition(QXmlStreamReader& reader, QRect& posit
                         hasSize = true;
                     }
                 }
-            } else if (elementName == QS("tblPr")) {
+            } else if (tag == OoxmlTag::TblPr) {
                 // 表格属性，可能包含位置信息
                 QString style = attributes.value(QS("style")).toString();
                 if (!style.isEmpty()) {
@@ -339,8 +340,8 @@ bool DocxTableExtractor::getTablePosition(QXmlStreamReader& reader, QRect& posit
                 }
             }
         } else if (token == QXmlStreamReader::EndElement) {
-            QString elementName = reader.name().toString();
-            if (elementName == QS("tbl")) {
+            const OoxmlTag tag = OoxmlTags::lookup(reader.name());
+            if (tag == OoxmlTag::Tbl) {
                 break;
             }
         }
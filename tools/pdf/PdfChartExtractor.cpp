@@ -11,6 +11,9 @@
 #include "QtCompat.h"
 #include "PdfChartExtractor.h"
 #include "../utils/ContentUtils.h"
+#include "../../src/PdfObjectScanner.h"
+#include "../../src/PdfDocumentPool.h"
+#include "../../src/PdfTextLayoutCache.h"
 #include <QFileInfo>
 #include <QDebug>
 #include <QFile>
@@ -117,20 +120,16 @@ int PdfChartExtractor::getChartCount(const QString& filePath)
 
 bool PdfChartExtractor::parsePdfFile(const QString& filePath, QList<ChartInfo>& charts)
 {
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
+    // 内存映射后按字节扫描对象，不把整个文件解码为字符串
+    PdfObjectScanner scanner;
+    if (!scanner.open(filePath)) {
         qDebug() << QS("PdfChartExtractor: 无法打开PDF文件") << filePath;
         return false;
     }
 
-    QByteArray pdfData = file.readAll();
-    file.close();
-
     // 改进的PDF图表提取（基于多种模式识别）
     // 这是一个简化的实现，实际项目中需要专业的PDF库
-    QString pdfContent = QString::fromUtf8(pdfData);
-
-    qDebug() << QS("PdfChartExtractor: 开始分析PDF文件，大小:") << pdfData.size() << QS("字节");
+    qDebug() << QS("PdfChartExtractor: 开始分析PDF文件，大小:") << scanner.data().size() << QS("字节");
 
     // 多种图表模式匹配
     QList<QRegularExpression> chartPatterns = {
@@ -146,52 +145,57 @@ bool PdfChartExtractor::parsePdfFile(const QString& filePath, QList<ChartInfo>&
     int totalCharts = 0;
     QSet<QString> foundCharts;
 
-    for (const QRegularExpression& pattern : chartPatterns) {
-        QRegularExpressionMatchIterator matches = pattern.globalMatch(pdfContent);
-        while (matches.hasNext()) {
-            QRegularExpressionMatch match = matches.next();
-            QString chartContent = match.captured(1);
+    // 文字只会以明文出现在未压缩的流中，只解码这些流而不是整个文件，
+    // 且一次只解码一个流，所有模式匹配完再处理下一个
+    for (QByteArrayView stream : scanner.plainStreams()) {
+        const QString pdfContent = QString::fromUtf8(stream);
+        for (const QRegularExpression& pattern : chartPatterns) {
+            QRegularExpressionMatchIterator matches = pattern.globalMatch(pdfContent);
+            while (matches.hasNext()) {
+                QRegularExpressionMatch match = matches.next();
+                QString chartContent = match.captured(1);
+
+                // 避免重复的图表
+                QString contentHash = QString::number(qHash(chartContent));
+                if (foundCharts.contains(contentHash)) {
+                    continue;
+                }
+                foundCharts.insert(contentHash);
+
+                // 创建图表信息
+                ChartInfo chart;
+                chart.id = generateUniqueId(QS("pdf_chart"));
+                chart.title = QString(QS("PDF图表 %1")).arg(totalCharts + 1);
+                chart.type = ChartType::UNKNOWN; // 默认类型
+                chart.size = QSize(300, 200);    // 默认尺寸
+
+                // 改进的图表类型识别
+                if (chartContent.contains(QS("柱状")) || chartContent.contains(QS("柱状图")) ||
+                    chartContent.contains(QS("Bar")) || chartContent.contains(QS("条形"))) {
+                    chart.type = ChartType::BAR;
+                } else if (chartContent.contains(QS("折线")) || chartContent.contains(QS("折线图")) ||
+                           chartContent.contains(QS("Line")) || chartContent.contains(QS("曲线"))) {
+                    chart.type = ChartType::LINE;
+                } else if (chartContent.contains(QS("饼图")) || chartContent.contains(QS("Pie"))) {
+                    chart.type = ChartType::PIE;
+                }
 
-            // 避免重复的图表
-            QString contentHash = QString::number(qHash(chartContent));
-            if (foundCharts.contains(contentHash)) {
-                continue;
-            }
-            foundCharts.insert(contentHash);
-
-            // 创建图表信息
-            ChartInfo chart;
-            chart.id = generateUniqueId(QS("pdf_chart"));
-            chart.title = QString(QS("PDF图表 %1")).arg(totalCharts + 1);
-            chart.type = ChartType::UNKNOWN; // 默认类型
-            chart.size = QSize(300, 200);    // 默认尺寸
-
-            // 改进的图表类型识别
-            if (chartContent.contains(QS("柱状")) || chartContent.contains(QS("柱状图")) ||
-                chartContent.contains(QS("Bar")) || chartContent.contains(QS("条形"))) {
-                chart.type = ChartType::BAR;
-            } else if (chartContent.contains(QS("折线")) || chartContent.contains(QS("折线图")) ||
-                       chartContent.contains(QS("Line")) || chartContent.contains(QS("曲线"))) {
-                chart.type = ChartType::LINE;
-            } else if (chartContent.contains(QS("饼图")) || chartContent.contains(QS("Pie"))) {
-                chart.type = ChartType::PIE;
+                // 创建示例数据系列
+                DataSeries series(QS("数据系列1"));
+                series.labels << QS("项目1") << QS("项目2") << QS("项目3");
+                series.values << 10.0 << 20.0 << 15.0;
+                chart.series.append(series);
+
+                // 添加详细的图表属性
+                chart.properties[QtCompat::PROP_SOURCE] = QtCompat::FORMAT_PDF;
+                chart.properties[QtCompat::PROP_METHOD] = QS("regex_advanced");
+                chart.properties[QtCompat::PROP_TYPE] = QString::number(static_cast<int>(chart.type));
+                chart.properties[QtCompat::PROP_PATTERN] = pattern.pattern();
+                chart.properties[QtCompat::PROP_FILE_SIZE] = QString::number(scanner.data().size());
+
+                charts.append(chart);
+                totalCharts++;
             }
-
-            // 创建示例数据系列
-            DataSeries series(QS("数据系列1"));
-            series.labels << QS("项目1") << QS("项目2") << QS("项目3");
-            series.values << 10.0 << 20.0 << 15.0;
-            chart.series.append(series);
-
-            // 添加详细的图表属性
-            chart.properties[QtCompat::PROP_SOURCE] = QtCompat::FORMAT_PDF;
-            chart.properties[QtCompat::PROP_METHOD] = QS("regex_advanced");
-            chart.properties[QtCompat::PROP_TYPE] = QString::number(static_cast<int>(chart.type));
-            chart.properties[QtCompat::PROP_PATTERN] = pattern.pattern();
-            chart.properties[QtCompat::PROP_FILE_SIZE] = QString::number(pdfData.size());
-
-            charts.append(chart);
-            totalCharts++;
         }
     }
 
@@ -448,23 +452,9 @@ QString PdfChartExtractor::extractTextFromPageWithPoppler(int pageNumber) const
         return QString();
     }
 
-    try {
-        // 获取页面（Qt版本）
-        std::unique_ptr<Poppler::Page> page = m_popplerDocument->page(pageNumber);
-        if (!page) {
-            return QString();
-        }
-
-        // 提取文本（Qt版本）
-        QString text = page->text(QRectF());
-
-        // 页面对象会自动清理（unique_ptr）
-
-        return text;
-    } catch (const std::exception& e) {
-        qDebug() << QS("PdfChartExtractor: 提取文本时发生异常:") << QString::fromUtf8(e.what());
-        return QString();
-    }
+    // 从版面缓存借用页面文本，与其他提取器共用同一次版面分析
+    PdfTextLayoutCache::LayoutPtr layout = PdfTextLayoutCache::instance()->acquire(m_popplerDocument, pageNumber);
+    return layout ? layout->text : QString();
 }
 
 bool PdfChartExtractor::loadPopplerDocument(const QString& filePath)
@@ -473,16 +463,11 @@ bool PdfChartExtractor::loadPopplerDocument(const QString& filePath)
         // 关闭之前的文档
         closePopplerDocument();
 
-        // 加载PDF文档（Qt版本，支持NSS数字签名）
-        m_popplerDocument = Poppler::Document::load(filePath);
+        // 从文档池借用PDF文档（Qt版本，支持NSS数字签名），同一文件只解析一次
+        QString errorMessage;
+        m_popplerDocument = PdfDocumentPool::instance()->acquire(filePath, &errorMessage);
         if (!m_popplerDocument) {
-            setLastError(QS("无法加载PDF文档"));
-            return false;
-        }
-
-        if (m_popplerDocument->isLocked()) {
-            setLastError(QS("PDF文档已加密"));
-            m_popplerDocument.reset();
+            setLastError(errorMessage);
             return false;
         }
         
@@ -13,7 +13,7 @@
 #include "../base/ChartExtractor.h"
 #include "poppler-qt6.h" // 使用Qt6版本的Poppler
 #include "poppler-form.h" // 支持NSS数字签名
-#include <memory> // 用于std::unique_ptr
+#include <memory> // 用于std::shared_ptr
 
 /**
  * @brief PDF图表提取器
@@ -127,8 +127,8 @@ protected:
 private:
     static const QStringList SUPPORTED_EXTENSIONS;
     
-    // Poppler文档对象（Qt版本，使用unique_ptr）
-    std::unique_ptr<Poppler::Document> m_popplerDocument;
+    // Poppler文档对象（Qt版本，从PdfDocumentPool借用）
+    std::shared_ptr<Poppler::Document> m_popplerDocument;
     QString m_currentPdfPath;
 };
 
@@ -19,16 +19,35 @@
 #include "QtCompat.h"
 #include <QDebug>
 #include <QFile>
+#include <QHash>
 #include <QRegularExpression>
 #include "../../src/PopplerCompat.h"
+#include "../../src/PdfDocumentPool.h"
+#include "../../src/PdfCoreDocument.h"
+#include "../../src/PdfObjectScanner.h"
 
 // 根据Poppler可用性决定是否使用Poppler
 #include "poppler-qt6.h"
 #include <memory>
 
+#include <ImageCollectorOutputDev.h>
+#include <PDFDoc.h>
+
 // 静态常量定义
 const QStringList PdfImageExtractor::SUPPORTED_EXTENSIONS = {QS("pdf")};
 
+namespace {
+
+/**
+ * @brief 将CollectedImage的引用格式化为"num gen R"
+ */
+QString refToString(const Ref& ref)
+{
+    return QS("%1 %2 R").arg(ref.num).arg(ref.gen);
+}
+
+} // namespace
+
 PdfImageExtractor::PdfImageExtractor(QObject* parent)
     : ImageExtractor(parent), m_popplerDocument(nullptr)
 {
@@ -58,9 +77,15 @@ ImageExtractor::ExtractStatus PdfImageExtractor::extractImages(const QString& fi
     }
 
     try {
+        // 优先直接提取页面资源中的图片XObject，不做任何渲染
+        if (extractEmbeddedImages(filePath, images)) {
+            qDebug() << "PdfImageExtractor: 从XObject提取" << images.size() << "个图片";
+            return ExtractStatus::SUCCESS;
+        }
+
         // 检查Poppler是否可用
         if (PopplerCompat::isPopplerAvailable()) {
-            // 优先使用Poppler解析PDF文件
+            // 使用Poppler解析PDF文件
             if (parsePdfWithPoppler(filePath, images)) {
                 qDebug() << "PdfImageExtractor: 使用Poppler成功提取" << images.size() << "个图片";
                 return ExtractStatus::SUCCESS;
@@ -137,115 +162,47 @@ int PdfImageExtractor::getImageCount(const QString& filePath)
 
 bool PdfImageExtractor::parsePdfFile(const QString& filePath, QList<ImageInfo>& images)
 {
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
+    // 内存映射后按字节扫描对象，不把整个文件解码为字符串
+    PdfObjectScanner scanner;
+    if (!scanner.open(filePath)) {
         qDebug() << "PdfImageExtractor: 无法打开PDF文件" << filePath;
         return false;
     }
 
-    QByteArray pdfData = file.readAll();
-    file.close();
-
-    qDebug() << "PdfImageExtractor: 开始分析PDF文件，大小:" << pdfData.size() << "字节";
-
-    // 使用多种方法提取图片
-    QString pdfContent = QString::fromUtf8(pdfData);
-
-    // 方法1: 查找所有图片对象引用
-    QRegularExpression imageRefPattern(QS(R"(\/Im(\d+)\s+(\d+)\s+R)"));
-    QRegularExpressionMatchIterator imageRefMatches = imageRefPattern.globalMatch(pdfContent);
+    qDebug() << "PdfImageExtractor: 开始分析PDF文件，大小:" << scanner.data().size() << "字节";
 
-    QSet<QString> processedImages;
+    // 一次顺序扫描找出全部图片XObject（/Subtype /Image的流对象）
+    qDebug() << "PdfImageExtractor: 查找图片对象...";
     int imageCount = 0;
-
-    qDebug() << "PdfImageExtractor: 查找图片对象引用...";
-    while (imageRefMatches.hasNext()) {
-        QRegularExpressionMatch match = imageRefMatches.next();
-        QString imageId = match.captured(1);
-        QString objectNumber = match.captured(2);
-
-        qDebug() << "PdfImageExtractor: 找到图片引用 Im" << imageId << "对象" << objectNumber;
-
-        if (!processedImages.contains(imageId)) {
-            processedImages.insert(imageId);
-
-            // 查找对应的对象定义
-            QString objPattern = QS(R"(%1\s+(\d+)\s+obj)").arg(objectNumber);
-            QRegularExpression objRegex(objPattern);
-            QRegularExpressionMatch objMatch = objRegex.match(pdfContent);
-
-            if (objMatch.hasMatch()) {
-                qDebug() << "PdfImageExtractor: 找到对象定义" << objectNumber;
-                // 查找对象内容
-                QString objContent = extractObjectContent(pdfContent, objectNumber);
-                if (!objContent.isEmpty()) {
-                    ImageInfo image = parseImageObjectContent(objContent, imageId);
-                    if (!image.id.isEmpty()) {
-                        images.append(image);
-                        imageCount++;
-                        qDebug() << "PdfImageExtractor: 成功提取图片对象" << imageId
-                                 << "尺寸:" << image.size << "格式:" << image.format;
-                    }
-                }
-            }
+    PdfObjectScanner::Object object;
+    while (scanner.next(object)) {
+        if (!object.hasStream()) {
+            continue;
+        }
+        const QByteArrayView dictionary = scanner.body(object);
+        if (PdfObjectScanner::name(dictionary, "Subtype") != "Image") {
+            continue;
         }
-    }
-
-    // 方法2: 查找XObject图片
-    qDebug() << "PdfImageExtractor: 查找XObject图片...";
-    QRegularExpression xObjectPattern(QS(R"(\/XObject\s*<<([^>]*\/Subtype\s*\/Image[^>]*)>>)"));
-    QRegularExpressionMatchIterator xObjectMatches = xObjectPattern.globalMatch(pdfContent);
-
-    while (xObjectMatches.hasNext()) {
-        QRegularExpressionMatch match = xObjectMatches.next();
-        QString xObjectContent = match.captured(1);
-
-        qDebug() << "PdfImageExtractor: 找到XObject图片内容:" << xObjectContent.left(100);
 
-        // 提取图片信息
-        ImageInfo image = parseXObjectImage(xObjectContent);
+        const QString objectNumber = QString::number(object.number);
+        ImageInfo image = parseImageObjectContent(dictionary, scanner.stream(object), objectNumber);
         if (!image.id.isEmpty()) {
             images.append(image);
             imageCount++;
-            qDebug() << "PdfImageExtractor: 成功提取XObject图片" << image.id;
-        }
-    }
-
-    // 方法3: 查找所有包含图片特征的对象
-    qDebug() << "PdfImageExtractor: 查找包含图片特征的对象...";
-    QRegularExpression imageObjPattern(QS(
-        R"(\d+\s+\d+\s+obj[\s\S]*?\/Type\s*\/XObject[\s\S]*?\/Subtype\s*\/Image[\s\S]*?endobj)"));
-    QRegularExpressionMatchIterator imageObjMatches = imageObjPattern.globalMatch(pdfContent);
-
-    while (imageObjMatches.hasNext()) {
-        QRegularExpressionMatch match = imageObjMatches.next();
-        QString objContent = match.captured(0);
-
-        qDebug() << "PdfImageExtractor: 找到图片对象，内容长度:" << objContent.length();
-
-        // 提取对象编号
-        QRegularExpression objNumPattern(QS(R"((\d+)\s+\d+\s+obj)"));
-        QRegularExpressionMatch objNumMatch = objNumPattern.match(objContent);
-        if (objNumMatch.hasMatch()) {
-            QString objNumber = objNumMatch.captured(1);
-            ImageInfo image = parseImageObjectContent(objContent, objNumber);
-            if (!image.id.isEmpty()) {
-                images.append(image);
-                imageCount++;
-                qDebug() << "PdfImageExtractor: 成功提取图片对象" << objNumber;
-            }
+            qDebug() << "PdfImageExtractor: 成功提取图片对象" << objectNumber
+                     << "尺寸:" << image.size << "格式:" << image.format;
         }
     }
 
     qDebug() << "PdfImageExtractor: 总共提取了" << imageCount << "个图片对象";
 
-    // 方法4: 如果没有找到图片，尝试从页面内容中提取
+    // 方法2: 如果没有找到图片，尝试从页面内容中提取
     if (images.isEmpty()) {
         qDebug() << "PdfImageExtractor: 未找到图片对象，尝试从页面内容提取";
-        extractImagesFromPageContent(pdfContent, images);
+        extractImagesFromPageContent(scanner, images);
     }
 
-    // 方法5: 如果仍然没有找到，创建一些示例图片用于测试
+    // 方法3: 如果仍然没有找到，创建一些示例图片用于测试
     if (images.isEmpty()) {
         qDebug() << "PdfImageExtractor: 仍未找到图片，创建示例图片用于测试";
 
@@ -428,6 +385,105 @@ bool PdfImageExtractor::decodePdfImageData(const QByteArray& encodedData, const
     return true;
 }
 
+bool PdfImageExtractor::extractEmbeddedImages(const QString& filePath, QList<ImageInfo>& images)
+{
+    PdfCoreDocument document;
+    if (!document.open(filePath)) {
+        qDebug() << "PdfImageExtractor: 无法打开PDF核心文档" << document.lastError();
+        return false;
+    }
+
+    try {
+        ImageCollectorOutputDev collector;
+        collector.setMinSize(MIN_EMBEDDED_IMAGE_SIZE);
+
+        // 同一XObject在多处引用时只转换一次，QByteArray隐式共享。
+        // 收集器只在首次引用时给出原始数据，原始数据和解码光栅随每页的collected释放，
+        // 整个文档期间只保留这里的编码结果
+        QHash<QString, QByteArray> convertedData;
+
+        const int pageCount = document.pageCount();
+        for (int i = 0; i < pageCount; ++i) {
+            document.document()->displayPage(&collector, i + 1, 72.0, 72.0, 0, false, true, false);
+
+            const std::vector<CollectedImage> collected = collector.takeImages();
+            for (const CollectedImage& item : collected) {
+                if (!item.repeated && (!item.data || item.data->empty())) {
+                    continue;
+                }
+
+                ImageInfo image;
+                image.id = generateUniqueId(QS("pdf_image"));
+                image.size = QSize(item.width, item.height);
+                image.position = QRectF(QPointF(item.x1, item.y1), QPointF(item.x2, item.y2)).toAlignedRect();
+                image.isEmbedded = true;
+
+                const bool hasRef = item.ref != Ref::INVALID();
+                const QString refKey = hasRef ? refToString(item.ref) : QString();
+
+                switch (item.encoding) {
+                case CollectedImage::encodingJPEG:
+                    image.format = QS("jpeg");
+                    image.metadata[QS("encoding")] = QS("DCTDecode");
+                    break;
+                case CollectedImage::encodingJPX:
+                    image.format = QS("jp2");
+                    image.metadata[QS("encoding")] = QS("JPXDecode");
+                    break;
+                case CollectedImage::encodingRGB:
+                    image.format = QS("png");
+                    image.metadata[QS("encoding")] = QS("decoded");
+                    break;
+                }
+
+                if (item.repeated) {
+                    // 首次引用没有可用数据（过大或解码失败）时，后续引用同样跳过
+                    if (!convertedData.contains(refKey)) {
+                        continue;
+                    }
+                    image.data = convertedData.value(refKey);
+                } else {
+                    if (item.encoding == CollectedImage::encodingRGB) {
+                        // 只有非JPEG图片需要解码后重新编码
+                        const QImage raster(reinterpret_cast<const uchar*>(item.data->data()), item.width,
+                                            item.height, item.width * 3, QImage::Format_RGB888);
+                        QBuffer buffer(&image.data);
+                        buffer.open(QIODevice::WriteOnly);
+                        raster.save(&buffer, "PNG");
+                    } else {
+                        // DCT/JPX原始数据直接输出，不解码也不重新编码
+                        image.data = QByteArray(item.data->data(), static_cast<qsizetype>(item.data->size()));
+                    }
+                    if (hasRef) {
+                        convertedData.insert(refKey, image.data);
+                    }
+                }
+
+                image.originalPath = hasRef ? refToString(item.ref) : QS("inline");
+                image.description = QS("PDF第%1页的嵌入图片").arg(item.page);
+                image.metadata[QS("source")] = QS("PDF");
+                image.metadata[QS("pageNumber")] = QString::number(item.page);
+                image.metadata[QS("extractionMethod")] = item.inlineImage ? QS("inline_image") : QS("xobject");
+                image.metadata[QS("bitsPerComponent")] = item.bitsPerComponent;
+                image.metadata[QS("components")] = item.components;
+                image.metadata[QS("masked")] = item.masked;
+                image.metadata[QS("dataSize")] = QString::number(image.data.size());
+                if (hasRef) {
+                    image.metadata[QS("objectRef")] = refKey;
+                }
+
+                images.append(image);
+            }
+        }
+
+        return true;
+    } catch (const std::exception& e) {
+        qDebug() << "PdfImageExtractor: 提取嵌入图片时发生异常:" << e.what();
+        images.clear();
+        return false;
+    }
+}
+
 // Poppler相关方法实现
 bool PdfImageExtractor::parsePdfWithPoppler(const QString& filePath, QList<ImageInfo>& images)
 {
@@ -534,16 +590,11 @@ bool PdfImageExtractor::loadPopplerDocument(const QString& filePath)
         // 关闭之前的文档
         closePopplerDocument();
 
-        // 加载PDF文档（Qt版本，支持NSS数字签名）
-        m_popplerDocument = Poppler::Document::load(filePath);
+        // 从文档池借用PDF文档（Qt版本，支持NSS数字签名），同一文件只解析一次
+        QString errorMessage;
+        m_popplerDocument = PdfDocumentPool::instance()->acquire(filePath, &errorMessage);
         if (!m_popplerDocument) {
-            setLastError(QS("无法加载PDF文档"));
-            return false;
-        }
-
-        if (m_popplerDocument->isLocked()) {
-            setLastError(QS("PDF文档已加密"));
-            m_popplerDocument.reset();
+            setLastError(errorMessage);
             return false;
         }
 
@@ -578,34 +629,7 @@ void PdfImageExtractor::closePopplerDocument()
 }
 
 // 新增的辅助方法
-QString PdfImageExtractor::extractObjectContent(const QString& pdfContent,
-                                                const QString& objectNumber)
-{
-    // 查找对象开始
-    QString objStartPattern = QS(R"(%1\s+\d+\s+obj)").arg(objectNumber);
-    QRegularExpression objStartRegex(objStartPattern);
-    QRegularExpressionMatch startMatch = objStartRegex.match(pdfContent);
-
-    if (!startMatch.hasMatch()) {
-        return QString();
-    }
-
-    int startPos = startMatch.capturedEnd();
-
-    // 查找对象结束
-    QString objEndPattern = QS(R"(endobj)");
-    QRegularExpression objEndRegex(objEndPattern);
-    QRegularExpressionMatch endMatch = objEndRegex.match(pdfContent, startPos);
-
-    if (!endMatch.hasMatch()) {
-        return QString();
-    }
-
-    int endPos = endMatch.capturedStart();
-    return pdfContent.mid(startPos, endPos - startPos);
-}
-
-ImageInfo PdfImageExtractor::parseImageObjectContent(const QString& objContent,
+ImageInfo PdfImageExtractor::parseImageObjectContent(QByteArrayView dictionary, QByteArrayView streamData,
                                                      const QString& imageId)
 {
     ImageInfo image;
@@ -614,61 +638,50 @@ ImageInfo PdfImageExtractor::parseImageObjectContent(const QString& objContent,
     image.isEmbedded = true;
 
     // 提取宽度和高度
-    QRegularExpression widthPattern(QS(R"(\/Width\s+(\d+))"));
-    QRegularExpressionMatch widthMatch = widthPattern.match(objContent);
-    int width = widthMatch.hasMatch() ? widthMatch.captured(1).toInt() : 150;
-
-    QRegularExpression heightPattern(QS(R"(\/Height\s+(\d+))"));
-    QRegularExpressionMatch heightMatch = heightPattern.match(objContent);
-    int height = heightMatch.hasMatch() ? heightMatch.captured(1).toInt() : 100;
+    int width = PdfObjectScanner::integer(dictionary, "Width", 150);
+    int height = PdfObjectScanner::integer(dictionary, "Height", 100);
 
     image.size = QSize(width, height);
 
-    // 提取过滤器（图片格式）
-    QRegularExpression filterPattern(QS(R"(\/Filter\s*\/([A-Za-z0-9]+))"));
-    QRegularExpressionMatch filterMatch = filterPattern.match(objContent);
-    QString filter = filterMatch.hasMatch() ? filterMatch.captured(1) : QS("DCTDecode");
-
-    // 提取图片数据 - 改进的数据提取
-    QRegularExpression dataPattern(QS(R"(stream\s*\n([\s\S]*?)\nendstream)"));
-    QRegularExpressionMatch dataMatch = dataPattern.match(objContent);
+    // 提取过滤器（图片格式），过滤器数组取第一个
+    const QByteArray filterName = PdfObjectScanner::name(dictionary, "Filter");
+    QString filter = filterName.isEmpty() ? QS("DCTDecode") : QString::fromLatin1(filterName);
 
-    if (dataMatch.hasMatch()) {
-        QString imageDataStr = dataMatch.captured(1);
-        qDebug() << "PdfImageExtractor: 找到图片数据，长度:" << imageDataStr.length()
+    if (!streamData.isEmpty()) {
+        qDebug() << "PdfImageExtractor: 找到图片数据，长度:" << streamData.size()
                  << "过滤器:" << filter;
 
+        // 只复制图片本身的原始字节，二进制数据不经过任何文本解码
         QByteArray binaryData;
 
         // 根据过滤器类型处理数据
         if (filter == QS("DCTDecode")) {
             // JPEG数据，直接使用
-            binaryData = imageDataStr.toUtf8();
+            binaryData = streamData.toByteArray();
             image.format = QS("jpeg");
             qDebug() << "PdfImageExtractor: 处理JPEG数据";
         } else if (filter == QS("FlateDecode")) {
             // PNG数据，需要解压缩（这里简化处理）
-            binaryData = imageDataStr.toUtf8();
+            binaryData = streamData.toByteArray();
             image.format = QS("png");
             qDebug() << "PdfImageExtractor: 处理PNG数据";
         } else if (filter == QS("CCITTFaxDecode")) {
             // TIFF数据
-            binaryData = imageDataStr.toUtf8();
+            binaryData = streamData.toByteArray();
             image.format = QS("tiff");
             qDebug() << "PdfImageExtractor: 处理TIFF数据";
+        } else if (filter == QS("ASCIIHexDecode")) {
+            // 十六进制编码的数据
+            binaryData = QByteArray::fromHex(streamData.toByteArray());
+            image.format = QS("raw");
+            qDebug() << "PdfImageExtractor: 处理十六进制数据";
         } else {
             // 其他格式，尝试作为原始数据
-            binaryData = imageDataStr.toUtf8();
+            binaryData = streamData.toByteArray();
             image.format = QS("raw");
             qDebug() << "PdfImageExtractor: 处理原始数据";
         }
 
-        // 如果数据为空，尝试十六进制解码
-        if (binaryData.isEmpty()) {
-            qDebug() << "PdfImageExtractor: 尝试十六进制解码";
-            binaryData = QByteArray::fromHex(imageDataStr.toUtf8());
-        }
-
         // 如果仍然为空，创建示例数据
         if (binaryData.isEmpty()) {
             qDebug() << "PdfImageExtractor: 创建示例图片数据";
@@ -779,170 +792,51 @@ ImageInfo PdfImageExtractor::parseImageObjectContent(const QString& objContent,
     return image;
 }
 
-ImageInfo PdfImageExtractor::parseXObjectImage(const QString& xObjectContent)
+void PdfImageExtractor::extractImagesFromPageContent(PdfObjectScanner& scanner,
+                                                     QList<ImageInfo>& images)
 {
-    ImageInfo image;
-    image.id = generateUniqueId(QS("pdf_xobject"));
-    image.format = QS("jpeg"); // 默认格式
-    image.isEmbedded = true;
-
-    // 提取宽度和高度
-    QRegularExpression widthPattern(QS(R"(\/Width\s+(\d+))"));
-    QRegularExpressionMatch widthMatch = widthPattern.match(xObjectContent);
-    int width = widthMatch.hasMatch() ? widthMatch.captured(1).toInt() : 150;
-
-    QRegularExpression heightPattern(QS(R"(\/Height\s+(\d+))"));
-    QRegularExpressionMatch heightMatch = heightPattern.match(xObjectContent);
-    int height = heightMatch.hasMatch() ? heightMatch.captured(1).toInt() : 100;
-
-    image.size = QSize(width, height);
-
-    // 提取过滤器
-    QRegularExpression filterPattern(QS(R"(\/Filter\s*\/([A-Za-z0-9]+))"));
-    QRegularExpressionMatch filterMatch = filterPattern.match(xObjectContent);
-    QString filter = filterMatch.hasMatch() ? filterMatch.captured(1) : QS("DCTDecode");
-
-    // 尝试提取图片数据
-    QRegularExpression dataPattern(QS(R"(stream\s*\n([\s\S]*?)\nendstream)"));
-    QRegularExpressionMatch dataMatch = dataPattern.match(xObjectContent);
-
-    if (dataMatch.hasMatch()) {
-        QString imageDataStr = dataMatch.captured(1);
-        qDebug() << "PdfImageExtractor: XObject找到图片数据，长度:" << imageDataStr.length();
-
-        QByteArray binaryData = imageDataStr.toUtf8();
-
-        // 根据过滤器确定格式
-        if (filter == QS("DCTDecode")) {
-            image.format = QS("jpeg");
-        } else if (filter == QS("FlateDecode")) {
-            image.format = QS("png");
-        } else if (filter == QS("CCITTFaxDecode")) {
-            image.format = QS("tiff");
+    // 查找页面对象及其内容流
+    int pageCount = 0;
+    scanner.rewind();
+    PdfObjectScanner::Object pageObject;
+    while (pageCount < 5 && scanner.next(pageObject)) { // 限制处理前5页
+        const QByteArrayView pageDictionary = scanner.body(pageObject);
+        if (PdfObjectScanner::name(pageDictionary, "Type") != "Page") {
+            continue;
         }
 
-        // 转换为Base64
-        image.data = binaryData.toBase64();
-        qDebug() << "PdfImageExtractor: XObject成功提取图片数据，Base64长度:"
-                 << image.data.length();
-                 
-        // 验证Base64数据
-        if (image.data.isEmpty() || image.data.length() < 100) {
-            qDebug() << "PdfImageExtractor: XObject Base64数据异常，重新创建示例图片";
-            QImage sampleImg(width, height, QImage::Format_RGB32);
-            sampleImg.fill(QColor(180, 180, 180));
-            
-            QPainter painter(&sampleImg);
-            painter.setPen(QPen(Qt::black, 2));
-            painter.setFont(QFont(QS("Arial"), 10));
-            painter.drawText(sampleImg.rect(), Qt::AlignCenter, 
-                           QS("XObject图片\n%1x%2").arg(width).arg(height));
-            
-            QByteArray sampleData;
-            QBuffer buffer(&sampleData);
-            buffer.open(QIODevice::WriteOnly);
-            sampleImg.save(&buffer, "PNG");
-            
-            image.data = sampleData.toBase64();
-            image.format = QS("png");
+        // /Contents N G R：只处理单个间接引用的内容流
+        const QByteArrayView contents = PdfObjectScanner::value(pageDictionary, "Contents");
+        qsizetype digits = 0;
+        while (digits < contents.size() && contents[digits] >= '0' && contents[digits] <= '9') {
+            ++digits;
         }
-    } else {
-        qDebug() << "PdfImageExtractor: XObject未找到图片数据流，创建示例图片";
-        // 创建示例图片
-        QImage sampleImg(width, height, QImage::Format_RGB32);
-        sampleImg.fill(QColor(180, 180, 180));
-        
-        QPainter painter(&sampleImg);
-        painter.setPen(QPen(Qt::black, 2));
-        painter.setFont(QFont(QS("Arial"), 10));
-        painter.drawText(sampleImg.rect(), Qt::AlignCenter, 
-                       QS("XObject图片\n%1x%2").arg(width).arg(height));
-        
-        QByteArray sampleData;
-        QBuffer buffer(&sampleData);
-        buffer.open(QIODevice::WriteOnly);
-        sampleImg.save(&buffer, "PNG"); // 使用PNG格式
-        
-        image.data = sampleData.toBase64();
-        image.format = QS("png");
-    }
+        bool ok = contents.endsWith('R') && digits > 0;
+        const int contentObjNumber = ok ? contents.first(digits).toInt(&ok) : 0;
+        PdfObjectScanner::Object contentObject;
+        if (ok && scanner.findObject(contentObjNumber, contentObject)) {
+            // 压缩的内容流无法直接查找图片引用
+            const QByteArrayView contentDictionary = scanner.body(contentObject);
+            const QByteArrayView contentStream = PdfObjectScanner::value(contentDictionary, "Filter").isEmpty()
+                                                     ? scanner.stream(contentObject)
+                                                     : QByteArrayView();
 
-    // 添加数据验证
-    if (image.data.isEmpty()) {
-        qDebug() << "PdfImageExtractor: XObject图片数据为空，创建默认图片";
-        QImage defaultImg(100, 100, QImage::Format_RGB32);
-        defaultImg.fill(QColor(128, 128, 128));
-        
-        QPainter painter(&defaultImg);
-        painter.setPen(QPen(Qt::white, 2));
-        painter.setFont(QFont(QS("Arial"), 8));
-        painter.drawText(defaultImg.rect(), Qt::AlignCenter, QS("XObject无数据"));
-        
-        QByteArray defaultData;
-        QBuffer buffer(&defaultData);
-        buffer.open(QIODevice::WriteOnly);
-        defaultImg.save(&buffer, "PNG");
-        
-        image.data = defaultData.toBase64();
-        image.format = QS("png");
-        image.size = QSize(100, 100);
-    }
-    
-    // 验证Base64数据格式
-    QByteArray decodedData = QByteArray::fromBase64(image.data);
-    if (decodedData.isEmpty() && !image.data.isEmpty()) {
-        qDebug() << "PdfImageExtractor: XObject Base64数据无效，重新编码";
-        QImage testImg(50, 50, QImage::Format_RGB32);
-        testImg.fill(QColor(200, 200, 200));
-        
-        QByteArray testData;
-        QBuffer testBuffer(&testData);
-        testBuffer.open(QIODevice::WriteOnly);
-        testImg.save(&testBuffer, "PNG");
-        
-        image.data = testData.toBase64();
-        image.format = QS("png");
-        image.size = QSize(50, 50);
-    }
-
-    // 添加元数据
-    image.metadata[QS("source")] = QS("PDF");
-    image.metadata[QS("extractionMethod")] = QS("xobject_regex");
-    image.metadata[QS("filter")] = filter;
-    image.metadata[QS("width")] = QString::number(width);
-    image.metadata[QS("height")] = QString::number(height);
-    image.metadata[QS("dataSize")] = QString::number(image.data.length());
-    image.metadata[QS("isValidBase64")] = QByteArray::fromBase64(image.data).isEmpty() ? QS("false") : QS("true");
-
-    image.originalPath = QS("PDF XObject图片");
-    image.description =
-        QS("从PDF XObject提取的图片，格式: %1，尺寸: %2x%3").arg(filter).arg(width).arg(height);
-
-    return image;
-}
-
-void PdfImageExtractor::extractImagesFromPageContent(const QString& pdfContent,
-                                                     QList<ImageInfo>& images)
-{
-    // 查找页面内容流
-    QRegularExpression pagePattern(QS(R"(\/Contents\s+(\d+)\s+\d+\s+R)"));
-    QRegularExpressionMatchIterator pageMatches = pagePattern.globalMatch(pdfContent);
-
-    int pageCount = 0;
-    while (pageMatches.hasNext() && pageCount < 5) { // 限制处理前5页
-        QRegularExpressionMatch match = pageMatches.next();
-        QString contentObjNumber = match.captured(1);
-
-        QString contentObj = extractObjectContent(pdfContent, contentObjNumber);
-        if (!contentObj.isEmpty()) {
             // 从页面内容中查找图片引用
-            QRegularExpression imageRefPattern(QS(R"(\/Im(\d+))"));
-            QRegularExpressionMatchIterator imageRefs = imageRefPattern.globalMatch(contentObj);
-
-            while (imageRefs.hasNext()) {
-                QRegularExpressionMatch imageRef = imageRefs.next();
-                QString imageId = imageRef.captured(1);
+            QStringList imageIds;
+            qsizetype pos = 0;
+            while ((pos = PdfObjectScanner::indexOf(contentStream, "/Im", pos)) >= 0) {
+                pos += 3;
+                qsizetype end = pos;
+                while (end < contentStream.size() && contentStream[end] >= '0' && contentStream[end] <= '9') {
+                    ++end;
+                }
+                if (end > pos) {
+                    imageIds.append(QString::fromLatin1(contentStream.sliced(pos, end - pos)));
+                }
+                pos = end;
+            }
 
+            for (const QString& imageId : imageIds) {
                 // 创建基础图片信息
                 ImageInfo image;
                 image.id = generateUniqueId(QS("pdf_page_image"));
@@ -13,7 +13,10 @@
 #include "../base/ImageExtractor.h"
 #include "poppler-qt6.h" // 使用Qt6版本的Poppler
 #include "poppler-form.h" // 支持NSS数字签名
-#include <memory> // 用于std::unique_ptr
+#include <memory> // 用于std::shared_ptr
+#include <QByteArrayView>
+
+class PdfObjectScanner;
 
 /**
  * @brief PDF图片提取器
@@ -99,6 +102,17 @@ protected:
     bool decodePdfImageData(const QByteArray& encodedData, const QString& format,
                             QByteArray& decodedData) const;
 
+    /**
+     * @brief 遍历页面内容提取嵌入的图片XObject和内联图片
+     *
+     * DCTDecode/JPXDecode图片直接输出原始数据，其余图片解码一次后编码为PNG，
+     * 位置取自绘制时的变换矩阵（点，原点在页面左上角）。
+     * @param filePath PDF文件路径
+     * @param images 输出图片信息列表
+     * @return 文档能否解析（没有图片时也返回true）
+     */
+    bool extractEmbeddedImages(const QString& filePath, QList<ImageInfo>& images);
+
     // Poppler相关方法
     bool parsePdfWithPoppler(const QString& filePath, QList<ImageInfo>& images);
     QImage renderPageWithPoppler(int pageNumber, int dpi = 150) const;
@@ -106,16 +120,15 @@ protected:
     void closePopplerDocument();
     
     // 新增的辅助方法
-    QString extractObjectContent(const QString& pdfContent, const QString& objectNumber);
-    ImageInfo parseImageObjectContent(const QString& objContent, const QString& imageId);
-    ImageInfo parseXObjectImage(const QString& xObjectContent);
-    void extractImagesFromPageContent(const QString& pdfContent, QList<ImageInfo>& images);
+    ImageInfo parseImageObjectContent(QByteArrayView dictionary, QByteArrayView streamData, const QString& imageId);
+    void extractImagesFromPageContent(PdfObjectScanner& scanner, QList<ImageInfo>& images);
 
 private:
     static const QStringList SUPPORTED_EXTENSIONS;
+    static const int MIN_EMBEDDED_IMAGE_SIZE = 8; ///< 忽略小于该尺寸的图片（分隔线、底纹等）
     
-    // Poppler文档对象（Qt版本，使用unique_ptr）
-    std::unique_ptr<Poppler::Document> m_popplerDocument;
+    // Poppler文档对象（Qt版本，从PdfDocumentPool借用）
+    std::shared_ptr<Poppler::Document> m_popplerDocument;
     QString m_currentPdfPath;
 };
 
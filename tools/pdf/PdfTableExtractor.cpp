@@ -11,6 +11,10 @@
 #include "QtCompat.h"
 #include "PdfTableExtractor.h"
 #include "../utils/ContentUtils.h"
+#include "../../src/PdfObjectScanner.h"
+#include "../../src/PdfDocumentPool.h"
+#include "../../src/PdfTextLayoutCache.h"
+#include "../../src/PdfTableDetector.h"
 #include <QFileInfo>
 #include <QDebug>
 #include <QFile>
@@ -99,20 +103,16 @@ int PdfTableExtractor::getTableCount(const QString& filePath)
 
 bool PdfTableExtractor::parsePdfFile(const QString& filePath, QList<TableInfo>& tables)
 {
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
+    // 内存映射后按字节扫描对象，不把整个文件解码为字符串
+    PdfObjectScanner scanner;
+    if (!scanner.open(filePath)) {
         qDebug() << QS("PdfTableExtractor: 无法打开PDF文件") << filePath;
         return false;
     }
 
-    QByteArray pdfData = file.readAll();
-    file.close();
-
     // 改进的PDF表格提取（基于多种模式识别）
     // 这是一个简化的实现，实际项目中需要专业的PDF库
-    QString pdfContent = QString::fromUtf8(pdfData);
-
-    qDebug() << QS("PdfTableExtractor: 开始分析PDF文件，大小:") << pdfData.size() << QS("字节");
+    qDebug() << QS("PdfTableExtractor: 开始分析PDF文件，大小:") << scanner.data().size() << QS("字节");
 
     // 多种表格模式匹配
     QList<QRegularExpression> tablePatterns = {
@@ -130,58 +130,63 @@ bool PdfTableExtractor::parsePdfFile(const QString& filePath, QList<TableInfo>&
     int totalTables = 0;
     QSet<QString> foundTables;
 
-    for (const QRegularExpression& pattern : tablePatterns) {
-        QRegularExpressionMatchIterator matches = pattern.globalMatch(pdfContent);
-        while (matches.hasNext()) {
-            QRegularExpressionMatch match = matches.next();
-            QString tableContent = match.captured(1);
-
-            // 避免重复的表格
-            QString contentHash = QString::number(qHash(tableContent));
-            if (foundTables.contains(contentHash)) {
-                continue;
-            }
-            foundTables.insert(contentHash);
-
-            // 创建表格信息
-            TableInfo table;
-            table.id = generateUniqueId(QS("pdf_table"));
-            table.title = QString(QS("PDF表格 %1")).arg(totalTables + 1);
-
-            // 改进的表格行分割
-            QStringList rows = tableContent.split(QS("\n"), Qt::SkipEmptyParts);
-            if (rows.size() > 1) {
-                table.rows = rows.size();
-                table.columns = 1; // 默认列数
-
-                // 创建单元格数据
-                for (int i = 0; i < rows.size(); ++i) {
-                    QList<CellInfo> row;
-                    CellInfo cell(i, 0, rows[i].trimmed());
-                    row.append(cell);
-                    table.cells.append(row);
+    // 文字只会以明文出现在未压缩的流中，只解码这些流而不是整个文件，
+    // 且一次只解码一个流，所有模式匹配完再处理下一个
+    for (QByteArrayView stream : scanner.plainStreams()) {
+        const QString pdfContent = QString::fromUtf8(stream);
+        for (const QRegularExpression& pattern : tablePatterns) {
+            QRegularExpressionMatchIterator matches = pattern.globalMatch(pdfContent);
+            while (matches.hasNext()) {
+                QRegularExpressionMatch match = matches.next();
+                QString tableContent = match.captured(1);
+
+                // 避免重复的表格
+                QString contentHash = QString::number(qHash(tableContent));
+                if (foundTables.contains(contentHash)) {
+                    continue;
                 }
+                foundTables.insert(contentHash);
 
-                // 改进的列数检测（基于多种分隔符）
-                int maxCols = 1;
-                for (const QString& row : rows) {
-                    int colCount = qMax(qMax(qMax(row.count(QS("\t")) + 1, row.count(QS("|")) + 1),
-                                             qMax(row.count(QS(",")) + 1, row.count(QS(";")) + 1)),
-                                        row.count(QS(" ")) + 1);
-                    maxCols = qMax(maxCols, colCount);
-                }
-                table.columns = qMin(maxCols, 10); // 限制最大列数
+                // 创建表格信息
+                TableInfo table;
+                table.id = generateUniqueId(QS("pdf_table"));
+                table.title = QString(QS("PDF表格 %1")).arg(totalTables + 1);
 
-                // 添加详细的表格属性
-                table.properties[QS("source")] = QS("PDF");
-                table.properties[QS("extractionMethod")] = QS("regex_advanced");
-                table.properties[QS("rowCount")] = QString::number(table.rows);
-                table.properties[QS("columnCount")] = QString::number(table.columns);
-                table.properties[QS("pattern")] = pattern.pattern();
-                table.properties[QS("fileSize")] = QString::number(pdfData.size());
+                // 改进的表格行分割
+                QStringList rows = tableContent.split(QS("\n"), Qt::SkipEmptyParts);
+                if (rows.size() > 1) {
+                    table.rows = rows.size();
+                    table.columns = 1; // 默认列数
 
-                tables.append(table);
-                totalTables++;
+                    // 创建单元格数据
+                    for (int i = 0; i < rows.size(); ++i) {
+                        QList<CellInfo> row;
+                        CellInfo cell(i, 0, rows[i].trimmed());
+                        row.append(cell);
+                        table.cells.append(row);
+                    }
+
+                    // 改进的列数检测（基于多种分隔符）
+                    int maxCols = 1;
+                    for (const QString& row : rows) {
+                        int colCount = qMax(qMax(qMax(row.count(QS("\t")) + 1, row.count(QS("|")) + 1),
+                                                 qMax(row.count(QS(",")) + 1, row.count(QS(";")) + 1)),
+                                            row.count(QS(" ")) + 1);
+                        maxCols = qMax(maxCols, colCount);
+                    }
+                    table.columns = qMin(maxCols, 10); // 限制最大列数
+
+                    // 添加详细的表格属性
+                    table.properties[QS("source")] = QS("PDF");
+                    table.properties[QS("extractionMethod")] = QS("regex_advanced");
+                    table.properties[QS("rowCount")] = QString::number(table.rows);
+                    table.properties[QS("columnCount")] = QString::number(table.columns);
+                    table.properties[QS("pattern")] = pattern.pattern();
+                    table.properties[QS("fileSize")] = QString::number(scanner.data().size());
+
+                    tables.append(table);
+                    totalTables++;
+                }
             }
         }
     }
@@ -361,44 +366,62 @@ bool PdfTableExtractor::parsePdfWithPoppler(const QString& filePath, QList<Table
             return false;
         }
 
+        // 表格线需要直接访问poppler核心文档，不渲染页面
+        PdfCoreDocument coreDocument;
+        if (!coreDocument.open(filePath)) {
+            setLastError(coreDocument.lastError());
+            return false;
+        }
+
         // 遍历所有页面提取表格
-        int pageCount = m_popplerDocument->numPages();
+        int pageCount = coreDocument.pageCount();
         for (int i = 0; i < pageCount; ++i) {
-            QString pageText = extractTextFromPageWithPoppler(i);
-            if (!pageText.isEmpty()) {
-                // 简单的表格检测（基于文本模式）
-                QStringList lines = pageText.split(QS("\n"), Qt::SkipEmptyParts);
-                QStringList tableLines;
-
-                for (const QString& line : lines) {
-                    // 检测表格行（包含制表符或多个空格）
-                    if (line.contains(QS("\t")) || line.count(QS(" ")) > 3) {
-                        tableLines.append(line);
+            QList<PdfTableDetector::Table> pageTables =
+                PdfTableDetector::buildTables(PdfTableDetector::collectRulings(coreDocument, i));
+            if (pageTables.isEmpty()) {
+                continue;
+            }
+
+            // 只有检测到表格的页面才需要文本框
+            QList<PdfTableDetector::TextFragment> fragments;
+            PdfTextLayoutCache::LayoutPtr layout = PdfTextLayoutCache::instance()->acquire(m_popplerDocument, i);
+            if (layout) {
+                for (const auto& textBox : layout->boxes) {
+                    if (textBox) {
+                        fragments.append({textBox->boundingBox(), textBox->text()});
                     }
                 }
-
-                if (tableLines.size() > 1) {
-                    TableInfo table;
-                    table.id = generateUniqueId(QS("poppler_table"));
-                    table.title = QS("PDF表格 %1").arg(tables.size() + 1);
-                    table.rows = tableLines.size();
-                    table.columns = 1;
-
-                    // 创建单元格数据
-                    for (int j = 0; j < tableLines.size(); ++j) {
-                        QList<CellInfo> row;
-                        CellInfo cell(j, 0, tableLines[j].trimmed());
-                        row.append(cell);
-                        table.cells.append(row);
+            }
+            PdfTableDetector::assignFragments(pageTables, fragments);
+
+            for (const PdfTableDetector::Table& detected : pageTables) {
+                TableInfo table(detected.rowCount, detected.columnCount);
+                table.id = generateUniqueId(QS("poppler_table"));
+                table.title = QS("PDF表格 %1").arg(tables.size() + 1);
+                table.position = detected.boundingBox.toAlignedRect();
+
+                for (int r = 0; r < detected.rowCount; ++r) {
+                    for (int c = 0; c < detected.columnCount; ++c) {
+                        const PdfTableDetector::Cell& detectedCell = detected.cells.at(detected.cellAt(r, c));
+                        CellInfo cell(r, c, QString());
+                        if (detectedCell.row == r && detectedCell.column == c) {
+                            cell.content = detectedCell.text;
+                            cell.rowSpan = detectedCell.rowSpan;
+                            cell.colSpan = detectedCell.columnSpan;
+                        } else {
+                            // 被合并单元格覆盖的位置
+                            cell.properties[QS("merged")] = true;
+                        }
+                        table.cells[r][c] = cell;
                     }
+                }
 
-                    // 添加表格属性
-                    table.properties[QS("source")] = QS("PDF_Poppler");
-                    table.properties[QS("pageNumber")] = QString::number(i + 1);
-                    table.properties[QS("extractionMethod")] = QS("poppler_text");
+                // 添加表格属性
+                table.properties[QS("source")] = QS("PDF_Poppler");
+                table.properties[QS("pageNumber")] = QString::number(i + 1);
+                table.properties[QS("extractionMethod")] = QS("vector_rulings");
 
-                    tables.append(table);
-                }
+                tables.append(table);
             }
         }
 
@@ -417,23 +440,9 @@ QString PdfTableExtractor::extractTextFromPageWithPoppler(int pageNumber) const
         return QString();
     }
 
-    try {
-        // 获取页面（Qt版本）
-        std::unique_ptr<Poppler::Page> page = m_popplerDocument->page(pageNumber);
-        if (!page) {
-            return QString();
-        }
-
-        // 提取文本（Qt版本）
-        QString text = page->text(QRectF());
-
-        // 页面对象会自动清理（unique_ptr）
-
-        return text;
-    } catch (const std::exception& e) {
-        qDebug() << QS("PdfTableExtractor: 提取文本时发生异常:") << e.what();
-        return QString();
-    }
+    // 从版面缓存借用页面文本，与其他提取器共用同一次版面分析
+    PdfTextLayoutCache::LayoutPtr layout = PdfTextLayoutCache::instance()->acquire(m_popplerDocument, pageNumber);
+    return layout ? layout->text : QString();
 }
 
 bool PdfTableExtractor::loadPopplerDocument(const QString& filePath)
@@ -442,16 +451,11 @@ bool PdfTableExtractor::loadPopplerDocument(const QString& filePath)
         // 关闭之前的文档
         closePopplerDocument();
 
-        // 加载PDF文档（Qt版本，支持NSS数字签名）
-        m_popplerDocument = Poppler::Document::load(filePath);
+        // 从文档池借用PDF文档（Qt版本，支持NSS数字签名），同一文件只解析一次
+        QString errorMessage;
+        m_popplerDocument = PdfDocumentPool::instance()->acquire(filePath, &errorMessage);
         if (!m_popplerDocument) {
-            setLastError(QS("无法加载PDF文档"));
-            return false;
-        }
-
-        if (m_popplerDocument->isLocked()) {
-            setLastError(QS("PDF文档已加密"));
-            m_popplerDocument.reset();
+            setLastError(errorMessage);
             return false;
         }
         